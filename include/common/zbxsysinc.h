@@ -203,6 +203,10 @@
 #	include <netinet/in.h>
 #endif
 
+#ifdef HAVE_NETINET_TCP_H
+#	include <netinet/tcp.h>
+#endif
+
 #ifdef HAVE_PWD_H
 #	include <pwd.h>
 #endif
@@ -39,6 +39,7 @@
 #define ZBX_RTC_PROXYPOLLER_PROCESS		19
 #define ZBX_RTC_PROF_ENABLE			20
 #define ZBX_RTC_PROF_DISABLE			21
+#define ZBX_RTC_TASKMANAGER_PROCESS		22
 
 /* internal rtc messages */
 #define ZBX_RTC_SUBSCRIBE			100
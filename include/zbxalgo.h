@@ -164,6 +164,7 @@ void	zbx_hashset_destroy(zbx_hashset_t *hs);
 int	zbx_hashset_reserve(zbx_hashset_t *hs, int num_slots_req);
 void	*zbx_hashset_insert(zbx_hashset_t *hs, const void *data, size_t size);
 void	*zbx_hashset_insert_ext(zbx_hashset_t *hs, const void *data, size_t size, size_t offset);
+void	*zbx_hashset_find_or_insert(zbx_hashset_t *hs, const void *data, size_t size, int *found);
 void	*zbx_hashset_search(const zbx_hashset_t *hs, const void *data);
 void	zbx_hashset_remove(zbx_hashset_t *hs, const void *data);
 void	zbx_hashset_remove_direct(zbx_hashset_t *hs, void *data);
@@ -292,6 +293,7 @@ typedef struct zbx_vector_ ## __id ## _s									\
 	__type			*values;									\
 	int			values_num;									\
 	int			values_alloc;									\
+	__type			*values_static;									\
 	zbx_mem_malloc_func_t	mem_malloc_func;								\
 	zbx_mem_realloc_func_t	mem_realloc_func;								\
 	zbx_mem_free_func_t	mem_free_func;									\
@@ -305,6 +307,8 @@ void	zbx_vector_ ## __id ## _create_ext(zbx_vector_ ## __id ## _t *vector,					\
 						zbx_mem_malloc_func_t mem_malloc_func,				\
 						zbx_mem_realloc_func_t mem_realloc_func,			\
 						zbx_mem_free_func_t mem_free_func);				\
+void	zbx_vector_ ## __id ## _create_static(zbx_vector_ ## __id ## _t *vector, __type *values,		\
+						int values_alloc);						\
 void	zbx_vector_ ## __id ## _destroy(zbx_vector_ ## __id ## _t *vector);					\
 														\
 void	zbx_vector_ ## __id ## _append(zbx_vector_ ## __id ## _t *vector, __type value);			\
@@ -360,6 +364,24 @@ ZBX_PTR_VECTOR_DECL(tags, zbx_tag_t*)
 
 #define	ZBX_VECTOR_IMPL(__id, __type)										\
 														\
+static void	__vector_ ## __id ## _realloc(zbx_vector_ ## __id ## _t *vector, int values_alloc)		\
+{														\
+	/* storage passed to create_static() is not owned, move values to heap if outgrown */			\
+	if (NULL != vector->values_static && vector->values == vector->values_static)				\
+	{													\
+		vector->values = (__type *)vector->mem_malloc_func(NULL, (size_t)values_alloc *			\
+				sizeof(__type));								\
+		memcpy(vector->values, vector->values_static, (size_t)vector->values_num * sizeof(__type));	\
+	}													\
+	else													\
+	{													\
+		vector->values = (__type *)vector->mem_realloc_func(vector->values,				\
+				(size_t)values_alloc * sizeof(__type));						\
+	}													\
+														\
+	vector->values_alloc = values_alloc;									\
+}														\
+														\
 static void	__vector_ ## __id ## _ensure_free_space(zbx_vector_ ## __id ## _t *vector)			\
 {														\
 	if (NULL == vector->values)										\
@@ -371,10 +393,8 @@ static void	__vector_ ## __id ## _ensure_free_space(zbx_vector_ ## __id ## _t *v
 	}													\
 	else if (vector->values_num == vector->values_alloc)							\
 	{													\
-		vector->values_alloc = MAX(vector->values_alloc + 1, vector->values_alloc *			\
-				ZBX_VECTOR_ARRAY_GROWTH_FACTOR);						\
-		vector->values = (__type *)vector->mem_realloc_func(vector->values,				\
-				(size_t)vector->values_alloc * sizeof(__type));					\
+		__vector_ ## __id ## _realloc(vector, MAX(vector->values_alloc + 1, vector->values_alloc *	\
+				ZBX_VECTOR_ARRAY_GROWTH_FACTOR));						\
 	}													\
 }														\
 														\
@@ -394,20 +414,36 @@ void	zbx_vector_ ## __id ## _create_ext(zbx_vector_ ## __id ## _t *vector,					\
 	vector->values = NULL;											\
 	vector->values_num = 0;											\
 	vector->values_alloc = 0;										\
+	vector->values_static = NULL;										\
 														\
 	vector->mem_malloc_func = mem_malloc_func;								\
 	vector->mem_realloc_func = mem_realloc_func;								\
 	vector->mem_free_func = mem_free_func;									\
 }														\
 														\
+/* creates vector using caller provided storage for the first values_alloc values, so */			\
+/* short lived vectors that fit in it do not allocate memory; storage must outlive vector */			\
+void	zbx_vector_ ## __id ## _create_static(zbx_vector_ ## __id ## _t *vector, __type *values,		\
+						int values_alloc)						\
+{														\
+	zbx_vector_ ## __id ## _create(vector);									\
+														\
+	vector->values = values;										\
+	vector->values_alloc = values_alloc;									\
+	vector->values_static = values;										\
+}														\
+														\
 void	zbx_vector_ ## __id ## _destroy(zbx_vector_ ## __id ## _t *vector)					\
 {														\
 	if (NULL != vector->values)										\
 	{													\
-		vector->mem_free_func(vector->values);								\
+		if (vector->values != vector->values_static)							\
+			vector->mem_free_func(vector->values);							\
+														\
 		vector->values = NULL;										\
 		vector->values_num = 0;										\
 		vector->values_alloc = 0;									\
+		vector->values_static = NULL;									\
 	}													\
 														\
 	vector->mem_malloc_func = NULL;										\
@@ -611,11 +647,7 @@ void	zbx_vector_ ## __id ## _setdiff(zbx_vector_ ## __id ## _t *left, const zbx_
 void	zbx_vector_ ## __id ## _reserve(zbx_vector_ ## __id ## _t *vector, size_t size)				\
 {														\
 	if ((int)size > vector->values_alloc)									\
-	{													\
-		vector->values_alloc = (int)size;								\
-		vector->values = (__type *)vector->mem_realloc_func(vector->values,				\
-				(size_t)vector->values_alloc * sizeof(__type));					\
-	}													\
+		__vector_ ## __id ## _realloc(vector, (int)size);						\
 }														\
 														\
 void	zbx_vector_ ## __id ## _clear(zbx_vector_ ## __id ## _t *vector)					\
@@ -712,6 +744,7 @@ void	zbx_queue_ptr_create(zbx_queue_ptr_t *queue);
 void	zbx_queue_ptr_destroy(zbx_queue_ptr_t *queue);
 void	zbx_queue_ptr_push(zbx_queue_ptr_t *queue, void *value);
 void	*zbx_queue_ptr_pop(zbx_queue_ptr_t *queue);
+void	*zbx_queue_ptr_peek(const zbx_queue_ptr_t *queue, int index);
 void	zbx_queue_ptr_remove_value(zbx_queue_ptr_t *queue, const void *value);
 
 /* list item data */
@@ -761,4 +794,20 @@ int	zbx_list_iterator_isset(const zbx_list_iterator_t *iterator);
 void	zbx_list_iterator_update(zbx_list_iterator_t *iterator);
 void	*zbx_list_iterator_remove_next(zbx_list_iterator_t *iterator);
 
+/* region allocator for objects freed all at once */
+typedef struct zbx_arena_block_s zbx_arena_block_t;
+
+typedef struct
+{
+	zbx_arena_block_t	*blocks;
+	size_t			block_size;
+	size_t			offset;
+}
+zbx_arena_t;
+
+void	zbx_arena_create(zbx_arena_t *arena, size_t block_size);
+void	zbx_arena_destroy(zbx_arena_t *arena);
+void	*zbx_arena_malloc(zbx_arena_t *arena, size_t size);
+char	*zbx_arena_strdup(zbx_arena_t *arena, const char *str);
+
 #endif /* ZABBIX_ZBXALGO_H */
@@ -38,5 +38,6 @@ typedef void (*zbx_async_task_clear_cb_t)(void *data);
 
 void	zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase, const char *addr,
 		void *data, int timeout, zbx_async_task_process_cb_t process_cb, zbx_async_task_clear_cb_t clear_cb);
+void	zbx_async_poller_dns_cache_destroy(void);
 #endif
 #endif
@@ -747,6 +747,7 @@ void	zbx_dc_config_get_hosts_by_itemids(zbx_dc_host_t *hosts, const zbx_uint64_t
 void	zbx_dc_config_get_hosts_by_hostids(zbx_dc_host_t *hosts, const zbx_uint64_t *hostids, int *errcodes, int num);
 void	zbx_dc_config_get_items_by_keys(zbx_dc_item_t *items, zbx_host_key_t *keys, int *errcodes, size_t num);
 void	zbx_dc_config_get_items_by_itemids(zbx_dc_item_t *items, const zbx_uint64_t *itemids, int *errcodes, size_t num);
+void	zbx_dc_config_get_items_monitored_status(const zbx_uint64_t *itemids, int *errcodes, int *queued, size_t num);
 
 void	zbx_dc_config_history_sync_get_items_by_itemids(zbx_history_sync_item_t *items, const zbx_uint64_t *itemids,
 		int *errcodes, size_t num, unsigned int mode);
@@ -1107,6 +1108,10 @@ void	zbx_get_item_tags(zbx_uint64_t itemid, zbx_vector_item_tag_t *item_tags);
 
 void	zbx_dc_config_history_sync_get_item_tags_by_functionids(const zbx_uint64_t *functionids,
 		size_t functionids_num, zbx_vector_item_tag_t *item_tags);
+void	zbx_dc_config_history_sync_get_item_tags_by_itemids(const zbx_uint64_t *itemids, zbx_vector_tags_t *item_tags,
+		size_t num);
+void	zbx_dc_config_history_sync_get_host_groups(const zbx_uint64_t *hostids, zbx_vector_ptr_t *groups, size_t num);
+zbx_uint64_t	zbx_dc_config_history_sync_get_revision(void);
 
 const char	*zbx_dc_get_instanceid(void);
 
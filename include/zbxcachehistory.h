@@ -107,7 +107,7 @@ void	zbx_hc_get_items(zbx_vector_uint64_pair_t *items);
 int	zbx_db_trigger_queue_locked(void);
 void	zbx_db_trigger_queue_unlock(void);
 
-int	zbx_hc_check_proxy(zbx_uint64_t proxyid);
+int	zbx_hc_check_proxy(zbx_uint64_t proxyid, int backlog);
 
 void	zbx_dc_add_history(zbx_uint64_t itemid, unsigned char item_value_type, unsigned char item_flags,
 		AGENT_RESULT *result, const zbx_timespec_t *ts, unsigned char state, const char *error);
@@ -89,6 +89,9 @@ typedef struct
 	zbx_uint64_t	itemid;
 	int		values_num;
 	int		hourly_num;
+	zbx_uint64_t	hits;
+	zbx_uint64_t	misses;		/* the number of values read from database */
+	zbx_uint64_t	size;		/* the approximate memory used by item, bytes */
 }
 zbx_vc_item_stats_t;
 
@@ -108,6 +111,11 @@ int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_
 int	zbx_vc_get_value(zbx_uint64_t itemid, unsigned char value_type, const zbx_timespec_t *ts,
 		zbx_history_record_t *value);
 
+typedef void	(*zbx_vc_fold_func_t)(const zbx_history_record_t *record, void *data);
+
+int	zbx_vc_fold_values(zbx_uint64_t itemid, unsigned char value_type, int seconds, int count,
+		const zbx_timespec_t *ts, zbx_vc_fold_func_t fold_func, void *data);
+
 int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush);
 
 int	zbx_vc_get_statistics(zbx_vc_stats_t *stats);
@@ -116,7 +124,7 @@ void	zbx_vc_remove_items_by_ids(zbx_vector_uint64_t *itemids);
 
 void	zbx_vc_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, int *mode);
 void	zbx_vc_get_mem_stats(zbx_shmem_stats_t *mem);
-void	zbx_vc_get_item_stats(zbx_vector_ptr_t *stats);
+void	zbx_vc_get_item_stats(zbx_vector_ptr_t *stats, int get_size);
 void	zbx_vc_flush_stats(void);
 
 #endif
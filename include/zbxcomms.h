@@ -22,6 +22,7 @@
 
 #include "zbxalgo.h"
 #include "zbxtime.h"
+#include "zbxcompress.h"
 
 #define ZBX_IPV4_MAX_CIDR_PREFIX	32	/* max number of bits in IPv4 CIDR prefix */
 #define ZBX_IPV6_MAX_CIDR_PREFIX	128	/* max number of bits in IPv6 CIDR prefix */
@@ -212,8 +213,9 @@ typedef struct
 	zbx_uint64_t	expected_len;
 	zbx_uint64_t	reserved;
 	zbx_uint64_t	max_len;
-	unsigned char	expect;
-	int		protocol_version;
+	unsigned char			expect;
+	int				protocol_version;
+	zbx_uncompress_stream_t		*uncompress;
 }
 zbx_tcp_recv_context_t;
 
@@ -252,6 +254,7 @@ int	zbx_socket_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char
 #define ZBX_TCP_PROTOCOL		0x01
 #define ZBX_TCP_COMPRESS		0x02
 #define ZBX_TCP_LARGE			0x04
+#define ZBX_TCP_ZSTD			0x08	/* compressed data uses zstd instead of zlib */
 
 #define ZBX_TCP_SEC_UNENCRYPTED		1		/* do not use encryption with this socket */
 #define ZBX_TCP_SEC_TLS_PSK		2		/* use TLS with pre-shared key (PSK) with this socket */
@@ -309,6 +312,7 @@ int	zbx_socket_check_deadline(zbx_socket_t *s);
 int	zbx_ip_cmp(unsigned int prefix_size, const struct addrinfo *current_ai, ZBX_SOCKADDR name, int ipv6v4_mode);
 int	zbx_validate_peer_list(const char *peer_list, char **error);
 int	zbx_tcp_check_allowed_peers(const zbx_socket_t *s, const char *peer_list);
+int	zbx_tcp_check_allowed_peers_cached(const zbx_socket_t *s, const char *peer_list);
 int	validate_cidr(const char *ip, const char *cidr, void *value);
 
 int	zbx_udp_connect(zbx_socket_t *s, const char *source_ip, const char *ip, unsigned short port, int timeout);
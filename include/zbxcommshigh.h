@@ -21,6 +21,7 @@
 #define ZABBIX_COMMSHIGH_H
 
 #include "zbxcomms.h"
+#include "zbxjson.h"
 #include "cfg.h"
 
 int	zbx_connect_to_server(zbx_socket_t *sock, const char *source_ip, zbx_vector_addr_ptr_t *addrs, int timeout,
@@ -44,4 +45,8 @@ int	zbx_send_response_ext(zbx_socket_t *sock, int result, const char *info, cons
 
 int	zbx_recv_response(zbx_socket_t *sock, int timeout, char **error);
 
+void	zbx_json_add_compression(struct zbx_json *j);
+int	zbx_get_compression_method(const struct zbx_json_parse *jp);
+unsigned char	zbx_compress_method_protocol(int method);
+
 #endif // ZABBIX_COMMSHIGH_H
@@ -22,8 +22,21 @@
 
 #include "zbxtypes.h"
 
+#define ZBX_COMPRESS_METHOD_ZLIB	0
+#define ZBX_COMPRESS_METHOD_ZSTD	1
+
 int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out);
 int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out);
+int	zbx_compress_ext(const char *in, size_t size_in, char **out, size_t *size_out, int method);
+int	zbx_uncompress_ext(const char *in, size_t size_in, char *out, size_t *size_out, int method);
+int	zbx_compress_method_supported(int method);
 const char	*zbx_compress_strerror(void);
 
+typedef struct zbx_uncompress_stream_s	zbx_uncompress_stream_t;
+
+int	zbx_uncompress_stream_init(zbx_uncompress_stream_t **stream, char *out, size_t size_out);
+int	zbx_uncompress_stream(zbx_uncompress_stream_t *stream, const char *in, size_t size_in);
+int	zbx_uncompress_stream_finish(zbx_uncompress_stream_t *stream, size_t *size_out);
+void	zbx_uncompress_stream_free(zbx_uncompress_stream_t *stream);
+
 #endif
@@ -44,6 +44,7 @@ zbx_dservice_t;
 void	zbx_discoverer_init(void);
 
 void	*zbx_discovery_open(void);
+void	zbx_discovery_prefetch(void *handle, const zbx_vector_uint64_t *dcheckids, const zbx_vector_str_t *ips);
 void	zbx_discovery_update_host(void *handle, zbx_uint64_t druleid, zbx_db_dhost *dhost, const char *ip,
 		const char *dns, int status, time_t now, zbx_add_event_func_t add_event_cb);
 void	zbx_discovery_update_service(void *handle, zbx_uint64_t druleid, zbx_uint64_t dcheckid,
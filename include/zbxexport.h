@@ -31,6 +31,10 @@ typedef struct
 	char	*name;
 	FILE	*file;
 	int	missing;
+	/* the current position in export file */
+	long	offset;
+	/* set when export file presence was checked since the last flush */
+	int	checked;
 }
 zbx_export_file_t;
 
@@ -31,6 +31,9 @@
 
 #define ZBX_IPC_WAIT_FOREVER	-1
 
+/* number of power of two size classes of recycled message data buffers */
+#define ZBX_IPC_POOL_CLASSES_NUM	11
+
 typedef struct
 {
 	/* the message code */
@@ -79,6 +82,13 @@ typedef struct
 
 	/* the clients with messages */
 	zbx_queue_ptr_t		clients_recv;
+
+	/* the number of messages returned without polling sockets */
+	int			recv_nopoll_num;
+
+	/* the released messages and message data buffers for reuse */
+	zbx_vector_ptr_t	messages_pool;
+	zbx_vector_ptr_t	buffers_pool[ZBX_IPC_POOL_CLASSES_NUM];
 }
 zbx_ipc_service_t;
 
@@ -99,6 +109,7 @@ int	zbx_ipc_service_start(zbx_ipc_service_t *service, const char *service_name,
 int	zbx_ipc_service_recv(zbx_ipc_service_t *service, const zbx_timespec_t *timeout, zbx_ipc_client_t **client,
 		zbx_ipc_message_t **message);
 void	zbx_ipc_service_alert(zbx_ipc_service_t *service);
+void	zbx_ipc_service_release_message(zbx_ipc_service_t *service, zbx_ipc_message_t *message);
 void	zbx_ipc_service_close(zbx_ipc_service_t *service);
 
 int	zbx_ipc_client_send(zbx_ipc_client_t *client, zbx_uint32_t code, const unsigned char *data, zbx_uint32_t size);
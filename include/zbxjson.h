@@ -207,6 +207,7 @@
 #define ZBX_PROTO_TAG_REMOVED_MACRO_HOSTIDS	"del_macro_hostids"
 #define ZBX_PROTO_TAG_ACKNOWLEDGEID		"acknowledgeid"
 #define ZBX_PROTO_TAG_WAIT			"wait"
+#define ZBX_PROTO_TAG_COMPRESSION		"compression"
 
 #define ZBX_PROTO_VALUE_FAILED		"failed"
 #define ZBX_PROTO_VALUE_SUCCESS		"success"
@@ -243,6 +244,8 @@
 #define ZBX_PROTO_VALUE_PROXY_UPLOAD_ENABLED	"enabled"
 #define ZBX_PROTO_VALUE_PROXY_UPLOAD_DISABLED	"disabled"
 
+#define ZBX_PROTO_VALUE_COMPRESSION_ZSTD	"zstd"
+
 #define ZBX_PROTO_VALUE_REPORT_TEST		"report.test"
 
 #define ZBX_PROTO_VALUE_SUPPRESSION_SUPPRESS	"suppress"
@@ -372,7 +375,10 @@ typedef struct zbx_jsonpath_index zbx_jsonpath_index_t;
 
 int	zbx_jsonpath_compile(const char *path, zbx_jsonpath_t *jsonpath);
 int	zbx_jsonpath_query(const struct zbx_json_parse *jp, const char *path, char **output);
+int	zbx_jsonpath_query_text(const char *data, const zbx_jsonpath_t *jsonpath, char **output);
 int	zbx_jsonobj_query_ext(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const char *path, char **output);
+int	zbx_jsonobj_query_path(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, zbx_jsonpath_t *jsonpath,
+		char **output);
 void	zbx_jsonpath_clear(zbx_jsonpath_t *jsonpath);
 
 zbx_jsonpath_index_t	*zbx_jsonpath_index_create(char **error);
@@ -119,6 +119,11 @@ void	zbx_pp_manager_get_sequence_stats(zbx_pp_manager_t *manager, zbx_vector_pp_
 
 void	zbx_pp_manager_get_worker_usage(zbx_pp_manager_t *manager, zbx_vector_dbl_t *worker_usage);
 
+ZBX_PTR_VECTOR_DECL(pp_time_stats_ptr, zbx_pp_time_stats_t *)
+
+void	zbx_pp_manager_get_item_stats(zbx_pp_manager_t *manager, zbx_vector_pp_time_stats_ptr_t *items);
+void	zbx_pp_manager_get_step_stats(zbx_pp_manager_t *manager, zbx_vector_pp_time_stats_ptr_t *steps);
+
 void zbx_preproc_stats_ext_get(struct zbx_json *json, const void *arg);
 zbx_uint64_t	zbx_preprocessor_get_queue_size(void);
 void	zbx_preprocessor_get_worker_info(zbx_process_info_t *info);
@@ -128,6 +133,8 @@ void	zbx_preprocessor_flush(void);
 int	zbx_preprocessor_get_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
 		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, char **error);
 int	zbx_preprocessor_get_top_sequences(int limit, zbx_vector_pp_sequence_stats_ptr_t *sequences, char **error);
+int	zbx_preprocessor_get_top_items(int limit, zbx_vector_pp_time_stats_ptr_t *items, char **error);
+int	zbx_preprocessor_get_top_steps(int limit, zbx_vector_pp_time_stats_ptr_t *steps, char **error);
 int	zbx_preprocessor_test(unsigned char value_type, const char *value, const zbx_timespec_t *ts,
 		unsigned char state, const zbx_vector_pp_step_ptr_t *steps, zbx_vector_pp_result_ptr_t *results,
 		zbx_pp_history_t *history, char **error);
@@ -97,12 +97,28 @@ zbx_pp_item_preproc_t	*zbx_pp_item_preproc_create(zbx_uint64_t hostid, unsigned
 void	zbx_pp_item_preproc_release(zbx_pp_item_preproc_t *preproc);
 int	zbx_pp_preproc_has_history(int type);
 
+#define ZBX_PP_TIME_BUCKETS_NUM	5
+
+/* preprocessing execution time statistics */
+typedef struct
+{
+	zbx_uint64_t	id;		/* itemid or preprocessing step type */
+	zbx_uint64_t	num;		/* number of executions */
+	double		time;		/* total execution time */
+
+	/* execution time histogram with <1ms, <10ms, <100ms, <1s, >=1s buckets */
+	zbx_uint64_t	buckets[ZBX_PP_TIME_BUCKETS_NUM];
+}
+zbx_pp_time_stats_t;
+
 typedef struct
 {
 	zbx_uint64_t		itemid;
 	zbx_uint64_t		revision;
 
 	zbx_pp_item_preproc_t	*preproc;
+
+	zbx_pp_time_stats_t	time_stats;
 }
 zbx_pp_item_t;
 
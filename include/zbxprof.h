@@ -32,6 +32,7 @@ void	zbx_prof_enable(zbx_prof_scope_t scope);
 void	zbx_prof_disable(void);
 void	zbx_prof_start(const char *func_name, zbx_prof_scope_t scope);
 void	zbx_prof_end_wait(void);
+void	zbx_prof_contended(void);
 void	zbx_prof_end(void);
 void	zbx_prof_update(const char *info, double time_now);
 
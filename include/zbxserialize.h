@@ -139,4 +139,6 @@
 zbx_uint32_t	zbx_serialize_uint31_compact(unsigned char *ptr, zbx_uint32_t value);
 zbx_uint32_t	zbx_deserialize_uint31_compact(const unsigned char *ptr, zbx_uint32_t *value);
 
+void	zbx_serialize_reserve(unsigned char **buffer, zbx_uint32_t *buffer_alloc, zbx_uint32_t size);
+
 #endif /* ZABBIX_SERIALIZE_H */
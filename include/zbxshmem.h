@@ -32,6 +32,7 @@ typedef struct
 {
 	void		*base;
 	void		**buckets;
+	zbx_uint64_t	buckets_mask;	/* bit N is set when bucket N has free chunks */
 	void		*lo_bound;
 	void		*hi_bound;
 	zbx_uint64_t	free_size;
@@ -63,6 +64,8 @@ typedef struct
 }
 zbx_shmem_stats_t;
 
+void	zbx_init_library_shmem(int huge_pages);
+
 int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error);
 int	zbx_shmem_create_min(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
@@ -67,6 +67,8 @@ int	zbx_trends_eval_min(const char *table, zbx_uint64_t itemid, time_t start, ti
 		char **error);
 int	zbx_trends_eval_sum(const char *table, zbx_uint64_t itemid, time_t start, time_t end, double *value,
 		char **error);
+void	zbx_trends_prefetch(const char *table, const char *function, time_t start, time_t end,
+		const zbx_vector_uint64_t *itemids);
 
 /* trends function cache */
 typedef struct
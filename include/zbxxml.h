@@ -26,6 +26,7 @@
 
 #ifdef HAVE_LIBXML2
 #	include <libxml/tree.h>
+#	include <libxml/xpath.h>
 #endif
 
 int	zbx_xml_get_data_dyn(const char *xml, const char *tag, char **data);
@@ -38,6 +39,10 @@ int	zbx_query_xpath(zbx_variant_t *value, const char *params, char **errmsg);
 #ifdef HAVE_LIBXML2
 int	zbx_open_xml(char *data, int options, int maxerrlen, void **xml_doc, void **root_node, char **errmsg);
 int	zbx_check_xml_memory(char *mem, int maxerrlen, char **errmsg);
+
+xmlDoc	*zbx_xml_doc_parse(const char *data, char **errmsg);
+xmlXPathCompExpr	*zbx_xml_xpath_compile(const char *xpath, char **errmsg);
+int	zbx_query_xpath_doc(xmlDoc *doc, xmlXPathCompExpr *xpath, zbx_variant_t *value, char **errmsg);
 #endif
 
 int	zbx_xmlnode_to_json(void *xml_node, char **jstr);
@@ -0,0 +1,116 @@
+# ZSTD_CHECK_CONFIG ([DEFAULT-ACTION])
+# ----------------------------------------------------------
+#
+# Checks for zstd.
+#
+# This macro #defines HAVE_ZSTD if required header files are
+# found, and sets @ZSTD_LDFLAGS@ and @ZSTD_CFLAGS@ to the necessary
+# values.
+#
+# This macro is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+AC_DEFUN([ZSTD_TRY_LINK],
+[
+found_zstd=$1
+AC_LINK_IFELSE([AC_LANG_PROGRAM([[
+#include <zstd.h>
+]], [[
+	ZSTD_CCtx	*cctx;
+
+	cctx = ZSTD_createCCtx();
+	ZSTD_freeCCtx(cctx);
+]])],[found_zstd="yes"],[])
+])dnl
+
+AC_DEFUN([ZSTD_CHECK_CONFIG],
+[
+	want_zstd="no"
+
+	AC_ARG_WITH([zstd],[
+If you want to use zstd compression for Zabbix protocol:
+AS_HELP_STRING([--with-zstd@<:@=DIR@:>@], [use zstd from given base install directory (DIR), default is to search through a number of common places for the zstd files.])],
+		[
+			if test "x$withval" != "xno"; then
+				want_zstd="yes"
+
+				if test "x$withval" != "xyes"; then
+					ZSTD_CFLAGS="-I$withval/include"
+					ZSTD_LDFLAGS="-L$withval/lib"
+					_zstd_dir_set="yes"
+				fi
+			fi
+		]
+	)
+
+	AC_ARG_WITH([zstd-include],
+		AS_HELP_STRING([--with-zstd-include=DIR],
+			[use zstd include headers from given path.]
+		),
+		[
+			ZSTD_CFLAGS="-I$withval"
+			_zstd_dir_set="yes"
+		]
+	)
+
+	AC_ARG_WITH([zstd-lib],
+		AS_HELP_STRING([--with-zstd-lib=DIR],
+			[use zstd libraries from given path.]
+		),
+		[
+			ZSTD_LDFLAGS="-L$withval"
+			_zstd_dir_set="yes"
+		]
+	)
+
+	if test "x$want_zstd" = "xyes"; then
+		AC_MSG_CHECKING(for zstd support)
+
+		ZSTD_LIBS="-lzstd"
+
+		if test -n "$_zstd_dir_set" -o -f /usr/include/zstd.h; then
+			found_zstd="yes"
+		elif test -f /usr/local/include/zstd.h; then
+			ZSTD_CFLAGS="-I/usr/local/include"
+			ZSTD_LDFLAGS="-L/usr/local/lib"
+			found_zstd="yes"
+		elif test -f /usr/pkg/include/zstd.h; then
+			ZSTD_CFLAGS="-I/usr/pkg/include"
+			ZSTD_LDFLAGS="-L/usr/pkg/lib"
+			found_zstd="yes"
+		else
+			found_zstd="no"
+		fi
+
+		if test "x$found_zstd" = "xyes"; then
+			am_save_CFLAGS="$CFLAGS"
+			am_save_LDFLAGS="$LDFLAGS"
+			am_save_LIBS="$LIBS"
+
+			CFLAGS="$CFLAGS $ZSTD_CFLAGS"
+			LDFLAGS="$LDFLAGS $ZSTD_LDFLAGS"
+			LIBS="$LIBS $ZSTD_LIBS"
+
+			ZSTD_TRY_LINK([no])
+
+			CFLAGS="$am_save_CFLAGS"
+			LDFLAGS="$am_save_LDFLAGS"
+			LIBS="$am_save_LIBS"
+		fi
+
+		if test "x$found_zstd" = "xyes"; then
+			AC_DEFINE([HAVE_ZSTD], 1, [Define to 1 if you have the 'zstd' library (-lzstd)])
+			AC_MSG_RESULT(yes)
+		else
+			AC_MSG_RESULT(no)
+			ZSTD_CFLAGS=""
+			ZSTD_LDFLAGS=""
+			ZSTD_LIBS=""
+		fi
+	fi
+
+	AC_SUBST(ZSTD_CFLAGS)
+	AC_SUBST(ZSTD_LDFLAGS)
+	AC_SUBST(ZSTD_LIBS)
+])dnl
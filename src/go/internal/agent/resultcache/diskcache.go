@@ -368,108 +368,143 @@ func (c *DiskCache) flushOutput(u Uploader) {
 	}
 }
 
-func (c *DiskCache) write(r *plugin.Result) {
+// write stores results in a single transaction, so that the database is synced once per batch
+// instead of once per result
+func (c *DiskCache) write(results []*plugin.Result) {
 	var err error
-	c.lastDataID++
 
-	var LastLogsize int64 = DbVariableNotSet
-	if r.LastLogsize != nil {
-		LastLogsize = int64(*r.LastLogsize)
-	}
+	now := time.Now().Unix()
+	cacheLock.Lock()
+	defer cacheLock.Unlock()
 
-	var Value string
-	var State int = DbVariableNotSet
-	if r.Error != nil {
-		Value = r.Error.Error()
-		State = itemutil.StateNotSupported
-	} else if r.Value != nil {
-		Value = *r.Value
-	}
+	for _, r := range results {
+		if r.Persistent {
+			continue
+		}
 
-	var ns int
-	var clock int64
-	if !r.Ts.IsZero() {
-		clock = r.Ts.Unix()
-		ns = r.Ts.Nanosecond()
-	}
+		if c.oldestData == 0 && !r.Ts.IsZero() {
+			c.oldestData = r.Ts.Unix()
+		}
 
-	var Mtime int = DbVariableNotSet
-	if r.Mtime != nil {
-		Mtime = *r.Mtime
-	}
+		if (now - c.oldestData) > c.storagePeriod+StorageTolerance {
+			query := fmt.Sprintf("DELETE FROM data_%d WHERE clock<?", c.serverID)
+			if _, err = c.database.Exec(query, now-c.storagePeriod); err != nil {
+				c.Errf("cannot delete old data from data_%d : %s", c.serverID, err)
+			}
 
-	var EventSource string
-	if r.EventSource != nil {
-		EventSource = *r.EventSource
+			c.oldestData, err = c.getOldestWriteClock(tableName("data", c.serverID))
+			if err != nil {
+				c.Errf("cannot query minimum write clock from data_%d : %s", c.serverID, err)
+			}
+		}
+		break
 	}
 
-	var EventID int = DbVariableNotSet
-	if r.EventID != nil {
-		EventID = *r.EventID
+	var tx *sql.Tx
+	if tx, err = c.database.Begin(); err != nil {
+		c.Errf("cannot begin transaction : %s", err)
+		panic(err)
 	}
 
-	var EventSeverity int = DbVariableNotSet
-	if r.EventSeverity != nil {
-		EventSeverity = *r.EventSeverity
-	}
+	// statements prepared within transaction are closed when it is committed or rolled back
+	var dataStmt, logStmt *sql.Stmt
 
-	var EventTimestamp int = DbVariableNotSet
-	if r.EventTimestamp != nil {
-		EventTimestamp = *r.EventTimestamp
-	}
+	for _, r := range results {
+		var LastLogsize int64 = DbVariableNotSet
+		if r.LastLogsize != nil {
+			LastLogsize = int64(*r.LastLogsize)
+		}
 
-	var stmt *sql.Stmt
+		var Value string
+		var State int = DbVariableNotSet
+		if r.Error != nil {
+			Value = r.Error.Error()
+			State = itemutil.StateNotSupported
+		} else if r.Value != nil {
+			Value = *r.Value
+		}
 
-	now := time.Now().Unix()
-	cacheLock.Lock()
-	defer cacheLock.Unlock()
+		var ns int
+		var clock int64
+		if !r.Ts.IsZero() {
+			clock = r.Ts.Unix()
+			ns = r.Ts.Nanosecond()
+		}
 
-	if r.Persistent {
+		var Mtime int = DbVariableNotSet
+		if r.Mtime != nil {
+			Mtime = *r.Mtime
+		}
 
-		if c.oldestLog == 0 {
-			c.oldestLog = clock
+		var EventSource string
+		if r.EventSource != nil {
+			EventSource = *r.EventSource
 		}
-		if (now - c.oldestLog) > c.storagePeriod {
-			atomic.StoreUint32(&c.persistFlag, 1)
+
+		var EventID int = DbVariableNotSet
+		if r.EventID != nil {
+			EventID = *r.EventID
 		}
-		stmt, err = c.database.Prepare(c.insertResultTable(fmt.Sprintf("log_%d", c.serverID)))
 
-		if err != nil {
-			c.Errf("cannot prepare SQL query to insert history in log_%d : %s", c.serverID, err)
-		} else {
-			defer stmt.Close()
+		var EventSeverity int = DbVariableNotSet
+		if r.EventSeverity != nil {
+			EventSeverity = *r.EventSeverity
 		}
-	} else {
-		if c.oldestData == 0 {
-			c.oldestData = clock
+
+		var EventTimestamp int = DbVariableNotSet
+		if r.EventTimestamp != nil {
+			EventTimestamp = *r.EventTimestamp
 		}
 
-		if (now - c.oldestData) > c.storagePeriod+StorageTolerance {
-			query := fmt.Sprintf("DELETE FROM data_%d WHERE clock<?", c.serverID)
-			if _, err = c.database.Exec(query, now-c.storagePeriod); err != nil {
-				c.Errf("cannot delete old data from data_%d : %s", c.serverID, err)
+		var stmt *sql.Stmt
+
+		if r.Persistent {
+			if c.oldestLog == 0 {
+				c.oldestLog = clock
+			}
+			if (now - c.oldestLog) > c.storagePeriod {
+				atomic.StoreUint32(&c.persistFlag, 1)
 			}
 
-			c.oldestData, err = c.getOldestWriteClock(tableName("data", c.serverID))
-			if err != nil {
-				c.Errf("cannot query minimum write clock from data_%d : %s", c.serverID, err)
+			if logStmt == nil {
+				logStmt, err = tx.Prepare(c.insertResultTable(fmt.Sprintf("log_%d", c.serverID)))
+				if err != nil {
+					c.Errf("cannot prepare SQL query to insert history in log_%d : %s", c.serverID, err)
+					break
+				}
 			}
-		}
-		stmt, err = c.database.Prepare(c.insertResultTable(fmt.Sprintf("data_%d", c.serverID)))
-		if err != nil {
-			c.Errf("cannot prepare SQL query to insert history in data_%d : %s", c.serverID, err)
+			stmt = logStmt
 		} else {
-			defer stmt.Close()
+			if c.oldestData == 0 {
+				c.oldestData = clock
+			}
+
+			if dataStmt == nil {
+				dataStmt, err = tx.Prepare(c.insertResultTable(fmt.Sprintf("data_%d", c.serverID)))
+				if err != nil {
+					c.Errf("cannot prepare SQL query to insert history in data_%d : %s", c.serverID, err)
+					break
+				}
+			}
+			stmt = dataStmt
 		}
-	}
-	if stmt != nil {
+
+		c.lastDataID++
 		_, err = stmt.Exec(c.lastDataID, now, r.Itemid, LastLogsize, Mtime, State, Value,
 			EventSource, EventID, EventSeverity, EventTimestamp, clock, ns)
 		if err != nil {
 			c.Errf("cannot execute SQL statement : %s", err)
+			break
 		}
 	}
+
 	if err != nil {
+		_ = tx.Rollback()
+		panic(err)
+	}
+
+	if err = tx.Commit(); err != nil {
+		c.Errf("cannot commit transaction : %s", err)
 		panic(err)
 	}
 }
@@ -532,8 +567,17 @@ func (c *DiskCache) run() {
 	defer log.PanicHook()
 	c.Debugf("starting disk cache")
 
+	var results []*plugin.Result
+	var next interface{}
+	var pending bool
+
 	for {
-		u := <-c.input
+		var u interface{}
+		if pending {
+			u, pending = next, false
+		} else {
+			u = <-c.input
+		}
 		if u == nil {
 			break
 		}
@@ -541,7 +585,27 @@ func (c *DiskCache) run() {
 		case Uploader:
 			c.flushOutput(v)
 		case *plugin.Result:
-			c.write(v)
+			// collect results that are already queued to write them in one transaction, the first
+			// message of other type is processed after the batch to preserve ordering
+			results = append(results[:0], v)
+		batch:
+			for len(results) < DataLimit {
+				select {
+				case next = <-c.input:
+					r, ok := next.(*plugin.Result)
+					if !ok {
+						pending = true
+						break batch
+					}
+					results = append(results, r)
+				default:
+					break batch
+				}
+			}
+			c.write(results)
+			for i := range results {
+				results[i] = nil
+			}
 		case *CommandResult:
 			c.writeCommand(v)
 		case *agent.AgentOptions:
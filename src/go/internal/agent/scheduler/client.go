@@ -32,7 +32,6 @@ import (
 	"zabbix.com/internal/agent"
 	"zabbix.com/internal/agent/resultcache"
 	"zabbix.com/pkg/glexpr"
-	"zabbix.com/pkg/zbxlib"
 )
 
 // clientItem represents item monitored by client
@@ -143,7 +142,7 @@ func (c *client) addRequest(p *pluginAgent, r *plugin.Request, sink plugin.Resul
 			var task *exporterTask
 			var scheduling bool
 
-			if _, scheduling, err = zbxlib.GetNextcheck(r.Itemid, r.Delay, now); err != nil {
+			if _, scheduling, err = getNextcheck(r.Itemid, r.Delay, now); err != nil {
 				return err
 			}
 			if tacc, ok = c.exporters[r.Itemid]; ok {
@@ -206,9 +206,67 @@ func (t *exporterTask) perform(s Scheduler) {
 	}(t.item.key)
 }
 
+// parseSimpleDelay returns item update interval in seconds if the delay is a plain number with
+// optional time suffix and no custom intervals, otherwise false is returned
+func parseSimpleDelay(delay string) (period int64, ok bool) {
+	var i int
+	for i < len(delay) && delay[i] >= '0' && delay[i] <= '9' {
+		// longer values are either invalid or out of range, leave them to the full parser
+		if i == 9 {
+			return 0, false
+		}
+		period = period*10 + int64(delay[i]-'0')
+		i++
+	}
+	if i == 0 {
+		return 0, false
+	}
+
+	if i < len(delay) {
+		switch delay[i] {
+		case 's':
+		case 'm':
+			period *= 60
+		case 'h':
+			period *= 3600
+		case 'd':
+			period *= 86400
+		case 'w':
+			period *= 7 * 86400
+		default:
+			return 0, false
+		}
+		if i+1 != len(delay) {
+			return 0, false
+		}
+	}
+
+	if period == 0 || period > 86400 {
+		return 0, false
+	}
+
+	return period, true
+}
+
+// getNextcheck calculates item nextcheck the same way as zbxlib.GetNextcheck, but avoids calling
+// C library for simple update intervals used by most items
+func getNextcheck(itemid uint64, delay string, now time.Time) (nextcheck time.Time, scheduling bool,
+	err error) {
+	if period, ok := parseSimpleDelay(delay); ok {
+		seconds := now.Unix()
+		next := period*(seconds/period) + int64(itemid%uint64(period))
+		for next <= seconds {
+			next += period
+		}
+		return time.Unix(next, 0), false, nil
+	}
+
+	return zbxlib.GetNextcheck(itemid, delay, now)
+}
+
 func (t *exporterTask) reschedule(now time.Time) (err error) {
 	var nextcheck time.Time
-	nextcheck, _, err = zbxlib.GetNextcheck(t.item.itemid, t.item.delay, now)
+	nextcheck, _, err = getNextcheck(t.item.itemid, t.item.delay, now)
 	if err != nil {
 		return
 	}
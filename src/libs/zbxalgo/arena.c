@@ -0,0 +1,152 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxalgo.h"
+
+#define ZBX_ARENA_ALIGN			sizeof(zbx_uint64_t)
+#define ZBX_ARENA_ALIGN_SIZE(size)	(((size) + ZBX_ARENA_ALIGN - 1) & ~(ZBX_ARENA_ALIGN - 1))
+
+#define ZBX_ARENA_BLOCK_SIZE_MIN	1024
+
+struct zbx_arena_block_s
+{
+	zbx_arena_block_t	*next;
+	size_t			size;
+};
+
+#define ZBX_ARENA_BLOCK_OFFSET	ZBX_ARENA_ALIGN_SIZE(sizeof(zbx_arena_block_t))
+
+static zbx_arena_block_t	*arena_block_create(size_t size)
+{
+	zbx_arena_block_t	*block;
+
+	block = (zbx_arena_block_t *)zbx_malloc(NULL, ZBX_ARENA_BLOCK_OFFSET + size);
+	block->size = size;
+	block->next = NULL;
+
+	return block;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates memory arena                                              *
+ *                                                                            *
+ * Parameters: arena      - [OUT]                                             *
+ *             block_size - [IN] the size of memory blocks allocated by arena *
+ *                                                                            *
+ * Comments: Arena serves small allocations from large memory blocks. The     *
+ *           allocated memory cannot be freed individually - it is released   *
+ *           by resetting or destroying the whole arena. The first block is   *
+ *           allocated on the first allocation request.                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_arena_create(zbx_arena_t *arena, size_t block_size)
+{
+	arena->blocks = NULL;
+	arena->block_size = ZBX_ARENA_ALIGN_SIZE(MAX(block_size, ZBX_ARENA_BLOCK_SIZE_MIN));
+	arena->offset = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees all memory allocated by arena                               *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_arena_destroy(zbx_arena_t *arena)
+{
+	zbx_arena_block_t	*block;
+
+	while (NULL != (block = arena->blocks))
+	{
+		arena->blocks = block->next;
+		zbx_free(block);
+	}
+
+	arena->offset = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates memory from arena                                       *
+ *                                                                            *
+ * Parameters: arena - [IN]                                                   *
+ *             size  - [IN] the number of bytes to allocate                   *
+ *                                                                            *
+ * Return value: The allocated memory, aligned for any zabbix data type.      *
+ *                                                                            *
+ * Comments: Allocations larger than a quarter of block size get a dedicated  *
+ *           block, so they do not waste the free space of the current block. *
+ *                                                                            *
+ ******************************************************************************/
+void	*zbx_arena_malloc(zbx_arena_t *arena, size_t size)
+{
+	zbx_arena_block_t	*block;
+	void			*ptr;
+
+	size = ZBX_ARENA_ALIGN_SIZE(MAX(size, 1));
+
+	if (size > arena->block_size / 4)
+	{
+		block = arena_block_create(size);
+
+		/* keep the current block at list head so its free space is still used */
+		if (NULL != arena->blocks)
+		{
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		}
+		else
+		{
+			arena->blocks = block;
+			arena->offset = size;
+		}
+
+		return (char *)block + ZBX_ARENA_BLOCK_OFFSET;
+	}
+
+	if (NULL == arena->blocks || arena->offset + size > arena->blocks->size)
+	{
+		block = arena_block_create(arena->block_size);
+		block->next = arena->blocks;
+		arena->blocks = block;
+		arena->offset = 0;
+	}
+
+	ptr = (char *)arena->blocks + ZBX_ARENA_BLOCK_OFFSET + arena->offset;
+	arena->offset += size;
+
+	return ptr;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copies string into arena memory                                   *
+ *                                                                            *
+ ******************************************************************************/
+char	*zbx_arena_strdup(zbx_arena_t *arena, const char *str)
+{
+	size_t	len;
+	char	*ptr;
+
+	len = strlen(str) + 1;
+	ptr = (char *)zbx_arena_malloc(arena, len);
+	memcpy(ptr, str, len);
+
+	return ptr;
+}
@@ -20,8 +20,6 @@
 #include "zbxalgo.h"
 
 
-static void	swap(zbx_binary_heap_t *heap, int index_1, int index_2);
-
 static void	__binary_heap_ensure_free_space(zbx_binary_heap_t *heap);
 
 static int	__binary_heap_bubble_up(zbx_binary_heap_t *heap, int index);
@@ -31,23 +29,6 @@ static int	__binary_heap_bubble_down(zbx_binary_heap_t *heap, int index);
 
 #define	HAS_DIRECT_OPTION(heap)	(0 != (heap->options & ZBX_BINARY_HEAP_OPTION_DIRECT))
 
-/* helper functions */
-
-static void	swap(zbx_binary_heap_t *heap, int index_1, int index_2)
-{
-	zbx_binary_heap_elem_t	tmp;
-
-	tmp = heap->elems[index_1];
-	heap->elems[index_1] = heap->elems[index_2];
-	heap->elems[index_2] = tmp;
-
-	if (HAS_DIRECT_OPTION(heap))
-	{
-		zbx_hashmap_set(heap->key_index, heap->elems[index_1].key, index_1);
-		zbx_hashmap_set(heap->key_index, heap->elems[index_2].key, index_2);
-	}
-}
-
 /* private binary heap functions */
 
 static void	__binary_heap_ensure_free_space(zbx_binary_heap_t *heap)
@@ -81,61 +62,98 @@ static void	__binary_heap_ensure_free_space(zbx_binary_heap_t *heap)
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves element up until the heap property is restored              *
+ *                                                                            *
+ * Return value: the new element index                                        *
+ *                                                                            *
+ * Comments: Instead of swapping the element with its parent on every level   *
+ *           the parents are shifted down into the hole and the element is    *
+ *           written only once at its final position. This halves the number  *
+ *           of element copies and key index updates for direct heaps.        *
+ *           The key index of the element is updated only if it was moved.    *
+ *                                                                            *
+ ******************************************************************************/
 static int	__binary_heap_bubble_up(zbx_binary_heap_t *heap, int index)
 {
+	zbx_binary_heap_elem_t	elem;
+	int			start = index;
+
+	elem = heap->elems[index];
+
 	while (0 != index)
 	{
-		if (heap->compare_func(&heap->elems[(index - 1) / 2], &heap->elems[index]) <= 0)
+		int	parent = (index - 1) / 2;
+
+		if (heap->compare_func(&heap->elems[parent], &elem) <= 0)
 			break;
 
-		swap(heap, (index - 1) / 2, index);
-		index = (index - 1) / 2;
+		heap->elems[index] = heap->elems[parent];
+
+		if (HAS_DIRECT_OPTION(heap))
+			zbx_hashmap_set(heap->key_index, heap->elems[index].key, index);
+
+		index = parent;
+	}
+
+	if (index != start)
+	{
+		heap->elems[index] = elem;
+
+		if (HAS_DIRECT_OPTION(heap))
+			zbx_hashmap_set(heap->key_index, elem.key, index);
 	}
 
 	return index;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves element down until the heap property is restored            *
+ *                                                                            *
+ * Return value: the new element index                                        *
+ *                                                                            *
+ * Comments: See __binary_heap_bubble_up() comments.                          *
+ *                                                                            *
+ ******************************************************************************/
 static int	__binary_heap_bubble_down(zbx_binary_heap_t *heap, int index)
 {
+	zbx_binary_heap_elem_t	elem;
+	int			start = index;
+
+	elem = heap->elems[index];
+
 	while (1)
 	{
-		int left = 2 * index + 1;
-		int right = 2 * index + 2;
+		int	child = 2 * index + 1;
 
-		if (left >= heap->elems_num)
+		if (child >= heap->elems_num)
 			break;
 
-		if (right >= heap->elems_num)
+		if (child + 1 < heap->elems_num &&
+				heap->compare_func(&heap->elems[child], &heap->elems[child + 1]) > 0)
 		{
-			if (heap->compare_func(&heap->elems[index], &heap->elems[left]) > 0)
-			{
-				swap(heap, index, left);
-				index = left;
-			}
+			child++;
+		}
 
+		if (heap->compare_func(&elem, &heap->elems[child]) <= 0)
 			break;
-		}
 
-		if (heap->compare_func(&heap->elems[left], &heap->elems[right]) <= 0)
-		{
-			if (heap->compare_func(&heap->elems[index], &heap->elems[left]) > 0)
-			{
-				swap(heap, index, left);
-				index = left;
-			}
-			else
-				break;
-		}
-		else
-		{
-			if (heap->compare_func(&heap->elems[index], &heap->elems[right]) > 0)
-			{
-				swap(heap, index, right);
-				index = right;
-			}
-			else
-				break;
-		}
+		heap->elems[index] = heap->elems[child];
+
+		if (HAS_DIRECT_OPTION(heap))
+			zbx_hashmap_set(heap->key_index, heap->elems[index].key, index);
+
+		index = child;
+	}
+
+	if (index != start)
+	{
+		heap->elems[index] = elem;
+
+		if (HAS_DIRECT_OPTION(heap))
+			zbx_hashmap_set(heap->key_index, elem.key, index);
 	}
 
 	return index;
@@ -193,7 +193,26 @@ void	*zbx_hashset_insert(zbx_hashset_t *hs, const void *data, size_t size)
 	return zbx_hashset_insert_ext(hs, data, size, 0);
 }
 
-void	*zbx_hashset_insert_ext(zbx_hashset_t *hs, const void *data, size_t size, size_t offset)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find hashset entry matching the given data or insert a new one    *
+ *          if it does not exist                                              *
+ *                                                                            *
+ * Parameters: hs     - [IN] the hashset                                      *
+ *             data   - [IN] the data to search/insert                        *
+ *             size   - [IN] the data size                                    *
+ *             offset - [IN] the offset of data to copy when inserting        *
+ *             found  - [OUT] 1 - an existing entry was found                 *
+ *                            0 - a new entry was inserted                    *
+ *                                                                            *
+ * Return value: the found/inserted entry or NULL in the case of failure      *
+ *                                                                            *
+ * Comments: The data is hashed and the slot chain is walked only once, so    *
+ *           search-or-insert callers do not pay for two lookups on a miss.   *
+ *                                                                            *
+ ******************************************************************************/
+static void	*hashset_find_or_insert(zbx_hashset_t *hs, const void *data, size_t size, size_t offset,
+		int *found)
 {
 	int			slot;
 	zbx_hash_t		hash;
@@ -231,11 +250,40 @@ void	*zbx_hashset_insert_ext(zbx_hashset_t *hs, const void *data, size_t size, s
 		entry->next = hs->slots[slot];
 		hs->slots[slot] = entry;
 		hs->num_data++;
+
+		*found = 0;
 	}
+	else
+		*found = 1;
 
 	return entry->data;
 }
 
+void	*zbx_hashset_insert_ext(zbx_hashset_t *hs, const void *data, size_t size, size_t offset)
+{
+	int	found;
+
+	return hashset_find_or_insert(hs, data, size, offset, &found);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: search hashset entry and insert a new one if it is not found      *
+ *                                                                            *
+ * Parameters: hs    - [IN] the hashset                                       *
+ *             data  - [IN] the data to search/insert                         *
+ *             size  - [IN] the data size                                     *
+ *             found - [OUT] 1 - an existing entry was found                  *
+ *                           0 - a new entry was inserted                     *
+ *                                                                            *
+ * Return value: the found/inserted entry or NULL in the case of failure      *
+ *                                                                            *
+ ******************************************************************************/
+void	*zbx_hashset_find_or_insert(zbx_hashset_t *hs, const void *data, size_t size, int *found)
+{
+	return hashset_find_or_insert(hs, data, size, 0, found);
+}
+
 void	*zbx_hashset_search(const zbx_hashset_t *hs, const void *data)
 {
 	int			slot;
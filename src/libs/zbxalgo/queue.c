@@ -164,6 +164,34 @@ void	*zbx_queue_ptr_pop(zbx_queue_ptr_t *queue)
 	return value;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets value from the queue without removing it                     *
+ *                                                                            *
+ * Parameters: queue - [IN]                                                   *
+ *             index - [IN] the value position, 0 being the next value to pop *
+ *                                                                            *
+ * Return value: The queue element or NULL if index is out of range.          *
+ *                                                                            *
+ ******************************************************************************/
+void	*zbx_queue_ptr_peek(const zbx_queue_ptr_t *queue, int index)
+{
+	int	values_num, pos;
+
+	values_num = queue->head_pos - queue->tail_pos;
+
+	if (0 > values_num)
+		values_num += queue->alloc_num;
+
+	if (0 > index || index >= values_num)
+		return NULL;
+
+	if ((pos = queue->tail_pos + index) >= queue->alloc_num)
+		pos -= queue->alloc_num;
+
+	return queue->values[pos];
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: removes specified value from queue                                *
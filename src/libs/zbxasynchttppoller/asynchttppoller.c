@@ -205,6 +205,7 @@ zbx_asynchttppoller_config *zbx_async_httpagent_create(struct event_base *ev,
 		httpagent_action_callback_fn httpagent_action_callback, void *arg)
 {
 	CURLMcode			merr;
+	CURLSHcode			shrerr;
 	CURLcode			err;
 	zbx_asynchttppoller_config	*asynchttppoller_config = zbx_malloc(NULL ,sizeof(zbx_asynchttppoller_config));
 
@@ -254,6 +255,29 @@ zbx_asynchttppoller_config *zbx_async_httpagent_create(struct event_base *ev,
 		exit(EXIT_FAILURE);
 	}
 
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	/* CURLPIPE_MULTIPLEX is supported starting with version 7.43.0 (0x072b00) */
+	if (CURLM_OK != (merr = curl_multi_setopt(asynchttppoller_config->curl_handle, CURLMOPT_PIPELINING,
+			CURLPIPE_MULTIPLEX)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot set CURLMOPT_PIPELINING: %s", curl_multi_strerror(merr));
+	}
+#endif
+	if (NULL == (asynchttppoller_config->curl_share = curl_share_init()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize cURL share object");
+		exit(EXIT_FAILURE);
+	}
+
+	/* connections and DNS cache are already shared by multi handle, but TLS sessions are kept per easy */
+	/* handle unless shared explicitly; no locking is needed as all handles are used by one thread      */
+	if (CURLSHE_OK != (shrerr = curl_share_setopt(asynchttppoller_config->curl_share, CURLSHOPT_SHARE,
+			CURL_LOCK_DATA_SSL_SESSION)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot share TLS sessions between cURL handles: %s",
+				curl_share_strerror(shrerr));
+	}
+
 	if (NULL == (asynchttppoller_config->curl_timeout = evtimer_new(ev, on_timeout, asynchttppoller_config)))
 	{
 		zabbix_log(LOG_LEVEL_ERR, "cannot create timer event");
@@ -265,9 +289,18 @@ zbx_asynchttppoller_config *zbx_async_httpagent_create(struct event_base *ev,
 
 void	zbx_async_httpagent_clean(zbx_asynchttppoller_config *asynchttppoller_config)
 {
+	CURLSHcode	shrerr;
+
+	/* easy handles must be removed and cleaned up by the caller, otherwise the share object stays in use */
 	if (NULL != asynchttppoller_config->curl_handle)
 		curl_multi_cleanup(asynchttppoller_config->curl_handle);
 
+	if (NULL != asynchttppoller_config->curl_share &&
+			CURLSHE_OK != (shrerr = curl_share_cleanup(asynchttppoller_config->curl_share)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot release cURL share object: %s", curl_share_strerror(shrerr));
+	}
+
 	if (NULL != asynchttppoller_config->curl_timeout)
 		event_free(asynchttppoller_config->curl_timeout);
 }
@@ -22,6 +22,7 @@
 
 #ifdef HAVE_LIBEVENT
 #include "zbxip.h"
+#include "zbxalgo.h"
 #include <event2/util.h>
 #include <event2/dns.h>
 typedef struct
@@ -38,6 +39,22 @@ typedef struct
 }
 zbx_async_task_t;
 
+typedef struct
+{
+	char			*host;
+	char			ip[65];
+	int			err;
+	time_t			expires;
+	unsigned char		resolving;
+	zbx_vector_ptr_t	tasks;		/* tasks waiting for resolution in progress */
+}
+zbx_async_dns_entry_t;
+
+#define ZBX_ASYNC_DNS_CACHE_TTL	10
+
+static ZBX_THREAD_LOCAL zbx_hashset_t	dns_cache;
+static ZBX_THREAD_LOCAL time_t		dns_cache_cleanup;
+
 static void	async_task_remove(zbx_async_task_t *task)
 {
 	task->free_cb(task->data);
@@ -114,12 +131,8 @@ static void	async_event(evutil_socket_t fd, short what, void *arg)
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, task_state_to_str(ret));
 }
 
-static void	async_dns_event(int err, struct evutil_addrinfo *ai, void *arg)
+static void	async_task_start(zbx_async_task_t *task, int err, const char *ip)
 {
-	zbx_async_task_t	*task = (zbx_async_task_t *)arg;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() result:%d", __func__, err);
-
 	if (0 != err)
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot resolve DNS name: %s", evutil_gai_strerror(err));
@@ -129,32 +142,180 @@ static void	async_dns_event(int err, struct evutil_addrinfo *ai, void *arg)
 	}
 	else
 	{
-		struct timeval	tv = {task->timeout, 0};
+		struct timeval		tv = {task->timeout, 0};
+		const struct timeval	*ptv;
 
-		switch (ai->ai_addr->sa_family)
-		{
-			case AF_INET:
-				inet_ntop(AF_INET, &(((struct sockaddr_in *)ai->ai_addr)->sin_addr), task->ip,
-						(socklen_t)sizeof(task->ip));
-				break;
-			case AF_INET6:
-				inet_ntop(AF_INET6, &(((struct sockaddr_in *)ai->ai_addr)->sin_addr), task->ip,
-						(socklen_t)sizeof(task->ip));
-				break;
-			default:
-				task->ip[0] = '\0';
-				break;
-		}
+		zbx_strlcpy(task->ip, ip, sizeof(task->ip));
 
-		evutil_freeaddrinfo(ai);
+		/* tasks use only a few distinct timeouts, keep them in libevent common timeout queues */
+		/* to add and expire timers in constant time instead of sifting through timer heap     */
+		if (NULL == (ptv = event_base_init_common_timeout(event_get_base(task->timeout_event), &tv)))
+			ptv = &tv;
 
-		evtimer_add(task->timeout_event, &tv);
+		evtimer_add(task->timeout_event, ptv);
 		async_event(-1, 0, task);
 	}
+}
+
+static void	async_addrinfo_to_ip(const struct evutil_addrinfo *ai, char *ip, size_t ip_len)
+{
+	switch (ai->ai_addr->sa_family)
+	{
+		case AF_INET:
+			inet_ntop(AF_INET, &(((struct sockaddr_in *)ai->ai_addr)->sin_addr), ip, (socklen_t)ip_len);
+			break;
+		case AF_INET6:
+			inet_ntop(AF_INET6, &(((struct sockaddr_in6 *)ai->ai_addr)->sin6_addr), ip, (socklen_t)ip_len);
+			break;
+		default:
+			ip[0] = '\0';
+			break;
+	}
+}
+
+static void	async_dns_event(int err, struct evutil_addrinfo *ai, void *arg)
+{
+	zbx_async_task_t	*task = (zbx_async_task_t *)arg;
+	char			ip[65] = "";
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() result:%d", __func__, err);
+
+	if (0 == err)
+	{
+		async_addrinfo_to_ip(ai, ip, sizeof(ip));
+		evutil_freeaddrinfo(ai);
+	}
+
+	async_task_start(task, err, ip);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+static zbx_hash_t	async_dns_entry_hash(const void *data)
+{
+	const zbx_async_dns_entry_t	*entry = (const zbx_async_dns_entry_t *)data;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(entry->host);
+}
+
+static int	async_dns_entry_compare(const void *d1, const void *d2)
+{
+	const zbx_async_dns_entry_t	*entry1 = (const zbx_async_dns_entry_t *)d1;
+	const zbx_async_dns_entry_t	*entry2 = (const zbx_async_dns_entry_t *)d2;
+
+	return strcmp(entry1->host, entry2->host);
+}
+
+static void	async_dns_entry_clean(void *data)
+{
+	zbx_async_dns_entry_t	*entry = (zbx_async_dns_entry_t *)data;
+
+	zbx_free(entry->host);
+	zbx_vector_ptr_destroy(&entry->tasks);
+}
+
+static void	async_dns_cache_event(int err, struct evutil_addrinfo *ai, void *arg)
+{
+	zbx_async_dns_entry_t	*entry = (zbx_async_dns_entry_t *)arg;
+	int			i;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() host:'%s' result:%d tasks:%d", __func__, entry->host, err,
+			entry->tasks.values_num);
+
+	if (0 == (entry->err = err))
+	{
+		async_addrinfo_to_ip(ai, entry->ip, sizeof(entry->ip));
+		evutil_freeaddrinfo(ai);
+	}
+
+	entry->expires = time(NULL) + ZBX_ASYNC_DNS_CACHE_TTL;
+	entry->resolving = 0;
+
+	for (i = 0; i < entry->tasks.values_num; i++)
+		async_task_start((zbx_async_task_t *)entry->tasks.values[i], entry->err, entry->ip);
+
+	zbx_vector_ptr_clear(&entry->tasks);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resolve host name for task, sharing recent or in progress         *
+ *          resolution of the same name with other tasks                      *
+ *                                                                            *
+ * Parameters: dnsbase - [IN] asynchronous DNS base                           *
+ *             host    - [IN] host name to resolve                            *
+ *             task    - [IN] task to start when the name is resolved         *
+ *                                                                            *
+ * Comments: Answers, including failures, are reused for a short time only,   *
+ *           as TTL of DNS records is not available from evdns_getaddrinfo(). *
+ *                                                                            *
+ ******************************************************************************/
+static void	async_dns_cache_resolve(struct evdns_base *dnsbase, const char *host, zbx_async_task_t *task)
+{
+	zbx_async_dns_entry_t	*entry, entry_local;
+	struct evutil_addrinfo	hints;
+	time_t			now;
+
+	now = time(NULL);
+
+	if (NULL == dns_cache.slots)
+	{
+		zbx_hashset_create_ext(&dns_cache, 100, async_dns_entry_hash, async_dns_entry_compare,
+				async_dns_entry_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+				ZBX_DEFAULT_MEM_FREE_FUNC);
+		dns_cache_cleanup = now + ZBX_ASYNC_DNS_CACHE_TTL;
+	}
+	else if (dns_cache_cleanup <= now)
+	{
+		zbx_hashset_iter_t	iter;
+
+		zbx_hashset_iter_reset(&dns_cache, &iter);
+		while (NULL != (entry = (zbx_async_dns_entry_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (0 == entry->resolving && entry->expires <= now)
+				zbx_hashset_iter_remove(&iter);
+		}
+
+		dns_cache_cleanup = now + ZBX_ASYNC_DNS_CACHE_TTL;
+	}
+
+	entry_local.host = (char *)host;
+
+	if (NULL == (entry = (zbx_async_dns_entry_t *)zbx_hashset_search(&dns_cache, &entry_local)))
+	{
+		entry_local.host = zbx_strdup(NULL, host);
+		entry_local.expires = 0;
+		entry_local.resolving = 0;
+		zbx_vector_ptr_create(&entry_local.tasks);
+
+		entry = (zbx_async_dns_entry_t *)zbx_hashset_insert(&dns_cache, &entry_local, sizeof(entry_local));
+	}
+
+	if (0 != entry->resolving)
+	{
+		zbx_vector_ptr_append(&entry->tasks, task);
+		return;
+	}
+
+	if (now < entry->expires)
+	{
+		async_task_start(task, entry->err, entry->ip);
+		return;
+	}
+
+	entry->resolving = 1;
+	zbx_vector_ptr_append(&entry->tasks, task);
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = PF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	/* callback can be called before evdns_getaddrinfo() returns, entry must be ready at this point */
+	evdns_getaddrinfo(dnsbase, host, NULL, &hints, async_dns_cache_event, entry);
+}
+
 void	zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase, const char *addr,
 		void *data, int timeout, zbx_async_task_process_cb_t process_cb, zbx_async_task_clear_cb_t clear_cb)
 {
@@ -181,11 +342,31 @@ void	zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase
 		hints.ai_flags = AI_NUMERICHOST;
 #endif
 	else
-		hints.ai_flags = 0;
+	{
+		async_dns_cache_resolve(dnsbase, addr, task);
+		return;
+	}
 
 	hints.ai_family = PF_UNSPEC;
 	hints.ai_socktype = SOCK_STREAM;
 
 	evdns_getaddrinfo(dnsbase, addr, NULL, &hints, async_dns_event, task);
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: release host name resolution cache                                *
+ *                                                                            *
+ * Comments: must be called after DNS base is freed, so that all pending      *
+ *           resolutions have already been completed or cancelled             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_poller_dns_cache_destroy(void)
+{
+	if (NULL == dns_cache.slots)
+		return;
+
+	zbx_hashset_destroy(&dns_cache);
+	memset(&dns_cache, 0, sizeof(dns_cache));
+}
 #endif
@@ -314,30 +314,48 @@ static int	zbx_audit_validate_entry(const zbx_audit_entry_t *entry)
 	}
 }
 
+static void	audit_insert_prepare(zbx_db_insert_t *db_insert_audit)
+{
+	zbx_db_insert_prepare(db_insert_audit, "auditlog", "auditid", "userid", "username", "clock", "action", "ip",
+			"resourceid", "resourcename", "resourcetype", "recordsetid", "details", NULL);
+}
+
 void	zbx_audit_flush(void)
 {
+/* LLD and template linking can produce huge number of audit records, insert them in batches */
+/* so the copies of record details kept by database insert stay limited                     */
+#define AUDIT_FLUSH_BATCH_SIZE	1000
 	char			recsetid_cuid[CUID_LEN];
 	zbx_hashset_iter_t	iter;
 	zbx_audit_entry_t	**audit_entry;
 	zbx_db_insert_t		db_insert_audit;
+	int			now, rows_num = 0;
 
 	RETURN_IF_AUDIT_OFF();
 
 	zbx_new_cuid(recsetid_cuid);
 	zbx_hashset_iter_reset(&zbx_audit, &iter);
+	now = (int)time(NULL);
 
-	zbx_db_insert_prepare(&db_insert_audit, "auditlog", "auditid", "userid", "username", "clock", "action", "ip",
-			"resourceid", "resourcename", "resourcetype", "recordsetid", "details", NULL);
+	audit_insert_prepare(&db_insert_audit);
 
 	while (NULL != (audit_entry = (zbx_audit_entry_t **)zbx_hashset_iter_next(&iter)))
 	{
-		if (SUCCEED == zbx_audit_validate_entry(*audit_entry))
+		if (SUCCEED != zbx_audit_validate_entry(*audit_entry))
+			continue;
+
+		zbx_db_insert_add_values(&db_insert_audit, (*audit_entry)->audit_cuid, AUDIT_USERID,
+				AUDIT_USERNAME, now, (*audit_entry)->audit_action, AUDIT_IP,
+				(*audit_entry)->id, (*audit_entry)->name, (*audit_entry)->resource_type,
+				recsetid_cuid, 0 == strcmp((*audit_entry)->details_json.buffer, "{}") ? "" :
+				(*audit_entry)->details_json.buffer);
+
+		if (AUDIT_FLUSH_BATCH_SIZE == ++rows_num)
 		{
-			zbx_db_insert_add_values(&db_insert_audit, (*audit_entry)->audit_cuid, AUDIT_USERID,
-					AUDIT_USERNAME, (int)time(NULL), (*audit_entry)->audit_action, AUDIT_IP,
-					(*audit_entry)->id, (*audit_entry)->name, (*audit_entry)->resource_type,
-					recsetid_cuid, 0 == strcmp((*audit_entry)->details_json.buffer, "{}") ? "" :
-					(*audit_entry)->details_json.buffer);
+			zbx_db_insert_execute(&db_insert_audit);
+			zbx_db_insert_clean(&db_insert_audit);
+			audit_insert_prepare(&db_insert_audit);
+			rows_num = 0;
 		}
 	}
 
@@ -345,6 +363,7 @@ void	zbx_audit_flush(void)
 	zbx_db_insert_clean(&db_insert_audit);
 
 	zbx_audit_clean();
+#undef AUDIT_FLUSH_BATCH_SIZE
 }
 
 int	zbx_audit_flush_once(void)
@@ -41,6 +41,14 @@ static void	autoreg_get_hosts(zbx_vector_ptr_t *autoreg_hosts, zbx_vector_str_t
 	}
 }
 
+static int	compare_autoreg_host_by_host(const void *d1, const void *d2)
+{
+	const zbx_autoreg_host_t	*p1 = *(const zbx_autoreg_host_t * const *)d1;
+	const zbx_autoreg_host_t	*p2 = *(const zbx_autoreg_host_t * const *)d2;
+
+	return strcmp(p1->host, p2->host);
+}
+
 static void	autoreg_process_hosts(zbx_vector_ptr_t *autoreg_hosts, zbx_uint64_t proxyid)
 {
 	zbx_db_result_t		result;
@@ -49,12 +57,15 @@ static void	autoreg_process_hosts(zbx_vector_ptr_t *autoreg_hosts, zbx_uint64_t
 	zbx_uint64_t		current_proxyid;
 	char			*sql = NULL;
 	size_t			sql_alloc = 256, sql_offset;
-	zbx_autoreg_host_t	*autoreg_host;
+	zbx_autoreg_host_t	*autoreg_host, autoreg_host_local;
 	int			i;
 
 	sql = (char *)zbx_malloc(sql, sql_alloc);
 	zbx_vector_str_create(&hosts);
 
+	/* hosts are unique in the batch, sort them by name to match database rows in logarithmic time */
+	zbx_vector_ptr_sort(autoreg_hosts, compare_autoreg_host_by_host);
+
 	if (0 != proxyid)
 	{
 		autoreg_get_hosts(autoreg_hosts, &hosts);
@@ -75,45 +86,44 @@ static void	autoreg_process_hosts(zbx_vector_ptr_t *autoreg_hosts, zbx_uint64_t
 
 		while (NULL != (row = zbx_db_fetch(result)))
 		{
-			for (i = 0; i < autoreg_hosts->values_num; i++)
-			{
-				autoreg_host = (zbx_autoreg_host_t *)autoreg_hosts->values[i];
-
-				if (0 != strcmp(autoreg_host->host, row[0]))
-					continue;
+			autoreg_host_local.host = row[0];
 
-				ZBX_STR2UINT64(autoreg_host->hostid, row[1]);
-				ZBX_DBROW2UINT64(current_proxyid, row[2]);
+			if (FAIL == (i = zbx_vector_ptr_bsearch(autoreg_hosts, &autoreg_host_local,
+					compare_autoreg_host_by_host)))
+			{
+				continue;
+			}
 
-				if (current_proxyid != proxyid || SUCCEED == zbx_db_is_null(row[8]) ||
-						0 != strcmp(autoreg_host->host_metadata, row[3]) ||
-						autoreg_host->flag != atoi(row[7]))
-				{
-					break;
-				}
+			autoreg_host = (zbx_autoreg_host_t *)autoreg_hosts->values[i];
 
-				/* process with autoregistration if the connection type was forced and */
-				/* is different from the last registered connection type               */
-				if (ZBX_CONN_DEFAULT != autoreg_host->flag)
-				{
-					unsigned short	port;
+			ZBX_STR2UINT64(autoreg_host->hostid, row[1]);
+			ZBX_DBROW2UINT64(current_proxyid, row[2]);
 
-					if (FAIL == zbx_is_ushort(row[6], &port) || port != autoreg_host->port)
-						break;
+			if (current_proxyid != proxyid || SUCCEED == zbx_db_is_null(row[8]) ||
+					0 != strcmp(autoreg_host->host_metadata, row[3]) ||
+					autoreg_host->flag != atoi(row[7]))
+			{
+				continue;
+			}
 
-					if (ZBX_CONN_IP == autoreg_host->flag && 0 != strcmp(row[4], autoreg_host->ip))
-						break;
+			/* process with autoregistration if the connection type was forced and */
+			/* is different from the last registered connection type               */
+			if (ZBX_CONN_DEFAULT != autoreg_host->flag)
+			{
+				unsigned short	port;
 
-					if (ZBX_CONN_DNS == autoreg_host->flag && 0 != strcmp(row[5], autoreg_host->dns))
-						break;
-				}
+				if (FAIL == zbx_is_ushort(row[6], &port) || port != autoreg_host->port)
+					continue;
 
-				zbx_vector_ptr_remove(autoreg_hosts, i);
-				zbx_autoreg_host_free(autoreg_host);
+				if (ZBX_CONN_IP == autoreg_host->flag && 0 != strcmp(row[4], autoreg_host->ip))
+					continue;
 
-				break;
+				if (ZBX_CONN_DNS == autoreg_host->flag && 0 != strcmp(row[5], autoreg_host->dns))
+					continue;
 			}
 
+			zbx_vector_ptr_remove(autoreg_hosts, i);
+			zbx_autoreg_host_free(autoreg_host);
 		}
 		zbx_db_free_result(result);
 
@@ -137,16 +147,18 @@ static void	autoreg_process_hosts(zbx_vector_ptr_t *autoreg_hosts, zbx_uint64_t
 
 		while (NULL != (row = zbx_db_fetch(result)))
 		{
-			for (i = 0; i < autoreg_hosts->values_num; i++)
-			{
-				autoreg_host = (zbx_autoreg_host_t *)autoreg_hosts->values[i];
+			autoreg_host_local.host = row[1];
 
-				if (0 == autoreg_host->autoreg_hostid && 0 == strcmp(autoreg_host->host, row[1]))
-				{
-					ZBX_STR2UINT64(autoreg_host->autoreg_hostid, row[0]);
-					break;
-				}
+			if (FAIL == (i = zbx_vector_ptr_bsearch(autoreg_hosts, &autoreg_host_local,
+					compare_autoreg_host_by_host)))
+			{
+				continue;
 			}
+
+			autoreg_host = (zbx_autoreg_host_t *)autoreg_hosts->values[i];
+
+			if (0 == autoreg_host->autoreg_hostid)
+				ZBX_STR2UINT64(autoreg_host->autoreg_hostid, row[0]);
 		}
 		zbx_db_free_result(result);
 
@@ -52,6 +52,47 @@ static int	interface_availability_compare(const void *d1, const void *d2)
 	return ia1->id - ia2->id;
 }
 
+/* merges chronologically sorted updates of the same interface into the first one, so that */
+/* an interface flapping within flush window results in a single update statement          */
+static void	interface_availabilities_coalesce(zbx_vector_availability_ptr_t *interface_availabilities)
+{
+	int	i, j;
+
+	for (i = 0, j = 1; j < interface_availabilities->values_num; j++)
+	{
+		zbx_interface_availability_t	*ia = interface_availabilities->values[i],
+						*next = interface_availabilities->values[j];
+
+		if (ia->interfaceid != next->interfaceid)
+		{
+			interface_availabilities->values[++i] = next;
+			continue;
+		}
+
+		if (0 != (next->agent.flags & ZBX_FLAGS_AGENT_STATUS_AVAILABLE))
+			ia->agent.available = next->agent.available;
+
+		if (0 != (next->agent.flags & ZBX_FLAGS_AGENT_STATUS_ERROR))
+		{
+			zbx_free(ia->agent.error);
+			ia->agent.error = next->agent.error;
+			next->agent.error = NULL;
+		}
+
+		if (0 != (next->agent.flags & ZBX_FLAGS_AGENT_STATUS_ERRORS_FROM))
+			ia->agent.errors_from = next->agent.errors_from;
+
+		if (0 != (next->agent.flags & ZBX_FLAGS_AGENT_STATUS_DISABLE_UNTIL))
+			ia->agent.disable_until = next->agent.disable_until;
+
+		ia->agent.flags |= next->agent.flags;
+		zbx_interface_availability_free(next);
+	}
+
+	if (0 != interface_availabilities->values_num)
+		interface_availabilities->values_num = i + 1;
+}
+
 static void	process_new_active_check_heartbeat(zbx_avail_active_hb_cache_t *cache,
 		zbx_host_active_avail_t *avail_new)
 {
@@ -537,11 +578,12 @@ ZBX_THREAD_ENTRY(zbx_availability_manager_thread, args)
 				zbx_block_signals(&orig_mask);
 				zbx_vector_availability_ptr_sort(&interface_availabilities,
 						interface_availability_compare);
+				processed_num = interface_availabilities.values_num;
+				interface_availabilities_coalesce(&interface_availabilities);
 
 				zbx_db_update_interface_availabilities(&interface_availabilities);
 				zbx_unblock_signals(&orig_mask);
 
-				processed_num = interface_availabilities.values_num;
 				zbx_vector_availability_ptr_clear_ext(&interface_availabilities,
 						zbx_interface_availability_free);
 			}
@@ -573,6 +615,7 @@ ZBX_THREAD_ENTRY(zbx_availability_manager_thread, args)
 	if (0 != interface_availabilities.values_num)
 	{
 		zbx_vector_availability_ptr_sort(&interface_availabilities, interface_availability_compare);
+		interface_availabilities_coalesce(&interface_availabilities);
 		zbx_db_update_interface_availabilities(&interface_availabilities);
 	}
 	zbx_db_close();
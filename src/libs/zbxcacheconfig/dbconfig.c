@@ -52,6 +52,17 @@ int	sync_in_progress = 0;
 #define START_SYNC	do { WRLOCK_CACHE_CONFIG_HISTORY; WRLOCK_CACHE; sync_in_progress = 1; } while(0)
 #define FINISH_SYNC	do { sync_in_progress = 0; UNLOCK_CACHE; UNLOCK_CACHE_CONFIG_HISTORY; } while(0)
 
+/* lock only configuration cache when syncing domains not accessed by history syncers */
+#define START_SYNC_CONFIG	do { WRLOCK_CACHE; sync_in_progress = 1; } while(0)
+#define FINISH_SYNC_CONFIG	do { sync_in_progress = 0; UNLOCK_CACHE; } while(0)
+
+/* When atomic builtins are available history syncers lock triggers with compare-and-swap under the */
+/* configuration cache read lock instead of taking the write lock, so that syncers processing      */
+/* different items do not serialize with each other and with configuration cache readers.         */
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+#	define DC_TRIGGER_ATOMIC_LOCK
+#endif
+
 #define ZBX_SNMP_OID_TYPE_NORMAL	0
 #define ZBX_SNMP_OID_TYPE_DYNAMIC	1
 #define ZBX_SNMP_OID_TYPE_MACRO		2
@@ -145,11 +156,28 @@ struct zbx_dc_um_handle_t
 {
 	zbx_dc_um_handle_t	*prev;
 	zbx_um_cache_t		**cache;
+	zbx_hashset_t		*values;
 	unsigned char		macro_env;
 };
 
 static zbx_dc_um_handle_t	*dc_um_handle = NULL;
 
+/* process local cache of resolved single host user macros */
+typedef struct
+{
+	zbx_uint64_t	hostid;
+	char		*macro;
+	size_t		macro_len;
+	char		*value;
+	unsigned char	env;
+}
+zbx_dc_um_value_t;
+
+#define ZBX_DC_UM_VALUES_MAX	10000
+
+static zbx_hashset_t	dc_um_values;
+static zbx_uint64_t	dc_um_values_revision;
+
 /******************************************************************************
  *                                                                            *
  * Parameters: type - [IN] item type [ITEM_TYPE_* flag]                       *
@@ -595,22 +623,11 @@ static void	DCincrease_disable_until(ZBX_DC_INTERFACE *interface, int now, int c
  ******************************************************************************/
 void	*DCfind_id(zbx_hashset_t *hashset, zbx_uint64_t id, size_t size, int *found)
 {
-	void		*ptr;
 	zbx_uint64_t	buffer[1024];	/* adjust buffer size to accommodate any type DCfind_id() can be called for */
 
-	if (NULL == (ptr = zbx_hashset_search(hashset, &id)))
-	{
-		*found = 0;
-
-		buffer[0] = id;
-		ptr = zbx_hashset_insert(hashset, &buffer[0], size);
-	}
-	else
-	{
-		*found = 1;
-	}
+	buffer[0] = id;
 
-	return ptr;
+	return zbx_hashset_find_or_insert(hashset, &buffer[0], size, found);
 }
 
 ZBX_DC_ITEM	*DCfind_item(zbx_uint64_t hostid, const char *key)
@@ -687,18 +704,19 @@ const char	*dc_strpool_intern(const char *str)
 {
 	void		*record;
 	zbx_uint32_t	*refcount;
+	int		num_data;
 
 	if (NULL == str)
 		return NULL;
 
-	record = zbx_hashset_search(&config->strpool, str - REFCOUNT_FIELD_SIZE);
+	/* insert_ext() returns existing record if the string is already interned, */
+	/* so a single lookup is done both for new and existing strings            */
+	num_data = config->strpool.num_data;
+	record = zbx_hashset_insert_ext(&config->strpool, str - REFCOUNT_FIELD_SIZE,
+			REFCOUNT_FIELD_SIZE + strlen(str) + 1, REFCOUNT_FIELD_SIZE);
 
-	if (NULL == record)
-	{
-		record = zbx_hashset_insert_ext(&config->strpool, str - REFCOUNT_FIELD_SIZE,
-				REFCOUNT_FIELD_SIZE + strlen(str) + 1, REFCOUNT_FIELD_SIZE);
+	if (num_data != config->strpool.num_data)
 		*(zbx_uint32_t *)record = 0;
-	}
 
 	refcount = (zbx_uint32_t *)record;
 	(*refcount)++;
@@ -711,8 +729,10 @@ void	dc_strpool_release(const char *str)
 	zbx_uint32_t	*refcount;
 
 	refcount = (zbx_uint32_t *)(str - REFCOUNT_FIELD_SIZE);
+
+	/* the record is located by its address, avoiding string hashing and comparison */
 	if (0 == --(*refcount))
-		zbx_hashset_remove(&config->strpool, str - REFCOUNT_FIELD_SIZE);
+		zbx_hashset_remove_direct(&config->strpool, (void *)(str - REFCOUNT_FIELD_SIZE));
 }
 
 const char	*dc_strpool_acquire(const char *str)
@@ -1840,6 +1860,21 @@ static void	DCsync_host_inventory(zbx_dbsync_t *sync, zbx_uint64_t revision)
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: synchronizes secrets with vault or proxy configuration            *
+ *                                                                            *
+ * Parameters: jp_kvs_paths     - [IN] secrets received from server, NULL to  *
+ *                                     get secrets from vault                 *
+ *             config_vault     - [IN]                                        *
+ *             config_source_ip - [IN]                                        *
+ *                                                                            *
+ * Comments: Secrets of all paths are retrieved first and then the changes    *
+ *           are applied to configuration cache at once, so the cache is      *
+ *           write locked and its revision updated only once per sync and     *
+ *           never during vault requests.                                     *
+ *                                                                            *
+ ******************************************************************************/
 void	zbx_dc_sync_kvs_paths(const struct zbx_json_parse *jp_kvs_paths, const zbx_config_vault_t *config_vault,
 		const char *config_source_ip)
 {
@@ -1847,7 +1882,7 @@ void	zbx_dc_sync_kvs_paths(const struct zbx_json_parse *jp_kvs_paths, const zbx_
 	zbx_dc_kv_t		*dc_kv;
 	zbx_kvs_t		kvs;
 	zbx_hashset_iter_t	iter;
-	int			i, j;
+	int			i;
 	zbx_vector_ptr_pair_t	diff;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -1895,45 +1930,48 @@ void	zbx_dc_sync_kvs_paths(const struct zbx_json_parse *jp_kvs_paths, const zbx_
 			else if (NULL == dc_kv->value)
 				continue;
 
+			/* secret value is copied as path secrets are cleared before getting the next path */
 			pair.first = dc_kv;
-			pair.second = kv;
+			pair.second = (NULL != kv ? zbx_strdup(NULL, kv->value) : NULL);
 			zbx_vector_ptr_pair_append(&diff, pair);
 		}
 
-		if (0 != diff.values_num)
-		{
-			START_SYNC;
-
-			config->revision.config++;
+		zbx_kvs_clear(&kvs);
+	}
 
-			for (j = 0; j < diff.values_num; j++)
-			{
-				zbx_kv_t	*kv;
+	if (0 != diff.values_num)
+	{
+		START_SYNC;
 
-				dc_kv = (zbx_dc_kv_t *)diff.values[j].first;
-				kv = (zbx_kv_t *)diff.values[j].second;
+		config->revision.config++;
 
-				if (NULL != kv)
-				{
-					dc_strpool_replace(dc_kv->value != NULL ? 1 : 0, &dc_kv->value, kv->value);
-				}
-				else
-				{
-					dc_strpool_release(dc_kv->value);
-					dc_kv->value = NULL;
-				}
+		for (i = 0; i < diff.values_num; i++)
+		{
+			char	*value;
 
-				config->um_cache = um_cache_set_value_to_macros(config->um_cache,
-						config->revision.config, &dc_kv->macros, dc_kv->value);
+			dc_kv = (zbx_dc_kv_t *)diff.values[i].first;
+			value = (char *)diff.values[i].second;
 
-				dc_kv->update = 0;
+			if (NULL != value)
+			{
+				dc_strpool_replace(dc_kv->value != NULL ? 1 : 0, &dc_kv->value, value);
+			}
+			else
+			{
+				dc_strpool_release(dc_kv->value);
+				dc_kv->value = NULL;
 			}
 
-			FINISH_SYNC;
+			config->um_cache = um_cache_set_value_to_macros(config->um_cache,
+					config->revision.config, &dc_kv->macros, dc_kv->value);
+
+			dc_kv->update = 0;
 		}
 
-		zbx_vector_ptr_pair_clear(&diff);
-		zbx_kvs_clear(&kvs);
+		FINISH_SYNC;
+
+		for (i = 0; i < diff.values_num; i++)
+			zbx_free(diff.values[i].second);
 	}
 
 	zbx_vector_ptr_pair_destroy(&diff);
@@ -6932,7 +6970,7 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 	zbx_dbsync_init(&hgroups_sync, mode);
 	zbx_dbsync_init(&hgroup_host_sync, mode);
 	zbx_dbsync_init(&itempp_sync, changelog_sync_mode);
-	zbx_dbsync_init(&itemscrp_sync, mode);
+	zbx_dbsync_init(&itemscrp_sync, changelog_sync_mode);
 
 	zbx_dbsync_init(&maintenance_sync, mode);
 	zbx_dbsync_init(&maintenance_period_sync, mode);
@@ -7095,6 +7133,10 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 		goto out;
 	connector_sec = zbx_time() - sec;
 
+	/* Each configuration domain below is applied in a separate locking window and the cache is */
+	/* not locked at all for domains without changes, so that readers of other domains are not  */
+	/* blocked for the whole synchronization. Domains are applied in dependency order.          */
+
 	zbx_hashset_create(&psk_owners, 0, ZBX_DEFAULT_PTR_HASH_FUNC, ZBX_DEFAULT_PTR_COMPARE_FUNC);
 
 	START_SYNC;
@@ -7113,41 +7155,76 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 	DCsync_host_inventory(&hi_sync, new_revision);
 	hisec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	DCsync_hostgroups(&hgroups_sync);
-	DCsync_hostgroup_hosts(&hgroup_host_sync);
-	hgroups_sec2 = zbx_time() - sec;
+	FINISH_SYNC;
 
-	sec = zbx_time();
-	DCsync_maintenances(&maintenance_sync);
-	DCsync_maintenance_tags(&maintenance_tag_sync);
-	DCsync_maintenance_groups(&maintenance_group_sync);
-	DCsync_maintenance_hosts(&maintenance_host_sync);
-	DCsync_maintenance_periods(&maintenance_period_sync);
-	maintenance_sec2 = zbx_time() - sec;
+	zbx_hashset_destroy(&psk_owners);
 
-	if (0 != hgroups_sync.add_num + hgroups_sync.update_num + hgroups_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_HOST_GROUPS;
+	/* host groups and maintenances */
+	hgroups_sec2 = maintenance_sec2 = 0;
 
-	if (0 != maintenance_group_sync.add_num + maintenance_group_sync.update_num + maintenance_group_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_MAINTENANCE_GROUPS;
+	if (FAIL == zbx_dbsync_is_empty(&hgroups_sync) || FAIL == zbx_dbsync_is_empty(&hgroup_host_sync) ||
+			FAIL == zbx_dbsync_is_empty(&maintenance_sync) ||
+			FAIL == zbx_dbsync_is_empty(&maintenance_tag_sync) ||
+			FAIL == zbx_dbsync_is_empty(&maintenance_group_sync) ||
+			FAIL == zbx_dbsync_is_empty(&maintenance_host_sync) ||
+			FAIL == zbx_dbsync_is_empty(&maintenance_period_sync))
+	{
+		START_SYNC;
 
-	if (0 != (update_flags & ZBX_DBSYNC_UPDATE_HOST_GROUPS))
-		dc_hostgroups_update_cache();
+		sec = zbx_time();
+		DCsync_hostgroups(&hgroups_sync);
+		DCsync_hostgroup_hosts(&hgroup_host_sync);
+		hgroups_sec2 = zbx_time() - sec;
 
-	/* pre-cache nested groups used in maintenances to allow read lock */
-	/* during host maintenance update calculations                     */
-	if (0 != (update_flags & (ZBX_DBSYNC_UPDATE_HOST_GROUPS | ZBX_DBSYNC_UPDATE_MAINTENANCE_GROUPS)))
-		dc_maintenance_precache_nested_groups();
+		sec = zbx_time();
+		DCsync_maintenances(&maintenance_sync);
+		DCsync_maintenance_tags(&maintenance_tag_sync);
+		DCsync_maintenance_groups(&maintenance_group_sync);
+		DCsync_maintenance_hosts(&maintenance_host_sync);
+		DCsync_maintenance_periods(&maintenance_period_sync);
+		maintenance_sec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	DCsync_connectors(&connector_sync, new_revision);
-	DCsync_connector_tags(&connector_tag_sync);
-	connector_sec2 = zbx_time() - sec;
+		if (0 != hgroups_sync.add_num + hgroups_sync.update_num + hgroups_sync.remove_num)
+			update_flags |= ZBX_DBSYNC_UPDATE_HOST_GROUPS;
 
-	FINISH_SYNC;
+		if (0 != maintenance_group_sync.add_num + maintenance_group_sync.update_num +
+				maintenance_group_sync.remove_num)
+		{
+			update_flags |= ZBX_DBSYNC_UPDATE_MAINTENANCE_GROUPS;
+		}
 
-	zbx_hashset_destroy(&psk_owners);
+		if (0 != (update_flags & ZBX_DBSYNC_UPDATE_HOST_GROUPS))
+			dc_hostgroups_update_cache();
+
+		/* pre-cache nested groups used in maintenances to allow read lock */
+		/* during host maintenance update calculations                     */
+		if (0 != (update_flags & (ZBX_DBSYNC_UPDATE_HOST_GROUPS | ZBX_DBSYNC_UPDATE_MAINTENANCE_GROUPS)))
+			dc_maintenance_precache_nested_groups();
+
+		FINISH_SYNC;
+	}
+
+	/* connectors */
+	connector_sec2 = 0;
+
+	if (FAIL == zbx_dbsync_is_empty(&connector_sync) || FAIL == zbx_dbsync_is_empty(&connector_tag_sync))
+	{
+		START_SYNC;
+
+		sec = zbx_time();
+		DCsync_connectors(&connector_sync, new_revision);
+		DCsync_connector_tags(&connector_tag_sync);
+		connector_sec2 = zbx_time() - sec;
+
+		if (0 != connector_sync.add_num + connector_sync.update_num + connector_sync.remove_num +
+				connector_tag_sync.add_num + connector_tag_sync.update_num +
+				connector_tag_sync.remove_num)
+		{
+			connectors_num = config->connectors.num_data;
+		}
+
+		FINISH_SYNC;
+	}
 
 	zbx_dbsync_process_active_avail_diff(&active_avail_diff);
 	zbx_vector_uint64_destroy(&active_avail_diff);
@@ -7189,44 +7266,54 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 		goto out;
 	itemscrp_sec = zbx_time() - sec;
 
-	START_SYNC;
+	/* interfaces and items */
+	ifsec2 = isec2 = tisec2 = pisec2 = idsec2 = itempp_sec2 = itemscrp_sec2 = 0;
 
-	/* resolves macros for interface_snmpaddrs, must be after DCsync_hmacros() */
-	sec = zbx_time();
-	DCsync_interfaces(&if_sync, new_revision);
-	ifsec2 = zbx_time() - sec;
+	if (FAIL == zbx_dbsync_is_empty(&if_sync) || FAIL == zbx_dbsync_is_empty(&items_sync) ||
+			FAIL == zbx_dbsync_is_empty(&template_items_sync) ||
+			FAIL == zbx_dbsync_is_empty(&prototype_items_sync) ||
+			FAIL == zbx_dbsync_is_empty(&item_discovery_sync) ||
+			FAIL == zbx_dbsync_is_empty(&itempp_sync) || FAIL == zbx_dbsync_is_empty(&itemscrp_sync))
+	{
+		START_SYNC;
 
-	/* relies on hosts, proxies and interfaces, must be after DCsync_{hosts,interfaces}() */
+		/* resolves macros for interface_snmpaddrs, must be after DCsync_hmacros() */
+		sec = zbx_time();
+		DCsync_interfaces(&if_sync, new_revision);
+		ifsec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	DCsync_items(&items_sync, new_revision, flags, synced, deleted_itemids);
-	isec2 = zbx_time() - sec;
+		/* relies on hosts, proxies and interfaces, must be after DCsync_{hosts,interfaces}() */
 
-	sec = zbx_time();
-	DCsync_template_items(&template_items_sync);
-	tisec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_items(&items_sync, new_revision, flags, synced, deleted_itemids);
+		isec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	DCsync_prototype_items(&prototype_items_sync);
-	pisec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_template_items(&template_items_sync);
+		tisec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	DCsync_item_discovery(&item_discovery_sync);
-	idsec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_prototype_items(&prototype_items_sync);
+		pisec2 = zbx_time() - sec;
 
-	/* relies on items, must be after DCsync_items() */
-	sec = zbx_time();
-	DCsync_item_preproc(&itempp_sync, new_revision);
-	itempp_sec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_item_discovery(&item_discovery_sync);
+		idsec2 = zbx_time() - sec;
 
-	/* relies on items, must be after DCsync_items() */
-	sec = zbx_time();
-	DCsync_itemscript_param(&itemscrp_sync, new_revision);
-	itemscrp_sec2 = zbx_time() - sec;
+		/* relies on items, must be after DCsync_items() */
+		sec = zbx_time();
+		DCsync_item_preproc(&itempp_sync, new_revision);
+		itempp_sec2 = zbx_time() - sec;
 
-	FINISH_SYNC;
+		/* relies on items, must be after DCsync_items() */
+		sec = zbx_time();
+		DCsync_itemscript_param(&itemscrp_sync, new_revision);
+		itemscrp_sec2 = zbx_time() - sec;
 
-	zbx_dc_flush_history();	/* misconfigured items generate pseudo-historic values to become notsupported */
+		FINISH_SYNC;
+
+		zbx_dc_flush_history();	/* misconfigured items generate pseudo-historic values to become notsupported */
+	}
 
 	/* sync function data to support function lookups when resolving macros during configuration sync */
 
@@ -7241,11 +7328,16 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 		goto out;
 	fsec = zbx_time() - sec;
 
-	START_SYNC;
-	sec = zbx_time();
-	DCsync_functions(&func_sync, new_revision);
-	fsec2 = zbx_time() - sec;
-	FINISH_SYNC;
+	fsec2 = 0;
+
+	if (FAIL == zbx_dbsync_is_empty(&func_sync))
+	{
+		START_SYNC;
+		sec = zbx_time();
+		DCsync_functions(&func_sync, new_revision);
+		fsec2 = zbx_time() - sec;
+		FINISH_SYNC;
+	}
 
 	/* sync rest of the data */
 	sec = zbx_time();
@@ -7298,114 +7390,145 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 		goto out;
 	corr_operation_sec = zbx_time() - sec;
 
-	START_SYNC;
+	if (0 != hosts_sync.add_num + hosts_sync.update_num + hosts_sync.remove_num)
+		update_flags |= ZBX_DBSYNC_UPDATE_HOSTS;
 
-	sec = zbx_time();
-	DCsync_triggers(&triggers_sync, new_revision);
-	tsec2 = zbx_time() - sec;
+	if (0 != items_sync.add_num + items_sync.update_num + items_sync.remove_num)
+		update_flags |= ZBX_DBSYNC_UPDATE_ITEMS;
 
-	sec = zbx_time();
-	DCsync_trigdeps(&tdep_sync);
-	dsec2 = zbx_time() - sec;
+	if (0 != func_sync.add_num + func_sync.update_num + func_sync.remove_num)
+		update_flags |= ZBX_DBSYNC_UPDATE_FUNCTIONS;
 
-	sec = zbx_time();
-	DCsync_expressions(&expr_sync, new_revision);
-	expr_sec2 = zbx_time() - sec;
+	if (0 != gmacro_sync.add_num + gmacro_sync.update_num + gmacro_sync.remove_num)
+		update_flags |= ZBX_DBSYNC_UPDATE_MACROS;
 
-	sec = zbx_time();
-	DCsync_actions(&action_sync);
-	action_sec2 = zbx_time() - sec;
+	if (0 != hmacro_sync.add_num + hmacro_sync.update_num + hmacro_sync.remove_num)
+		update_flags |= ZBX_DBSYNC_UPDATE_MACROS;
 
-	sec = zbx_time();
-	DCsync_action_ops(&action_op_sync);
-	action_op_sec2 = zbx_time() - sec;
+	if (0 != htmpl_sync.add_num + htmpl_sync.update_num + htmpl_sync.remove_num)
+		update_flags |= ZBX_DBSYNC_UPDATE_MACROS;
 
-	sec = zbx_time();
-	DCsync_action_conditions(&action_condition_sync);
-	action_condition_sec2 = zbx_time() - sec;
+	/* triggers, also reindexing trigger links if hosts, items, functions or macros were changed */
+	tsec2 = dsec2 = expr_sec2 = trigger_tag_sec2 = item_tag_sec2 = update_sec = 0;
 
-	sec = zbx_time();
-	/* relies on triggers, must be after DCsync_triggers() */
-	DCsync_trigger_tags(&trigger_tag_sync);
-	trigger_tag_sec2 = zbx_time() - sec;
+	if (FAIL == zbx_dbsync_is_empty(&triggers_sync) || FAIL == zbx_dbsync_is_empty(&tdep_sync) ||
+			FAIL == zbx_dbsync_is_empty(&expr_sync) || FAIL == zbx_dbsync_is_empty(&trigger_tag_sync) ||
+			FAIL == zbx_dbsync_is_empty(&item_tag_sync) ||
+			0 != (update_flags & (ZBX_DBSYNC_UPDATE_HOSTS | ZBX_DBSYNC_UPDATE_ITEMS |
+			ZBX_DBSYNC_UPDATE_FUNCTIONS | ZBX_DBSYNC_UPDATE_MACROS)))
+	{
+		START_SYNC;
 
-	sec = zbx_time();
-	DCsync_item_tags(&item_tag_sync);
-	item_tag_sec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_triggers(&triggers_sync, new_revision);
+		tsec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	DCsync_correlations(&correlation_sync);
-	correlation_sec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_trigdeps(&tdep_sync);
+		dsec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	/* relies on correlation rules, must be after DCsync_correlations() */
-	DCsync_corr_conditions(&corr_condition_sync);
-	corr_condition_sec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_expressions(&expr_sync, new_revision);
+		expr_sec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	/* relies on correlation rules, must be after DCsync_correlations() */
-	DCsync_corr_operations(&corr_operation_sync);
-	corr_operation_sec2 = zbx_time() - sec;
+		sec = zbx_time();
+		/* relies on triggers, must be after DCsync_triggers() */
+		DCsync_trigger_tags(&trigger_tag_sync);
+		trigger_tag_sec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	dc_sync_drules(&drules_sync, new_revision);
-	dc_sync_dchecks(&dchecks_sync, new_revision);
-	drules_sec2 = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_item_tags(&item_tag_sync);
+		item_tag_sec2 = zbx_time() - sec;
 
-	sec = zbx_time();
-	dc_sync_httptests(&httptest_sync, new_revision);
-	dc_sync_httptest_fields(&httptest_field_sync, new_revision);
-	dc_sync_httpsteps(&httpstep_sync, new_revision);
-	dc_sync_httpstep_fields(&httpstep_field_sync, new_revision);
-	httptest_sec2 = zbx_time() - sec;
+		sec = zbx_time();
 
-	sec = zbx_time();
+		if (0 != triggers_sync.add_num + triggers_sync.update_num + triggers_sync.remove_num)
+			update_flags |= ZBX_DBSYNC_UPDATE_TRIGGERS;
 
-	if (0 != hosts_sync.add_num + hosts_sync.update_num + hosts_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_HOSTS;
+		if (0 != tdep_sync.add_num + tdep_sync.update_num + tdep_sync.remove_num)
+			update_flags |= ZBX_DBSYNC_UPDATE_TRIGGER_DEPENDENCY;
 
-	if (0 != items_sync.add_num + items_sync.update_num + items_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_ITEMS;
+		/* update trigger topology if trigger dependency was changed */
+		if (0 != (update_flags & ZBX_DBSYNC_UPDATE_TRIGGER_DEPENDENCY))
+			dc_trigger_update_topology();
 
-	if (0 != func_sync.add_num + func_sync.update_num + func_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_FUNCTIONS;
+		/* update various trigger related links in cache */
+		if (0 != (update_flags & (ZBX_DBSYNC_UPDATE_HOSTS | ZBX_DBSYNC_UPDATE_ITEMS |
+				ZBX_DBSYNC_UPDATE_FUNCTIONS | ZBX_DBSYNC_UPDATE_TRIGGERS | ZBX_DBSYNC_UPDATE_MACROS)))
+		{
+			dc_trigger_update_cache();
+			dc_schedule_trigger_timers((ZBX_DBSYNC_INIT == mode ? &trend_queue : NULL), time(NULL));
+		}
 
-	if (0 != triggers_sync.add_num + triggers_sync.update_num + triggers_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_TRIGGERS;
+		update_sec = zbx_time() - sec;
 
-	if (0 != tdep_sync.add_num + tdep_sync.update_num + tdep_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_TRIGGER_DEPENDENCY;
+		FINISH_SYNC;
+	}
 
-	if (0 != gmacro_sync.add_num + gmacro_sync.update_num + gmacro_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_MACROS;
+	/* actions */
+	action_sec2 = action_op_sec2 = action_condition_sec2 = 0;
 
-	if (0 != hmacro_sync.add_num + hmacro_sync.update_num + hmacro_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_MACROS;
+	if (FAIL == zbx_dbsync_is_empty(&action_sync) || FAIL == zbx_dbsync_is_empty(&action_op_sync) ||
+			FAIL == zbx_dbsync_is_empty(&action_condition_sync))
+	{
+		START_SYNC;
 
-	if (0 != htmpl_sync.add_num + htmpl_sync.update_num + htmpl_sync.remove_num)
-		update_flags |= ZBX_DBSYNC_UPDATE_MACROS;
+		sec = zbx_time();
+		DCsync_actions(&action_sync);
+		action_sec2 = zbx_time() - sec;
 
-	if (0 != connector_sync.add_num + connector_sync.update_num + connector_sync.remove_num +
-			connector_tag_sync.add_num + connector_tag_sync.update_num + connector_tag_sync.remove_num)
-	{
-		connectors_num = config->connectors.num_data;
+		sec = zbx_time();
+		DCsync_action_ops(&action_op_sync);
+		action_op_sec2 = zbx_time() - sec;
+
+		sec = zbx_time();
+		DCsync_action_conditions(&action_condition_sync);
+		action_condition_sec2 = zbx_time() - sec;
+
+		FINISH_SYNC;
 	}
 
-	/* update trigger topology if trigger dependency was changed */
-	if (0 != (update_flags & ZBX_DBSYNC_UPDATE_TRIGGER_DEPENDENCY))
-		dc_trigger_update_topology();
+	/* correlations, discovery rules and web scenarios are not used by history syncers */
+	correlation_sec2 = corr_condition_sec2 = corr_operation_sec2 = drules_sec2 = httptest_sec2 = 0;
 
-	/* update various trigger related links in cache */
-	if (0 != (update_flags & (ZBX_DBSYNC_UPDATE_HOSTS | ZBX_DBSYNC_UPDATE_ITEMS | ZBX_DBSYNC_UPDATE_FUNCTIONS |
-			ZBX_DBSYNC_UPDATE_TRIGGERS | ZBX_DBSYNC_UPDATE_MACROS)))
+	if (FAIL == zbx_dbsync_is_empty(&correlation_sync) || FAIL == zbx_dbsync_is_empty(&corr_condition_sync) ||
+			FAIL == zbx_dbsync_is_empty(&corr_operation_sync) ||
+			FAIL == zbx_dbsync_is_empty(&drules_sync) || FAIL == zbx_dbsync_is_empty(&dchecks_sync) ||
+			FAIL == zbx_dbsync_is_empty(&httptest_sync) ||
+			FAIL == zbx_dbsync_is_empty(&httptest_field_sync) ||
+			FAIL == zbx_dbsync_is_empty(&httpstep_sync) ||
+			FAIL == zbx_dbsync_is_empty(&httpstep_field_sync))
 	{
-		dc_trigger_update_cache();
-		dc_schedule_trigger_timers((ZBX_DBSYNC_INIT == mode ? &trend_queue : NULL), time(NULL));
-	}
+		START_SYNC_CONFIG;
 
-	update_sec = zbx_time() - sec;
+		sec = zbx_time();
+		DCsync_correlations(&correlation_sync);
+		correlation_sec2 = zbx_time() - sec;
 
-	config->revision.config = new_revision;
+		sec = zbx_time();
+		/* relies on correlation rules, must be after DCsync_correlations() */
+		DCsync_corr_conditions(&corr_condition_sync);
+		corr_condition_sec2 = zbx_time() - sec;
+
+		sec = zbx_time();
+		/* relies on correlation rules, must be after DCsync_correlations() */
+		DCsync_corr_operations(&corr_operation_sync);
+		corr_operation_sec2 = zbx_time() - sec;
+
+		sec = zbx_time();
+		dc_sync_drules(&drules_sync, new_revision);
+		dc_sync_dchecks(&dchecks_sync, new_revision);
+		drules_sec2 = zbx_time() - sec;
+
+		sec = zbx_time();
+		dc_sync_httptests(&httptest_sync, new_revision);
+		dc_sync_httptest_fields(&httptest_field_sync, new_revision);
+		dc_sync_httpsteps(&httpstep_sync, new_revision);
+		dc_sync_httpstep_fields(&httpstep_field_sync, new_revision);
+		httptest_sec2 = zbx_time() - sec;
+
+		FINISH_SYNC_CONFIG;
+	}
 
 	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_DEBUG))
 	{
@@ -7587,6 +7710,9 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() total sql  : " ZBX_FS_DBL " sec.", __func__, total);
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() total sync : " ZBX_FS_DBL " sec.", __func__, total2);
 
+		/* other processes modify shared cache data (pqueue, strpool, memory) outside of sync */
+		RDLOCK_CACHE;
+
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() proxies    : %d (%d slots)", __func__,
 				config->proxies.num_data, config->proxies.num_slots);
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() proxies_p    : %d (%d slots)", __func__,
@@ -7730,12 +7856,16 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 				config->strpool.num_data, config->strpool.num_slots);
 
 		zbx_shmem_dump_stats(LOG_LEVEL_DEBUG, config_mem);
+
+		UNLOCK_CACHE;
 	}
 
 	dberr = ZBX_DB_OK;
 out:
-	if (0 == sync_in_progress)
-		START_SYNC;
+	START_SYNC;
+
+	if (ZBX_DB_OK == dberr)
+		config->revision.config = new_revision;
 
 	config->status->last_update = 0;
 	config->sync_ts = time(NULL);
@@ -9456,6 +9586,47 @@ void	zbx_dc_config_get_items_by_itemids(zbx_dc_item_t *items, const zbx_uint64_t
 	UNLOCK_CACHE;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if items are enabled and belong to monitored hosts          *
+ *                                                                            *
+ * Parameters: itemids  - [IN] array of item IDs                              *
+ *             errcodes - [OUT] SUCCEED if item is enabled and belongs to     *
+ *                              monitored host, otherwise FAIL                *
+ *             queued   - [OUT] SUCCEED if item is counted in item queue,     *
+ *                              otherwise FAIL                                *
+ *             num      - [IN] number of elements                             *
+ *                                                                            *
+ * Comments: Unlike zbx_dc_config_get_items_by_itemids() item and host        *
+ *           properties are not copied, which matters when checking large     *
+ *           number of history records before sending them to server.         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_get_items_monitored_status(const zbx_uint64_t *itemids, int *errcodes, int *queued, size_t num)
+{
+	size_t			i;
+	const ZBX_DC_ITEM	*dc_item;
+	const ZBX_DC_HOST	*dc_host;
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < num; i++)
+	{
+		if (NULL == (dc_item = (ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids[i])) ||
+				NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &dc_item->hostid)) ||
+				ITEM_STATUS_ACTIVE != dc_item->status || HOST_STATUS_MONITORED != dc_host->status)
+		{
+			errcodes[i] = FAIL;
+			continue;
+		}
+
+		errcodes[i] = SUCCEED;
+		queued[i] = zbx_is_counted_in_item_queue(dc_item->type, dc_item->key);
+	}
+
+	UNLOCK_CACHE;
+}
+
 int	zbx_dc_config_get_active_items_count_by_hostid(zbx_uint64_t hostid)
 {
 	const ZBX_DC_HOST	*dc_host;
@@ -9861,6 +10032,45 @@ void	zbx_dc_config_clean_triggers(zbx_dc_trigger_t *triggers, int *errcodes, siz
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: try to lock trigger for processing                                *
+ *                                                                            *
+ * Return value: SUCCEED - trigger was locked by the caller                   *
+ *               FAIL    - trigger is already locked by another process       *
+ *                                                                            *
+ * Comments: Without atomic builtins the configuration cache write lock must  *
+ *           be held, otherwise at least the read lock.                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_trigger_trylock(ZBX_DC_TRIGGER *dc_trigger)
+{
+#ifdef DC_TRIGGER_ATOMIC_LOCK
+	unsigned char	unlocked = 0;
+
+	if (0 == __atomic_compare_exchange_n(&dc_trigger->locked, &unlocked, 1, 0, __ATOMIC_ACQUIRE,
+			__ATOMIC_RELAXED))
+	{
+		return FAIL;
+	}
+#else
+	if (1 == dc_trigger->locked)
+		return FAIL;
+
+	dc_trigger->locked = 1;
+#endif
+	return SUCCEED;
+}
+
+static void	dc_trigger_unlock(ZBX_DC_TRIGGER *dc_trigger)
+{
+#ifdef DC_TRIGGER_ATOMIC_LOCK
+	__atomic_store_n(&dc_trigger->locked, 0, __ATOMIC_RELEASE);
+#else
+	dc_trigger->locked = 0;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Lock triggers for specified items so that multiple processes do   *
@@ -9895,13 +10105,16 @@ void	zbx_dc_config_clean_triggers(zbx_dc_trigger_t *triggers, int *errcodes, siz
  ******************************************************************************/
 int	zbx_dc_config_lock_triggers_by_history_items(zbx_vector_ptr_t *history_items, zbx_vector_uint64_t *triggerids)
 {
-	int			i, j, locked_num = 0;
+	int			i, j, k, locked_num = 0;
 	const ZBX_DC_ITEM	*dc_item;
 	ZBX_DC_TRIGGER		*dc_trigger;
 	zbx_hc_item_t		*history_item;
 
+#ifdef DC_TRIGGER_ATOMIC_LOCK
+	RDLOCK_CACHE;
+#else
 	WRLOCK_CACHE;
-
+#endif
 	for (i = 0; i < history_items->values_num; i++)
 	{
 		history_item = (zbx_hc_item_t *)history_items->values[i];
@@ -9920,23 +10133,29 @@ int	zbx_dc_config_lock_triggers_by_history_items(zbx_vector_ptr_t *history_items
 			if (TRIGGER_STATUS_ENABLED != dc_trigger->status)
 				continue;
 
-			if (1 == dc_trigger->locked)
+			if (SUCCEED != dc_trigger_trylock(dc_trigger))
+				break;
+		}
+
+		if (NULL != dc_trigger)
+		{
+			/* release triggers locked for this item before the busy one */
+			for (k = 0; k < j; k++)
 			{
-				locked_num++;
-				history_item->status = ZBX_HC_ITEM_STATUS_BUSY;
-				goto next;
+				if (TRIGGER_STATUS_ENABLED == dc_item->triggers[k]->status)
+					dc_trigger_unlock(dc_item->triggers[k]);
 			}
+
+			locked_num++;
+			history_item->status = ZBX_HC_ITEM_STATUS_BUSY;
+			continue;
 		}
 
 		for (j = 0; NULL != (dc_trigger = dc_item->triggers[j]); j++)
 		{
-			if (TRIGGER_STATUS_ENABLED != dc_trigger->status)
-				continue;
-
-			dc_trigger->locked = 1;
-			zbx_vector_uint64_append(triggerids, dc_trigger->triggerid);
+			if (TRIGGER_STATUS_ENABLED == dc_trigger->status)
+				zbx_vector_uint64_append(triggerids, dc_trigger->triggerid);
 		}
-next:;
 	}
 
 	UNLOCK_CACHE;
@@ -9962,8 +10181,11 @@ void	zbx_dc_config_lock_triggers_by_triggerids(zbx_vector_uint64_t *triggerids_i
 	if (0 == triggerids_in->values_num)
 		return;
 
+#ifdef DC_TRIGGER_ATOMIC_LOCK
+	RDLOCK_CACHE;
+#else
 	WRLOCK_CACHE;
-
+#endif
 	for (i = 0; i < triggerids_in->values_num; i++)
 	{
 		if (NULL == (dc_trigger = (ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
@@ -9972,10 +10194,9 @@ void	zbx_dc_config_lock_triggers_by_triggerids(zbx_vector_uint64_t *triggerids_i
 			continue;
 		}
 
-		if (1 == dc_trigger->locked)
+		if (SUCCEED != dc_trigger_trylock(dc_trigger))
 			continue;
 
-		dc_trigger->locked = 1;
 		zbx_vector_uint64_append(triggerids_out, dc_trigger->triggerid);
 	}
 
@@ -9998,7 +10219,7 @@ void	zbx_dc_config_unlock_triggers(const zbx_vector_uint64_t *triggerids)
 			continue;
 		}
 
-		dc_trigger->locked = 0;
+		dc_trigger_unlock(dc_trigger);
 	}
 
 	UNLOCK_CACHE;
@@ -10043,8 +10264,10 @@ static int	DCconfig_find_active_time_function(const char *expression, const unsi
 	const ZBX_DC_HOST	*dc_host;
 	const ZBX_DC_ITEM	*dc_item;
 	zbx_vector_uint64_t	functionids;
+	zbx_uint64_t		functionids_static[16];
 
-	zbx_vector_uint64_create(&functionids);
+	/* triggers rarely reference more functions, avoid allocating memory for every timer trigger */
+	zbx_vector_uint64_create_static(&functionids, functionids_static, ARRSIZE(functionids_static));
 	zbx_get_serialized_expression_functionids(expression, data, &functionids);
 
 	for (i = 0; i < functionids.values_num; i++)
@@ -10714,6 +10937,136 @@ static void	dc_requeue_item_at(ZBX_DC_ITEM *dc_item, ZBX_DC_HOST *dc_host, int n
 	DCupdate_item_queue(dc_item, old_poller_type, old_nextcheck);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if item can be polled in the same batch as the first item  *
+ *          of the batch                                                      *
+ *                                                                            *
+ * Parameters: first       - [IN] the first item of the batch                 *
+ *             dc_item     - [IN] the item to check                           *
+ *             poller_type - [IN] the poller type                             *
+ *                                                                            *
+ * Return value: SUCCEED - the item belongs to the batch                      *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Uses the same grouping rules as zbx_dc_config_get_poller_items() *
+ *           when taking items from the queue.                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_poller_item_batch_match(const ZBX_DC_ITEM *first, const ZBX_DC_ITEM *dc_item,
+		unsigned char poller_type)
+{
+	if (ITEM_TYPE_SNMP == first->type)
+	{
+		if (ZBX_POLLER_TYPE_NORMAL == poller_type && 0 != __config_snmp_item_compare(first, dc_item))
+			return FAIL;
+	}
+	else if (ITEM_TYPE_JMX == first->type)
+	{
+		if (ITEM_TYPE_JMX != dc_item->type || 0 != __config_java_item_compare(first, dc_item))
+			return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns items that do not belong to the batch back to the queue   *
+ *                                                                            *
+ * Parameters: itemids - [IN] the items to return                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_requeue_dequeued_items(const zbx_vector_uint64_t *itemids)
+{
+	int		i;
+	ZBX_DC_ITEM	*dc_item;
+
+	WRLOCK_CACHE;
+
+	for (i = 0; i < itemids->values_num; i++)
+	{
+		if (NULL == (dc_item = (ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids->values[i])))
+			continue;
+
+		if (ZBX_LOC_POLLER != dc_item->location)
+			continue;
+
+		dc_item->location = ZBX_LOC_NOWHERE;
+		DCupdate_item_queue(dc_item, dc_item->poller_type, dc_item->nextcheck);
+	}
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copies configuration of items taken from poller queue             *
+ *                                                                            *
+ * Parameters: items       - [IN/OUT] on input contains itemids and hostids   *
+ *                                    of the dequeued items, on output - the  *
+ *                                    items                                   *
+ *             num         - [IN] the number of dequeued items                *
+ *             poller_type - [IN] the poller type                             *
+ *                                                                            *
+ * Return value: number of items in items array                               *
+ *                                                                            *
+ * Comments: Item configuration is not modified by pollers, so it is copied   *
+ *           under read lock after the queue has been updated under write     *
+ *           lock. This allows other cache readers to run in parallel with    *
+ *           the relatively expensive copying. Items removed from cache in    *
+ *           the meantime are dropped.                                        *
+ *                                                                            *
+ *           Configuration sync can change items between the two locks, so    *
+ *           the batch grouping is checked again on the copied data. Items    *
+ *           that no longer match the first item of the batch are returned to *
+ *           the queue.                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_config_get_dequeued_items(zbx_dc_item_t *items, int num, unsigned char poller_type)
+{
+	int			i, items_num = 0;
+	const ZBX_DC_ITEM	*dc_item, *dc_item_first = NULL;
+	const ZBX_DC_HOST	*dc_host;
+	zbx_vector_uint64_t	requeue_itemids;
+
+	zbx_vector_uint64_create(&requeue_itemids);
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < num; i++)
+	{
+		if (NULL == (dc_item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &items[i].itemid)))
+			continue;
+
+		if (NULL == (dc_host = (const ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &items[i].host.hostid)))
+			continue;
+
+		if (NULL == dc_item_first)
+		{
+			dc_item_first = dc_item;
+		}
+		else if (SUCCEED != dc_poller_item_batch_match(dc_item_first, dc_item, poller_type))
+		{
+			zbx_vector_uint64_append(&requeue_itemids, dc_item->itemid);
+			continue;
+		}
+
+		DCget_host(&items[items_num].host, dc_host);
+		DCget_item(&items[items_num], dc_item);
+		items_num++;
+	}
+
+	UNLOCK_CACHE;
+
+	if (0 != requeue_itemids.values_num)
+		dc_requeue_dequeued_items(&requeue_itemids);
+
+	zbx_vector_uint64_destroy(&requeue_itemids);
+
+	return items_num;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Get array of items for selected poller                            *
@@ -10877,12 +11230,17 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 
 		dc_item_prev = dc_item;
 		dc_item->location = ZBX_LOC_POLLER;
-		DCget_host(&(*items)[num].host, dc_host);
-		DCget_item(&(*items)[num], dc_item);
+
+		/* only remember the dequeued item, its configuration is copied later under read lock */
+		(*items)[num].itemid = dc_item->itemid;
+		(*items)[num].host.hostid = dc_host->hostid;
 		num++;
 	}
 
 	UNLOCK_CACHE;
+
+	if (0 != num)
+		num = dc_config_get_dequeued_items(*items, num, poller_type);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%d", __func__, num);
 
@@ -11599,6 +11957,13 @@ int	zbx_dc_set_interfaces_availability(zbx_vector_availability_ptr_t *availabili
 	return ret;
 }
 
+typedef struct
+{
+	zbx_uint64_t	triggerid;
+	int		ret;
+}
+zbx_dc_trigdep_check_t;
+
 /******************************************************************************
  *                                                                            *
  * Comments: helper function for trigger dependency checking                  *
@@ -11612,6 +11977,9 @@ int	zbx_dc_set_interfaces_availability(zbx_vector_availability_ptr_t *availabili
  *                                   for bulk trigger operations              *
  *                                   (optional together with triggerids       *
  *                                   parameter)                               *
+ *             checked        - [IN/OUT] the already checked master triggers  *
+ *             truncated      - [OUT] set to 1 if the dependency levels limit *
+ *                                    was reached during the check            *
  *                                                                            *
  * Return value: SUCCEED - trigger dependency check succeed / was unresolved  *
  *               FAIL    - otherwise                                          *
@@ -11623,48 +11991,80 @@ int	zbx_dc_set_interfaces_availability(zbx_vector_availability_ptr_t *availabili
  *           vector, so the dependency check can be performed after a new     *
  *           master trigger value has been calculated.                        *
  *                                                                            *
+ *           Master triggers shared by several dependency chains (or by       *
+ *           several triggers of the batch) are checked only once, their      *
+ *           result is remembered in checked hashset unless it contains       *
+ *           unresolved master triggers or was cut off by the dependency      *
+ *           levels limit (it could differ when checked from a lower level).  *
+ *                                                                            *
  ******************************************************************************/
 static int	DCconfig_check_trigger_dependencies_rec(const ZBX_DC_TRIGGER_DEPLIST *trigdep, int level,
-		const zbx_vector_uint64_t *triggerids, zbx_vector_uint64_t *master_triggerids)
+		const zbx_vector_uint64_t *triggerids, zbx_vector_uint64_t *master_triggerids, zbx_hashset_t *checked,
+		int *truncated)
 {
-	int				i;
+	int				i, ret, masters_num, next_truncated;
 	const ZBX_DC_TRIGGER		*next_trigger;
 	const ZBX_DC_TRIGGER_DEPLIST	*next_trigdep;
+	zbx_dc_trigdep_check_t		*check, check_local;
 
 	if (ZBX_TRIGGER_DEPENDENCY_LEVELS_MAX < level)
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "recursive trigger dependency is too deep (triggerid:" ZBX_FS_UI64 ")",
 				trigdep->triggerid);
+		*truncated = 1;
 		return SUCCEED;
 	}
 
-	if (0 != trigdep->dependencies.values_num)
+	for (i = 0; i < trigdep->dependencies.values_num; i++)
 	{
-		for (i = 0; i < trigdep->dependencies.values_num; i++)
+		next_trigdep = (const ZBX_DC_TRIGGER_DEPLIST *)trigdep->dependencies.values[i];
+
+		if (NULL != (check = (zbx_dc_trigdep_check_t *)zbx_hashset_search(checked, &next_trigdep->triggerid)))
 		{
-			next_trigdep = (const ZBX_DC_TRIGGER_DEPLIST *)trigdep->dependencies.values[i];
+			if (FAIL == check->ret)
+				return FAIL;
 
-			if (NULL != (next_trigger = next_trigdep->trigger) &&
-					TRIGGER_STATUS_ENABLED == next_trigger->status &&
-					TRIGGER_FUNCTIONAL_TRUE == next_trigger->functional)
-			{
+			continue;
+		}
 
-				if (NULL == triggerids || FAIL == zbx_vector_uint64_bsearch(triggerids,
-						next_trigger->triggerid, ZBX_DEFAULT_UINT64_COMPARE_FUNC))
-				{
-					if (TRIGGER_VALUE_PROBLEM == next_trigger->value)
-						return FAIL;
-				}
-				else
-					zbx_vector_uint64_append(master_triggerids, next_trigger->triggerid);
-			}
+		masters_num = (NULL != master_triggerids ? master_triggerids->values_num : 0);
+		next_truncated = 0;
+		ret = SUCCEED;
 
-			if (FAIL == DCconfig_check_trigger_dependencies_rec(next_trigdep, level + 1, triggerids,
-					master_triggerids))
+		if (NULL != (next_trigger = next_trigdep->trigger) &&
+				TRIGGER_STATUS_ENABLED == next_trigger->status &&
+				TRIGGER_FUNCTIONAL_TRUE == next_trigger->functional)
+		{
+
+			if (NULL == triggerids || FAIL == zbx_vector_uint64_bsearch(triggerids,
+					next_trigger->triggerid, ZBX_DEFAULT_UINT64_COMPARE_FUNC))
 			{
-				return FAIL;
+				if (TRIGGER_VALUE_PROBLEM == next_trigger->value)
+					ret = FAIL;
 			}
+			else
+				zbx_vector_uint64_append(master_triggerids, next_trigger->triggerid);
+		}
+
+		if (SUCCEED == ret)
+		{
+			ret = DCconfig_check_trigger_dependencies_rec(next_trigdep, level + 1, triggerids,
+					master_triggerids, checked, &next_truncated);
+		}
+
+		if (0 != next_truncated)
+			*truncated = 1;
+
+		if (FAIL == ret || (0 == next_truncated &&
+				(NULL == master_triggerids || masters_num == master_triggerids->values_num)))
+		{
+			check_local.triggerid = next_trigdep->triggerid;
+			check_local.ret = ret;
+			zbx_hashset_insert(checked, &check_local, sizeof(check_local));
 		}
+
+		if (FAIL == ret)
+			return FAIL;
 	}
 
 	return SUCCEED;
@@ -11680,16 +12080,21 @@ static int	DCconfig_check_trigger_dependencies_rec(const ZBX_DC_TRIGGER_DEPLIST
  ******************************************************************************/
 int	zbx_dc_config_check_trigger_dependencies(zbx_uint64_t triggerid)
 {
-	int				ret = SUCCEED;
+	int				ret = SUCCEED, truncated = 0;
 	const ZBX_DC_TRIGGER_DEPLIST	*trigdep;
+	zbx_hashset_t			checked;
+
+	zbx_hashset_create(&checked, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	RDLOCK_CACHE;
 
 	if (NULL != (trigdep = (const ZBX_DC_TRIGGER_DEPLIST *)zbx_hashset_search(&config->trigdeps, &triggerid)))
-		ret = DCconfig_check_trigger_dependencies_rec(trigdep, 0, NULL, NULL);
+		ret = DCconfig_check_trigger_dependencies_rec(trigdep, 0, NULL, NULL, &checked, &truncated);
 
 	UNLOCK_CACHE;
 
+	zbx_hashset_destroy(&checked);
+
 	return ret;
 }
 
@@ -12098,6 +12503,14 @@ int	zbx_dc_get_item_queue(zbx_vector_ptr_t *queue, int from, int to)
 			if (ITEM_STATUS_ACTIVE != dc_item->status)
 				continue;
 
+			/* check the delay range first - most items are not late and this */
+			/* avoids maintenance, interface and item delay macro processing  */
+			if (now - dc_item->nextcheck < from || (ZBX_QUEUE_TO_INFINITY != to &&
+					now - dc_item->nextcheck >= to))
+			{
+				continue;
+			}
+
 			if (SUCCEED != zbx_is_counted_in_item_queue(dc_item->type, dc_item->key))
 				continue;
 
@@ -12139,12 +12552,6 @@ int	zbx_dc_get_item_queue(zbx_vector_ptr_t *queue, int from, int to)
 
 			}
 
-			if (now - dc_item->nextcheck < from || (ZBX_QUEUE_TO_INFINITY != to &&
-					now - dc_item->nextcheck >= to))
-			{
-				continue;
-			}
-
 			if (NULL != queue)
 			{
 				queue_item = (zbx_queue_item_t *)zbx_malloc(NULL, sizeof(zbx_queue_item_t));
@@ -14048,13 +14455,15 @@ int	zbx_dc_get_host_inventory_value_by_hostid(zbx_uint64_t hostid, char **replac
  ******************************************************************************/
 void	zbx_dc_get_trigger_dependencies(const zbx_vector_uint64_t *triggerids, zbx_vector_ptr_t *deps)
 {
-	int				i, ret;
+	int				i, ret, truncated = 0;
 	const ZBX_DC_TRIGGER_DEPLIST	*trigdep;
 	zbx_vector_uint64_t		masterids;
 	zbx_trigger_dep_t		*dep;
+	zbx_hashset_t			checked;
 
 	zbx_vector_uint64_create(&masterids);
 	zbx_vector_uint64_reserve(&masterids, 64);
+	zbx_hashset_create(&checked, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	RDLOCK_CACHE;
 
@@ -14066,7 +14475,8 @@ void	zbx_dc_get_trigger_dependencies(const zbx_vector_uint64_t *triggerids, zbx_
 			continue;
 		}
 
-		if (FAIL == (ret = DCconfig_check_trigger_dependencies_rec(trigdep, 0, triggerids, &masterids)) ||
+		if (FAIL == (ret = DCconfig_check_trigger_dependencies_rec(trigdep, 0, triggerids, &masterids,
+				&checked, &truncated)) ||
 				0 != masterids.values_num)
 		{
 			dep = (zbx_trigger_dep_t *)zbx_malloc(NULL, sizeof(zbx_trigger_dep_t));
@@ -14089,6 +14499,7 @@ void	zbx_dc_get_trigger_dependencies(const zbx_vector_uint64_t *triggerids, zbx_
 
 	UNLOCK_CACHE;
 
+	zbx_hashset_destroy(&checked);
 	zbx_vector_uint64_destroy(&masterids);
 }
 
@@ -14942,6 +15353,52 @@ int	zbx_dc_maintenance_has_tags(void)
 
 /* external user macro cache API */
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: hash resolved user macro value by host, environment and macro     *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_hash_t	dc_um_value_hash(const void *data)
+{
+	const zbx_dc_um_value_t	*um_value = (const zbx_dc_um_value_t *)data;
+	zbx_hash_t		hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_ALGO(&um_value->hostid, sizeof(um_value->hostid), ZBX_DEFAULT_HASH_SEED);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(um_value->macro, um_value->macro_len, hash);
+
+	return ZBX_DEFAULT_HASH_ALGO(&um_value->env, sizeof(um_value->env), hash);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compare resolved user macro values by host, environment and macro *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_um_value_compare(const void *d1, const void *d2)
+{
+	const zbx_dc_um_value_t	*v1 = (const zbx_dc_um_value_t *)d1;
+	const zbx_dc_um_value_t	*v2 = (const zbx_dc_um_value_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(v1->hostid, v2->hostid);
+	ZBX_RETURN_IF_NOT_EQUAL(v1->env, v2->env);
+	ZBX_RETURN_IF_NOT_EQUAL(v1->macro_len, v2->macro_len);
+
+	return memcmp(v1->macro, v2->macro, v1->macro_len);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free resolved user macro value                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_um_value_clean(void *data)
+{
+	zbx_dc_um_value_t	*um_value = (zbx_dc_um_value_t *)data;
+
+	zbx_free(um_value->macro);
+	zbx_free(um_value->value);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: open handle for user macro resolving in the specified security    *
@@ -14966,6 +15423,12 @@ static zbx_dc_um_handle_t	*dc_open_user_macros(unsigned char macro_env)
 	zbx_dc_um_handle_t	*handle;
 	static zbx_um_cache_t	*um_cache = NULL;
 
+	if (NULL == dc_um_values.hash_func)
+	{
+		zbx_hashset_create_ext(&dc_um_values, 100, dc_um_value_hash, dc_um_value_compare, dc_um_value_clean,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+
 	handle = (zbx_dc_um_handle_t *)zbx_malloc(NULL, sizeof(zbx_dc_um_handle_t));
 
 	if (NULL != dc_um_handle)
@@ -14982,6 +15445,7 @@ static zbx_dc_um_handle_t	*dc_open_user_macros(unsigned char macro_env)
 	handle->macro_env = macro_env;
 	handle->prev = dc_um_handle;
 	handle->cache = &um_cache;
+	handle->values = &dc_um_values;
 
 	dc_um_handle = handle;
 
@@ -15011,11 +15475,66 @@ static const zbx_um_cache_t	*dc_um_get_cache(const zbx_dc_um_handle_t *um_handle
 		*um_handle->cache = config->um_cache;
 		config->um_cache->refcount++;
 		UNLOCK_CACHE;
+
+		/* user macro cache is copied on write, so resolved values stay valid until its revision changes */
+		if (NULL != um_handle->values && dc_um_values_revision != (*um_handle->cache)->revision)
+		{
+			zbx_hashset_clear(um_handle->values);
+			dc_um_values_revision = (*um_handle->cache)->revision;
+		}
 	}
 
 	return *um_handle->cache;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resolve single host user macro using process local cache of      *
+ *          resolved values                                                   *
+ *                                                                            *
+ * Parameters: um_handle - [IN] the user macro cache handle                   *
+ *             hostid    - [IN] the host identifier                           *
+ *             macro     - [IN] the macro with optional context, not          *
+ *                              necessarily terminated after macro            *
+ *             macro_len - [IN] the macro length                              *
+ *             value     - [OUT] the macro value or NULL if macro is unknown, *
+ *                               valid until the next call                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_um_resolve_cached(const zbx_dc_um_handle_t *um_handle, zbx_uint64_t hostid, const char *macro,
+		size_t macro_len, const char **value)
+{
+	const zbx_um_cache_t	*um_cache;
+	zbx_dc_um_value_t	um_value_local, *um_value;
+
+	um_cache = dc_um_get_cache(um_handle);
+
+	um_value_local.hostid = hostid;
+	um_value_local.macro = (char *)macro;
+	um_value_local.macro_len = macro_len;
+	um_value_local.env = um_handle->macro_env;
+
+	if (NULL == (um_value = (zbx_dc_um_value_t *)zbx_hashset_search(um_handle->values, &um_value_local)))
+	{
+		const char	*resolved = NULL;
+
+		um_cache_resolve_const(um_cache, &hostid, 1, macro, um_handle->macro_env, &resolved);
+
+		if (ZBX_DC_UM_VALUES_MAX <= um_handle->values->num_data)
+			zbx_hashset_clear(um_handle->values);
+
+		um_value_local.macro = (char *)zbx_malloc(NULL, macro_len + 1);
+		memcpy(um_value_local.macro, macro, macro_len);
+		um_value_local.macro[macro_len] = '\0';
+		um_value_local.value = (NULL != resolved ? zbx_strdup(NULL, resolved) : NULL);
+
+		um_value = (zbx_dc_um_value_t *)zbx_hashset_insert(um_handle->values, &um_value_local,
+				sizeof(um_value_local));
+	}
+
+	*value = um_value->value;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: closes user macro resolving handle                                *
@@ -15076,8 +15595,16 @@ int	zbx_dc_expand_user_macros(const zbx_dc_um_handle_t *um_handle, char **text,
 		if (ZBX_TOKEN_USER_MACRO != token.type)
 			continue;
 
-		um_cache_resolve_const(dc_um_get_cache(um_handle), hostids, hostids_num, *text + token.loc.l,
-				um_handle->macro_env, &value);
+		if (1 == hostids_num && NULL != um_handle->values)
+		{
+			dc_um_resolve_cached(um_handle, hostids[0], *text + token.loc.l, token.loc.r - token.loc.l + 1,
+					&value);
+		}
+		else
+		{
+			um_cache_resolve_const(dc_um_get_cache(um_handle), hostids, hostids_num, *text + token.loc.l,
+					um_handle->macro_env, &value);
+		}
 
 		if (NULL == value)
 		{
@@ -119,34 +119,36 @@ ZBX_DC_PREPROCITEM;
 
 typedef struct
 {
+	/* fields accessed by queue and poller scans are grouped at the beginning of */
+	/* the structure and the rest is ordered by size to avoid alignment padding  */
 	zbx_uint64_t		itemid;
 	zbx_uint64_t		hostid;
-	zbx_uint64_t		interfaceid;
-	zbx_uint64_t		lastlogsize;
-	zbx_uint64_t		valuemapid;
-	const char		*key;
-	const char		*port;
-	const char		*error;
-	const char		*delay;
-	const char		*delay_ex;
-	const char		*history_period;
-	ZBX_DC_TRIGGER		**triggers;
 	int			nextcheck;
 	int			mtime;
 	int			data_expected_from;
-	zbx_uint64_t		revision;
 	unsigned char		type;
 	unsigned char		value_type;
 	unsigned char		poller_type;
+	unsigned char		status;
 	unsigned char		state;
 	unsigned char		db_state;
-	unsigned char		inventory_link;
-	unsigned char		location;
 	unsigned char		flags;
-	unsigned char		status;
+	unsigned char		location;
 	unsigned char		queue_priority;
+	unsigned char		inventory_link;
 	unsigned char		update_triggers;
+	zbx_uint64_t		interfaceid;
+	zbx_uint64_t		lastlogsize;
+	zbx_uint64_t		valuemapid;
+	zbx_uint64_t		revision;
 	zbx_uint64_t		templateid;
+	const char		*key;
+	const char		*port;
+	const char		*error;
+	const char		*delay;
+	const char		*delay_ex;
+	const char		*history_period;
+	ZBX_DC_TRIGGER		**triggers;
 	ZBX_DC_PREPROCITEM	*preproc_item;
 	ZBX_DC_MASTERITEM	*master_item;
 
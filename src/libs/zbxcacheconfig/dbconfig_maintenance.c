@@ -928,36 +928,6 @@ static void	dc_assign_maintenance_to_host(zbx_hashset_t *host_maintenances, zbx_
 	}
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: assign maintenance to a host that event belongs to, events can be *
- *          in multiple maintenances at a time                                *
- *                                                                            *
- * Parameters: host_event_maintenances - [OUT] host with maintenances         *
- *             maintenance             - [IN] maintenance that host is in     *
- *             hostid                  - [IN] ID of the host                  *
- *                                                                            *
- ******************************************************************************/
-static void	dc_assign_event_maintenance_to_host(zbx_hashset_t *host_event_maintenances,
-		zbx_dc_maintenance_t *maintenance, zbx_uint64_t hostid)
-{
-	zbx_host_event_maintenance_t	*host_event_maintenance, host_event_maintenance_local;
-
-	if (NULL == (host_event_maintenance = (zbx_host_event_maintenance_t *)zbx_hashset_search(
-			host_event_maintenances, &hostid)))
-	{
-		host_event_maintenance_local.hostid = hostid;
-		zbx_vector_ptr_create(&host_event_maintenance_local.maintenances);
-		zbx_vector_ptr_append(&host_event_maintenance_local.maintenances, maintenance);
-
-		zbx_hashset_insert(host_event_maintenances, &host_event_maintenance_local,
-				sizeof(host_event_maintenance_local));
-		return;
-	}
-
-	zbx_vector_ptr_append(&host_event_maintenance->maintenances, maintenance);
-}
-
 typedef void	(*assign_maintenance_to_host_f)(zbx_hashset_t *host_maintenances,
 		zbx_dc_maintenance_t *maintenance, zbx_uint64_t hostid);
 
@@ -1391,6 +1361,143 @@ static void	host_event_maintenance_clean(zbx_host_event_maintenance_t *host_even
 	zbx_vector_ptr_destroy(&host_event_maintenance->maintenances);
 }
 
+typedef struct
+{
+	const zbx_dc_maintenance_t	*maintenance;
+	zbx_vector_ptr_t		groups;
+}
+zbx_event_maintenance_t;
+
+static void	event_maintenance_free(zbx_event_maintenance_t *event_maintenance)
+{
+	zbx_vector_ptr_destroy(&event_maintenance->groups);
+	zbx_free(event_maintenance);
+}
+
+static int	event_maintenance_compare(const void *d1, const void *d2)
+{
+	const zbx_event_maintenance_t	*m1 = *(const zbx_event_maintenance_t * const *)d1;
+	const zbx_event_maintenance_t	*m2 = *(const zbx_event_maintenance_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(m1->maintenance->maintenanceid, m2->maintenance->maintenanceid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get running maintenances with their host groups (including the    *
+ *          nested groups) resolved                                           *
+ *                                                                            *
+ * Parameters: maintenanceids     - [IN] the maintenance ids                  *
+ *             event_maintenances - [OUT] the running maintenances            *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_get_event_maintenances_by_ids(const zbx_vector_uint64_t *maintenanceids,
+		zbx_vector_ptr_t *event_maintenances)
+{
+	const zbx_dc_maintenance_t	*maintenance;
+	zbx_event_maintenance_t		*event_maintenance;
+	zbx_dc_hostgroup_t		*group;
+	zbx_vector_uint64_t		groupids;
+	int				i, j;
+
+	zbx_vector_uint64_create(&groupids);
+
+	for (i = 0; i < maintenanceids->values_num; i++)
+	{
+		if (NULL == (maintenance = (const zbx_dc_maintenance_t *)zbx_hashset_search(&config->maintenances,
+				&maintenanceids->values[i])) || ZBX_MAINTENANCE_RUNNING != maintenance->state)
+		{
+			continue;
+		}
+
+		event_maintenance = (zbx_event_maintenance_t *)zbx_malloc(NULL, sizeof(zbx_event_maintenance_t));
+		event_maintenance->maintenance = maintenance;
+		zbx_vector_ptr_create(&event_maintenance->groups);
+
+		for (j = 0; j < maintenance->groupids.values_num; j++)
+			dc_get_nested_hostgroupids(maintenance->groupids.values[j], &groupids);
+
+		zbx_vector_uint64_sort(&groupids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_uniq(&groupids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+		for (j = 0; j < groupids.values_num; j++)
+		{
+			if (NULL != (group = (zbx_dc_hostgroup_t *)zbx_hashset_search(&config->hostgroups,
+					&groupids.values[j])))
+			{
+				zbx_vector_ptr_append(&event_maintenance->groups, group);
+			}
+		}
+
+		zbx_vector_uint64_clear(&groupids);
+		zbx_vector_ptr_append(event_maintenances, event_maintenance);
+	}
+
+	zbx_vector_ptr_sort(event_maintenances, event_maintenance_compare);
+	zbx_vector_ptr_uniq(event_maintenances, event_maintenance_compare);
+
+	zbx_vector_uint64_destroy(&groupids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get running maintenances of the specified host                    *
+ *                                                                            *
+ * Parameters: event_maintenances      - [IN] the running maintenances        *
+ *             host_event_maintenances - [IN/OUT] the already resolved host   *
+ *                                                maintenances                *
+ *             hostid                  - [IN] the host                        *
+ *                                                                            *
+ * Return value: the host maintenances                                        *
+ *                                                                            *
+ * Comments: Only the hosts of processed events are resolved instead of       *
+ *           expanding all hosts of maintenance host groups.                  *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_host_event_maintenance_t	*dc_get_host_event_maintenances(const zbx_vector_ptr_t *event_maintenances,
+		zbx_hashset_t *host_event_maintenances, zbx_uint64_t hostid)
+{
+	zbx_host_event_maintenance_t	*host_event_maintenance, host_event_maintenance_local;
+	int				i, j;
+
+	if (NULL != (host_event_maintenance = (zbx_host_event_maintenance_t *)zbx_hashset_search(
+			host_event_maintenances, &hostid)))
+	{
+		return host_event_maintenance;
+	}
+
+	host_event_maintenance_local.hostid = hostid;
+	zbx_vector_ptr_create(&host_event_maintenance_local.maintenances);
+
+	for (i = 0; i < event_maintenances->values_num; i++)
+	{
+		const zbx_event_maintenance_t	*event_maintenance = event_maintenances->values[i];
+
+		if (FAIL == zbx_vector_uint64_bsearch(&event_maintenance->maintenance->hostids, hostid,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+		{
+			for (j = 0; j < event_maintenance->groups.values_num; j++)
+			{
+				const zbx_dc_hostgroup_t	*group = event_maintenance->groups.values[j];
+
+				if (NULL != zbx_hashset_search(&group->hostids, &hostid))
+					break;
+			}
+
+			if (j == event_maintenance->groups.values_num)
+				continue;
+		}
+
+		zbx_vector_ptr_append(&host_event_maintenance_local.maintenances,
+				(void *)event_maintenance->maintenance);
+	}
+
+	return (zbx_host_event_maintenance_t *)zbx_hashset_insert(host_event_maintenances,
+			&host_event_maintenance_local, sizeof(host_event_maintenance_local));
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get maintenance data for events                                   *
@@ -1411,12 +1518,13 @@ int	zbx_dc_get_event_maintenances(zbx_vector_ptr_t *event_queries, const zbx_vec
 	ZBX_DC_ITEM			*item;
 	ZBX_DC_FUNCTION			*function;
 	zbx_vector_uint64_t		hostids;
-	zbx_hashset_iter_t		iter;
 	zbx_host_event_maintenance_t	*host_event_maintenance;
+	zbx_vector_ptr_t		event_maintenances;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	zbx_vector_uint64_create(&hostids);
+	zbx_vector_ptr_create(&event_maintenances);
 
 	zbx_hashset_create_ext(&host_event_maintenances, maintenanceids->values_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
 			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)host_event_maintenance_clean,
@@ -1432,19 +1540,11 @@ int	zbx_dc_get_event_maintenances(zbx_vector_ptr_t *event_queries, const zbx_vec
 
 	RDLOCK_CACHE;
 
-	dc_get_host_maintenances_by_ids(maintenanceids, &host_event_maintenances, dc_assign_event_maintenance_to_host);
+	dc_get_event_maintenances_by_ids(maintenanceids, &event_maintenances);
 
-	if (0 == host_event_maintenances.num_data)
+	if (0 == event_maintenances.values_num)
 		goto unlock;
 
-	zbx_hashset_iter_reset(&host_event_maintenances, &iter);
-
-	while (NULL != (host_event_maintenance = (zbx_host_event_maintenance_t *)zbx_hashset_iter_next(&iter)))
-	{
-		zbx_vector_ptr_sort(&host_event_maintenance->maintenances, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
-		zbx_vector_ptr_uniq(&host_event_maintenance->maintenances, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
-	}
-
 	for (i = 0; i < event_queries->values_num; i++)
 	{
 		query = (zbx_event_suppress_query_t *)event_queries->values[i];
@@ -1511,11 +1611,8 @@ int	zbx_dc_get_event_maintenances(zbx_vector_ptr_t *event_queries, const zbx_vec
 		{
 			const zbx_dc_maintenance_t	*maintenance;
 
-			if (NULL == (host_event_maintenance = zbx_hashset_search(&host_event_maintenances,
-					&hostids.values[j])))
-			{
-				continue;
-			}
+			host_event_maintenance = dc_get_host_event_maintenances(&event_maintenances,
+					&host_event_maintenances, hostids.values[j]);
 
 			for (k = 0; k < host_event_maintenance->maintenances.values_num; k++)
 			{
@@ -1523,9 +1620,6 @@ int	zbx_dc_get_event_maintenances(zbx_vector_ptr_t *event_queries, const zbx_vec
 
 				maintenance = (zbx_dc_maintenance_t *)host_event_maintenance->maintenances.values[k];
 
-				if (ZBX_MAINTENANCE_RUNNING != maintenance->state)
-					continue;
-
 				pair.first = maintenance->maintenanceid;
 
 				if (FAIL != zbx_vector_uint64_pair_search(&query->maintenances, pair,
@@ -1548,6 +1642,8 @@ skip:
 unlock:
 	UNLOCK_CACHE;
 
+	zbx_vector_ptr_clear_ext(&event_maintenances, (zbx_clean_func_t)event_maintenance_free);
+	zbx_vector_ptr_destroy(&event_maintenances);
 	zbx_vector_uint64_destroy(&hostids);
 	zbx_hashset_destroy(&host_event_maintenances);
 
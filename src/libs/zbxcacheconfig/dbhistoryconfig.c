@@ -306,6 +306,103 @@ void	zbx_dc_config_history_sync_get_item_tags_by_functionids(const zbx_uint64_t
 	UNLOCK_CACHE_CONFIG_HISTORY;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get own item tags (without inherited host/template tags) by       *
+ *          item IDs                                                          *
+ *                                                                            *
+ * Parameters: itemids   - [IN] array of item IDs                             *
+ *             item_tags - [OUT] array of tag vectors, one per item           *
+ *             num       - [IN] number of elements                            *
+ *                                                                            *
+ * Comments: Data is retrieved using history read lock that must be write     *
+ *           locked only when configuration sync occurs to avoid processes    *
+ *           blocking each other.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_history_sync_get_item_tags_by_itemids(const zbx_uint64_t *itemids, zbx_vector_tags_t *item_tags,
+		size_t num)
+{
+	const ZBX_DC_ITEM	*dc_item;
+
+	RDLOCK_CACHE_CONFIG_HISTORY;
+
+	for (size_t i = 0; i < num; i++)
+	{
+		if (NULL == (dc_item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids[i])))
+			continue;
+
+		for (int j = 0; j < dc_item->tags.values_num; j++)
+		{
+			const zbx_dc_item_tag_t	*dc_tag = (const zbx_dc_item_tag_t *)dc_item->tags.values[j];
+			zbx_tag_t		*tag;
+
+			tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
+			tag->tag = zbx_strdup(NULL, dc_tag->tag);
+			tag->value = zbx_strdup(NULL, dc_tag->value);
+			zbx_vector_tags_append(&item_tags[i], tag);
+		}
+	}
+
+	UNLOCK_CACHE_CONFIG_HISTORY;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get names of host groups the specified hosts belong to            *
+ *                                                                            *
+ * Parameters: hostids - [IN] array of host IDs                               *
+ *             groups  - [OUT] array of group name vectors, one per host      *
+ *             num     - [IN] number of elements                              *
+ *                                                                            *
+ * Comments: Data is retrieved using history read lock that must be write     *
+ *           locked only when configuration sync occurs to avoid processes    *
+ *           blocking each other.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_history_sync_get_host_groups(const zbx_uint64_t *hostids, zbx_vector_ptr_t *groups, size_t num)
+{
+	const zbx_dc_hostgroup_t	*group;
+	zbx_hashset_iter_t		iter;
+
+	RDLOCK_CACHE_CONFIG_HISTORY;
+
+	zbx_hashset_iter_reset(&config->hostgroups, &iter);
+
+	while (NULL != (group = (const zbx_dc_hostgroup_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (0 == group->hostids.num_data)
+			continue;
+
+		for (size_t i = 0; i < num; i++)
+		{
+			if (NULL != zbx_hashset_search(&group->hostids, &hostids[i]))
+				zbx_vector_ptr_append(&groups[i], zbx_strdup(NULL, group->name));
+		}
+	}
+
+	UNLOCK_CACHE_CONFIG_HISTORY;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get configuration cache revision                                  *
+ *                                                                            *
+ * Comments: The revision is increased by every configuration sync and can be *
+ *           used to invalidate data cached locally by history syncers.       *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint64_t	zbx_dc_config_history_sync_get_revision(void)
+{
+	zbx_uint64_t	revision;
+
+	RDLOCK_CACHE_CONFIG_HISTORY;
+	revision = config->revision.config;
+	UNLOCK_CACHE_CONFIG_HISTORY;
+
+	return revision;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get enabled triggers for specified items                          *
@@ -664,7 +761,8 @@ void	zbx_dc_config_history_recv_get_items_by_keys(zbx_history_recv_item_t *items
 	int			maintenances_num;
 	size_t			i;
 	const ZBX_DC_ITEM	*dc_item;
-	const ZBX_DC_HOST	*dc_host;
+	const ZBX_DC_HOST	*dc_host = NULL;
+	const char		*host = NULL;
 
 	memset(errcodes, 0, sizeof(int) * num);
 
@@ -672,8 +770,14 @@ void	zbx_dc_config_history_recv_get_items_by_keys(zbx_history_recv_item_t *items
 
 	for (i = 0; i < num; i++)
 	{
-		if (NULL == (dc_host = DCfind_host(keys[i].host)) ||
-				NULL == (dc_item = DCfind_item(dc_host->hostid, keys[i].key)))
+		/* values are usually grouped by host, look up host only when it changes */
+		if (NULL == host || 0 != strcmp(host, keys[i].host))
+		{
+			host = keys[i].host;
+			dc_host = DCfind_host(host);
+		}
+
+		if (NULL == dc_host || NULL == (dc_item = DCfind_item(dc_host->hostid, keys[i].key)))
 		{
 			errcodes[i] = FAIL;
 			continue;
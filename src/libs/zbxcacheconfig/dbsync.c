@@ -47,8 +47,9 @@
 #define ZBX_DBSYNC_OBJ_CONNECTOR	17
 #define ZBX_DBSYNC_OBJ_CONNECTOR_TAG	18
 #define ZBX_DBSYNC_OBJ_PROXY		19
+#define ZBX_DBSYNC_OBJ_ITEM_PARAMETER	20
 /* number of dbsync objects - keep in sync with above defines */
-#define ZBX_DBSYNC_OBJ_COUNT		19
+#define ZBX_DBSYNC_OBJ_COUNT		20
 
 #define ZBX_DBSYNC_JOURNAL(X)		(X - 1)
 
@@ -723,6 +724,29 @@ void	zbx_dbsync_init(zbx_dbsync_t *sync, unsigned char mode)
 		sync->dbresult = NULL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if changeset contains no changes to apply                  *
+ *                                                                            *
+ * Parameter: sync - [IN] the changeset                                       *
+ *                                                                            *
+ * Return value: SUCCEED - the changeset is empty                             *
+ *               FAIL    - the changeset contains changes or is in            *
+ *                         initialization mode and reads rows directly from   *
+ *                         database                                           *
+ *                                                                            *
+ * Comments: This allows to skip locking configuration cache for domains      *
+ *           that have no changes since the last synchronization.             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsync_is_empty(const zbx_dbsync_t *sync)
+{
+	if (ZBX_DBSYNC_UPDATE != sync->mode)
+		return FAIL;
+
+	return 0 == sync->rows.values_num ? SUCCEED : FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: frees resources allocated by changeset                            *
@@ -3146,33 +3170,6 @@ static int	dbsync_compare_maintenance(const zbx_dc_maintenance_t *maintenance, c
 	return SUCCEED;
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: compares item script params table row with cached configuration   *
- *          data                                                              *
- *                                                                            *
- * Parameter: script - [IN] the cached item script                            *
- *            dbrow  - [IN] the database row                                  *
- *                                                                            *
- * Return value: SUCCEED - the row matches configuration data                 *
- *               FAIL    - otherwise                                          *
- *                                                                            *
- ******************************************************************************/
-static int	dbsync_compare_itemscript_param(const zbx_dc_scriptitem_param_t *scriptitem_param,
-		const zbx_db_row_t dbrow)
-{
-	if (FAIL == dbsync_compare_uint64(dbrow[1], scriptitem_param->itemid))
-		return FAIL;
-
-	if (FAIL == dbsync_compare_str(dbrow[2], scriptitem_param->name))
-		return FAIL;
-
-	if (FAIL == dbsync_compare_str(dbrow[3], scriptitem_param->value))
-		return FAIL;
-
-	return SUCCEED;
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: compares item_parameter table with cached configuration data      *
@@ -3185,74 +3182,35 @@ static int	dbsync_compare_itemscript_param(const zbx_dc_scriptitem_param_t *scri
  ******************************************************************************/
 int	zbx_dbsync_compare_item_script_param(zbx_dbsync_t *sync)
 {
-	zbx_db_row_t			dbrow;
-	zbx_db_result_t			result;
-	zbx_hashset_t			ids;
-	zbx_hashset_iter_t		iter;
-	zbx_uint64_t			rowid;
-	zbx_dc_scriptitem_param_t	*itemscript_params;
-	char				**row;
+	char	*sql = NULL;
+	size_t	sql_alloc = 0, sql_offset = 0;
+	int	ret = SUCCEED;
 
-	if (NULL == (result = zbx_db_select(
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
 			"select p.item_parameterid,p.itemid,p.name,p.value,i.hostid"
 			" from item_parameter p,items i,hosts h"
 			" where p.itemid=i.itemid"
 				" and i.hostid=h.hostid"
 				" and h.status in (%d,%d)"
-				" and i.flags<>%d"
-			" order by p.itemid",
+				" and i.flags<>%d",
 			HOST_STATUS_MONITORED, HOST_STATUS_NOT_MONITORED,
-			ZBX_FLAG_DISCOVERY_PROTOTYPE)))
-	{
-		return FAIL;
-	}
+			ZBX_FLAG_DISCOVERY_PROTOTYPE);
 
 	dbsync_prepare(sync, 5, NULL);
 
 	if (ZBX_DBSYNC_INIT == sync->mode)
 	{
-		sync->dbresult = result;
-		return SUCCEED;
-	}
-
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->itemscript_params.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
-
-	while (NULL != (dbrow = zbx_db_fetch(result)))
-	{
-		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
-
-		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
-
-		row = dbsync_preproc_row(sync, dbrow);
-
-		if (NULL == (itemscript_params = (zbx_dc_scriptitem_param_t *)
-				zbx_hashset_search(&dbsync_env.cache->itemscript_params, &rowid)))
-		{
-			tag = ZBX_DBSYNC_ROW_ADD;
-		}
-		else if (FAIL == dbsync_compare_itemscript_param(itemscript_params, row))
-		{
-			tag = ZBX_DBSYNC_ROW_UPDATE;
-		}
-
-		if (ZBX_DBSYNC_ROW_NONE != tag)
-			dbsync_add_row(sync, rowid, tag, row);
-	}
-
-	zbx_hashset_iter_reset(&dbsync_env.cache->itemscript_params, &iter);
-
-	while (NULL != (itemscript_params = (zbx_dc_scriptitem_param_t *)zbx_hashset_iter_next(&iter)))
-	{
-		if (NULL == zbx_hashset_search(&ids, &itemscript_params->item_script_paramid))
-			dbsync_add_row(sync, itemscript_params->item_script_paramid, ZBX_DBSYNC_ROW_REMOVE, NULL);
+		if (NULL == (sync->dbresult = zbx_db_select("%s", sql)))
+			ret = FAIL;
+		goto out;
 	}
 
-	zbx_hashset_destroy(&ids);
-	zbx_db_free_result(result);
+	ret = dbsync_read_journal(sync, &sql, &sql_alloc, &sql_offset, "p.item_parameterid", "and", NULL,
+			&dbsync_env.journals[ZBX_DBSYNC_JOURNAL(ZBX_DBSYNC_OBJ_ITEM_PARAMETER)]);
+out:
+	zbx_free(sql);
 
-	return SUCCEED;
+	return ret;
 }
 
 /******************************************************************************
@@ -93,6 +93,16 @@ typedef struct
 }
 ZBX_DC_IDS;
 
+/* numeric value prepared for trend calculation */
+typedef struct
+{
+	zbx_uint64_t		itemid;
+	zbx_history_value_t	value;
+	int			hour;
+	unsigned char		value_type;
+}
+zbx_dc_trend_value_t;
+
 static ZBX_DC_IDS	*ids = NULL;
 
 typedef struct
@@ -100,6 +110,8 @@ typedef struct
 	zbx_list_t	list;
 	zbx_hashset_t	index;
 	int		state;
+	zbx_list_item_t	*live_tail;	/* the last queued proxy without backlog, such proxies are queued */
+					/* before the proxies catching up on backlog                      */
 }
 zbx_hc_proxyqueue_t;
 
@@ -363,6 +375,7 @@ static void	DCupdate_trends(zbx_vector_uint64_pair_t *trends_diff)
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+#if !defined(HAVE_POSTGRESQL) && !defined(HAVE_MYSQL)
 /******************************************************************************
  *                                                                            *
  * Purpose: helper function for DCflush trends                                *
@@ -626,6 +639,132 @@ static void	dc_trends_fetch_and_update(ZBX_DC_TREND *trends, int trends_num, zbx
 	if (sql_offset > 16)	/* In ORACLE always present begin..end; */
 		zbx_db_execute("%s", sql);
 }
+#else
+#define ZBX_TRENDS_UPSERT_BATCH	1000
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute trends upsert statement prepared in sql buffer            *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_upsert_trends_execute(unsigned char value_type, const char *table_name, size_t *sql_offset)
+{
+	const char	*t = table_name;
+
+	/* merge with existing trend of the same hour, calculate avg weighted by num */
+#if defined(HAVE_POSTGRESQL)
+	zbx_snprintf_alloc(&sql, &sql_alloc, sql_offset,
+			" on conflict (itemid,clock) do update set"
+			" num=%s.num+excluded.num,"
+			"value_min=least(%s.value_min,excluded.value_min),"
+			"value_max=greatest(%s.value_max,excluded.value_max),",
+			t, t, t);
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		zbx_snprintf_alloc(&sql, &sql_alloc, sql_offset,
+				"value_avg=%s.value_avg/(%s.num+excluded.num)*%s.num+"
+				"excluded.value_avg/(%s.num+excluded.num)*excluded.num",
+				t, t, t, t);
+	}
+	else
+	{
+		zbx_snprintf_alloc(&sql, &sql_alloc, sql_offset,
+				"value_avg=div(%s.value_avg*%s.num+excluded.value_avg*excluded.num,"
+				"%s.num+excluded.num)",
+				t, t, t);
+	}
+#else
+	ZBX_UNUSED(t);
+
+	/* assignments are evaluated left to right, num must be updated last */
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		zbx_strcpy_alloc(&sql, &sql_alloc, sql_offset,
+				" on duplicate key update"
+				" value_avg=value_avg/(num+values(num))*num+values(value_avg)/(num+values(num))*"
+				"values(num),");
+	}
+	else
+	{
+		zbx_strcpy_alloc(&sql, &sql_alloc, sql_offset,
+				" on duplicate key update"
+				" value_avg=(value_avg*num+values(value_avg)*values(num)) div (num+values(num)),");
+	}
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, sql_offset,
+			"value_min=least(value_min,values(value_min)),"
+			"value_max=greatest(value_max,values(value_max)),"
+			"num=num+values(num)");
+#endif
+	zbx_db_execute("%s", sql);
+	*sql_offset = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: insert trends or merge them with existing trends of the same      *
+ *          hour using single statement per batch                             *
+ *                                                                            *
+ * Comments: A helper function for DCflush trends                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_upsert_trends_in_db(ZBX_DC_TREND *trends, int trends_num, unsigned char value_type,
+		const char *table_name, int clock)
+{
+	ZBX_DC_TREND	*trend;
+	int		i, rows_num = 0;
+	size_t		sql_offset = 0;
+
+	for (i = 0; i < trends_num; i++)
+	{
+		trend = &trends[i];
+
+		if (0 == trend->itemid)
+			continue;
+
+		if (clock != trend->clock || value_type != trend->value_type)
+			continue;
+
+		if (0 == rows_num)
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "insert into %s"
+					" (itemid,clock,num,value_min,value_avg,value_max) values ", table_name);
+		}
+		else
+			zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ',');
+
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "(" ZBX_FS_UI64 ",%d,%d," ZBX_FS_DBL64_SQL ","
+					ZBX_FS_DBL64_SQL "," ZBX_FS_DBL64_SQL ")", trend->itemid, trend->clock,
+					trend->num, trend->value_min.dbl, trend->value_avg.dbl, trend->value_max.dbl);
+		}
+		else
+		{
+			zbx_uint128_t	avg;
+
+			/* calculate the trend average value */
+			zbx_udiv128_64(&avg, &trend->value_avg.ui64, trend->num);
+
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "(" ZBX_FS_UI64 ",%d,%d," ZBX_FS_UI64 ","
+					ZBX_FS_UI64 "," ZBX_FS_UI64 ")", trend->itemid, trend->clock, trend->num,
+					trend->value_min.ui64, avg.lo, trend->value_max.ui64);
+		}
+
+		trend->itemid = 0;
+
+		if (ZBX_TRENDS_UPSERT_BATCH == ++rows_num)
+		{
+			dc_upsert_trends_execute(value_type, table_name, &sql_offset);
+			rows_num = 0;
+		}
+	}
+
+	if (0 != rows_num)
+		dc_upsert_trends_execute(value_type, table_name, &sql_offset);
+}
+#endif
 
 /******************************************************************************
  *                                                                            *
@@ -634,11 +773,14 @@ static void	dc_trends_fetch_and_update(ZBX_DC_TREND *trends, int trends_num, zbx
  ******************************************************************************/
 static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uint64_pair_t *trends_diff)
 {
-	int		num, i, clock, inserts_num = 0, itemids_alloc, itemids_num = 0, trends_to = *trends_num;
+	int		num, i, clock;
 	unsigned char	value_type;
+	const char	*table_name;
+#if !defined(HAVE_POSTGRESQL) && !defined(HAVE_MYSQL)
+	int		inserts_num = 0, itemids_alloc, itemids_num = 0, trends_to = *trends_num;
 	zbx_uint64_t	*itemids = NULL;
 	ZBX_DC_TREND	*trend = NULL;
-	const char	*table_name;
+#endif
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() trends_num:%d", __func__, *trends_num);
 
@@ -657,6 +799,12 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 			assert(0);
 	}
 
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+	/* existing trends are merged by database, disable_from is not needed */
+	ZBX_UNUSED(trends_diff);
+
+	dc_upsert_trends_in_db(trends, *trends_num, value_type, table_name, clock);
+#else
 	itemids_alloc = MIN(ZBX_HC_SYNC_MAX, *trends_num);
 	itemids = (zbx_uint64_t *)zbx_malloc(itemids, itemids_alloc * sizeof(zbx_uint64_t));
 
@@ -669,7 +817,7 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 
 		inserts_num++;
 
-		if (0 != trend->disable_from)
+		if (0 != trend->disable_from && clock >= trend->disable_from)
 			continue;
 
 		uint64_array_add(&itemids, &itemids_alloc, &itemids_num, trend->itemid, 64);
@@ -681,20 +829,26 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 		}
 	}
 
+	/* Update existing trends first with a primary key lookup. Trends of the current hour   */
+	/* written before server restart are found here and do not need the range scans below. */
 	if (0 != itemids_num)
 	{
-		dc_remove_updated_trends(trends, trends_to, table_name, value_type, itemids,
-				&itemids_num, clock);
+		dc_trends_fetch_and_update(trends, trends_to, itemids, itemids_num,
+				&inserts_num, value_type, table_name, clock);
+		itemids_num = 0;
 	}
 
 	for (i = 0; i < trends_to; i++)
 	{
 		trend = &trends[i];
 
+		if (0 == trend->itemid)
+			continue;
+
 		if (clock != trend->clock || value_type != trend->value_type)
 			continue;
 
-		if (0 != trend->disable_from && clock >= trend->disable_from)
+		if (0 != trend->disable_from)
 			continue;
 
 		uint64_array_add(&itemids, &itemids_alloc, &itemids_num, trend->itemid, 64);
@@ -702,8 +856,8 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 
 	if (0 != itemids_num)
 	{
-		dc_trends_fetch_and_update(trends, trends_to, itemids, itemids_num,
-				&inserts_num, value_type, table_name, clock);
+		dc_remove_updated_trends(trends, trends_to, table_name, value_type, itemids,
+				&itemids_num, clock);
 	}
 
 	zbx_free(itemids);
@@ -733,6 +887,7 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 
 	if (0 != inserts_num)
 		dc_insert_trends_in_db(trends, trends_to, value_type, table_name, clock);
+#endif
 
 	/* clean trends */
 	for (i = 0, num = 0; i < *trends_num; i++)
@@ -756,7 +911,9 @@ static void	DCflush_trend(ZBX_DC_TREND *trend, ZBX_DC_TREND **trends, int *trend
 {
 	if (*trends_num == *trends_alloc)
 	{
-		*trends_alloc += 256;
+		/* all items of a batch are flushed at hour change, grow geometrically to avoid */
+		/* reallocating the buffer every 256 trends                                    */
+		*trends_alloc = (0 == *trends_alloc ? 256 : *trends_alloc * 2);
 		*trends = (ZBX_DC_TREND *)zbx_realloc(*trends, *trends_alloc * sizeof(ZBX_DC_TREND));
 	}
 
@@ -775,40 +932,38 @@ static void	DCflush_trend(ZBX_DC_TREND *trend, ZBX_DC_TREND **trends, int *trend
  * Purpose: add new value to the trends                                       *
  *                                                                            *
  ******************************************************************************/
-static void	DCadd_trend(const zbx_dc_history_t *history, ZBX_DC_TREND **trends, int *trends_alloc, int *trends_num)
+static void	DCadd_trend(const zbx_dc_trend_value_t *value, ZBX_DC_TREND **trends, int *trends_alloc,
+		int *trends_num)
 {
 	ZBX_DC_TREND	*trend = NULL;
-	int		hour;
-
-	hour = history->ts.sec - history->ts.sec % SEC_PER_HOUR;
 
-	trend = DCget_trend(history->itemid);
+	trend = DCget_trend(value->itemid);
 
-	if (trend->num > 0 && (trend->clock != hour || trend->value_type != history->value_type) &&
+	if (trend->num > 0 && (trend->clock != value->hour || trend->value_type != value->value_type) &&
 			SUCCEED == zbx_history_requires_trends(trend->value_type))
 	{
 		DCflush_trend(trend, trends, trends_alloc, trends_num);
 	}
 
-	trend->value_type = history->value_type;
-	trend->clock = hour;
+	trend->value_type = value->value_type;
+	trend->clock = value->hour;
 
 	switch (trend->value_type)
 	{
 		case ITEM_VALUE_TYPE_FLOAT:
-			if (trend->num == 0 || history->value.dbl < trend->value_min.dbl)
-				trend->value_min.dbl = history->value.dbl;
-			if (trend->num == 0 || history->value.dbl > trend->value_max.dbl)
-				trend->value_max.dbl = history->value.dbl;
-			trend->value_avg.dbl += history->value.dbl / (trend->num + 1) -
+			if (trend->num == 0 || value->value.dbl < trend->value_min.dbl)
+				trend->value_min.dbl = value->value.dbl;
+			if (trend->num == 0 || value->value.dbl > trend->value_max.dbl)
+				trend->value_max.dbl = value->value.dbl;
+			trend->value_avg.dbl += value->value.dbl / (trend->num + 1) -
 					trend->value_avg.dbl / (trend->num + 1);
 			break;
 		case ITEM_VALUE_TYPE_UINT64:
-			if (trend->num == 0 || history->value.ui64 < trend->value_min.ui64)
-				trend->value_min.ui64 = history->value.ui64;
-			if (trend->num == 0 || history->value.ui64 > trend->value_max.ui64)
-				trend->value_max.ui64 = history->value.ui64;
-			zbx_uinc128_64(&trend->value_avg.ui64, history->value.ui64);
+			if (trend->num == 0 || value->value.ui64 < trend->value_min.ui64)
+				trend->value_min.ui64 = value->value.ui64;
+			if (trend->num == 0 || value->value.ui64 > trend->value_max.ui64)
+				trend->value_max.ui64 = value->value.ui64;
+			zbx_uinc128_64(&trend->value_avg.ui64, value->value.ui64);
 			break;
 	}
 	trend->num++;
@@ -832,27 +987,40 @@ static void	DCmass_update_trends(const zbx_dc_history_t *history, int history_nu
 	zbx_timespec_t		ts;
 	int			trends_alloc = 0, i, hour, seconds;
 	zbx_vector_uint64_t	del_itemids;
+	zbx_dc_trend_value_t	*values;
+	int			values_num = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	zbx_vector_uint64_create(&del_itemids);
 
-	zbx_timespec(&ts);
-	seconds = ts.sec % SEC_PER_HOUR;
-	hour = ts.sec - seconds;
-
-	LOCK_TRENDS;
+	/* gather trend values into compact array before locking trends cache */
+	values = (zbx_dc_trend_value_t *)zbx_malloc(NULL, sizeof(zbx_dc_trend_value_t) * (size_t)history_num);
 
 	for (i = 0; i < history_num; i++)
 	{
 		const zbx_dc_history_t	*h = &history[i];
+		zbx_dc_trend_value_t	*value;
 
 		if (0 != (ZBX_DC_FLAGS_NOT_FOR_TRENDS & h->flags))
 			continue;
 
-		DCadd_trend(h, trends, &trends_alloc, trends_num);
+		value = &values[values_num++];
+		value->itemid = h->itemid;
+		value->value = h->value;
+		value->hour = h->ts.sec - h->ts.sec % SEC_PER_HOUR;
+		value->value_type = h->value_type;
 	}
 
+	zbx_timespec(&ts);
+	seconds = ts.sec % SEC_PER_HOUR;
+	hour = ts.sec - seconds;
+
+	LOCK_TRENDS;
+
+	for (i = 0; i < values_num; i++)
+		DCadd_trend(&values[i], trends, &trends_alloc, trends_num);
+
 	if (cache->trends_last_cleanup_hour < hour && ZBX_TRENDS_CLEANUP_TIME < seconds)
 	{
 		zbx_hashset_iter_t	iter;
@@ -891,6 +1059,8 @@ static void	DCmass_update_trends(const zbx_dc_history_t *history, int history_nu
 
 	UNLOCK_TRENDS;
 
+	zbx_free(values);
+
 	if (0 != del_itemids.values_num)
 	{
 		zbx_dc_config_history_sync_unset_existing_itemids(&del_itemids);
@@ -983,51 +1153,69 @@ static void	zbx_host_info_clean(zbx_host_info_t *host_info)
  *                                                                            *
  * Purpose: get hosts groups names                                            *
  *                                                                            *
- * Parameters: hosts_info - [IN/OUT] output names of host groups for a host   *
- *             hostids    - [IN] hosts identifiers                            *
+ * Parameters: hostids - [IN] hosts identifiers                               *
+ *                                                                            *
+ * Return value: hosts information with names of host groups                  *
+ *                                                                            *
+ * Comments: Host groups are taken from configuration cache and kept locally  *
+ *           until configuration cache revision changes, so only hosts not    *
+ *           seen since the last configuration sync require a lookup.         *
  *                                                                            *
  ******************************************************************************/
-static void	db_get_hosts_info_by_hostid(zbx_hashset_t *hosts_info, const zbx_vector_uint64_t *hostids)
+static zbx_hashset_t	*dc_get_hosts_info_by_hostid(const zbx_vector_uint64_t *hostids)
 {
-	int		i;
-	size_t		sql_offset = 0;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
+	static zbx_hashset_t	*hosts_info = NULL;
+	static zbx_uint64_t	hosts_info_revision;
 
-	for (i = 0; i < hostids->values_num; i++)
-	{
-		zbx_host_info_t	host_info = {.hostid = hostids->values[i]};
+	int			i;
+	zbx_uint64_t		revision;
+	zbx_vector_uint64_t	new_hostids;
+	zbx_vector_ptr_t	*groups;
+
+	revision = zbx_dc_config_history_sync_get_revision();
 
-		zbx_vector_ptr_create(&host_info.groups);
-		zbx_hashset_insert(hosts_info, &host_info, sizeof(host_info));
+	if (NULL == hosts_info)
+	{
+		hosts_info = (zbx_hashset_t *)zbx_malloc(NULL, sizeof(zbx_hashset_t));
+		zbx_hashset_create_ext(hosts_info, (size_t)hostids->values_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)zbx_host_info_clean,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
 	}
+	else if (revision != hosts_info_revision)
+		zbx_hashset_clear(hosts_info);
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-				"select distinct hg.hostid,g.name"
-				" from hstgrp g,hosts_groups hg"
-				" where g.groupid=hg.groupid"
-					" and");
+	hosts_info_revision = revision;
 
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "hg.hostid", hostids->values, hostids->values_num);
+	zbx_vector_uint64_create(&new_hostids);
 
-	result = zbx_db_select("%s", sql);
+	for (i = 0; i < hostids->values_num; i++)
+	{
+		if (NULL == zbx_hashset_search(hosts_info, &hostids->values[i]))
+			zbx_vector_uint64_append(&new_hostids, hostids->values[i]);
+	}
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	if (0 != new_hostids.values_num)
 	{
-		zbx_uint64_t	hostid;
-		zbx_host_info_t	*host_info;
+		groups = (zbx_vector_ptr_t *)zbx_malloc(NULL, sizeof(zbx_vector_ptr_t) * (size_t)new_hostids.values_num);
 
-		ZBX_DBROW2UINT64(hostid, row[0]);
+		for (i = 0; i < new_hostids.values_num; i++)
+			zbx_vector_ptr_create(&groups[i]);
 
-		if (NULL == (host_info = (zbx_host_info_t *)zbx_hashset_search(hosts_info, &hostid)))
+		zbx_dc_config_history_sync_get_host_groups(new_hostids.values, groups, (size_t)new_hostids.values_num);
+
+		for (i = 0; i < new_hostids.values_num; i++)
 		{
-			THIS_SHOULD_NEVER_HAPPEN;
-			continue;
+			zbx_host_info_t	host_info = {.hostid = new_hostids.values[i], .groups = groups[i]};
+
+			zbx_hashset_insert(hosts_info, &host_info, sizeof(host_info));
 		}
 
-		zbx_vector_ptr_append(&host_info->groups, zbx_strdup(NULL, row[1]));
+		zbx_free(groups);
 	}
-	zbx_db_free_result(result);
+
+	zbx_vector_uint64_destroy(&new_hostids);
+
+	return hosts_info;
 }
 
 typedef struct
@@ -1079,57 +1267,41 @@ static void	db_get_item_names_by_itemid(zbx_hashset_t *items_info, const zbx_vec
 
 /******************************************************************************
  *                                                                            *
- * Purpose: get item tags                                                     *
+ * Purpose: get item tags from configuration cache                            *
  *                                                                            *
  * Parameters: items_info - [IN/OUT] output item tags                         *
  *             itemids    - [IN] the item identifiers                         *
  *                                                                            *
  ******************************************************************************/
-static void	db_get_item_tags_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
+static void	dc_get_item_tags_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
 {
-	size_t		sql_offset = 0;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	zbx_item_info_t	*item_info = NULL;
+	int			i;
+	zbx_vector_tags_t	*item_tags;
+	zbx_item_info_t		*item_info;
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select itemid,tag,value from item_tag where");
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
-	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by itemid");
+	item_tags = (zbx_vector_tags_t *)zbx_malloc(NULL, sizeof(zbx_vector_tags_t) * (size_t)itemids->values_num);
 
-	result = zbx_db_select("%s", sql);
+	for (i = 0; i < itemids->values_num; i++)
+		zbx_vector_tags_create(&item_tags[i]);
 
-	while (NULL != (row = zbx_db_fetch(result)))
-	{
-		zbx_uint64_t	itemid;
-		zbx_tag_t	*item_tag;
-
-		ZBX_DBROW2UINT64(itemid, row[0]);
+	zbx_dc_config_history_sync_get_item_tags_by_itemids(itemids->values, item_tags, (size_t)itemids->values_num);
 
-		if (NULL == item_info || item_info->itemid != itemid)
+	for (i = 0; i < itemids->values_num; i++)
+	{
+		if (NULL == (item_info = (zbx_item_info_t *)zbx_hashset_search(items_info, &itemids->values[i])))
 		{
-			if (NULL != item_info)
-			{
-				zbx_vector_tags_sort(&item_info->item_tags, zbx_compare_tags);
-			}
-			if (NULL == (item_info = (zbx_item_info_t *)zbx_hashset_search(items_info, &itemid)))
-			{
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
-			}
+			THIS_SHOULD_NEVER_HAPPEN;
+			zbx_vector_tags_clear_ext(&item_tags[i], zbx_free_tag);
+			zbx_vector_tags_destroy(&item_tags[i]);
+			continue;
 		}
 
-		item_tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(*item_tag));
-		item_tag->tag = zbx_strdup(NULL, row[1]);
-		item_tag->value = zbx_strdup(NULL, row[2]);
-		zbx_vector_tags_append(&item_info->item_tags, item_tag);
-	}
-
-	if (NULL != item_info)
-	{
+		zbx_vector_tags_destroy(&item_info->item_tags);
+		item_info->item_tags = item_tags[i];
 		zbx_vector_tags_sort(&item_info->item_tags, zbx_compare_tags);
 	}
 
-	zbx_db_free_result(result);
+	zbx_free(item_tags);
 }
 
 /******************************************************************************
@@ -1143,7 +1315,7 @@ static void	db_get_item_tags_by_itemid(zbx_hashset_t *items_info, const zbx_vect
 static void	db_get_items_info_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
 {
 	db_get_item_names_by_itemid(items_info, itemids);
-	db_get_item_tags_by_itemid(items_info, itemids);
+	dc_get_item_tags_by_itemid(items_info, itemids);
 }
 
 /******************************************************************************
@@ -1439,7 +1611,7 @@ static void	DCexport_history_and_trends(const zbx_dc_history_t *history, int his
 {
 	int			i, index;
 	zbx_vector_uint64_t	hostids, item_info_ids;
-	zbx_hashset_t		hosts_info, items_info;
+	zbx_hashset_t		*hosts_info, items_info;
 	zbx_history_sync_item_t	*item;
 	zbx_item_info_t		item_info;
 
@@ -1515,24 +1687,18 @@ static void	DCexport_history_and_trends(const zbx_dc_history_t *history, int his
 	zbx_vector_uint64_sort(&hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_vector_uint64_uniq(&hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
-	zbx_hashset_create_ext(&hosts_info, hostids.values_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)zbx_host_info_clean,
-			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
-
-	db_get_hosts_info_by_hostid(&hosts_info, &hostids);
+	hosts_info = dc_get_hosts_info_by_hostid(&hostids);
 
 	db_get_items_info_by_itemid(&items_info, &item_info_ids);
 
 	if (0 != history_num)
 	{
-		DCexport_history(history, history_num, &hosts_info, &items_info, history_export_enabled,
+		DCexport_history(history, history_num, hosts_info, &items_info, history_export_enabled,
 				connector_filters, data, data_alloc, data_offset);
 	}
 
 	if (0 != trends_num)
-		DCexport_trends(trends, trends_num, &hosts_info, &items_info);
-
-	zbx_hashset_destroy(&hosts_info);
+		DCexport_trends(trends, trends_num, hosts_info, &items_info);
 clean:
 	zbx_hashset_destroy(&items_info);
 	zbx_vector_uint64_destroy(&item_info_ids);
@@ -2397,51 +2563,44 @@ static int	history_value_compare_func(const void *d1, const void *d2)
 	return 0;
 }
 
-static void	vc_flag_duplicates(zbx_vector_ptr_t *history_index, zbx_vector_ptr_t *duplicates)
-{
-	int	i;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
-
-	for (i = 0; i < duplicates->values_num; i++)
-	{
-		int	idx_cached;
-
-		if (FAIL != (idx_cached = zbx_vector_ptr_bsearch(history_index, duplicates->values[i],
-				history_value_compare_func)))
-		{
-			zbx_dc_history_t	*cached_value = (zbx_dc_history_t *)history_index->values[idx_cached];
-
-			dc_history_clean_value(cached_value);
-			cached_value->flags |= ZBX_DC_FLAGS_NOT_FOR_HISTORY;
-		}
-	}
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
-}
-
-static void	db_fetch_duplicates(zbx_history_dupl_select_t *query, unsigned char value_type,
-		zbx_vector_ptr_t *duplicates)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: flag history values already stored in database as duplicates      *
+ *                                                                            *
+ * Parameters: query         - [IN] duplicate selection query                 *
+ *             value_type    - [IN] value type of the selected table          *
+ *             history_index - [IN/OUT] sorted history values                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_flag_duplicates(zbx_history_dupl_select_t *query, unsigned char value_type,
+		zbx_vector_ptr_t *history_index)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_dc_history_t	d;
 
 	if (NULL == query->sql)
 		return;
 
+	d.value_type = value_type;
+
 	result = zbx_db_select("%s", query->sql);
 
 	while (NULL != (row = zbx_db_fetch(result)))
 	{
-		zbx_dc_history_t	*d = (zbx_dc_history_t *)zbx_malloc(NULL, sizeof(zbx_dc_history_t));
+		int	idx_cached;
 
-		ZBX_STR2UINT64(d->itemid, row[0]);
-		d->ts.sec = atoi(row[1]);
-		d->ts.ns = atoi(row[2]);
+		ZBX_STR2UINT64(d.itemid, row[0]);
+		d.ts.sec = atoi(row[1]);
+		d.ts.ns = atoi(row[2]);
 
-		d->value_type = value_type;
+		if (FAIL != (idx_cached = zbx_vector_ptr_bsearch(history_index, &d, history_value_compare_func)))
+		{
+			zbx_dc_history_t	*cached_value = (zbx_dc_history_t *)history_index->values[idx_cached];
 
-		zbx_vector_ptr_append(duplicates, d);
+			dc_history_clean_value(cached_value);
+			cached_value->flags |= ZBX_DC_FLAGS_NOT_FOR_HISTORY;
+		}
 	}
 	zbx_db_free_result(result);
 
@@ -2457,11 +2616,10 @@ static void	remove_history_duplicates(zbx_vector_ptr_t *history)
 					select_log = {.table_name = "history_log"},
 					select_text = {.table_name = "history_text"},
 					select_bin = {.table_name = "history_bin"};
-	zbx_vector_ptr_t		duplicates, history_index;
+	zbx_vector_ptr_t		history_index;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_vector_ptr_create(&duplicates);
 	zbx_vector_ptr_create(&history_index);
 
 	zbx_vector_ptr_append_array(&history_index, history->values, history->values_num);
@@ -2502,17 +2660,13 @@ static void	remove_history_duplicates(zbx_vector_ptr_t *history)
 				h->ts.sec, h->ts.ns);
 	}
 
-	db_fetch_duplicates(&select_flt, ITEM_VALUE_TYPE_FLOAT, &duplicates);
-	db_fetch_duplicates(&select_uint, ITEM_VALUE_TYPE_UINT64, &duplicates);
-	db_fetch_duplicates(&select_str, ITEM_VALUE_TYPE_STR, &duplicates);
-	db_fetch_duplicates(&select_log, ITEM_VALUE_TYPE_LOG, &duplicates);
-	db_fetch_duplicates(&select_text, ITEM_VALUE_TYPE_TEXT, &duplicates);
-	db_fetch_duplicates(&select_bin, ITEM_VALUE_TYPE_BIN, &duplicates);
-
-	vc_flag_duplicates(&history_index, &duplicates);
+	db_flag_duplicates(&select_flt, ITEM_VALUE_TYPE_FLOAT, &history_index);
+	db_flag_duplicates(&select_uint, ITEM_VALUE_TYPE_UINT64, &history_index);
+	db_flag_duplicates(&select_str, ITEM_VALUE_TYPE_STR, &history_index);
+	db_flag_duplicates(&select_log, ITEM_VALUE_TYPE_LOG, &history_index);
+	db_flag_duplicates(&select_text, ITEM_VALUE_TYPE_TEXT, &history_index);
+	db_flag_duplicates(&select_bin, ITEM_VALUE_TYPE_BIN, &history_index);
 
-	zbx_vector_ptr_clear_ext(&duplicates, (zbx_clean_func_t)zbx_ptr_free);
-	zbx_vector_ptr_destroy(&duplicates);
 	zbx_vector_ptr_destroy(&history_index);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -2908,7 +3062,7 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 	static ZBX_HISTORY_STRING	*history_string;
 	static ZBX_HISTORY_TEXT		*history_text;
 	static ZBX_HISTORY_LOG		*history_log;
-	static int			module_enabled = FAIL;
+	static int			module_enabled = FAIL, sync_max = ZBX_HC_SYNC_MAX;
 	int				i, history_num, history_float_num, history_integer_num, history_string_num,
 					history_text_num, history_log_num, txn_error, compression_age,
 					connectors_retrieved = FAIL;
@@ -3000,7 +3154,7 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 		*more = ZBX_SYNC_DONE;
 
 		LOCK_CACHE;
-		hc_pop_items(&history_items);		/* select and take items out of history cache */
+		hc_pop_items(&history_items, sync_max);	/* select and take items out of history cache */
 		UNLOCK_CACHE;
 
 		if (0 != history_items.values_num)
@@ -3019,6 +3173,7 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 		if (0 != history_num)
 		{
 			zbx_dc_um_handle_t	*um_handle;
+			double			sync_sec;
 
 			if (FAIL == connectors_retrieved)
 			{
@@ -3057,6 +3212,8 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 					events_cbs->add_event_cb, &item_diff,
 					&inventory_values, compression_age, &proxy_subscriptions);
 
+			sync_sec = zbx_time();
+
 			if (FAIL != (ret = DBmass_add_history(history, history_num)))
 			{
 				zbx_dc_config_items_apply_changes(&item_diff);
@@ -3092,6 +3249,8 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 				while (ZBX_DB_DOWN == txn_error);
 			}
 
+			sync_max = hc_sync_adjust_max(sync_max, history_num, zbx_time() - sync_sec);
+
 			zbx_dc_close_user_macros(um_handle);
 
 			if (NULL != events_cbs->clean_events_cb)
@@ -3992,7 +4151,8 @@ void	zbx_dc_flush_history(void)
  *                                                                            *
  ******************************************************************************/
 ZBX_SHMEM_FUNC_IMPL(__hc_index, hc_index_mem)
-ZBX_SHMEM_FUNC_IMPL(__hc, hc_mem)
+ZBX_SHMEM_FUNC1_IMPL_MALLOC(__hc, hc_mem)
+ZBX_SHMEM_FUNC1_IMPL_FREE(__hc, hc_mem)
 
 /******************************************************************************
  *                                                                            *
@@ -4017,43 +4177,12 @@ static int	hc_queue_elem_compare_func(const void *d1, const void *d2)
  *                                                                            *
  * Parameters: data - [IN] history item data                                  *
  *                                                                            *
+ * Comments: The value strings and log value are allocated together with the  *
+ *           history data record, see hc_clone_history_data().                *
+ *                                                                            *
  ******************************************************************************/
 static void	hc_free_data(zbx_hc_data_t *data)
 {
-	if (ITEM_STATE_NOTSUPPORTED == data->state)
-	{
-		__hc_shmem_free_func(data->value.str);
-	}
-	else
-	{
-		if (0 == (data->flags & ZBX_DC_FLAG_NOVALUE))
-		{
-			switch (data->value_type)
-			{
-				case ITEM_VALUE_TYPE_STR:
-				case ITEM_VALUE_TYPE_TEXT:
-				case ITEM_VALUE_TYPE_BIN:
-					__hc_shmem_free_func(data->value.str);
-					break;
-				case ITEM_VALUE_TYPE_LOG:
-					__hc_shmem_free_func(data->value.log->value);
-
-					if (NULL != data->value.log->source)
-						__hc_shmem_free_func(data->value.log->source);
-
-					__hc_shmem_free_func(data->value.log);
-					break;
-				case ITEM_VALUE_TYPE_UINT64:
-				case ITEM_VALUE_TYPE_FLOAT:
-					break;
-				case ITEM_VALUE_TYPE_NONE:
-				default:
-					THIS_SHOULD_NEVER_HAPPEN;
-					exit(EXIT_FAILURE);
-			}
-		}
-	}
-
 	__hc_shmem_free_func(data);
 }
 
@@ -4107,119 +4236,90 @@ static zbx_hc_item_t	*hc_add_item(zbx_uint64_t itemid, zbx_hc_data_t *data)
  *                                                                            *
  * Purpose: copies string value to history cache                              *
  *                                                                            *
- * Parameters: str - [IN] the string value                                    *
+ * Parameters: dst - [OUT] the memory to copy string into                     *
+ *             str - [IN] the string value                                    *
  *                                                                            *
- * Return value: the copied string or NULL if there was not enough memory     *
+ * Return value: the copied string or NULL if the string value is empty       *
  *                                                                            *
  ******************************************************************************/
-static char	*hc_mem_value_str_dup(const dc_value_str_t *str)
+static char	*hc_copy_value_str(char **dst, const dc_value_str_t *str)
 {
 	char	*ptr;
 
-	if (NULL == (ptr = (char *)__hc_shmem_malloc_func(NULL, str->len)))
+	if (0 == str->len)
 		return NULL;
 
+	ptr = *dst;
 	memcpy(ptr, &string_values[str->pvalue], str->len - 1);
 	ptr[str->len - 1] = '\0';
 
+	*dst += str->len;
+
 	return ptr;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: clones string value into history data memory                      *
+ * Purpose: calculates memory required to store item value in history cache   *
  *                                                                            *
- * Parameters: dst - [IN/OUT] a reference to the cloned value                 *
- *             str - [IN] the string value to clone                           *
- *                                                                            *
- * Return value: SUCCESS - either there was no need to clone the string       *
- *                         (it was empty or already cloned) or the string was *
- *                          cloned successfully                               *
- *               FAIL    - not enough memory                                  *
+ * Parameters: item_value - [IN] the item value                               *
  *                                                                            *
- * Comments: This function can be called in loop with the same dst value      *
- *           until it finishes cloning string value.                          *
+ * Return value: the size of history data record including value strings     *
  *                                                                            *
  ******************************************************************************/
-static int	hc_clone_history_str_data(char **dst, const dc_value_str_t *str)
+static size_t	hc_get_history_data_size(const dc_item_value_t *item_value)
 {
-	if (0 == str->len)
-		return SUCCEED;
+	size_t	size = sizeof(zbx_hc_data_t);
 
-	if (NULL != *dst)
-		return SUCCEED;
+	if (ITEM_STATE_NOTSUPPORTED == item_value->state || 0 != (ZBX_DC_FLAG_LLD & item_value->flags))
+		return size + item_value->value.value_str.len;
 
-	if (NULL != (*dst = hc_mem_value_str_dup(str)))
-		return SUCCEED;
+	if (0 != (ZBX_DC_FLAG_NOVALUE & item_value->flags))
+		return size;
 
-	return FAIL;
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: clones log value into history data memory                         *
- *                                                                            *
- * Parameters: dst        - [IN/OUT] a reference to the cloned value          *
- *             item_value - [IN] the log value to clone                       *
- *                                                                            *
- * Return value: SUCCESS - the log value was cloned successfully              *
- *               FAIL    - not enough memory                                  *
- *                                                                            *
- * Comments: This function can be called in loop with the same dst value      *
- *           until it finishes cloning log value.                             *
- *                                                                            *
- ******************************************************************************/
-static int	hc_clone_history_log_data(zbx_log_value_t **dst, const dc_item_value_t *item_value)
-{
-	if (NULL == *dst)
+	switch (item_value->value_type)
 	{
-		/* using realloc instead of malloc just to suppress 'not used' warning for realloc */
-		if (NULL == (*dst = (zbx_log_value_t *)__hc_shmem_realloc_func(NULL, sizeof(zbx_log_value_t))))
-			return FAIL;
-
-		memset(*dst, 0, sizeof(zbx_log_value_t));
+		case ITEM_VALUE_TYPE_STR:
+		case ITEM_VALUE_TYPE_TEXT:
+		case ITEM_VALUE_TYPE_BIN:
+			size += item_value->value.value_str.len;
+			break;
+		case ITEM_VALUE_TYPE_LOG:
+			size += sizeof(zbx_log_value_t) + item_value->value.value_str.len + item_value->source.len;
+			break;
 	}
 
-	if (SUCCEED != hc_clone_history_str_data(&(*dst)->value, &item_value->value.value_str))
-		return FAIL;
-
-	if (SUCCEED != hc_clone_history_str_data(&(*dst)->source, &item_value->source))
-		return FAIL;
-
-	(*dst)->logeventid = item_value->logeventid;
-	(*dst)->severity = item_value->severity;
-	(*dst)->timestamp = item_value->timestamp;
-
-	return SUCCEED;
+	return size;
 }
 
 /******************************************************************************
  *                                                                            *
  * Purpose: clones item value from local cache into history cache             *
  *                                                                            *
- * Parameters: data       - [IN/OUT] a reference to the cloned value          *
+ * Parameters: data       - [OUT] a reference to the cloned value             *
  *             item_value - [IN] the item value                               *
  *                                                                            *
  * Return value: SUCCESS - the item value was cloned successfully             *
  *               FAIL    - not enough memory                                  *
  *                                                                            *
- * Comments: This function can be called in loop with the same data value     *
- *           until it finishes cloning item value.                            *
+ * Comments: The history data record, log value and value strings are stored  *
+ *           in a single allocation to reduce allocator overhead and          *
+ *           fragmentation of history cache memory.                           *
  *                                                                            *
  ******************************************************************************/
 static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *item_value)
 {
-	if (NULL == *data)
-	{
-		if (NULL == (*data = (zbx_hc_data_t *)__hc_shmem_malloc_func(NULL, sizeof(zbx_hc_data_t))))
-			return FAIL;
+	char	*ptr;
 
-		memset(*data, 0, sizeof(zbx_hc_data_t));
+	if (NULL == (*data = (zbx_hc_data_t *)__hc_shmem_malloc_func(NULL, hc_get_history_data_size(item_value))))
+		return FAIL;
 
-		(*data)->state = item_value->state;
-		(*data)->ts = item_value->ts;
-		(*data)->flags = item_value->flags;
-	}
+	memset(*data, 0, sizeof(zbx_hc_data_t));
+	ptr = (char *)(*data + 1);
+
+	(*data)->state = item_value->state;
+	(*data)->ts = item_value->ts;
+	(*data)->flags = item_value->flags;
 
 	if (0 != (ZBX_DC_FLAG_META & item_value->flags))
 	{
@@ -4229,9 +4329,7 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 
 	if (ITEM_STATE_NOTSUPPORTED == item_value->state)
 	{
-		if (NULL == ((*data)->value.str = hc_mem_value_str_dup(&item_value->value.value_str)))
-			return FAIL;
-
+		(*data)->value.str = hc_copy_value_str(&ptr, &item_value->value.value_str);
 		(*data)->value_type = item_value->value_type;
 		cache->stats.notsupported_counter++;
 
@@ -4240,9 +4338,7 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 
 	if (0 != (ZBX_DC_FLAG_LLD & item_value->flags))
 	{
-		if (NULL == ((*data)->value.str = hc_mem_value_str_dup(&item_value->value.value_str)))
-			return FAIL;
-
+		(*data)->value.str = hc_copy_value_str(&ptr, &item_value->value.value_str);
 		(*data)->value_type = ITEM_VALUE_TYPE_TEXT;
 
 		cache->stats.history_text_counter++;
@@ -4253,6 +4349,8 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 
 	if (0 == (ZBX_DC_FLAG_NOVALUE & item_value->flags))
 	{
+		zbx_log_value_t	*log;
+
 		switch (item_value->value_type)
 		{
 			case ITEM_VALUE_TYPE_FLOAT:
@@ -4264,15 +4362,19 @@ static int	hc_clone_history_data(zbx_hc_data_t **data, const dc_item_value_t *it
 			case ITEM_VALUE_TYPE_STR:
 			case ITEM_VALUE_TYPE_TEXT:
 			case ITEM_VALUE_TYPE_BIN:
-				if (SUCCEED != hc_clone_history_str_data(&(*data)->value.str,
-						&item_value->value.value_str))
-				{
-					return FAIL;
-				}
+				(*data)->value.str = hc_copy_value_str(&ptr, &item_value->value.value_str);
 				break;
 			case ITEM_VALUE_TYPE_LOG:
-				if (SUCCEED != hc_clone_history_log_data(&(*data)->value.log, item_value))
-					return FAIL;
+				log = (zbx_log_value_t *)ptr;
+				ptr += sizeof(zbx_log_value_t);
+
+				log->value = hc_copy_value_str(&ptr, &item_value->value.value_str);
+				log->source = hc_copy_value_str(&ptr, &item_value->source);
+				log->logeventid = item_value->logeventid;
+				log->severity = item_value->severity;
+				log->timestamp = item_value->timestamp;
+
+				(*data)->value.log = log;
 				break;
 			case ITEM_VALUE_TYPE_NONE:
 			default:
@@ -4330,7 +4432,7 @@ static void	hc_add_item_values(dc_item_value_t *values, int values_num)
 {
 	dc_item_value_t	*item_value;
 	int		i;
-	zbx_hc_item_t	*item;
+	zbx_hc_item_t	*item = NULL;
 
 	for (i = 0; i < values_num; i++)
 	{
@@ -4338,9 +4440,14 @@ static void	hc_add_item_values(dc_item_value_t *values, int values_num)
 
 		item_value = &values[i];
 
+		/* values of the same item are often flushed in a row (log items, bulk */
+		/* trapper and agent data), reuse the last item to avoid lookups        */
+		if (NULL == item || item->itemid != item_value->itemid)
+			item = hc_get_item(item_value->itemid);
+
 		/* a record with metadata and no value can be dropped if  */
 		/* the metadata update is copied to the last queued value */
-		if (NULL != (item = hc_get_item(item_value->itemid)) &&
+		if (NULL != item &&
 				0 != (item_value->flags & ZBX_DC_FLAG_NOVALUE) &&
 				0 != (item_value->flags & ZBX_DC_FLAG_META))
 		{
@@ -4457,17 +4564,18 @@ static void	hc_copy_history_data(zbx_dc_history_t *history, zbx_uint64_t itemid,
  * Purpose: pops the next batch of history items from cache for processing    *
  *                                                                            *
  * Parameters: history_items - [OUT] the locked history items                 *
+ *             max_num       - [IN] the maximum number of items to pop        *
  *                                                                            *
  * Comments: The history_items must be returned back to history cache with    *
  *           hc_push_items() function after they have been processed.         *
  *                                                                            *
  ******************************************************************************/
-void	hc_pop_items(zbx_vector_ptr_t *history_items)
+void	hc_pop_items(zbx_vector_ptr_t *history_items, int max_num)
 {
 	zbx_binary_heap_elem_t	*elem;
 	zbx_hc_item_t		*item;
 
-	while (ZBX_HC_SYNC_MAX > history_items->values_num && FAIL == zbx_binary_heap_empty(&cache->history_queue))
+	while (max_num > history_items->values_num && FAIL == zbx_binary_heap_empty(&cache->history_queue))
 	{
 		elem = zbx_binary_heap_find_min(&cache->history_queue);
 		item = (zbx_hc_item_t *)elem->data;
@@ -4477,6 +4585,32 @@ void	hc_pop_items(zbx_vector_ptr_t *history_items)
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adjusts synchronization batch size based on database latency      *
+ *                                                                            *
+ * Parameters: sync_max    - [IN] the current batch size                      *
+ *             history_num - [IN] the number of items synced in last batch    *
+ *             sync_sec    - [IN] the time spent writing last batch           *
+ *                                                                            *
+ * Return value: the batch size to use for the next batch                     *
+ *                                                                            *
+ * Comments: The batch size is halved when database writes take longer than   *
+ *           the target latency and grown slowly back up to ZBX_HC_SYNC_MAX   *
+ *           while full batches are written well within the target.           *
+ *                                                                            *
+ ******************************************************************************/
+int	hc_sync_adjust_max(int sync_max, int history_num, double sync_sec)
+{
+	if (ZBX_HC_SYNC_LATENCY_MAX < sync_sec)
+		return MAX(ZBX_HC_SYNC_MIN, sync_max / 2);
+
+	if (history_num == sync_max && ZBX_HC_SYNC_LATENCY_MAX / 2 > sync_sec)
+		return MIN(ZBX_HC_SYNC_MAX, sync_max + ZBX_HC_SYNC_STEP);
+
+	return sync_max;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: gets item history values                                          *
@@ -4687,6 +4821,7 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 				__hc_index_shmem_free_func);
 
 		cache->proxyqueue.state = ZBX_HC_PROXYQUEUE_STATE_NORMAL;
+		cache->proxyqueue.live_tail = NULL;
 
 		if (SUCCEED != (ret = init_trend_cache(trends_cache_size, error)))
 			goto out;
@@ -4957,16 +5092,31 @@ static zbx_uint64_t	zbx_hc_proxyqueue_peek(void)
  * Purpose: add new proxyid to a queue                                        *
  *                                                                            *
  * Parameters: proxyid   - [IN] the proxy id                                  *
+ *             backlog   - [IN] 1 - the proxy is catching up on backlog,      *
+ *                              0 - otherwise                                 *
+ *                                                                            *
+ * Comments: Proxies without backlog are queued before proxies catching up on *
+ *           backlog, so that large backlog uploads do not delay current data *
+ *           from other proxies.                                              *
  *                                                                            *
  ******************************************************************************/
-static void	zbx_hc_proxyqueue_enqueue(zbx_uint64_t proxyid)
+static void	zbx_hc_proxyqueue_enqueue(zbx_uint64_t proxyid, int backlog)
 {
 	if (NULL == zbx_hashset_search(&cache->proxyqueue.index, &proxyid))
 	{
 		zbx_uint64_t *ptr;
 
 		ptr = zbx_hashset_insert(&cache->proxyqueue.index, &proxyid, sizeof(proxyid));
-		(void)zbx_list_append(&cache->proxyqueue.list, ptr, NULL);
+
+		if (0 != backlog)
+			(void)zbx_list_append(&cache->proxyqueue.list, ptr, NULL);
+		else if (NULL == cache->proxyqueue.live_tail)
+			(void)zbx_list_prepend(&cache->proxyqueue.list, ptr, &cache->proxyqueue.live_tail);
+		else
+		{
+			(void)zbx_list_insert_after(&cache->proxyqueue.list, cache->proxyqueue.live_tail, ptr,
+					&cache->proxyqueue.live_tail);
+		}
 	}
 }
 
@@ -4990,6 +5140,9 @@ static int	zbx_hc_proxyqueue_dequeue(zbx_uint64_t proxyid)
 	if (proxyid != top_val)
 		return FAIL;
 
+	if (cache->proxyqueue.list.head == cache->proxyqueue.live_tail)
+		cache->proxyqueue.live_tail = NULL;
+
 	if (FAIL == zbx_list_pop(&cache->proxyqueue.list, &rem_val))
 		return FAIL;
 
@@ -4998,6 +5151,40 @@ static int	zbx_hc_proxyqueue_dequeue(zbx_uint64_t proxyid)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove proxyid from any position in a proxy queue                 *
+ *                                                                            *
+ * Parameters: proxyid - [IN] the proxy id                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	zbx_hc_proxyqueue_remove(zbx_uint64_t proxyid)
+{
+	zbx_uint64_t		*ptr;
+	zbx_list_iterator_t	iterator;
+
+	if (NULL == (ptr = (zbx_uint64_t *)zbx_hashset_search(&cache->proxyqueue.index, &proxyid)))
+		return;
+
+	if (SUCCEED == zbx_hc_proxyqueue_dequeue(proxyid))
+		return;
+
+	zbx_list_iterator_init(&cache->proxyqueue.list, &iterator);
+
+	while (SUCCEED == zbx_list_iterator_next(&iterator))
+	{
+		if (NULL == iterator.next || ptr != iterator.next->data)
+			continue;
+
+		if (iterator.next == cache->proxyqueue.live_tail)
+			cache->proxyqueue.live_tail = iterator.current;
+
+		(void)zbx_list_iterator_remove_next(&iterator);
+		zbx_hashset_remove_direct(&cache->proxyqueue.index, ptr);
+		break;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: remove all proxies from proxy priority queue                      *
@@ -5007,6 +5194,7 @@ static void	zbx_hc_proxyqueue_clear(void)
 {
 	zbx_list_destroy(&cache->proxyqueue.list);
 	zbx_hashset_clear(&cache->proxyqueue.index);
+	cache->proxyqueue.live_tail = NULL;
 }
 
 /******************************************************************************
@@ -5015,17 +5203,23 @@ static void	zbx_hc_proxyqueue_clear(void)
  *          from priority list and accordingly enable or disable wait mode    *
  *                                                                            *
  * Parameters: proxyid   - [IN] the proxyid                                   *
+ *             backlog   - [IN] 1 - the proxy is catching up on backlog,      *
+ *                              0 - otherwise                                 *
  *                                                                            *
  * Return value: SUCCEED - proxy can be processed now                         *
  *               FAIL    - proxy cannot be processed now, it got enqueued     *
  *                                                                            *
+ * Comments: Proxies catching up on backlog are held back earlier and are let *
+ *           through after the proxies sending current data, so that they do  *
+ *           not fill the history cache at the expense of other proxies.      *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_hc_check_proxy(zbx_uint64_t proxyid)
+int	zbx_hc_check_proxy(zbx_uint64_t proxyid, int backlog)
 {
 	double	hc_pused;
 	int	ret;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxyid:"ZBX_FS_UI64, __func__, proxyid);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxyid:"ZBX_FS_UI64 " backlog:%d", __func__, proxyid, backlog);
 
 	LOCK_CACHE;
 
@@ -5043,7 +5237,7 @@ int	zbx_hc_check_proxy(zbx_uint64_t proxyid)
 
 	if (ZBX_HC_PROXYQUEUE_STATE_WAIT == cache->proxyqueue.state)
 	{
-		zbx_hc_proxyqueue_enqueue(proxyid);
+		zbx_hc_proxyqueue_enqueue(proxyid, backlog);
 
 		if (60 < hc_pused)
 		{
@@ -5058,7 +5252,15 @@ int	zbx_hc_check_proxy(zbx_uint64_t proxyid)
 		if (80 <= hc_pused)
 		{
 			cache->proxyqueue.state = ZBX_HC_PROXYQUEUE_STATE_WAIT;
-			zbx_hc_proxyqueue_enqueue(proxyid);
+			zbx_hc_proxyqueue_enqueue(proxyid, backlog);
+
+			ret = FAIL;
+			goto out;
+		}
+
+		if (0 != backlog && 60 < hc_pused)
+		{
+			zbx_hc_proxyqueue_enqueue(proxyid, backlog);
 
 			ret = FAIL;
 			goto out;
@@ -5071,6 +5273,15 @@ int	zbx_hc_check_proxy(zbx_uint64_t proxyid)
 		goto out;
 	}
 
+	/* proxies without backlog are not held back by queued proxies catching up on backlog, */
+	/* but their own entry queued earlier must not stay in the queue blocking other proxies */
+	if (0 == backlog && NULL == cache->proxyqueue.live_tail)
+	{
+		zbx_hc_proxyqueue_remove(proxyid);
+		ret = SUCCEED;
+		goto out;
+	}
+
 	ret = zbx_hc_proxyqueue_dequeue(proxyid);
 
 out:
@@ -31,10 +31,18 @@
 #define ZBX_HC_TIMER_MAX	(ZBX_HC_SYNC_MAX / 2)
 #define ZBX_HC_TIMER_SOFT_MAX	(ZBX_HC_TIMER_MAX - 10)
 
+/* the minimum number of items in one synchronization batch when database is slow */
+#define ZBX_HC_SYNC_MIN		100
+/* the batch size adjustment step when database keeps up */
+#define ZBX_HC_SYNC_STEP	100
+/* the target time of writing one synchronization batch into database, seconds */
+#define ZBX_HC_SYNC_LATENCY_MAX	1.0
+
 void	dbcache_lock(void);
 void	dbcache_unlock(void);
 
-void	hc_pop_items(zbx_vector_ptr_t *history_items);
+void	hc_pop_items(zbx_vector_ptr_t *history_items, int max_num);
+int	hc_sync_adjust_max(int sync_max, int history_num, double sync_sec);
 void	hc_push_items(zbx_vector_ptr_t *history_items);
 void	hc_get_item_values(zbx_dc_history_t *history, zbx_vector_ptr_t *history_items);
 int	hc_queue_get_size(void);
@@ -205,6 +205,52 @@ static void	dc_add_proxy_history_notsupported(zbx_pb_history_data_t *handle, con
 	zbx_pb_history_write_value(handle, h->itemid, h->state, ZBX_NULL2EMPTY_STR(h->value.err), &h->ts, 0, now);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: mark value-less history records superseded by a later value-less  *
+ *          record of the same item                                           *
+ *                                                                            *
+ * Parameters: history     - [IN] array of history data                       *
+ *             history_num - [IN] number of history structures                *
+ *             skip        - [OUT] 1 for records that must not be buffered,   *
+ *                                 0 otherwise                                *
+ *                                                                            *
+ * Comments: Values discarded by throttling preprocessing steps are buffered  *
+ *           as records without value and metadata only to update item queue  *
+ *           on server. Only the latest of such records per item is sent to   *
+ *           server anyway, see pb_history_export(), so the earlier ones are  *
+ *           dropped before they are written to proxy buffer.                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_proxy_history_skip_novalue(const zbx_dc_history_t *history, int history_num, unsigned char *skip)
+{
+	int		i;
+	zbx_hashset_t	itemids;
+
+	zbx_hashset_create(&itemids, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	for (i = history_num - 1; i >= 0; i--)
+	{
+		const zbx_dc_history_t	*h = &history[i];
+
+		skip[i] = 0;
+
+		if (ITEM_STATE_NOTSUPPORTED == h->state || ITEM_VALUE_TYPE_LOG == h->value_type ||
+				ZBX_DC_FLAG_NOVALUE != (h->flags & (ZBX_DC_FLAG_NOVALUE | ZBX_DC_FLAG_META |
+				ZBX_DC_FLAG_UNDEF)))
+		{
+			continue;
+		}
+
+		if (NULL != zbx_hashset_search(&itemids, &h->itemid))
+			skip[i] = 1;
+		else
+			zbx_hashset_insert(&itemids, &h->itemid, sizeof(h->itemid));
+	}
+
+	zbx_hashset_destroy(&itemids);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: inserting new history data after new value is received            *
@@ -218,17 +264,24 @@ static void	DBmass_proxy_add_history(zbx_dc_history_t *history, int history_num)
 	int			i;
 	zbx_pb_history_data_t	*handle;
 	time_t			now;
+	unsigned char		*skip;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	now = time(NULL);
 
+	skip = (unsigned char *)zbx_malloc(NULL, (size_t)history_num);
+	dc_proxy_history_skip_novalue(history, history_num, skip);
+
 	handle = zbx_pb_history_open();
 
 	for (i = 0; i < history_num; i++)
 	{
 		const zbx_dc_history_t	*h = &history[i];
 
+		if (0 != skip[i])
+			continue;
+
 		if (ITEM_STATE_NOTSUPPORTED == h->state)
 		{
 			dc_add_proxy_history_notsupported(handle, h, now);
@@ -263,6 +316,7 @@ static void	DBmass_proxy_add_history(zbx_dc_history_t *history, int history_num)
 	}
 
 	zbx_pb_history_close(handle);
+	zbx_free(skip);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -373,7 +427,9 @@ void	zbx_sync_proxy_history(int *values_num, int *triggers_num, const zbx_events
 	ZBX_UNUSED(triggers_num);
 	ZBX_UNUSED(events_cbs);
 
+	static int		sync_max = ZBX_HC_SYNC_MAX;
 	int			history_num, txn_rc;
+	double			sync_sec;
 	time_t			sync_start;
 	zbx_vector_ptr_t	history_items;
 	zbx_vector_ptr_t	item_diff;
@@ -391,7 +447,7 @@ void	zbx_sync_proxy_history(int *values_num, int *triggers_num, const zbx_events
 
 		dbcache_lock();
 
-		hc_pop_items(&history_items);		/* select and take items out of history cache */
+		hc_pop_items(&history_items, sync_max);	/* select and take items out of history cache */
 		history_num = history_items.values_num;
 
 		dbcache_unlock();
@@ -403,6 +459,8 @@ void	zbx_sync_proxy_history(int *values_num, int *triggers_num, const zbx_events
 		proxy_prepare_history(history, history_items.values_num);
 
 		DCmass_proxy_prepare_itemdiff(history, history_num, &item_diff);
+
+		sync_sec = zbx_time();
 		DBmass_proxy_add_history(history, history_num);
 
 		if (0 != item_diff.values_num)
@@ -415,6 +473,8 @@ void	zbx_sync_proxy_history(int *values_num, int *triggers_num, const zbx_events
 			while (ZBX_DB_DOWN == (txn_rc = zbx_db_commit()));
 		}
 
+		sync_max = hc_sync_adjust_max(sync_max, history_num, zbx_time() - sync_sec);
+
 		dbcache_lock();
 
 		hc_push_items(&history_items);	/* return items to history cache */
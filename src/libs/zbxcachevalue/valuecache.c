@@ -43,6 +43,8 @@
  * In low memory mode cache continues to function as before with few restrictions:
  *   1) items that weren't accessed during the last day are removed from cache.
  *   2) items with worst hits/values ratio might be removed from cache to free the space.
+ *      The hits of the remaining items are halved after each such removal, so that items
+ *      hot in the past but no longer used are removed before currently used items.
  *   3) no new items are added to the cache.
  *
  * The low memory mode can't be turned off - it will persist until server is rebooted.
@@ -167,9 +169,13 @@ typedef struct
 
 	/* The number of cache hits for this item.                    */
 	/* Used to evaluate if the item must be dropped from cache    */
-	/* in low memory situation.                                   */
+	/* in low memory situation. Halved every time items are       */
+	/* dropped to free space.                                     */
 	zbx_uint64_t	hits;
 
+	/* The number of values read from database for this item.     */
+	zbx_uint64_t	misses;
+
 	/* the last (newest) chunk of item history data               */
 	zbx_vc_chunk_t	*head;
 
@@ -644,8 +650,8 @@ static void	vc_history_record_vector_clean(zbx_vector_history_record_t *vector,
  *             hits    - [IN] the number of hits to add                       *
  *             misses  - [IN] the number of misses to add                     *
  *                                                                            *
- * Comments: The misses are added only to cache statistics, while hits are    *
- *           added to both - item and cache statistics.                       *
+ * Comments: The hits and misses are added to both - item and cache           *
+ *           statistics.                                                      *
  *                                                                            *
  ******************************************************************************/
 static void	vc_update_statistics(zbx_vc_item_t *item, int hits, int misses, int now)
@@ -655,6 +661,7 @@ static void	vc_update_statistics(zbx_vc_item_t *item, int hits, int misses, int
 		int	hour;
 
 		item->hits += (zbx_uint64_t)hits;
+		item->misses += (zbx_uint64_t)misses;
 		item->last_accessed = now;
 
 		hour = item->last_accessed / SEC_PER_HOUR;
@@ -866,6 +873,11 @@ static void	vc_release_space(zbx_vc_item_t *source_item, size_t space)
 		freed += vch_item_free_cache(item) + sizeof(zbx_vc_item_t);
 		zbx_hashset_remove_direct(&vc_cache->items, item);
 	}
+
+	/* age hits of the remaining items so that weights reflect recent usage */
+	for (; i < items.values_num; i++)
+		items.values[i].item->hits /= 2;
+
 	zbx_vector_vc_itemweight_destroy(&items);
 }
 
@@ -920,6 +932,39 @@ static void	vc_history_record_vector_append(zbx_vector_history_record_t *vector,
 	zbx_vector_history_record_append_ptr(vector, &record);
 }
 
+/* the history record consumer used when retrieving item values */
+typedef struct
+{
+	zbx_vc_fold_func_t	fold_func;
+	void			*data;
+	int			values_num;
+	zbx_timespec_t		last_ts;	/* the timestamp of the last consumed record */
+}
+zbx_vc_fold_t;
+
+/* the vector based record consumer used by zbx_vc_get_values() */
+typedef struct
+{
+	zbx_vector_history_record_t	*values;
+	int				value_type;
+}
+zbx_vc_fold_vector_t;
+
+static void	vc_fold_vector_append(const zbx_history_record_t *record, void *data)
+{
+	zbx_vc_fold_vector_t	*fold_vector = (zbx_vc_fold_vector_t *)data;
+
+	vc_history_record_vector_append(fold_vector->values, fold_vector->value_type,
+			(zbx_history_record_t *)record);
+}
+
+static void	vc_fold_record(zbx_vc_fold_t *fold, const zbx_history_record_t *record)
+{
+	fold->fold_func(record, fold->data);
+	fold->last_ts = record->timestamp;
+	fold->values_num++;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: allocate cache memory to store item's resources                   *
@@ -2143,13 +2188,13 @@ out:
  * Purpose: retrieves item history data from cache                            *
  *                                                                            *
  * Parameters: item      - [IN] the item                                      *
- *             values    - [OUT] the item history data stored time/value      *
- *                         pairs in undefined order                           *
+ *             fold      - [IN/OUT] the consumer of item history records,     *
+ *                         records are passed in descending order             *
  *             seconds   - [IN] the time period to retrieve data for          *
  *             ts        - [IN] the requested period end timestamp            *
  *                                                                            *
  ******************************************************************************/
-static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
+static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vc_fold_t *fold, int seconds,
 		const zbx_timespec_t *ts)
 {
 	int		index, now;
@@ -2177,7 +2222,7 @@ static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_hi
 	while (0 < zbx_timespec_compare(&chunk->slots[chunk->last_value].timestamp, &start))
 	{
 		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&chunk->slots[index].timestamp, &start))
-			vc_history_record_vector_append(values, item->value_type, &chunk->slots[index--]);
+			vc_fold_record(fold, &chunk->slots[index--]);
 
 		if (NULL == (chunk = chunk->prev))
 			break;
@@ -2191,18 +2236,15 @@ static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_hi
  * Purpose: retrieves item history data from cache                            *
  *                                                                            *
  * Parameters: item      - [IN] the item                                      *
- *             values    - [OUT] the item history data stored time/value      *
- *                         pairs in undefined order, optional                 *
- *                         If null then cache is updated if necessary, but no *
- *                         values are returned. Used to ensure that cache     *
- *                         contains a value of the specified timestamp.       *
+ *             fold      - [IN/OUT] the consumer of item history records,     *
+ *                         records are passed in descending order             *
  *             seconds   - [IN] the time period                               *
  *             count     - [IN] the number of history values to retrieve      *
  *             timestamp - [IN] the target timestamp                          *
  *                                                                            *
  ******************************************************************************/
-static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vector_history_record_t *values,
-		int seconds, int count, const zbx_timespec_t *ts)
+static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vc_fold_t *fold, int seconds,
+		int count, const zbx_timespec_t *ts)
 {
 	int		index, now, range_timestamp;
 	zbx_vc_chunk_t	*chunk;
@@ -2233,9 +2275,9 @@ static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vecto
 	{
 		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&chunk->slots[index].timestamp, &start))
 		{
-			vc_history_record_vector_append(values, item->value_type, &chunk->slots[index--]);
+			vc_fold_record(fold, &chunk->slots[index--]);
 
-			if (values->values_num == count)
+			if (fold->values_num == count)
 				goto out;
 		}
 
@@ -2245,7 +2287,7 @@ static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vecto
 		index = chunk->last_value;
 	}
 out:
-	if (count > values->values_num)
+	if (count > fold->values_num)
 	{
 		if (0 == seconds)
 			return;
@@ -2257,7 +2299,7 @@ out:
 	else
 	{
 		/* the requested number of values was retrieved, set the range to the oldest value timestamp */
-		range_timestamp = values->values[values->values_num - 1].timestamp.sec - 1;
+		range_timestamp = fold->last_ts.sec - 1;
 	}
 
 	now = (int)time(NULL);
@@ -2269,11 +2311,7 @@ out:
  * Purpose: get item values for the specified range                           *
  *                                                                            *
  * Parameters: item      - [IN] the item                                      *
- *             values    - [OUT] the item history data stored time/value      *
- *                         pairs in undefined order, optional                 *
- *                         If null then cache is updated if necessary, but no *
- *                         values are returned. Used to ensure that cache     *
- *                         contains a value of the specified timestamp.       *
+ *             fold      - [IN/OUT] the consumer of item history records     *
  *             seconds   - [IN] the time period to retrieve data for          *
  *             count     - [IN] the number of history values to retrieve      *
  *             ts        - [IN] the target timestamp                          *
@@ -2290,13 +2328,11 @@ out:
  *           seconds before <timestamp>.                                      *
  *                                                                            *
  ******************************************************************************/
-static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
-		int count, const zbx_timespec_t *ts)
+static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vc_fold_t *fold, int seconds, int count,
+		const zbx_timespec_t *ts)
 {
 	int	ret, records_read, hits, misses, range_start;
 
-	zbx_vector_history_record_clear(values);
-
 	if (0 == count)
 	{
 		if (0 > (range_start = ts->sec - seconds))
@@ -2307,10 +2343,10 @@ static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t
 
 		records_read = ret;
 
-		vch_item_get_values_by_time(item, values, seconds, ts);
+		vch_item_get_values_by_time(item, fold, seconds, ts);
 
-		if (records_read > values->values_num)
-			records_read = values->values_num;
+		if (records_read > fold->values_num)
+			records_read = fold->values_num;
 	}
 	else
 	{
@@ -2321,13 +2357,13 @@ static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t
 
 		records_read = ret;
 
-		vch_item_get_values_by_time_and_count(item, values, seconds, count, ts);
+		vch_item_get_values_by_time_and_count(item, fold, seconds, count, ts);
 
-		if (records_read > values->values_num)
-			records_read = values->values_num;
+		if (records_read > fold->values_num)
+			records_read = fold->values_num;
 	}
 
-	hits = values->values_num - records_read;
+	hits = fold->values_num - records_read;
 	misses = records_read;
 
 	vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_STATS, hits, misses);
@@ -2527,6 +2563,7 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 	zbx_vc_item_t		*item;
 	int			i;
 	zbx_dc_history_t	*h;
+	zbx_vector_ptr_t	cached;
 
 	if (SUCCEED != zbx_history_add_values(history, ret_flush))
 		return FAIL;
@@ -2534,12 +2571,31 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 	if (ZBX_VC_DISABLED == vc_state)
 		return SUCCEED;
 
-	WRLOCK_CACHE;
+	zbx_vector_ptr_create(&cached);
+
+	/* find values of cached items under read lock, so that batches without */
+	/* cached items do not block value cache readers                         */
+	RDLOCK_CACHE;
 
 	for (i = 0; i < history->values_num; i++)
 	{
 		h = (zbx_dc_history_t *)history->values[i];
 
+		if (NULL != zbx_hashset_search(&vc_cache->items, &h->itemid))
+			zbx_vector_ptr_append(&cached, h);
+	}
+
+	UNLOCK_CACHE;
+
+	if (0 == cached.values_num)
+		goto out;
+
+	WRLOCK_CACHE;
+
+	for (i = 0; i < cached.values_num; i++)
+	{
+		h = (zbx_dc_history_t *)cached.values[i];
+
 		if (NULL != (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &h->itemid)))
 		{
 			zbx_history_record_t	record = {h->ts, h->value};
@@ -2570,6 +2626,8 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 	}
 
 	UNLOCK_CACHE;
+out:
+	zbx_vector_ptr_destroy(&cached);
 
 	return SUCCEED;
 }
@@ -2580,8 +2638,10 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
  *                                                                            *
  * Parameters: itemid     - [IN] the item id                                  *
  *             value_type - [IN] the item value type                          *
- *             values     - [OUT] the item history data stored time/value     *
- *                          pairs in descending order                         *
+ *             fold       - [IN/OUT] the consumer of cached history records   *
+ *             db_values  - [OUT] the item history data read directly from    *
+ *                          database in descending order, when item values    *
+ *                          could not be retrieved from cache                 *
  *             seconds    - [IN] the time period to retrieve data for         *
  *             count      - [IN] the number of history values to retrieve     *
  *             ts         - [IN] the period end timestamp                     *
@@ -2597,8 +2657,8 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
  *           seconds before <timestamp>.                                      *
  *                                                                            *
  ******************************************************************************/
-int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_history_record_t *values,
-		int seconds, int count, const zbx_timespec_t *ts)
+static int	vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vc_fold_t *fold,
+		zbx_vector_history_record_t *db_values, int seconds, int count, const zbx_timespec_t *ts)
 {
 	zbx_vc_item_t	*item, new_item;
 	int 		ret = FAIL, cache_used = 1;
@@ -2627,27 +2687,107 @@ int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_
 	else if (item->value_type != value_type)
 		goto out;
 
-	ret = vch_item_get_values(item, values, seconds, count, ts);
+	ret = vch_item_get_values(item, fold, seconds, count, ts);
 out:
 	if (FAIL == ret)
 	{
 		cache_used = 0;
 
 		UNLOCK_CACHE;
-		ret = vc_db_get_values(itemid, value_type, values, seconds, count, ts);
+		ret = vc_db_get_values(itemid, value_type, db_values, seconds, count, ts);
 		WRLOCK_CACHE;
 
 		if (ZBX_VC_DISABLED != vc_state)
 			vc_remove_item_by_id(itemid);
 
 		if (SUCCEED == ret)
-			vc_update_statistics(NULL, 0, values->values_num, (int)time(NULL));
+			vc_update_statistics(NULL, 0, db_values->values_num, (int)time(NULL));
 	}
 
 	UNLOCK_CACHE;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s count:%d cached:%d",
-			__func__, zbx_result_string(ret), values->values_num, cache_used);
+			__func__, zbx_result_string(ret), 0 != cache_used ? fold->values_num : db_values->values_num,
+			cache_used);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get item history data for the specified time period               *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the item id                                  *
+ *             value_type - [IN] the item value type                          *
+ *             values     - [OUT] the item history data stored time/value     *
+ *                          pairs in descending order                         *
+ *             seconds    - [IN] the time period to retrieve data for         *
+ *             count      - [IN] the number of history values to retrieve     *
+ *             ts         - [IN] the period end timestamp                     *
+ *                                                                            *
+ * Return value:  SUCCEED - the item history data was retrieved successfully  *
+ *                FAIL    - the item history data was not retrieved           *
+ *                                                                            *
+ * Comments: If the data is not in cache, it's read from DB, so this function *
+ *           will always return the requested data, unless some error occurs. *
+ *                                                                            *
+ *           If <count> is set then value range is defined as <count> values  *
+ *           before <timestamp>. Otherwise the range is defined as <seconds>  *
+ *           seconds before <timestamp>.                                      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_history_record_t *values,
+		int seconds, int count, const zbx_timespec_t *ts)
+{
+	zbx_vc_fold_vector_t	fold_vector = {.values = values, .value_type = value_type};
+	zbx_vc_fold_t		fold = {.fold_func = vc_fold_vector_append, .data = &fold_vector};
+
+	zbx_vector_history_record_clear(values);
+
+	return vc_get_values(itemid, value_type, &fold, values, seconds, count, ts);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pass item history data for the specified time period to callback *
+ *          function without copying it                                       *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the item id                                  *
+ *             value_type - [IN] the item value type                          *
+ *             seconds    - [IN] the time period to retrieve data for         *
+ *             count      - [IN] the number of history values to retrieve     *
+ *             ts         - [IN] the period end timestamp                     *
+ *             fold_func  - [IN] the callback function, called for each      *
+ *                               history record in descending order           *
+ *             data       - [IN] the callback data                            *
+ *                                                                            *
+ * Return value:  SUCCEED - the item history data was retrieved successfully  *
+ *                FAIL    - the item history data was not retrieved           *
+ *                                                                            *
+ * Comments: The callback is called with value cache locked, so it must not   *
+ *           access value cache or keep references to the passed records.     *
+ *           The request range is defined in the same way as for              *
+ *           zbx_vc_get_values() and the callback receives the same records   *
+ *           as would be returned by it.                                      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_vc_fold_values(zbx_uint64_t itemid, unsigned char value_type, int seconds, int count,
+		const zbx_timespec_t *ts, zbx_vc_fold_func_t fold_func, void *data)
+{
+	zbx_vc_fold_t			fold = {.fold_func = fold_func, .data = data};
+	zbx_vector_history_record_t	db_values;
+	int				i, ret;
+
+	zbx_history_record_vector_create(&db_values);
+
+	if (SUCCEED == (ret = vc_get_values(itemid, value_type, &fold, &db_values, seconds, count, ts)))
+	{
+		/* pass values that were read directly from database bypassing cache */
+		for (i = 0; i < db_values.values_num; i++)
+			vc_fold_record(&fold, &db_values.values[i]);
+	}
+
+	zbx_history_record_vector_destroy(&db_values, value_type);
 
 	return ret;
 }
@@ -2793,12 +2933,72 @@ void	zbx_vc_get_mem_stats(zbx_shmem_stats_t *mem)
 	UNLOCK_CACHE;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get size of cached string, shared strings are divided between     *
+ *          their users                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	vc_item_str_size(const char *str)
+{
+	if (NULL == str)
+		return 0;
+
+	return (strlen(str) + REFCOUNT_FIELD_SIZE + 1) / *(const zbx_uint32_t *)(str - REFCOUNT_FIELD_SIZE);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get approximate value cache memory used by item                   *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	vch_item_get_size(const zbx_vc_item_t *item)
+{
+	size_t			size = sizeof(zbx_vc_item_t);
+	const zbx_vc_chunk_t	*chunk;
+	int			i;
+
+	for (chunk = item->tail; NULL != chunk; chunk = chunk->next)
+	{
+		size += sizeof(zbx_vc_chunk_t) + (size_t)(chunk->slots_num - 1) * sizeof(zbx_history_record_t);
+
+		switch (item->value_type)
+		{
+			case ITEM_VALUE_TYPE_STR:
+			case ITEM_VALUE_TYPE_TEXT:
+				for (i = chunk->first_value; i <= chunk->last_value; i++)
+					size += vc_item_str_size(chunk->slots[i].value.str);
+				break;
+			case ITEM_VALUE_TYPE_LOG:
+				for (i = chunk->first_value; i <= chunk->last_value; i++)
+				{
+					const zbx_log_value_t	*log = chunk->slots[i].value.log;
+
+					if (NULL == log)
+						continue;
+
+					size += sizeof(zbx_log_value_t) + vc_item_str_size(log->source) +
+							vc_item_str_size(log->value);
+				}
+				break;
+		}
+	}
+
+	return size;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get statistics of cached items                                    *
  *                                                                            *
+ * Parameters: stats    - [OUT] the item statistics                           *
+ *             get_size - [IN] 1 - calculate memory used by items, 0 - skip   *
+ *                                                                            *
+ * Comments: Calculating item size walks all cached values while the cache is *
+ *           locked, so it is done only when requested.                       *
+ *                                                                            *
  ******************************************************************************/
-void	zbx_vc_get_item_stats(zbx_vector_ptr_t *stats)
+void	zbx_vc_get_item_stats(zbx_vector_ptr_t *stats, int get_size)
 {
 	zbx_hashset_iter_t	iter;
 	zbx_vc_item_t		*item;
@@ -2818,6 +3018,9 @@ void	zbx_vc_get_item_stats(zbx_vector_ptr_t *stats)
 		item_stats->itemid = item->itemid;
 		item_stats->values_num = item->values_total;
 		item_stats->hourly_num = item->last_hourly_num;
+		item_stats->hits = item->hits;
+		item_stats->misses = item->misses;
+		item_stats->size = (0 != get_size ? vch_item_get_size(item) : 0);
 		zbx_vector_ptr_append(stats, item_stats);
 	}
 
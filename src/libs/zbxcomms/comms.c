@@ -505,6 +505,21 @@ int	zbx_socket_connect(zbx_socket_t *s, int type, const char *source_ip, const c
 		goto out;
 	}
 
+#if defined(IPPROTO_TCP) && defined(TCP_FASTOPEN_CONNECT)
+	if (SOCK_STREAM == type)
+	{
+		int	on = 1;
+
+		/* defer SYN until the first write so that the request can be sent together with it when */
+		/* peer has granted Fast Open cookie, saving a round trip on short-lived connections      */
+		if (ZBX_PROTO_ERROR == setsockopt(s->socket, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, (void *)&on,
+				sizeof(on)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "setsockopt() with TCP_FASTOPEN_CONNECT for [[%s]:%hu] failed: %s",
+					ip, port, zbx_strerror_from_system(zbx_socket_last_error()));
+		}
+	}
+#endif
 	if (ZBX_PROTO_ERROR == connect(s->socket, ai->ai_addr, ai->ai_addrlen) &&
 			SUCCEED != zbx_socket_had_nonblocking_error())
 	{
@@ -725,6 +740,16 @@ ssize_t	zbx_tcp_write(zbx_socket_t *s, const char *buf, size_t len, short *event
 #define ZBX_TCP_HEADER_DATA	"ZBXD"
 #define ZBX_TCP_HEADER_LEN	ZBX_CONST_STRLEN(ZBX_TCP_HEADER_DATA)
 
+#define ZBX_TCP_COMPRESS_METHOD(flags)	\
+		(0 != ((flags) & ZBX_TCP_ZSTD) ? ZBX_COMPRESS_METHOD_ZSTD : ZBX_COMPRESS_METHOD_ZLIB)
+
+/* zstd compressed messages are accepted only if they can be uncompressed */
+#ifdef HAVE_ZSTD
+#	define ZBX_TCP_ZSTD_ACCEPT	ZBX_TCP_ZSTD
+#else
+#	define ZBX_TCP_ZSTD_ACCEPT	0
+#endif
+
 int	zbx_tcp_send_context_init(const char *data, size_t len, size_t reserved, unsigned char flags,
 		zbx_tcp_send_context_t *context)
 {
@@ -761,7 +786,8 @@ int	zbx_tcp_send_context_init(const char *data, size_t len, size_t reserved, uns
 		/* compress if not compressed yet */
 		if (0 == reserved)
 		{
-			if (SUCCEED != zbx_compress(data, len, &context->compressed_data, &context->send_len))
+			if (SUCCEED != zbx_compress_ext(data, len, &context->compressed_data, &context->send_len,
+					ZBX_TCP_COMPRESS_METHOD(flags)))
 			{
 				zbx_set_socket_strerror("cannot compress data: %s", zbx_compress_strerror());
 
@@ -1425,6 +1451,28 @@ int	zbx_tcp_listen(zbx_socket_t *s, const char *listen_ip, unsigned short listen
 					goto out;
 			}
 
+#if defined(IPPROTO_TCP) && defined(TCP_DEFER_ACCEPT)
+			/* clients always send first, do not wake up a process to accept a connection */
+			/* and then wait in receive until the client has actually sent some data      */
+			if (ZBX_PROTO_ERROR == setsockopt(s->sockets[s->num_socks], IPPROTO_TCP, TCP_DEFER_ACCEPT,
+					(void *)&timeout, sizeof(timeout)))
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "setsockopt() with TCP_DEFER_ACCEPT for [[%s]:%s] failed: %s",
+						NULL != ip ? ip : "-", port,
+						zbx_strerror_from_system(zbx_socket_last_error()));
+			}
+#endif
+#if defined(IPPROTO_TCP) && defined(TCP_FASTOPEN) && !defined(_WINDOWS)
+			/* accept requests carried in SYN from clients with a valid Fast Open cookie, */
+			/* takes effect only when server side Fast Open is enabled in the kernel      */
+			if (ZBX_PROTO_ERROR == setsockopt(s->sockets[s->num_socks], IPPROTO_TCP, TCP_FASTOPEN,
+					(void *)&CONFIG_TCP_MAX_BACKLOG_SIZE, sizeof(CONFIG_TCP_MAX_BACKLOG_SIZE)))
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "setsockopt() with TCP_FASTOPEN for [[%s]:%s] failed: %s",
+						NULL != ip ? ip : "-", port,
+						zbx_strerror_from_system(zbx_socket_last_error()));
+			}
+#endif
 			if (ZBX_PROTO_ERROR == listen(s->sockets[s->num_socks], CONFIG_TCP_MAX_BACKLOG_SIZE))
 			{
 				zbx_set_socket_strerror("listen() for [[%s]:%s] failed: %s",
@@ -1887,6 +1935,8 @@ int	zbx_socket_check_deadline(zbx_socket_t *s)
 #define ZBX_TCP_EXPECT_LENGTH		4
 #define ZBX_TCP_EXPECT_SIZE		5
 
+#define ZBX_TCP_UNCOMPRESS_STREAM_MIN	(64 * ZBX_KIBIBYTE)
+
 void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv_context, unsigned char flags)
 {
 	tcp_recv_context->buf_dyn_bytes = 0;
@@ -1895,6 +1945,7 @@ void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv
 	tcp_recv_context->expected_len = 16 * ZBX_MEBIBYTE;
 	tcp_recv_context->reserved = 0;
 	tcp_recv_context->expect = ZBX_TCP_EXPECT_HEADER;
+	tcp_recv_context->uncompress = NULL;
 #if defined(_WINDOWS)
 	tcp_recv_context->max_len = ZBX_MAX_RECV_DATA_SIZE;
 #else
@@ -1925,7 +1976,19 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 		else
 		{
 			if (context->buf_dyn_bytes + (size_t)nbytes <= context->expected_len)
-				memcpy(s->buffer + context->buf_dyn_bytes, s->buf_stat, (size_t)nbytes);
+			{
+				if (NULL == context->uncompress)
+				{
+					memcpy(s->buffer + context->buf_dyn_bytes, s->buf_stat, (size_t)nbytes);
+				}
+				else if (SUCCEED != zbx_uncompress_stream(context->uncompress, s->buf_stat,
+						(size_t)nbytes))
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+			}
 			context->buf_dyn_bytes += (size_t)nbytes;
 		}
 
@@ -1963,7 +2026,8 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 			context->protocol_version = s->buf_stat[ZBX_TCP_HEADER_LEN];
 
 			if (0 == (context->protocol_version & ZBX_TCP_PROTOCOL) ||
-					context->protocol_version > (ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS | flags))
+					0 != (context->protocol_version & ~(ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS |
+					ZBX_TCP_ZSTD_ACCEPT | flags)))
 			{
 				/* invalid protocol version, abort receiving */
 				break;
@@ -2030,6 +2094,28 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 				context->buf_stat_bytes -= context->offset;
 				memmove(s->buf_stat, s->buf_stat + context->offset, context->buf_stat_bytes);
 			}
+			else if (NULL == events && ZBX_TCP_COMPRESS == (context->protocol_version &
+					(ZBX_TCP_COMPRESS | ZBX_TCP_ZSTD)) &&
+					ZBX_TCP_UNCOMPRESS_STREAM_MIN <= context->expected_len)
+			{
+				/* uncompress large messages while receiving them instead of keeping the whole */
+				/* compressed message in memory next to the uncompressed one; asynchronous     */
+				/* receiving is left as is, it can be abandoned without a chance to clean up   */
+				s->buf_type = ZBX_BUF_TYPE_DYN;
+				s->buffer = (char *)zbx_malloc(NULL, context->reserved + 1);
+				context->buf_dyn_bytes = context->buf_stat_bytes - context->offset;
+				context->buf_stat_bytes = 0;
+
+				if (SUCCEED != zbx_uncompress_stream_init(&context->uncompress, s->buffer,
+						context->reserved) ||
+						SUCCEED != zbx_uncompress_stream(context->uncompress,
+						s->buf_stat + context->offset, context->buf_dyn_bytes))
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+			}
 			else
 			{
 				s->buf_type = ZBX_BUF_TYPE_DYN;
@@ -2050,14 +2136,35 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 	{
 		if (context->buf_stat_bytes + context->buf_dyn_bytes == context->expected_len)
 		{
-			if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
+			if (NULL != context->uncompress)
+			{
+				size_t	out_size;
+
+				if (FAIL == zbx_uncompress_stream_finish(context->uncompress, &out_size))
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+
+				if (out_size != context->reserved)
+				{
+					zbx_set_socket_strerror("size of uncompressed data is less than expected");
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+
+				s->read_bytes = context->reserved;
+			}
+			else if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
 			{
 				char	*out;
 				size_t	out_size = context->reserved;
 
 				out = (char *)zbx_malloc(NULL, context->reserved + 1);
-				if (FAIL == zbx_uncompress(s->buffer, context->buf_stat_bytes + context->buf_dyn_bytes,
-						out, &out_size))
+				if (FAIL == zbx_uncompress_ext(s->buffer, context->buf_stat_bytes +
+						context->buf_dyn_bytes, out, &out_size,
+						ZBX_TCP_COMPRESS_METHOD(context->protocol_version)))
 				{
 					zbx_free(out);
 					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
@@ -2137,11 +2244,18 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 		s->buffer[s->read_bytes] = '\0';
 	}
 out:
+	if (NULL != context->uncompress)
+	{
+		zbx_uncompress_stream_free(context->uncompress);
+		context->uncompress = NULL;
+	}
+
 	return (ZBX_PROTO_ERROR == nbytes ? FAIL : (ssize_t)(s->read_bytes + context->offset));
 
 #undef ZBX_TCP_EXPECT_HEADER
 #undef ZBX_TCP_EXPECT_LENGTH
 #undef ZBX_TCP_EXPECT_SIZE
+#undef ZBX_TCP_UNCOMPRESS_STREAM_MIN
 }
 
 /******************************************************************************
@@ -2432,6 +2546,37 @@ int	zbx_validate_peer_list(const char *peer_list, char **error)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if connection initiator matches any of resolved addresses   *
+ *                                                                            *
+ * Parameters: s           - [IN] socket descriptor                           *
+ *             ai          - [IN] resolved addresses of allowed peer          *
+ *             prefix_size - [IN] CIDR prefix size or -1 to match the whole   *
+ *                                address                                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	peer_addrinfo_match(const zbx_socket_t *s, const struct addrinfo *ai, int prefix_size)
+{
+	const struct addrinfo	*current_ai;
+
+	for (current_ai = ai; NULL != current_ai; current_ai = current_ai->ai_next)
+	{
+		int	prefix_size_current = prefix_size;
+
+		if (-1 == prefix_size_current)
+		{
+			prefix_size_current = (current_ai->ai_family == AF_INET ?
+					ZBX_IPV4_MAX_CIDR_PREFIX : ZBX_IPV6_MAX_CIDR_PREFIX);
+		}
+
+		if (SUCCEED == zbx_ip_cmp((unsigned int)prefix_size_current, current_ai, s->peer_info, 0))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: check if connection initiator is in list of peers                 *
@@ -2459,7 +2604,7 @@ int	zbx_tcp_check_allowed_peers(const zbx_socket_t *s, const char *peer_list)
 
 	for (start = tmp; '\0' != *start;)
 	{
-		struct addrinfo	hints, *ai = NULL, *current_ai;
+		struct addrinfo	hints, *ai = NULL;
 
 		prefix_size = -1;
 
@@ -2482,24 +2627,98 @@ int	zbx_tcp_check_allowed_peers(const zbx_socket_t *s, const char *peer_list)
 
 		if (0 == getaddrinfo(start, NULL, &hints, &ai))
 		{
-			for (current_ai = ai; NULL != current_ai; current_ai = current_ai->ai_next)
+			if (SUCCEED == peer_addrinfo_match(s, ai, prefix_size))
 			{
-				int	prefix_size_current = prefix_size;
+				freeaddrinfo(ai);
+				return SUCCEED;
+			}
+			freeaddrinfo(ai);
+		}
 
-				if (-1 == prefix_size_current)
-				{
-					prefix_size_current = (current_ai->ai_family == AF_INET ?
-							ZBX_IPV4_MAX_CIDR_PREFIX : ZBX_IPV6_MAX_CIDR_PREFIX);
-				}
+		if (NULL != end)
+			start = end + 1;
+		else
+			break;
+	}
 
-				if (SUCCEED == zbx_ip_cmp((unsigned int)prefix_size_current, current_ai, s->peer_info,
-						0))
-				{
-					freeaddrinfo(ai);
-					return SUCCEED;
-				}
+	zbx_set_socket_strerror("connection from \"%s\" rejected, allowed hosts: \"%s\"", s->peer, peer_list);
+
+	return FAIL;
+}
+
+typedef struct
+{
+	struct addrinfo	*ai;
+	int		prefix_size;
+}
+zbx_allowed_peer_t;
+
+static ZBX_THREAD_LOCAL char			*allowed_peers_list = NULL;
+static ZBX_THREAD_LOCAL zbx_allowed_peer_t	*allowed_peers = NULL;
+static ZBX_THREAD_LOCAL int			allowed_peers_num = 0, allowed_peers_alloc = 0;
+static ZBX_THREAD_LOCAL time_t			allowed_peers_time = 0;
+
+static void	allowed_peers_clear(void)
+{
+	int	i;
+
+	for (i = 0; i < allowed_peers_num; i++)
+		freeaddrinfo(allowed_peers[i].ai);
+
+	allowed_peers_num = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resolve list of allowed peers into cache                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	allowed_peers_resolve(const char *peer_list, time_t now)
+{
+	char	*start, *end, *cidr_sep, tmp[MAX_STRING_LEN];
+
+	allowed_peers_clear();
+
+	if (NULL == allowed_peers_list || 0 != strcmp(allowed_peers_list, peer_list))
+		allowed_peers_list = zbx_strdup(allowed_peers_list, peer_list);
+
+	allowed_peers_time = now;
+
+	zbx_strscpy(tmp, peer_list);
+
+	for (start = tmp; '\0' != *start;)
+	{
+		struct addrinfo	hints, *ai = NULL;
+		int		prefix_size = -1;
+
+		if (NULL != (end = strchr(start, ',')))
+			*end = '\0';
+
+		if (NULL != (cidr_sep = strchr(start, '/')))
+		{
+			*cidr_sep = '\0';
+
+			/* validate_cidr() may overwrite 'prefix_size' */
+			if (SUCCEED != validate_cidr(start, cidr_sep + 1, &prefix_size))
+				*cidr_sep = '/';	/* CIDR is only supported for IP */
+		}
+
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_protocol = IPPROTO_TCP;
+
+		if (0 == getaddrinfo(start, NULL, &hints, &ai))
+		{
+			if (allowed_peers_num == allowed_peers_alloc)
+			{
+				allowed_peers_alloc = (0 == allowed_peers_alloc ? 8 : allowed_peers_alloc * 2);
+				allowed_peers = (zbx_allowed_peer_t *)zbx_realloc(allowed_peers,
+						sizeof(zbx_allowed_peer_t) * (size_t)allowed_peers_alloc);
 			}
-			freeaddrinfo(ai);
+
+			allowed_peers[allowed_peers_num].ai = ai;
+			allowed_peers[allowed_peers_num++].prefix_size = prefix_size;
 		}
 
 		if (NULL != end)
@@ -2507,6 +2726,64 @@ int	zbx_tcp_check_allowed_peers(const zbx_socket_t *s, const char *peer_list)
 		else
 			break;
 	}
+}
+
+static int	allowed_peers_match(const zbx_socket_t *s)
+{
+	int	i;
+
+	for (i = 0; i < allowed_peers_num; i++)
+	{
+		if (SUCCEED == peer_addrinfo_match(s, allowed_peers[i].ai, allowed_peers[i].prefix_size))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if connection initiator is in list of peers, reusing peer   *
+ *          addresses resolved during the current second                      *
+ *                                                                            *
+ * Parameters: s         - [IN] socket descriptor                             *
+ *             peer_list - [IN] comma-delimited list of allowed peers.        *
+ *                              NULL not allowed. Empty string results in     *
+ *                              return value FAIL.                            *
+ *                                                                            *
+ * Return value: SUCCEED - connection allowed                                 *
+ *               FAIL - connection is not allowed                             *
+ *                                                                            *
+ * Comments: Processes accepting many connections would otherwise resolve     *
+ *           host names of allowed peers for every connection. Peers that     *
+ *           are not found in the cache are checked against freshly resolved  *
+ *           addresses, so only removal of an address is noticed with up to   *
+ *           one second delay.                                                *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_check_allowed_peers_cached(const zbx_socket_t *s, const char *peer_list)
+{
+	time_t	now;
+	int	resolved = FAIL;
+
+	now = time(NULL);
+
+	if (NULL == allowed_peers_list || now != allowed_peers_time || 0 != strcmp(allowed_peers_list, peer_list))
+	{
+		allowed_peers_resolve(peer_list, now);
+		resolved = SUCCEED;
+	}
+
+	if (SUCCEED == allowed_peers_match(s))
+		return SUCCEED;
+
+	if (SUCCEED != resolved)
+	{
+		allowed_peers_resolve(peer_list, now);
+
+		if (SUCCEED == allowed_peers_match(s))
+			return SUCCEED;
+	}
 
 	zbx_set_socket_strerror("connection from \"%s\" rejected, allowed hosts: \"%s\"", s->peer, peer_list);
 
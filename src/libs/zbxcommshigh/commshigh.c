@@ -21,6 +21,7 @@
 
 #include "zbxcommon.h"
 #include "zbxjson.h"
+#include "zbxcompress.h"
 #include "zbxlog.h"
 #include "zbxtime.h"
 
@@ -341,3 +342,57 @@ out:
 
 	return ret;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: announce in request compression methods supported in addition     *
+ *          to zlib, so that peer can use them for response                   *
+ *                                                                            *
+ * Parameters: j - [IN/OUT] the request json                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_json_add_compression(struct zbx_json *j)
+{
+	if (SUCCEED == zbx_compress_method_supported(ZBX_COMPRESS_METHOD_ZSTD))
+	{
+		zbx_json_addstring(j, ZBX_PROTO_TAG_COMPRESSION, ZBX_PROTO_VALUE_COMPRESSION_ZSTD,
+				ZBX_JSON_TYPE_STRING);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compression method to use for response to request             *
+ *                                                                            *
+ * Parameters: jp - [IN] the request json                                     *
+ *                                                                            *
+ * Return value: compression method supported by both sides (see              *
+ *               ZBX_COMPRESS_METHOD_* defines)                               *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_get_compression_method(const struct zbx_json_parse *jp)
+{
+	char	value[ZBX_CONST_STRLEN(ZBX_PROTO_VALUE_COMPRESSION_ZSTD) + 1];
+
+	if (SUCCEED == zbx_compress_method_supported(ZBX_COMPRESS_METHOD_ZSTD) &&
+			SUCCEED == zbx_json_value_by_name(jp, ZBX_PROTO_TAG_COMPRESSION, value, sizeof(value), NULL) &&
+			0 == strcmp(value, ZBX_PROTO_VALUE_COMPRESSION_ZSTD))
+	{
+		return ZBX_COMPRESS_METHOD_ZSTD;
+	}
+
+	return ZBX_COMPRESS_METHOD_ZLIB;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get protocol flags for data compressed with the specified method  *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_compress_method_protocol(int method)
+{
+	if (ZBX_COMPRESS_METHOD_ZSTD == method)
+		return ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS | ZBX_TCP_ZSTD;
+
+	return ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS;
+}
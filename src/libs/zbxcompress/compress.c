@@ -24,8 +24,16 @@
 #ifdef HAVE_ZLIB
 #include "zlib.h"
 
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#include "zstd_errors.h"
+#endif
+
 #define ZBX_COMPRESS_STRERROR_LEN	512
 
+/* error code to report compression methods the build does not support, does not clash with zlib codes */
+#define ZBX_COMPRESS_ERR_METHOD		(-1000)
+
 static int	zbx_zlib_errno = 0;
 
 /******************************************************************************
@@ -51,6 +59,9 @@ const char	*zbx_compress_strerror(void)
 		case Z_DATA_ERROR:
 			zbx_strlcpy(message, "corrupted input data", sizeof(message));
 			break;
+		case ZBX_COMPRESS_ERR_METHOD:
+			zbx_strlcpy(message, "unsupported compression method", sizeof(message));
+			break;
 		default:
 			zbx_snprintf(message, sizeof(message), "unknown error (%d)", zbx_zlib_errno);
 			break;
@@ -120,6 +131,288 @@ int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
 	return SUCCEED;
 }
 
+#ifdef HAVE_ZSTD
+/******************************************************************************
+ *                                                                            *
+ * Purpose: map zstd error to the zlib error codes used for error reporting   *
+ *                                                                            *
+ ******************************************************************************/
+static int	zstd_error_to_zlib(size_t ret)
+{
+	switch (ZSTD_getErrorCode(ret))
+	{
+		case ZSTD_error_memory_allocation:
+			return Z_MEM_ERROR;
+		case ZSTD_error_dstSize_tooSmall:
+			return Z_BUF_ERROR;
+		default:
+			return Z_DATA_ERROR;
+	}
+}
+
+static int	zstd_compress(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	char	*buf;
+	size_t	buf_size, ret;
+
+	buf_size = ZSTD_compressBound(size_in);
+	buf = (char *)zbx_malloc(NULL, buf_size);
+
+	if (0 != ZSTD_isError(ret = ZSTD_compress(buf, buf_size, in, size_in, ZSTD_CLEVEL_DEFAULT)))
+	{
+		zbx_zlib_errno = zstd_error_to_zlib(ret);
+		zbx_free(buf);
+		return FAIL;
+	}
+
+	*out = buf;
+	*size_out = ret;
+
+	return SUCCEED;
+}
+
+static int	zstd_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	size_t	ret;
+
+	if (0 != ZSTD_isError(ret = ZSTD_decompress(out, *size_out, in, size_in)))
+	{
+		zbx_zlib_errno = zstd_error_to_zlib(ret);
+		return FAIL;
+	}
+
+	*size_out = ret;
+
+	return SUCCEED;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if compression method is supported by this build            *
+ *                                                                            *
+ * Parameters: method - [IN] the compression method (ZBX_COMPRESS_METHOD_*)   *
+ *                                                                            *
+ * Return value: SUCCEED - the method is supported                            *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress_method_supported(int method)
+{
+	switch (method)
+	{
+		case ZBX_COMPRESS_METHOD_ZLIB:
+			return SUCCEED;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_METHOD_ZSTD:
+			return SUCCEED;
+#endif
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data with the specified method                           *
+ *                                                                            *
+ * Parameters: in       - [IN] the data to compress                           *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the compressed data                           *
+ *             size_out - [OUT] the compressed data size                      *
+ *             method   - [IN] the compression method (ZBX_COMPRESS_METHOD_*) *
+ *                                                                            *
+ * Return value: SUCCEED - the data was compressed successfully               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: In the case of success the output buffer must be freed by the    *
+ *           caller.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress_ext(const char *in, size_t size_in, char **out, size_t *size_out, int method)
+{
+	switch (method)
+	{
+		case ZBX_COMPRESS_METHOD_ZLIB:
+			return zbx_compress(in, size_in, out, size_out);
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_METHOD_ZSTD:
+			return zstd_compress(in, size_in, out, size_out);
+#endif
+		default:
+			zbx_zlib_errno = ZBX_COMPRESS_ERR_METHOD;
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data compressed with the specified method              *
+ *                                                                            *
+ * Parameters: in       - [IN] the data to uncompress                         *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the uncompressed data                         *
+ *             size_out - [IN/OUT] the buffer and uncompressed data size      *
+ *             method   - [IN] the compression method (ZBX_COMPRESS_METHOD_*) *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_ext(const char *in, size_t size_in, char *out, size_t *size_out, int method)
+{
+	switch (method)
+	{
+		case ZBX_COMPRESS_METHOD_ZLIB:
+			return zbx_uncompress(in, size_in, out, size_out);
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_METHOD_ZSTD:
+			return zstd_uncompress(in, size_in, out, size_out);
+#endif
+		default:
+			zbx_zlib_errno = ZBX_COMPRESS_ERR_METHOD;
+			return FAIL;
+	}
+}
+
+struct zbx_uncompress_stream_s
+{
+	z_stream	zs;
+	char		*out;
+	size_t		size_out;
+	int		finished;
+};
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start uncompressing data that is received in parts                *
+ *                                                                            *
+ * Parameters: stream   - [OUT] the uncompression stream                      *
+ *             out      - [IN] the output buffer                              *
+ *             size_out - [IN] the output buffer size                         *
+ *                                                                            *
+ * Return value: SUCCEED - the stream was initialized successfully            *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Unlike zbx_uncompress() the whole compressed data does not have  *
+ *           to be kept in memory, it can be passed by parts as it arrives.   *
+ *           The stream must be freed with zbx_uncompress_stream_free().      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_init(zbx_uncompress_stream_t **stream, char *out, size_t size_out)
+{
+	zbx_uncompress_stream_t	*st;
+
+	st = (zbx_uncompress_stream_t *)zbx_malloc(NULL, sizeof(zbx_uncompress_stream_t));
+	memset(&st->zs, 0, sizeof(st->zs));
+
+	if (Z_OK != (zbx_zlib_errno = inflateInit(&st->zs)))
+	{
+		zbx_free(st);
+		return FAIL;
+	}
+
+	st->out = out;
+	st->size_out = size_out;
+	st->finished = 0;
+
+	st->zs.next_out = (Bytef *)out;
+	st->zs.avail_out = (uInt)MIN(size_out, UINT_MAX);
+
+	*stream = st;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress next part of compressed data                           *
+ *                                                                            *
+ * Parameters: stream  - [IN] the uncompression stream                        *
+ *             in      - [IN] the compressed data part                        *
+ *             size_in - [IN] the compressed data part size                   *
+ *                                                                            *
+ * Return value: SUCCEED - the data part was uncompressed successfully        *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Data following the end of compressed stream is ignored.          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	z_stream	*zs = &stream->zs;
+
+	while (0 == stream->finished && 0 != size_in)
+	{
+		uInt	avail_in;
+		int	ret;
+
+		avail_in = (uInt)MIN(size_in, UINT_MAX);
+		zs->next_in = (Bytef *)in;
+		zs->avail_in = avail_in;
+
+		while (0 != zs->avail_in)
+		{
+			if (0 == zs->avail_out)
+			{
+				size_t	offset = (size_t)((char *)zs->next_out - stream->out);
+
+				/* Output buffer can be larger than zlib can address at once. When it is full */
+				/* inflate() is still called to consume the stream trailer, it fails with     */
+				/* Z_BUF_ERROR if there is more data to uncompress.                           */
+				zs->avail_out = (uInt)MIN(stream->size_out - offset, UINT_MAX);
+			}
+
+			if (Z_STREAM_END == (ret = inflate(zs, Z_NO_FLUSH)))
+			{
+				stream->finished = 1;
+				break;
+			}
+
+			if (Z_OK != ret)
+			{
+				zbx_zlib_errno = (Z_NEED_DICT == ret ? Z_DATA_ERROR : ret);
+				return FAIL;
+			}
+		}
+
+		in += avail_in;
+		size_in -= avail_in;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check that compressed stream has ended and get uncompressed size  *
+ *                                                                            *
+ * Parameters: stream   - [IN] the uncompression stream                       *
+ *             size_out - [OUT] the uncompressed data size                    *
+ *                                                                            *
+ * Return value: SUCCEED - all compressed data was uncompressed               *
+ *               FAIL    - compressed data is incomplete                      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_finish(zbx_uncompress_stream_t *stream, size_t *size_out)
+{
+	if (0 == stream->finished)
+	{
+		zbx_zlib_errno = Z_DATA_ERROR;
+		return FAIL;
+	}
+
+	*size_out = (size_t)((char *)stream->zs.next_out - stream->out);
+
+	return SUCCEED;
+}
+
+void	zbx_uncompress_stream_free(zbx_uncompress_stream_t *stream)
+{
+	inflateEnd(&stream->zs);
+	zbx_free(stream);
+}
+
 #else
 
 int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
@@ -140,9 +433,63 @@ int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
 	return FAIL;
 }
 
+int	zbx_compress_ext(const char *in, size_t size_in, char **out, size_t *size_out, int method)
+{
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	ZBX_UNUSED(method);
+	return FAIL;
+}
+
+int	zbx_uncompress_ext(const char *in, size_t size_in, char *out, size_t *size_out, int method)
+{
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	ZBX_UNUSED(method);
+	return FAIL;
+}
+
+int	zbx_compress_method_supported(int method)
+{
+	ZBX_UNUSED(method);
+	return FAIL;
+}
+
 const char	*zbx_compress_strerror(void)
 {
 	return "";
 }
 
+int	zbx_uncompress_stream_init(zbx_uncompress_stream_t **stream, char *out, size_t size_out)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
+int	zbx_uncompress_stream(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	return FAIL;
+}
+
+int	zbx_uncompress_stream_finish(zbx_uncompress_stream_t *stream, size_t *size_out)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
+void	zbx_uncompress_stream_free(zbx_uncompress_stream_t *stream)
+{
+	ZBX_UNUSED(stream);
+}
+
 #endif
@@ -2872,6 +2872,47 @@ static void	decode_and_escape_binary_value_for_sql(char **sql_insert_data)
 }
 #endif
 
+#ifndef HAVE_ORACLE
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends unsigned integer value to bulk insert sql statement       *
+ *                                                                            *
+ * Comments: The value is formatted directly instead of using snprintf(),     *
+ *           which is noticeable when inserting large history and trends      *
+ *           batches.                                                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_insert_add_uint64(char **sql, size_t *sql_alloc, size_t *sql_offset, zbx_uint64_t value)
+{
+	char	buf[MAX_ID_LEN], *ptr = buf + sizeof(buf);
+
+	do
+	{
+		*(--ptr) = (char)('0' + value % 10);
+		value /= 10;
+	}
+	while (0 != value);
+
+	zbx_strncpy_alloc(sql, sql_alloc, sql_offset, ptr, (size_t)(buf + sizeof(buf) - ptr));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends integer value to bulk insert sql statement                *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_insert_add_int(char **sql, size_t *sql_alloc, size_t *sql_offset, int value)
+{
+	if (0 > value)
+	{
+		zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, '-');
+		db_insert_add_uint64(sql, sql_alloc, sql_offset, (zbx_uint64_t)-(value + 1) + 1);
+	}
+	else
+		db_insert_add_uint64(sql, sql_alloc, sql_offset, (zbx_uint64_t)value);
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: executes the prepared database bulk insert operation              *
@@ -3074,18 +3115,19 @@ retry_oracle:
 					zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, '\'');
 					break;
 				case ZBX_TYPE_INT:
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%d", value->i32);
+					db_insert_add_int(&sql, &sql_alloc, &sql_offset, value->i32);
 					break;
 				case ZBX_TYPE_FLOAT:
 					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ZBX_FS_DBL64_SQL, value->dbl);
 					break;
 				case ZBX_TYPE_UINT:
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ZBX_FS_UI64,
-							value->ui64);
+					db_insert_add_uint64(&sql, &sql_alloc, &sql_offset, value->ui64);
 					break;
 				case ZBX_TYPE_ID:
-					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
-							zbx_db_sql_id_ins(value->ui64));
+					if (0 != value->ui64)
+						db_insert_add_uint64(&sql, &sql_alloc, &sql_offset, value->ui64);
+					else
+						zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "null");
 					break;
 				default:
 					THIS_SHOULD_NEVER_HAPPEN;
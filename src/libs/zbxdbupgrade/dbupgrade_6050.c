@@ -731,6 +731,33 @@ static int	DBpatch_6050063(void)
 	return SUCCEED;
 }
 
+static int	DBpatch_6050064(void)
+{
+	return DBdrop_foreign_key("item_parameter", 1);
+}
+
+static int	DBpatch_6050065(void)
+{
+	const zbx_db_field_t	field = {"itemid", NULL, "items", "itemid", 0, ZBX_TYPE_ID, 0, 0};
+
+	return DBadd_foreign_key("item_parameter", 1, &field);
+}
+
+static int	DBpatch_6050066(void)
+{
+	return DBcreate_changelog_insert_trigger("item_parameter", "item_parameterid");
+}
+
+static int	DBpatch_6050067(void)
+{
+	return DBcreate_changelog_update_trigger("item_parameter", "item_parameterid");
+}
+
+static int	DBpatch_6050068(void)
+{
+	return DBcreate_changelog_delete_trigger("item_parameter", "item_parameterid");
+}
+
 #endif
 
 DBPATCH_START(6050)
@@ -801,5 +828,10 @@ DBPATCH_ADD(6050060, 0, 1)
 DBPATCH_ADD(6050061, 0, 1)
 DBPATCH_ADD(6050062, 0, 1)
 DBPATCH_ADD(6050063, 0, 1)
+DBPATCH_ADD(6050064, 0, 1)
+DBPATCH_ADD(6050065, 0, 1)
+DBPATCH_ADD(6050066, 0, 1)
+DBPATCH_ADD(6050067, 0, 1)
+DBPATCH_ADD(6050068, 0, 1)
 
 DBPATCH_END()
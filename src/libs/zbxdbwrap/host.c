@@ -1431,6 +1431,12 @@ void	zbx_db_delete_items(zbx_vector_uint64_t *itemids)
 	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ";\n");
 	zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
 
+	/* delete from item script parameters */
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "delete from item_parameter where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ";\n");
+	zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
+
 	/* delete from functions */
 	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "delete from functions where");
 	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
@@ -39,6 +39,7 @@
 #include "zbxcachehistory.h"
 #include "zbxpreproc.h"
 #include "zbxautoreg.h"
+#include "zbxrtc.h"
 
 /* the space reserved in json buffer to hold at least one record plus service data */
 #define ZBX_DATA_JSON_RESERVED		(ZBX_HISTORY_TEXT_VALUE_LEN * 4 + ZBX_KIBIBYTE * 4)
@@ -863,11 +864,94 @@ static void	log_client_timediff(int level, struct zbx_json_parse *jp, const zbx_
 	}
 }
 
+typedef struct
+{
+	const char	*host;
+	const char	*key;
+	const char	*itemid;
+	const char	*clock;
+	const char	*ns;
+	const char	*state;
+	const char	*lastlogsize;
+	const char	*mtime;
+	const char	*value;
+	const char	*timestamp;
+	const char	*source;
+	const char	*severity;
+	const char	*eventid;
+	const char	*id;
+}
+zbx_history_row_pairs_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locates values of history data row tags in a single pass          *
+ *                                                                            *
+ * Parameters: jp_row - [IN] JSON with history data row                       *
+ *             pairs  - [OUT] pointers to tag values, NULL if tag is missing  *
+ *                                                                            *
+ * Comments: Like zbx_json_pair_by_name() the first occurrence of a tag is    *
+ *           used, but the row is scanned once instead of once for each tag.  *
+ *                                                                            *
+ ******************************************************************************/
+static void	parse_history_data_row_pairs(const struct zbx_json_parse *jp_row, zbx_history_row_pairs_t *pairs)
+{
+	char		name[MAX_STRING_LEN];
+	const char	*p = NULL, **pvalue;
+
+	memset(pairs, 0, sizeof(zbx_history_row_pairs_t));
+
+	while (NULL != (p = zbx_json_pair_next(jp_row, p, name, sizeof(name))))
+	{
+		if (0 == strcmp(name, ZBX_PROTO_TAG_HOST))
+			pvalue = &pairs->host;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_KEY))
+			pvalue = &pairs->key;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_ITEMID))
+			pvalue = &pairs->itemid;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_CLOCK))
+			pvalue = &pairs->clock;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_NS))
+			pvalue = &pairs->ns;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_STATE))
+			pvalue = &pairs->state;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_LASTLOGSIZE))
+			pvalue = &pairs->lastlogsize;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_MTIME))
+			pvalue = &pairs->mtime;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_VALUE))
+			pvalue = &pairs->value;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_LOGTIMESTAMP))
+			pvalue = &pairs->timestamp;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_LOGSOURCE))
+			pvalue = &pairs->source;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_LOGSEVERITY))
+			pvalue = &pairs->severity;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_LOGEVENTID))
+			pvalue = &pairs->eventid;
+		else if (0 == strcmp(name, ZBX_PROTO_TAG_ID))
+			pvalue = &pairs->id;
+		else
+			continue;
+
+		if (NULL == *pvalue)
+			*pvalue = p;
+	}
+}
+
+static int	history_row_decode_dyn(const char *p, char **string, size_t *string_alloc)
+{
+	if (NULL == p || NULL == zbx_json_decodevalue_dyn(p, string, string_alloc, NULL))
+		return FAIL;
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: parses agent value from history data json row                     *
  *                                                                            *
- * Parameters: jp_row       - [IN] JSON with history data row                 *
+ * Parameters: pairs        - [IN] history data row tag values                *
  *             unique_shift - [IN/OUT] auto increment nanoseconds to ensure   *
  *                                     unique value of timestamps             *
  *             av           - [OUT] the agent value                           *
@@ -876,21 +960,21 @@ static void	log_client_timediff(int level, struct zbx_json_parse *jp, const zbx_
  *                FAIL    - otherwise                                         *
  *                                                                            *
  ******************************************************************************/
-static int	parse_history_data_row_value(const struct zbx_json_parse *jp_row, zbx_timespec_t *unique_shift,
+static int	parse_history_data_row_value(const zbx_history_row_pairs_t *pairs, zbx_timespec_t *unique_shift,
 		zbx_agent_value_t *av)
 {
 	char	*tmp = NULL;
-	size_t	tmp_alloc = 0;
+	size_t	tmp_alloc = 0, str_alloc;
 	int	ret = FAIL;
 
 	memset(av, 0, sizeof(zbx_agent_value_t));
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_CLOCK, &tmp, &tmp_alloc, NULL))
+	if (SUCCEED == history_row_decode_dyn(pairs->clock, &tmp, &tmp_alloc))
 	{
 		if (FAIL == zbx_is_uint31(tmp, &av->ts.sec))
 			goto out;
 
-		if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_NS, &tmp, &tmp_alloc, NULL))
+		if (SUCCEED == history_row_decode_dyn(pairs->ns, &tmp, &tmp_alloc))
 		{
 			if (FAIL == zbx_is_uint_n_range(tmp, tmp_alloc, &av->ts.ns, sizeof(av->ts.ns),
 				0LL, 999999999LL))
@@ -915,49 +999,49 @@ static int	parse_history_data_row_value(const struct zbx_json_parse *jp_row, zbx
 	else
 		zbx_timespec(&av->ts);
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_STATE, &tmp, &tmp_alloc, NULL))
+	if (SUCCEED == history_row_decode_dyn(pairs->state, &tmp, &tmp_alloc))
 		av->state = (unsigned char)atoi(tmp);
 
 	/* Unsupported item meta information must be ignored for backwards compatibility. */
 	/* New agents will not send meta information for items in unsupported state.      */
 	if (ITEM_STATE_NOTSUPPORTED != av->state)
 	{
-		if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_LASTLOGSIZE, &tmp, &tmp_alloc, NULL))
+		if (SUCCEED == history_row_decode_dyn(pairs->lastlogsize, &tmp, &tmp_alloc))
 		{
 			av->meta = 1;	/* contains meta information */
 
 			zbx_is_uint64(tmp, &av->lastlogsize);
 
-			if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_MTIME, &tmp, &tmp_alloc, NULL))
+			if (SUCCEED == history_row_decode_dyn(pairs->mtime, &tmp, &tmp_alloc))
 				av->mtime = atoi(tmp);
 		}
 	}
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_VALUE, &tmp, &tmp_alloc, NULL))
-		av->value = zbx_strdup(av->value, tmp);
+	/* value and source are decoded directly into agent value to avoid copying possibly large strings */
+	str_alloc = 0;
+	if (SUCCEED != history_row_decode_dyn(pairs->value, &av->value, &str_alloc))
+		zbx_free(av->value);
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_LOGTIMESTAMP, &tmp, &tmp_alloc, NULL))
+	if (SUCCEED == history_row_decode_dyn(pairs->timestamp, &tmp, &tmp_alloc))
 		av->timestamp = atoi(tmp);
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_LOGSOURCE, &tmp, &tmp_alloc, NULL))
-		av->source = zbx_strdup(av->source, tmp);
+	str_alloc = 0;
+	if (SUCCEED != history_row_decode_dyn(pairs->source, &av->source, &str_alloc))
+		zbx_free(av->source);
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_LOGSEVERITY, &tmp, &tmp_alloc, NULL))
+	if (SUCCEED == history_row_decode_dyn(pairs->severity, &tmp, &tmp_alloc))
 		av->severity = atoi(tmp);
 
-	if (SUCCEED == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_LOGEVENTID, &tmp, &tmp_alloc, NULL))
+	if (SUCCEED == history_row_decode_dyn(pairs->eventid, &tmp, &tmp_alloc))
 		av->logeventid = atoi(tmp);
 
-	if (SUCCEED != zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_ID, &tmp, &tmp_alloc, NULL) ||
-			SUCCEED != zbx_is_uint64(tmp, &av->id))
-	{
+	if (SUCCEED != history_row_decode_dyn(pairs->id, &tmp, &tmp_alloc) || SUCCEED != zbx_is_uint64(tmp, &av->id))
 		av->id = 0;
-	}
-
-	zbx_free(tmp);
 
 	ret = SUCCEED;
 out:
+	zbx_free(tmp);
+
 	return ret;
 }
 
@@ -965,18 +1049,18 @@ out:
  *                                                                            *
  * Purpose: parses item identifier from history data json row                 *
  *                                                                            *
- * Parameters: jp_row - [IN] JSON with history data row                       *
+ * Parameters: pairs  - [IN] history data row tag values                      *
  *             itemid - [OUT] the item identifier                             *
  *                                                                            *
  * Return value:  SUCCEED - the item identifier was parsed successfully       *
  *                FAIL    - otherwise                                         *
  *                                                                            *
  ******************************************************************************/
-static int	parse_history_data_row_itemid(const struct zbx_json_parse *jp_row, zbx_uint64_t *itemid)
+static int	parse_history_data_row_itemid(const zbx_history_row_pairs_t *pairs, zbx_uint64_t *itemid)
 {
 	char	buffer[MAX_ID_LEN + 1];
 
-	if (SUCCEED != zbx_json_value_by_name(jp_row, ZBX_PROTO_TAG_ITEMID, buffer, sizeof(buffer), NULL))
+	if (NULL == pairs->itemid || NULL == zbx_json_decodevalue(pairs->itemid, buffer, sizeof(buffer), NULL))
 		return FAIL;
 
 	if (SUCCEED != zbx_is_uint64(buffer, itemid))
@@ -988,27 +1072,27 @@ static int	parse_history_data_row_itemid(const struct zbx_json_parse *jp_row, zb
  *                                                                            *
  * Purpose: parses host,key pair from history data json row                   *
  *                                                                            *
- * Parameters: jp_row - [IN] JSON with history data row                       *
- *             hk     - [OUT] the host,key pair                               *
+ * Parameters: pairs - [IN] history data row tag values                       *
+ *             hk    - [OUT] the host,key pair                                *
  *                                                                            *
  * Return value:  SUCCEED - the host,key pair was parsed successfully         *
  *                FAIL    - otherwise                                         *
  *                                                                            *
  ******************************************************************************/
-static int	parse_history_data_row_hostkey(const struct zbx_json_parse *jp_row, zbx_host_key_t *hk)
+static int	parse_history_data_row_hostkey(const zbx_history_row_pairs_t *pairs, zbx_host_key_t *hk)
 {
 	size_t str_alloc;
 
 	str_alloc = 0;
 	zbx_free(hk->host);
 
-	if (SUCCEED != zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_HOST, &hk->host, &str_alloc, NULL))
+	if (SUCCEED != history_row_decode_dyn(pairs->host, &hk->host, &str_alloc))
 		return FAIL;
 
 	str_alloc = 0;
 	zbx_free(hk->key);
 
-	if (SUCCEED != zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_KEY, &hk->key, &str_alloc, NULL))
+	if (SUCCEED != history_row_decode_dyn(pairs->key, &hk->key, &str_alloc))
 	{
 		zbx_free(hk->host);
 		return FAIL;
@@ -1041,6 +1125,7 @@ static int	parse_history_data(struct zbx_json_parse *jp_data, const char **pnext
 		zbx_host_key_t *hostkeys, int *values_num, int *parsed_num, zbx_timespec_t *unique_shift)
 {
 	struct zbx_json_parse	jp_row;
+	zbx_history_row_pairs_t	pairs;
 	int			ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -1068,10 +1153,12 @@ static int	parse_history_data(struct zbx_json_parse *jp_data, const char **pnext
 
 		(*parsed_num)++;
 
-		if (SUCCEED != parse_history_data_row_hostkey(&jp_row, &hostkeys[*values_num]))
+		parse_history_data_row_pairs(&jp_row, &pairs);
+
+		if (SUCCEED != parse_history_data_row_hostkey(&pairs, &hostkeys[*values_num]))
 			continue;
 
-		if (SUCCEED != parse_history_data_row_value(&jp_row, unique_shift, &values[*values_num]))
+		if (SUCCEED != parse_history_data_row_value(&pairs, unique_shift, &values[*values_num]))
 			continue;
 
 		(*values_num)++;
@@ -1116,6 +1203,7 @@ static int	parse_history_data_by_itemids(struct zbx_json_parse *jp_data, const c
 		zbx_timespec_t *unique_shift, char **error)
 {
 	struct zbx_json_parse	jp_row;
+	zbx_history_row_pairs_t	pairs;
 	int			ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -1143,10 +1231,12 @@ static int	parse_history_data_by_itemids(struct zbx_json_parse *jp_data, const c
 
 		(*parsed_num)++;
 
-		if (SUCCEED != parse_history_data_row_itemid(&jp_row, &itemids[*values_num]))
+		parse_history_data_row_pairs(&jp_row, &pairs);
+
+		if (SUCCEED != parse_history_data_row_itemid(&pairs, &itemids[*values_num]))
 			continue;
 
-		if (SUCCEED != parse_history_data_row_value(&jp_row, unique_shift, &values[*values_num]))
+		if (SUCCEED != parse_history_data_row_value(&pairs, unique_shift, &values[*values_num]))
 			continue;
 
 		(*values_num)++;
@@ -2203,7 +2293,10 @@ static void	process_tasks_contents(struct zbx_json_parse *jp_tasks)
 
 	zbx_db_begin();
 	zbx_tm_save_tasks(&tasks);
-	zbx_db_commit();
+
+	/* let task manager process results received from proxy without waiting for the next check */
+	if (ZBX_DB_OK == zbx_db_commit() && 0 != tasks.values_num)
+		zbx_rtc_notify_taskmanager();
 
 	zbx_vector_tm_task_clear_ext(&tasks, zbx_tm_task_free);
 	zbx_vector_tm_task_destroy(&tasks);
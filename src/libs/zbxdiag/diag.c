@@ -393,6 +393,39 @@ static void	diag_add_preproc_sequences(struct zbx_json *json, const char *field,
 	zbx_json_close(json);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add preprocessing time statistics top list to output json         *
+ *                                                                            *
+ * Parameters: json    - [OUT] the output json                                *
+ *             field   - [IN] the field name                                  *
+ *             id_name - [IN] the statistics identifier name                  *
+ *             stats   - [IN] a top time statistics list                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_add_preproc_time_stats(struct zbx_json *json, const char *field, const char *id_name,
+		const zbx_vector_pp_time_stats_ptr_t *stats)
+{
+	const char	*buckets[ZBX_PP_TIME_BUCKETS_NUM] = {"<1ms", "<10ms", "<100ms", "<1s", ">=1s"};
+
+	zbx_json_addarray(json, field);
+
+	for (int i = 0; i < stats->values_num; i++)
+	{
+		zbx_json_addobject(json, NULL);
+		zbx_json_adduint64(json, id_name, stats->values[i]->id);
+		zbx_json_adduint64(json, "values", stats->values[i]->num);
+		zbx_json_addfloat(json, "time", stats->values[i]->time);
+
+		for (int j = 0; j < ZBX_PP_TIME_BUCKETS_NUM; j++)
+			zbx_json_adduint64(json, buckets[j], stats->values[i]->buckets[j]);
+
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add requested preprocessing diagnostic information to json data   *
@@ -478,6 +511,40 @@ int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *
 							(zbx_pp_sequence_stats_ptr_free_func_t)(zbx_ptr_free));
 					zbx_vector_pp_sequence_stats_ptr_destroy(&sequences);
 				}
+				else if (0 == strcmp(map->name, "items") || 0 == strcmp(map->name, "steps"))
+				{
+					zbx_vector_pp_time_stats_ptr_t	stats;
+					const char			*id_name;
+
+					zbx_vector_pp_time_stats_ptr_create(&stats);
+					time1 = zbx_time();
+
+					if ('i' == *map->name)
+					{
+						ret = zbx_preprocessor_get_top_items((int)map->value, &stats, error);
+						id_name = "itemid";
+					}
+					else
+					{
+						ret = zbx_preprocessor_get_top_steps((int)map->value, &stats, error);
+						id_name = "type";
+					}
+
+					if (SUCCEED != ret)
+					{
+						zbx_vector_pp_time_stats_ptr_destroy(&stats);
+						goto out;
+					}
+
+					time2 = zbx_time();
+					time_total += time2 - time1;
+
+					diag_add_preproc_time_stats(json, map->name, id_name, &stats);
+
+					zbx_vector_pp_time_stats_ptr_clear_ext(&stats,
+							(zbx_pp_time_stats_ptr_free_func_t)(zbx_ptr_free));
+					zbx_vector_pp_time_stats_ptr_destroy(&stats);
+				}
 				else
 				{
 					*error = zbx_dsprintf(*error, "Unsupported top field: %s", map->name);
@@ -671,10 +738,10 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 		diag_add_section_request(j, ZBX_DIAG_HISTORYCACHE, "values", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_VALUECACHE)))
-		diag_add_section_request(j, ZBX_DIAG_VALUECACHE, "values", "request.values", NULL);
+		diag_add_section_request(j, ZBX_DIAG_VALUECACHE, "values", "request.values", "misses", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_PREPROCESSING)))
-		diag_add_section_request(j, ZBX_DIAG_PREPROCESSING, "sequences", NULL);
+		diag_add_section_request(j, ZBX_DIAG_PREPROCESSING, "sequences", "items", "steps", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_LLD)))
 		diag_add_section_request(j, ZBX_DIAG_LLD, "values", NULL);
@@ -863,6 +930,8 @@ static void	diag_log_value_cache(struct zbx_json_parse *jp, char **out, size_t *
 
 	diag_log_top_view(jp, "top.values", "$.top.values", out, out_alloc, out_offset);
 	diag_log_top_view(jp, "top.request.values", "$.top['request.values']", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.size", "$.top.size", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.misses", "$.top.misses", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
@@ -883,6 +952,8 @@ static void	diag_log_preprocessing(struct zbx_json_parse *jp, char **out, size_t
 	zbx_free(msg);
 
 	diag_log_top_view(jp, "top.sequences", "$.top.sequences", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.items", "$.top.items", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.steps", "$.top.steps", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
@@ -25,6 +25,13 @@ void	*zbx_discovery_open(void)
 	return zbx_pb_discovery_open();
 }
 
+void	zbx_discovery_prefetch(void *handle, const zbx_vector_uint64_t *dcheckids, const zbx_vector_str_t *ips)
+{
+	ZBX_UNUSED(handle);
+	ZBX_UNUSED(dcheckids);
+	ZBX_UNUSED(ips);
+}
+
 void	zbx_discovery_close(void *handle)
 {
 	zbx_pb_discovery_close((zbx_pb_discovery_data_t *)handle);
@@ -24,13 +24,171 @@
 
 typedef struct
 {
+	zbx_uint64_t	dcheckid;
+	char		*ip;
+	int		port;
 	zbx_uint64_t	dserviceid;
+	zbx_uint64_t	dhostid;
 	int		status;
 	int		lastup;
 	int		lastdown;
 	char		*value;
+	char		*dns;
+}
+zbx_discovery_dservice_t;
+
+/* discovered services of one discovery results batch, loaded from database with a single query */
+typedef struct
+{
+	zbx_hashset_t		dservices;
+	zbx_vector_uint64_t	dcheckids;	/* checks covered by prefetch */
+	zbx_vector_str_t	ips;		/* addresses covered by prefetch */
+}
+zbx_discovery_cache_t;
+
+static zbx_hash_t	discovery_dservice_hash(const void *data)
+{
+	const zbx_discovery_dservice_t	*dservice = (const zbx_discovery_dservice_t *)data;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&dservice->dcheckid);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(dservice->ip, strlen(dservice->ip), hash);
+
+	return ZBX_DEFAULT_HASH_ALGO(&dservice->port, sizeof(dservice->port), hash);
+}
+
+static int	discovery_dservice_compare(const void *d1, const void *d2)
+{
+	const zbx_discovery_dservice_t	*dservice1 = (const zbx_discovery_dservice_t *)d1;
+	const zbx_discovery_dservice_t	*dservice2 = (const zbx_discovery_dservice_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(dservice1->dcheckid, dservice2->dcheckid);
+	ZBX_RETURN_IF_NOT_EQUAL(dservice1->port, dservice2->port);
+
+	return strcmp(dservice1->ip, dservice2->ip);
+}
+
+static void	discovery_dservice_clean(zbx_discovery_dservice_t *dservice)
+{
+	zbx_free(dservice->ip);
+	zbx_free(dservice->value);
+	zbx_free(dservice->dns);
+}
+
+static void	discovery_cache_init(zbx_discovery_cache_t *cache)
+{
+	zbx_hashset_create_ext(&cache->dservices, 0, discovery_dservice_hash, discovery_dservice_compare,
+			(zbx_clean_func_t)discovery_dservice_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_vector_uint64_create(&cache->dcheckids);
+	zbx_vector_str_create(&cache->ips);
+}
+
+static void	discovery_cache_destroy(zbx_discovery_cache_t *cache)
+{
+	zbx_hashset_destroy(&cache->dservices);
+	zbx_vector_uint64_destroy(&cache->dcheckids);
+	zbx_vector_str_clear_ext(&cache->ips, zbx_str_free);
+	zbx_vector_str_destroy(&cache->ips);
+}
+
+static zbx_discovery_dservice_t	*discovery_cache_add(zbx_discovery_cache_t *cache, zbx_db_row_t row)
+{
+	zbx_discovery_dservice_t	dservice_local, *dservice;
+
+	ZBX_STR2UINT64(dservice_local.dcheckid, row[0]);
+	dservice_local.ip = row[1];
+	dservice_local.port = atoi(row[2]);
+
+	if (NULL != (dservice = (zbx_discovery_dservice_t *)zbx_hashset_search(&cache->dservices, &dservice_local)))
+		return dservice;
+
+	dservice_local.ip = zbx_strdup(NULL, row[1]);
+	ZBX_STR2UINT64(dservice_local.dserviceid, row[3]);
+	ZBX_STR2UINT64(dservice_local.dhostid, row[4]);
+	dservice_local.status = atoi(row[5]);
+	dservice_local.lastup = atoi(row[6]);
+	dservice_local.lastdown = atoi(row[7]);
+	dservice_local.value = zbx_strdup(NULL, row[8]);
+	dservice_local.dns = zbx_strdup(NULL, row[9]);
+
+	return (zbx_discovery_dservice_t *)zbx_hashset_insert(&cache->dservices, &dservice_local,
+			sizeof(dservice_local));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get discovered service from cache or database                     *
+ *                                                                            *
+ * Return value: the discovered service or NULL if it is not registered       *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_discovery_dservice_t	*discovery_cache_get_dservice(zbx_discovery_cache_t *cache, zbx_uint64_t dcheckid,
+		const char *ip, int port)
+{
+	zbx_discovery_dservice_t	dservice_local, *dservice = NULL;
+	zbx_db_result_t			result;
+	zbx_db_row_t			row;
+	char				*ip_esc;
+
+	dservice_local.dcheckid = dcheckid;
+	dservice_local.ip = (char *)ip;
+	dservice_local.port = port;
+
+	if (NULL != (dservice = (zbx_discovery_dservice_t *)zbx_hashset_search(&cache->dservices, &dservice_local)))
+		return dservice;
+
+	/* prefetched services are complete for the covered checks and addresses */
+	if (FAIL != zbx_vector_uint64_bsearch(&cache->dcheckids, dcheckid, ZBX_DEFAULT_UINT64_COMPARE_FUNC) &&
+			FAIL != zbx_vector_str_bsearch(&cache->ips, dservice_local.ip, ZBX_DEFAULT_STR_COMPARE_FUNC))
+	{
+		return NULL;
+	}
+
+	ip_esc = zbx_db_dyn_escape_field("dservices", "ip", ip);
+
+	result = zbx_db_select(
+			"select dcheckid,ip,port,dserviceid,dhostid,status,lastup,lastdown,value,dns"
+			" from dservices"
+			" where dcheckid=" ZBX_FS_UI64
+				" and ip" ZBX_SQL_STRCMP
+				" and port=%d",
+			dcheckid, ZBX_SQL_STRVAL_EQ(ip_esc), port);
+
+	if (NULL != (row = zbx_db_fetch(result)))
+		dservice = discovery_cache_add(cache, row);
+
+	zbx_db_free_result(result);
+
+	zbx_free(ip_esc);
+
+	return dservice;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reflect moving of discovered services to another host in cache   *
+ *                                                                            *
+ * Parameters: cache       - [IN/OUT] discovered services cache             *
+ *             dhostid     - [IN] old host identifier                         *
+ *             dhostid_new - [IN] new host identifier                         *
+ *             ip          - [IN] address of moved services, NULL for all     *
+ *                                                                            *
+ ******************************************************************************/
+static void	discovery_cache_move_dservices(zbx_discovery_cache_t *cache, zbx_uint64_t dhostid,
+		zbx_uint64_t dhostid_new, const char *ip)
+{
+	zbx_hashset_iter_t		iter;
+	zbx_discovery_dservice_t	*dservice;
+
+	zbx_hashset_iter_reset(&cache->dservices, &iter);
+
+	while (NULL != (dservice = (zbx_discovery_dservice_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (dservice->dhostid == dhostid && (NULL == ip || 0 == strcmp(dservice->ip, ip)))
+			dservice->dhostid = dhostid_new;
+	}
 }
-DB_DSERVICE;
 
 static zbx_db_result_t	discovery_get_dhost_by_value(zbx_uint64_t dcheckid, const char *value)
 {
@@ -82,7 +240,8 @@ static zbx_db_result_t	discovery_get_dhost_by_ip_port(zbx_uint64_t druleid, cons
  * Parameters: host ip address                                                *
  *                                                                            *
  ******************************************************************************/
-static void	discovery_separate_host(zbx_uint64_t druleid, zbx_db_dhost *dhost, const char *ip)
+static void	discovery_separate_host(zbx_discovery_cache_t *cache, zbx_uint64_t druleid, zbx_db_dhost *dhost,
+		const char *ip)
 {
 	zbx_db_result_t	result;
 	char		*ip_esc, *sql = NULL;
@@ -115,6 +274,8 @@ static void	discovery_separate_host(zbx_uint64_t druleid, zbx_db_dhost *dhost, c
 					" and ip" ZBX_SQL_STRCMP,
 				dhostid, dhost->dhostid, ZBX_SQL_STRVAL_EQ(ip_esc));
 
+		discovery_cache_move_dservices(cache, dhost->dhostid, dhostid, ip);
+
 		dhost->dhostid = dhostid;
 		dhost->status = DOBJECT_STATUS_DOWN;
 		dhost->lastup = 0;
@@ -135,8 +296,9 @@ static void	discovery_separate_host(zbx_uint64_t druleid, zbx_db_dhost *dhost, c
  * Parameters: host ip address                                                *
  *                                                                            *
  ******************************************************************************/
-static void	discovery_register_host(zbx_uint64_t druleid, zbx_uint64_t dcheckid, zbx_uint64_t unique_dcheckid,
-		zbx_db_dhost *dhost, const char *ip, int port, int status, const char *value)
+static void	discovery_register_host(zbx_discovery_cache_t *cache, zbx_uint64_t druleid, zbx_uint64_t dcheckid,
+		zbx_uint64_t unique_dcheckid, zbx_db_dhost *dhost, const char *ip, int port, int status,
+		const char *value)
 {
 	zbx_db_result_t	result;
 	zbx_db_row_t	row;
@@ -191,7 +353,7 @@ static void	discovery_register_host(zbx_uint64_t druleid, zbx_uint64_t dcheckid,
 		dhost->lastdown = atoi(row[3]);
 
 		if (0 == match_value)
-			discovery_separate_host(druleid, dhost, ip);
+			discovery_separate_host(cache, druleid, dhost, ip);
 	}
 	zbx_db_free_result(result);
 
@@ -204,61 +366,61 @@ static void	discovery_register_host(zbx_uint64_t druleid, zbx_uint64_t dcheckid,
  *                                                                            *
  * Parameters: host ip address                                                *
  *                                                                            *
+ * Return value: the registered service or NULL if service is down and was    *
+ *               not registered before                                        *
+ *                                                                            *
  ******************************************************************************/
-static void	discovery_register_service(zbx_uint64_t dcheckid, zbx_db_dhost *dhost, DB_DSERVICE *dservice,
-		const char *ip, const char *dns, int port, int status)
+static zbx_discovery_dservice_t	*discovery_register_service(zbx_discovery_cache_t *cache, zbx_uint64_t dcheckid,
+		zbx_db_dhost *dhost, const char *ip, const char *dns, int port, int status)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	char		*ip_esc, *dns_esc;
-
-	zbx_uint64_t	dhostid;
+	zbx_discovery_dservice_t	*dservice;
+	char				*dns_esc;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() ip:'%s' port:%d", __func__, ip, port);
 
-	ip_esc = zbx_db_dyn_escape_field("dservices", "ip", ip);
-
-	result = zbx_db_select(
-			"select dserviceid,dhostid,status,lastup,lastdown,value,dns"
-			" from dservices"
-			" where dcheckid=" ZBX_FS_UI64
-				" and ip" ZBX_SQL_STRCMP
-				" and port=%d",
-			dcheckid, ZBX_SQL_STRVAL_EQ(ip_esc), port);
-
-	if (NULL == (row = zbx_db_fetch(result)))
+	if (NULL == (dservice = discovery_cache_get_dservice(cache, dcheckid, ip, port)))
 	{
 		if (DOBJECT_STATUS_UP == status)	/* add host only if service is up */
 		{
-			zabbix_log(LOG_LEVEL_DEBUG, "new service discovered on port %d", port);
+			zbx_discovery_dservice_t	dservice_local;
+			char				*ip_esc;
 
-			dservice->dserviceid = zbx_db_get_maxid("dservices");
-			dservice->status = DOBJECT_STATUS_DOWN;
-			dservice->value = zbx_strdup(dservice->value, "");
+			zabbix_log(LOG_LEVEL_DEBUG, "new service discovered on port %d", port);
 
+			dservice_local.dcheckid = dcheckid;
+			dservice_local.ip = zbx_strdup(NULL, ip);
+			dservice_local.port = port;
+			dservice_local.dserviceid = zbx_db_get_maxid("dservices");
+			dservice_local.dhostid = dhost->dhostid;
+			dservice_local.status = DOBJECT_STATUS_DOWN;
+			dservice_local.lastup = 0;
+			dservice_local.lastdown = 0;
+			dservice_local.value = zbx_strdup(NULL, "");
+			dservice_local.dns = zbx_strdup(NULL, dns);
+
+			ip_esc = zbx_db_dyn_escape_field("dservices", "ip", ip);
 			dns_esc = zbx_db_dyn_escape_field("dservices", "dns", dns);
 
 			zbx_db_execute("insert into dservices (dserviceid,dhostid,dcheckid,ip,dns,port,status)"
 					" values (" ZBX_FS_UI64 "," ZBX_FS_UI64 "," ZBX_FS_UI64 ",'%s','%s',%d,%d)",
-					dservice->dserviceid, dhost->dhostid, dcheckid, ip_esc, dns_esc, port,
-					dservice->status);
+					dservice_local.dserviceid, dhost->dhostid, dcheckid, ip_esc, dns_esc, port,
+					dservice_local.status);
 
 			zbx_free(dns_esc);
+			zbx_free(ip_esc);
+
+			dservice = (zbx_discovery_dservice_t *)zbx_hashset_insert(&cache->dservices, &dservice_local,
+					sizeof(dservice_local));
 		}
 	}
 	else
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "service is already in database");
 
-		ZBX_STR2UINT64(dservice->dserviceid, row[0]);
-		ZBX_STR2UINT64(dhostid, row[1]);
-		dservice->status = atoi(row[2]);
-		dservice->lastup = atoi(row[3]);
-		dservice->lastdown = atoi(row[4]);
-		dservice->value = zbx_strdup(dservice->value, row[5]);
-
-		if (dhostid != dhost->dhostid)
+		if (dservice->dhostid != dhost->dhostid)
 		{
+			zbx_uint64_t	dhostid = dservice->dhostid;
+
 			zbx_db_execute("update dservices"
 					" set dhostid=" ZBX_FS_UI64
 					" where dhostid=" ZBX_FS_UI64,
@@ -267,9 +429,11 @@ static void	discovery_register_service(zbx_uint64_t dcheckid, zbx_db_dhost *dhos
 			zbx_db_execute("delete from dhosts"
 					" where dhostid=" ZBX_FS_UI64,
 					dhostid);
+
+			discovery_cache_move_dservices(cache, dhostid, dhost->dhostid, NULL);
 		}
 
-		if (0 != strcmp(row[6], dns))
+		if (0 != strcmp(dservice->dns, dns))
 		{
 			dns_esc = zbx_db_dyn_escape_field("dservices", "dns", dns);
 
@@ -279,13 +443,14 @@ static void	discovery_register_service(zbx_uint64_t dcheckid, zbx_db_dhost *dhos
 					dns_esc, dservice->dserviceid);
 
 			zbx_free(dns_esc);
+
+			dservice->dns = zbx_strdup(dservice->dns, dns);
 		}
 	}
-	zbx_db_free_result(result);
-
-	zbx_free(ip_esc);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+
+	return dservice;
 }
 
 /******************************************************************************
@@ -293,7 +458,7 @@ static void	discovery_register_service(zbx_uint64_t dcheckid, zbx_db_dhost *dhos
  * Purpose: update discovered service details                                 *
  *                                                                            *
  ******************************************************************************/
-static void	discovery_update_dservice(zbx_uint64_t dserviceid, int status, int lastup, int lastdown,
+static void	discovery_update_dservice(zbx_discovery_dservice_t *dservice, int status, int lastup, int lastdown,
 		const char *value)
 {
 	char	*value_esc;
@@ -301,9 +466,16 @@ static void	discovery_update_dservice(zbx_uint64_t dserviceid, int status, int l
 	value_esc = zbx_db_dyn_escape_field("dservices", "value", value);
 
 	zbx_db_execute("update dservices set status=%d,lastup=%d,lastdown=%d,value='%s' where dserviceid=" ZBX_FS_UI64,
-			status, lastup, lastdown, value_esc, dserviceid);
+			status, lastup, lastdown, value_esc, dservice->dserviceid);
 
 	zbx_free(value_esc);
+
+	dservice->status = status;
+	dservice->lastup = lastup;
+	dservice->lastdown = lastdown;
+
+	if (value != dservice->value)
+		dservice->value = zbx_strdup(dservice->value, value);
 }
 
 /******************************************************************************
@@ -311,15 +483,18 @@ static void	discovery_update_dservice(zbx_uint64_t dserviceid, int status, int l
  * Purpose: update discovered service details                                 *
  *                                                                            *
  ******************************************************************************/
-static void	discovery_update_dservice_value(zbx_uint64_t dserviceid, const char *value)
+static void	discovery_update_dservice_value(zbx_discovery_dservice_t *dservice, const char *value)
 {
 	char	*value_esc;
 
 	value_esc = zbx_db_dyn_escape_field("dservices", "value", value);
 
-	zbx_db_execute("update dservices set value='%s' where dserviceid=" ZBX_FS_UI64, value_esc, dserviceid);
+	zbx_db_execute("update dservices set value='%s' where dserviceid=" ZBX_FS_UI64, value_esc,
+			dservice->dserviceid);
 
 	zbx_free(value_esc);
+
+	dservice->value = zbx_strdup(dservice->value, value);
 }
 
 /******************************************************************************
@@ -338,8 +513,8 @@ static void	discovery_update_dhost(const zbx_db_dhost *dhost)
  * Purpose: process and update the new service status                         *
  *                                                                            *
  ******************************************************************************/
-static void	discovery_update_service_status(zbx_db_dhost *dhost, const DB_DSERVICE *dservice, int service_status,
-		const char *value, int now, zbx_add_event_func_t add_event_cb)
+static void	discovery_update_service_status(zbx_db_dhost *dhost, zbx_discovery_dservice_t *dservice,
+		int service_status, const char *value, int now, zbx_add_event_func_t add_event_cb)
 {
 	zbx_timespec_t	ts;
 
@@ -352,7 +527,7 @@ static void	discovery_update_service_status(zbx_db_dhost *dhost, const DB_DSERVI
 	{
 		if (DOBJECT_STATUS_DOWN == dservice->status || 0 == dservice->lastup)
 		{
-			discovery_update_dservice(dservice->dserviceid, service_status, now, 0, value);
+			discovery_update_dservice(dservice, service_status, now, 0, value);
 
 			if (NULL != add_event_cb)
 			{
@@ -381,14 +556,14 @@ static void	discovery_update_service_status(zbx_db_dhost *dhost, const DB_DSERVI
 		}
 		else if (0 != strcmp(dservice->value, value))
 		{
-			discovery_update_dservice_value(dservice->dserviceid, value);
+			discovery_update_dservice_value(dservice, value);
 		}
 	}
 	else	/* DOBJECT_STATUS_DOWN */
 	{
 		if (DOBJECT_STATUS_UP == dservice->status || 0 == dservice->lastdown)
 		{
-			discovery_update_dservice(dservice->dserviceid, service_status, 0, now, dservice->value);
+			discovery_update_dservice(dservice, service_status, 0, now, dservice->value);
 
 			if (NULL != add_event_cb)
 			{
@@ -498,38 +673,117 @@ void	zbx_discovery_update_service(void *handle, zbx_uint64_t druleid, zbx_uint64
 		zbx_uint64_t unique_dcheckid, zbx_db_dhost *dhost, const char *ip, const char *dns, int port,
 		int status, const char *value, time_t now, zbx_add_event_func_t add_event_cb)
 {
-	DB_DSERVICE	dservice;
+	zbx_discovery_cache_t		*cache = (zbx_discovery_cache_t *)handle, cache_local;
+	zbx_discovery_dservice_t	*dservice = NULL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() ip:'%s' dns:'%s' port:%d status:%d value:'%s'",
 			__func__, ip, dns, port, status, value);
 
-	ZBX_UNUSED(handle);
-
-	memset(&dservice, 0, sizeof(dservice));
+	if (NULL == cache)
+	{
+		discovery_cache_init(&cache_local);
+		cache = &cache_local;
+	}
 
 	/* register host if is not registered yet */
 	if (0 == dhost->dhostid)
-		discovery_register_host(druleid, dcheckid, unique_dcheckid, dhost, ip, port, status, value);
+		discovery_register_host(cache, druleid, dcheckid, unique_dcheckid, dhost, ip, port, status, value);
 
 	/* register service if is not registered yet */
 	if (0 != dhost->dhostid)
-		discovery_register_service(dcheckid, dhost, &dservice, ip, dns, port, status);
+		dservice = discovery_register_service(cache, dcheckid, dhost, ip, dns, port, status);
 
 	/* service was not registered because we do not add down service */
-	if (0 != dservice.dserviceid)
-		discovery_update_service_status(dhost, &dservice, status, value, (int)now, add_event_cb);
+	if (NULL != dservice)
+		discovery_update_service_status(dhost, dservice, status, value, (int)now, add_event_cb);
 
-	zbx_free(dservice.value);
+	if (&cache_local == cache)
+		discovery_cache_destroy(&cache_local);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
 void	*zbx_discovery_open(void)
 {
-	return NULL;
+	zbx_discovery_cache_t	*cache;
+
+	cache = (zbx_discovery_cache_t *)zbx_malloc(NULL, sizeof(zbx_discovery_cache_t));
+	discovery_cache_init(cache);
+
+	return cache;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: load discovered services of the specified checks and addresses    *
+ *          with a single query                                               *
+ *                                                                            *
+ * Parameters: handle    - [IN] discovery handle                              *
+ *             dcheckids - [IN] discovery check identifiers                   *
+ *             ips       - [IN] discovered addresses                          *
+ *                                                                            *
+ * Comments: Must be called at most once per handle, before any updates.     *
+ *           Services of other checks or addresses are still read from        *
+ *           database one by one.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_discovery_prefetch(void *handle, const zbx_vector_uint64_t *dcheckids, const zbx_vector_str_t *ips)
+{
+	zbx_discovery_cache_t	*cache = (zbx_discovery_cache_t *)handle;
+	zbx_vector_str_t	ips_uniq;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	int			i;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() dcheckids:%d ips:%d", __func__, dcheckids->values_num,
+			ips->values_num);
+
+	if (0 == dcheckids->values_num || 0 == ips->values_num)
+		goto out;
+
+	zbx_vector_uint64_append_array(&cache->dcheckids, dcheckids->values, dcheckids->values_num);
+	zbx_vector_uint64_sort(&cache->dcheckids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(&cache->dcheckids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	zbx_vector_str_create(&ips_uniq);
+	zbx_vector_str_append_array(&ips_uniq, ips->values, ips->values_num);
+	zbx_vector_str_sort(&ips_uniq, ZBX_DEFAULT_STR_COMPARE_FUNC);
+	zbx_vector_str_uniq(&ips_uniq, ZBX_DEFAULT_STR_COMPARE_FUNC);
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select dcheckid,ip,port,dserviceid,dhostid,status,lastup,lastdown,value,dns"
+			" from dservices"
+			" where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "dcheckid", dcheckids->values,
+			dcheckids->values_num);
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " and");
+	zbx_db_add_str_condition_alloc(&sql, &sql_alloc, &sql_offset, "ip", (const char * const *)ips_uniq.values,
+			ips_uniq.values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+		discovery_cache_add(cache, row);
+
+	zbx_db_free_result(result);
+
+	for (i = 0; i < ips_uniq.values_num; i++)
+		zbx_vector_str_append(&cache->ips, zbx_strdup(NULL, ips_uniq.values[i]));
+
+	zbx_vector_str_sort(&cache->ips, ZBX_DEFAULT_STR_COMPARE_FUNC);
+
+	zbx_vector_str_destroy(&ips_uniq);
+	zbx_free(sql);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() dservices:%d", __func__, cache->dservices.num_data);
 }
 
 void	zbx_discovery_close(void *handle)
 {
-	ZBX_UNUSED(handle);
+	zbx_discovery_cache_t	*cache = (zbx_discovery_cache_t *)handle;
+
+	discovery_cache_destroy(cache);
+	zbx_free(cache);
 }
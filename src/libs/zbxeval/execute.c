@@ -3018,6 +3018,9 @@ static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, cha
 
 	zbx_vector_var_create(&output);
 
+	/* the output stack cannot grow larger than the number of tokens */
+	zbx_vector_var_reserve(&output, (size_t)ctx->stack.values_num);
+
 	for (i = 0; i < ctx->stack.values_num; i++)
 	{
 		zbx_eval_token_t	*token = &ctx->stack.values[i];
@@ -210,6 +210,22 @@ static int	open_export_file(zbx_export_file_t *file, char **error)
 		return FAIL;
 	}
 
+	if (-1 == (file->offset = ftell(file->file)))
+	{
+		*error = zbx_dsprintf(*error, "cannot get current position in export file '%s': %s",
+				file->name, zbx_strerror(errno));
+
+		if (0 != fclose(file->file))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "cannot close export file '%s': %s", file->name,
+					zbx_strerror(errno));
+		}
+
+		file->file = NULL;
+
+		return FAIL;
+	}
+
 	zabbix_log(LOG_LEVEL_DEBUG, "successfully created export file '%s'", file->name);
 
 	return SUCCEED;
@@ -242,6 +258,7 @@ static zbx_export_file_t	*export_init(const char *process_type, const char *proc
 	}
 
 	file->missing = 0;
+	file->checked = 0;
 
 	return file;
 }
@@ -284,7 +301,6 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 	static time_t	last_log_time = 0;
 	time_t		now;
 	char		*error_msg = NULL;
-	long		file_offset;
 
 	if (NULL == config_export)
 	{
@@ -292,7 +308,8 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		exit(EXIT_FAILURE);
 	}
 
-	if (0 == file->missing && 0 != access(file->name, F_OK))
+	/* check if export file was removed once per flush instead of every record */
+	if (0 == file->missing && 0 == file->checked && 0 != access(file->name, F_OK))
 	{
 		if (NULL != file->file && 0 != fclose(file->file))
 			zabbix_log(LOG_LEVEL_DEBUG, "cannot close export file '%s': %s",file->name,
@@ -301,6 +318,8 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		file->file = NULL;
 	}
 
+	file->checked = 1;
+
 	if (NULL == file->file && FAIL == open_export_file(file, &error_msg))
 	{
 		file->missing = 1;
@@ -313,14 +332,7 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		zabbix_log(LOG_LEVEL_ERR, "regained access to export file '%s'", file->name);
 	}
 
-	if (-1 == (file_offset = ftell(file->file)))
-	{
-		error_msg = zbx_dsprintf(error_msg, "cannot get current position in export file '%s': %s",
-				file->name, zbx_strerror(errno));
-		goto error;
-	}
-
-	if (config_export->file_size <= count + (size_t)file_offset + 1)
+	if (config_export->file_size <= count + (size_t)file->offset + 1)
 	{
 		char	filename_old[MAX_STRING_LEN];
 
@@ -361,6 +373,8 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		goto error;
 	}
 
+	file->offset += (long)count + 1;
+
 	return;
 error:
 	if (NULL != file->file && 0 != fclose(file->file))
@@ -400,7 +414,12 @@ void	zbx_trends_export_write(const char *buf, size_t count)
 
 static void	export_flush(zbx_export_file_t *file)
 {
-	if (NULL != file && NULL != file->file && 0 != fflush(file->file))
+	if (NULL == file)
+		return;
+
+	file->checked = 0;
+
+	if (NULL != file->file && 0 != fflush(file->file))
 		zabbix_log(LOG_LEVEL_ERR, "cannot flush export file '%s': %s", file->name, zbx_strerror(errno));
 }
 
@@ -1583,6 +1583,23 @@ out:
 #undef OP_IREGEXP
 #undef OP_BITAND
 
+typedef struct
+{
+	zbx_history_value_t	result;
+	unsigned char		value_type;
+}
+zbx_eval_sum_t;
+
+static void	evaluate_fold_sum(const zbx_history_record_t *record, void *data)
+{
+	zbx_eval_sum_t	*sum = (zbx_eval_sum_t *)data;
+
+	if (ITEM_VALUE_TYPE_FLOAT == sum->value_type)
+		sum->result.dbl += record->value.dbl;
+	else
+		sum->result.ui64 += record->value.ui64;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluate function 'sum' for the item.                             *
@@ -1601,16 +1618,13 @@ out:
 static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
 		const zbx_timespec_t *ts, char **error)
 {
-	int				arg1, i, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
-	zbx_value_type_t		arg1_type;
-	zbx_vector_history_record_t	values;
-	zbx_history_value_t		result;
-	zbx_timespec_t			ts_end = *ts;
+	int			arg1, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
+	zbx_value_type_t	arg1_type;
+	zbx_eval_sum_t		sum;
+	zbx_timespec_t		ts_end = *ts;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_history_record_vector_create(&values);
-
 	if (ITEM_VALUE_TYPE_FLOAT != item->value_type && ITEM_VALUE_TYPE_UINT64 != item->value_type)
 	{
 		*error = zbx_strdup(*error, "invalid value type");
@@ -1644,37 +1658,48 @@ static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
-	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
-	{
-		*error = zbx_strdup(*error, "cannot get values from value cache");
-		goto out;
-	}
+	sum.value_type = item->value_type;
 
 	if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
-	{
-		result.dbl = 0;
-
-		for (i = 0; i < values.values_num; i++)
-			result.dbl += values.values[i].value.dbl;
-	}
+		sum.result.dbl = 0;
 	else
-	{
-		result.ui64 = 0;
+		sum.result.ui64 = 0;
 
-		for (i = 0; i < values.values_num; i++)
-			result.ui64 += values.values[i].value.ui64;
+	if (FAIL == zbx_vc_fold_values(item->itemid, item->value_type, seconds, nvalues, &ts_end, evaluate_fold_sum,
+			&sum))
+	{
+		*error = zbx_strdup(*error, "cannot get values from value cache");
+		goto out;
 	}
 
-	zbx_history_value2variant(&result, item->value_type, value);
+	zbx_history_value2variant(&sum.result, item->value_type, value);
 	ret = SUCCEED;
 out:
-	zbx_history_record_vector_destroy(&values, item->value_type);
-
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
 	return ret;
 }
 
+typedef struct
+{
+	double		avg;
+	int		values_num;
+	unsigned char	value_type;
+}
+zbx_eval_avg_t;
+
+static void	evaluate_fold_avg(const zbx_history_record_t *record, void *data)
+{
+	zbx_eval_avg_t	*avg = (zbx_eval_avg_t *)data;
+
+	avg->values_num++;
+
+	if (ITEM_VALUE_TYPE_FLOAT == avg->value_type)
+		avg->avg += record->value.dbl / avg->values_num - avg->avg / avg->values_num;
+	else
+		avg->avg += (double)record->value.ui64;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluate function 'avg' for the item.                             *
@@ -1693,15 +1718,13 @@ out:
 static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
 		const zbx_timespec_t *ts, char **error)
 {
-	int				arg1, ret = FAIL, i, seconds = 0, nvalues = 0, time_shift;
-	zbx_value_type_t		arg1_type;
-	zbx_vector_history_record_t	values;
-	zbx_timespec_t			ts_end = *ts;
+	int			arg1, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
+	zbx_value_type_t	arg1_type;
+	zbx_eval_avg_t		avg = {.avg = 0};
+	zbx_timespec_t		ts_end = *ts;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_history_record_vector_create(&values);
-
 	if (ITEM_VALUE_TYPE_FLOAT != item->value_type && ITEM_VALUE_TYPE_UINT64 != item->value_type)
 	{
 		*error = zbx_strdup(*error, "invalid value type");
@@ -1735,29 +1758,21 @@ static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
-	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
+	avg.value_type = item->value_type;
+
+	if (FAIL == zbx_vc_fold_values(item->itemid, item->value_type, seconds, nvalues, &ts_end, evaluate_fold_avg,
+			&avg))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
 		goto out;
 	}
 
-	if (0 < values.values_num)
+	if (0 < avg.values_num)
 	{
-		double	avg = 0;
-
-		if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
-		{
-			for (i = 0; i < values.values_num; i++)
-				avg += values.values[i].value.dbl / (i + 1) - avg / (i + 1);
-		}
-		else
-		{
-			for (i = 0; i < values.values_num; i++)
-				avg += (double)values.values[i].value.ui64;
+		if (ITEM_VALUE_TYPE_UINT64 == item->value_type)
+			avg.avg = avg.avg / avg.values_num;
 
-			avg = avg / values.values_num;
-		}
-		zbx_variant_set_dbl(value, avg);
+		zbx_variant_set_dbl(value, avg.avg);
 
 		ret = SUCCEED;
 	}
@@ -1767,8 +1782,6 @@ static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 		*error = zbx_strdup(*error, "not enough data");
 	}
 out:
-	zbx_history_record_vector_destroy(&values, item->value_type);
-
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
 	return ret;
@@ -1811,16 +1824,42 @@ static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 #define EVALUATE_MIN	0
 #define EVALUATE_MAX	1
 
-#define LOOP_FIND_MIN_OR_MAX(type, mode_op)							\
-	do											\
-	{											\
-		for (i = 1; i < values.values_num; i++)							\
-		{											\
-			if (values.values[i].value.type mode_op values.values[index].value.type)	\
-				index = i;								\
-		}											\
-	}												\
-	while(0)
+typedef struct
+{
+	zbx_history_value_t	value;
+	int			values_num;
+	unsigned char		value_type;
+	int			min_or_max;
+}
+zbx_eval_min_or_max_t;
+
+static void	evaluate_fold_min_or_max(const zbx_history_record_t *record, void *data)
+{
+	zbx_eval_min_or_max_t	*mm = (zbx_eval_min_or_max_t *)data;
+
+	if (0 == mm->values_num++)
+	{
+		mm->value = record->value;
+		return;
+	}
+
+	if (ITEM_VALUE_TYPE_UINT64 == mm->value_type)
+	{
+		if (EVALUATE_MIN == mm->min_or_max ? record->value.ui64 < mm->value.ui64 :
+				record->value.ui64 > mm->value.ui64)
+		{
+			mm->value.ui64 = record->value.ui64;
+		}
+	}
+	else
+	{
+		if (EVALUATE_MIN == mm->min_or_max ? record->value.dbl < mm->value.dbl :
+				record->value.dbl > mm->value.dbl)
+		{
+			mm->value.dbl = record->value.dbl;
+		}
+	}
+}
 
 /******************************************************************************
  *                                                                            *
@@ -1841,15 +1880,13 @@ static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
 		const zbx_timespec_t *ts, char **error, int min_or_max)
 {
-	int				arg1, i, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
-	zbx_value_type_t		arg1_type;
-	zbx_vector_history_record_t	values;
-	zbx_timespec_t			ts_end = *ts;
+	int			arg1, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
+	zbx_value_type_t	arg1_type;
+	zbx_eval_min_or_max_t	mm = {.values_num = 0};
+	zbx_timespec_t		ts_end = *ts;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_history_record_vector_create(&values);
-
 	if (ITEM_VALUE_TYPE_FLOAT != item->value_type && ITEM_VALUE_TYPE_UINT64 != item->value_type)
 	{
 		*error = zbx_strdup(*error, "invalid value type");
@@ -1883,40 +1920,19 @@ static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
-	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
+	mm.value_type = item->value_type;
+	mm.min_or_max = min_or_max;
+
+	if (FAIL == zbx_vc_fold_values(item->itemid, item->value_type, seconds, nvalues, &ts_end,
+			evaluate_fold_min_or_max, &mm))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
 		goto out;
 	}
 
-	if (0 < values.values_num)
+	if (0 < mm.values_num)
 	{
-		int	index = 0;
-
-		if (ITEM_VALUE_TYPE_UINT64 == item->value_type)
-		{
-			if (EVALUATE_MIN == min_or_max)
-			{
-				LOOP_FIND_MIN_OR_MAX(ui64, <);
-			}
-			else
-			{
-				LOOP_FIND_MIN_OR_MAX(ui64, >);
-			}
-		}
-		else
-		{
-			if (EVALUATE_MIN == min_or_max)
-			{
-				LOOP_FIND_MIN_OR_MAX(dbl, <);
-			}
-			else
-			{
-				LOOP_FIND_MIN_OR_MAX(dbl, >);
-			}
-		}
-
-		zbx_history_value2variant(&values.values[index].value, item->value_type, value);
+		zbx_history_value2variant(&mm.value, item->value_type, value);
 		ret = SUCCEED;
 	}
 	else
@@ -1925,8 +1941,6 @@ static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_
 		*error = zbx_strdup(*error, "not enough data");
 	}
 out:
-	zbx_history_record_vector_destroy(&values, item->value_type);
-
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
 	return ret;
@@ -744,6 +744,62 @@ out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() items:%d", __func__, (SUCCEED == ret ? data->itemids.values_num : -1));
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find already initialized many item query with the same host, key  *
+ *          and filter as the specified query                                 *
+ *                                                                            *
+ * Parameters: eval  - [IN] evaluation data                                   *
+ *             index - [IN] index of the query to match in eval->queries      *
+ *                                                                            *
+ * Return value: the matching query or NULL if not found                      *
+ *                                                                            *
+ ******************************************************************************/
+static const zbx_expression_query_t	*expression_find_query_many(const zbx_expression_eval_t *eval, int index)
+{
+	const zbx_expression_query_t	*query = eval->queries.values[index];
+
+	for (int i = 0; i < index; i++)
+	{
+		const zbx_expression_query_t	*prev = eval->queries.values[i];
+
+		if (prev->flags != query->flags || NULL == prev->data)
+			continue;
+
+		if (0 == zbx_strcmp_null(prev->ref.host, query->ref.host) &&
+				0 == zbx_strcmp_null(prev->ref.key, query->ref.key) &&
+				0 == zbx_strcmp_null(prev->ref.filter, query->ref.filter))
+		{
+			return prev;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize many item query by copying matching items from another *
+ *          query with the same host, key and filter                          *
+ *                                                                            *
+ * Parameters: eval   - [IN] evaluation data                                  *
+ *             query  - [IN] query to initialize                              *
+ *             source - [IN] already initialized query                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	expression_copy_query_many(zbx_expression_eval_t *eval, zbx_expression_query_t *query,
+		const zbx_expression_query_t *source)
+{
+	zbx_expression_query_many_t		*data;
+	const zbx_expression_query_many_t	*source_data = (const zbx_expression_query_many_t *)source->data;
+
+	data = (zbx_expression_query_many_t *)zbx_malloc(NULL, sizeof(zbx_expression_query_many_t));
+	zbx_vector_uint64_create(&data->itemids);
+	zbx_vector_uint64_append_array(&data->itemids, source_data->itemids.values, source_data->itemids.values_num);
+	query->data = data;
+	eval->many_num++;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: cache items used in one item queries.                             *
@@ -2219,7 +2275,16 @@ int	zbx_expression_eval_execute(zbx_expression_eval_t *eval, const zbx_timespec_
 		if (ZBX_ITEM_QUERY_ERROR != query->flags)
 		{
 			if (0 != (query->flags & ZBX_ITEM_QUERY_MANY))
-				expression_init_query_many(eval, query);
+			{
+				const zbx_expression_query_t	*source;
+
+				/* the same query used by several functions, for example avg() and count() */
+				/* over the same host group, is resolved only once                         */
+				if (NULL != (source = expression_find_query_many(eval, i)))
+					expression_copy_query_many(eval, query, source);
+				else
+					expression_init_query_many(eval, query);
+			}
 			else
 				expression_init_query_one(eval, query);
 		}
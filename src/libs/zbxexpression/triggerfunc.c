@@ -19,6 +19,7 @@
 
 #include "evalfunc.h"
 #include "expression.h"
+#include "funcparam.h"
 
 #include "zbxdbhigh.h"
 #include "zbxcacheconfig.h"
@@ -32,7 +33,9 @@
 #include "zbxeval.h"
 #include "zbxexpression.h"
 #include "zbxnum.h"
+#include "zbxparam.h"
 #include "zbxtime.h"
+#include "zbxtrends.h"
 
 static void	zbx_extract_functionids(zbx_vector_uint64_t *functionids, zbx_vector_dc_trigger_t *triggers)
 {
@@ -362,6 +365,157 @@ static void	zbx_populate_function_items(const zbx_vector_uint64_t *functionids,
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() ifuncs_num:%d", __func__, ifuncs->num_data);
 }
 
+typedef struct
+{
+	const char		*table;
+	const char		*function;
+	time_t			start;
+	time_t			end;
+	zbx_vector_uint64_t	itemids;
+}
+zbx_trend_prefetch_t;
+
+static zbx_hash_t	trend_prefetch_hash_func(const void *data)
+{
+	const zbx_trend_prefetch_t	*prefetch = (const zbx_trend_prefetch_t *)data;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_STRING_HASH_FUNC(prefetch->function);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(prefetch->table, strlen(prefetch->table), hash);
+	hash = ZBX_DEFAULT_HASH_ALGO(&prefetch->start, sizeof(prefetch->start), hash);
+	hash = ZBX_DEFAULT_HASH_ALGO(&prefetch->end, sizeof(prefetch->end), hash);
+
+	return hash;
+}
+
+static int	trend_prefetch_compare_func(const void *d1, const void *d2)
+{
+	const zbx_trend_prefetch_t	*prefetch1 = (const zbx_trend_prefetch_t *)d1;
+	const zbx_trend_prefetch_t	*prefetch2 = (const zbx_trend_prefetch_t *)d2;
+	int				ret;
+
+	ZBX_RETURN_IF_NOT_EQUAL(prefetch1->start, prefetch2->start);
+	ZBX_RETURN_IF_NOT_EQUAL(prefetch1->end, prefetch2->end);
+
+	if (0 != (ret = strcmp(prefetch1->function, prefetch2->function)))
+		return ret;
+
+	return strcmp(prefetch1->table, prefetch2->table);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: fetch trend function values for items grouped by function and     *
+ *          period with single query per group                                *
+ *                                                                            *
+ * Parameters: funcs            - [IN] functions to evaluate                  *
+ *             history_itemids  - [IN] items from history cache               *
+ *             history_items    - [IN]                                        *
+ *             history_errcodes - [IN]                                        *
+ *             items            - [IN] other items used in functions          *
+ *             items_err        - [IN]                                        *
+ *             itemids          - [IN] identifiers of other items             *
+ *                                                                            *
+ * Comments: The fetched values are stored in trend function cache and later  *
+ *           retrieved from there by evaluate_function().                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	prefetch_trend_functions(zbx_hashset_t *funcs, const zbx_vector_uint64_t *history_itemids,
+		const zbx_history_sync_item_t *history_items, const int *history_errcodes,
+		const zbx_history_sync_item_t *items, const int *items_err, const zbx_vector_uint64_t *itemids)
+{
+	zbx_hashset_t		prefetches;
+	zbx_hashset_iter_t	iter;
+	zbx_func_t		*func;
+	zbx_trend_prefetch_t	*prefetch, prefetch_local;
+	int			i;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	zbx_hashset_create(&prefetches, 0, trend_prefetch_hash_func, trend_prefetch_compare_func);
+
+	zbx_hashset_iter_reset(funcs, &iter);
+	while (NULL != (func = (zbx_func_t *)zbx_hashset_iter_next(&iter)))
+	{
+		const zbx_history_sync_item_t	*item;
+		char				*params, *period = NULL, *error = NULL;
+		int				errcode;
+
+		if (ZBX_FUNCTION_TYPE_TRENDS != func->type || 0 == strcmp(func->function, "trendstl"))
+			continue;
+
+		if (FAIL != (i = zbx_vector_uint64_bsearch(history_itemids, func->itemid,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
+		{
+			item = history_items + i;
+			errcode = history_errcodes[i];
+		}
+		else
+		{
+			i = zbx_vector_uint64_bsearch(itemids, func->itemid, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+			item = items + i;
+			errcode = items_err[i];
+		}
+
+		if (SUCCEED != errcode || ITEM_STATUS_ACTIVE != item->status || 0 == item->trends ||
+				HOST_STATUS_MONITORED != item->host.status)
+		{
+			continue;
+		}
+
+		switch (item->value_type)
+		{
+			case ITEM_VALUE_TYPE_FLOAT:
+				prefetch_local.table = "trends";
+				break;
+			case ITEM_VALUE_TYPE_UINT64:
+				prefetch_local.table = "trends_uint";
+				break;
+			default:
+				continue;
+		}
+
+		params = zbx_dc_expand_user_macros_in_func_params(func->parameter, item->host.hostid);
+
+		if (1 == zbx_num_param(params) && SUCCEED == get_function_parameter_str(params, 1, &period) &&
+				SUCCEED == zbx_trends_parse_range(func->timespec.sec, period, &prefetch_local.start,
+				&prefetch_local.end, &error))
+		{
+			prefetch_local.function = func->function + ZBX_CONST_STRLEN("trend");
+
+			if (NULL == (prefetch = (zbx_trend_prefetch_t *)zbx_hashset_search(&prefetches,
+					&prefetch_local)))
+			{
+				prefetch = (zbx_trend_prefetch_t *)zbx_hashset_insert(&prefetches, &prefetch_local,
+						sizeof(prefetch_local));
+				zbx_vector_uint64_create(&prefetch->itemids);
+			}
+
+			zbx_vector_uint64_append(&prefetch->itemids, item->itemid);
+		}
+
+		zbx_free(error);
+		zbx_free(period);
+		zbx_free(params);
+	}
+
+	zbx_hashset_iter_reset(&prefetches, &iter);
+	while (NULL != (prefetch = (zbx_trend_prefetch_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (1 < prefetch->itemids.values_num)
+		{
+			zbx_trends_prefetch(prefetch->table, prefetch->function, prefetch->start, prefetch->end,
+					&prefetch->itemids);
+		}
+
+		zbx_vector_uint64_destroy(&prefetch->itemids);
+	}
+
+	zbx_hashset_destroy(&prefetches);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
 static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_uint64_t *history_itemids,
 		const zbx_history_sync_item_t *history_items, const int *history_errcodes,
 		zbx_history_sync_item_t **items, int **items_err, int *items_num)
@@ -397,6 +551,9 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 				(size_t)itemids.values_num, ZBX_ITEM_GET_SYNC);
 	}
 
+	prefetch_trend_functions(funcs, history_itemids, history_items, history_errcodes, *items, *items_err,
+			&itemids);
+
 	zbx_hashset_iter_reset(funcs, &iter);
 	while (NULL != (func = (zbx_func_t *)zbx_hashset_iter_next(&iter)))
 	{
@@ -741,7 +898,7 @@ void	zbx_evaluate_expressions(zbx_vector_dc_trigger_t *triggers, const zbx_vecto
 	zbx_db_event		event;
 	zbx_dc_trigger_t	*tr;
 	zbx_history_sync_item_t	*items = NULL;
-	int			i, *items_err, items_num = 0;
+	int			i, *items_err = NULL, items_num = 0;
 	double			expr_result;
 	zbx_dc_um_handle_t	*um_handle;
 	zbx_vector_uint64_t	hostids;
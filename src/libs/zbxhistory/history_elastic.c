@@ -323,6 +323,81 @@ static int	elastic_is_error_present(zbx_httppage_t *page, char **err)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove successfully indexed and rejected documents from bulk      *
+ *          request, leaving only documents that can succeed on retry         *
+ *                                                                            *
+ * Parameters: data - [IN/OUT] the elastic data with bulk request buffer      *
+ *             page - [IN] the buffer with bulk json response                 *
+ *                                                                            *
+ * Return value: the number of documents left for retry or                    *
+ *               FAIL if the response cannot be matched to the request        *
+ *                                                                            *
+ * Comments: Only documents failed with 429 (too many requests) or 5xx status *
+ *           are retried, other failures are caused by the document itself,  *
+ *           so retrying them would fail again.                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	elastic_bulk_filter_retries(zbx_elastic_data_t *data, const zbx_httppage_t *page)
+{
+	struct zbx_json_parse	jp, jp_items, jp_item, jp_action;
+	const char		*p = NULL, *action, *line = data->buf, *next;
+	char			name[MAX_ID_LEN], status[MAX_ID_LEN], *buf = NULL;
+	size_t			buf_alloc = 0, buf_offset = 0;
+	int			retries = 0, rejected = 0, status_code;
+
+	if (SUCCEED != zbx_json_open(page->data, &jp) || SUCCEED != zbx_json_brackets_by_name(&jp, "items", &jp_items))
+		return FAIL;
+
+	while (NULL != (p = zbx_json_next(&jp_items, p)))
+	{
+		/* each document consists of action and source lines */
+		if (NULL == (next = strchr(line, '\n')) || NULL == (next = strchr(next + 1, '\n')))
+			goto fail;
+
+		next++;
+
+		if (SUCCEED != zbx_json_brackets_open(p, &jp_item) ||
+				NULL == (action = zbx_json_pair_next(&jp_item, NULL, name, sizeof(name))) ||
+				SUCCEED != zbx_json_brackets_open(action, &jp_action) ||
+				SUCCEED != zbx_json_value_by_name(&jp_action, "status", status, sizeof(status), NULL))
+		{
+			goto fail;
+		}
+
+		if (NULL != zbx_json_pair_by_name(&jp_action, "error"))
+		{
+			status_code = atoi(status);
+
+			if (429 == status_code || 500 <= status_code)
+			{
+				zbx_strncpy_alloc(&buf, &buf_alloc, &buf_offset, line, (size_t)(next - line));
+				retries++;
+			}
+			else
+				rejected++;
+		}
+
+		line = next;
+	}
+
+	if ('\0' != *line)
+		goto fail;
+
+	if (0 != rejected)
+		zabbix_log(LOG_LEVEL_WARNING, "elasticsearch rejected %d history values", rejected);
+
+	zbx_free(data->buf);
+	data->buf = buf;
+
+	return retries;
+fail:
+	zbx_free(buf);
+
+	return FAIL;
+}
+
 /******************************************************************************************************************
  *                                                                                                                *
  * common sql service support                                                                                     *
@@ -341,7 +416,8 @@ static void	elastic_writer_init(void)
 
 	zbx_vector_ptr_create(&writer.ifaces);
 
-	if (NULL == (writer.handle = curl_multi_init()))
+	/* multi handle is kept between batches to reuse its connection cache */
+	if (NULL == writer.handle && NULL == (writer.handle = curl_multi_init()))
 	{
 		zbx_error("Cannot initialize cURL multi session");
 		exit(EXIT_FAILURE);
@@ -363,9 +439,6 @@ static void	elastic_writer_release(void)
 	for (i = 0; i < writer.ifaces.values_num; i++)
 		elastic_close((zbx_history_iface_t *)writer.ifaces.values[i]);
 
-	curl_multi_cleanup(writer.handle);
-	writer.handle = NULL;
-
 	zbx_vector_ptr_destroy(&writer.ifaces);
 
 	writer.initialized = 0;
@@ -566,15 +639,44 @@ try_again:
 			else if (CURLE_OK == curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&curl_page)
 					&& SUCCEED == elastic_is_error_present(&curl_page->page, &error))
 			{
+				zbx_elastic_data_t	*data = NULL;
+
 				zabbix_log(LOG_LEVEL_WARNING, "%s() cannot send data to elasticsearch: %s",
 						__func__, error);
 				zbx_free(error);
 
+				curl_multi_remove_handle(writer.handle, msg->easy_handle);
+
+				for (i = 0; i < writer.ifaces.values_num; i++)
+				{
+					data = ((zbx_history_iface_t *)writer.ifaces.values[i])->data.elastic_data;
+
+					if (data->handle == msg->easy_handle)
+						break;
+				}
+
 				/* If the error is due to elastic internal problems (for example an index */
 				/* became read-only), we put the handle in a retry list and */
-				/* remove it from the current execution loop */
-				zbx_vector_ptr_append(&retries, msg->easy_handle);
-				curl_multi_remove_handle(writer.handle, msg->easy_handle);
+				/* remove it from the current execution loop. When possible only the */
+				/* documents that failed with temporary errors are sent again. */
+				if (i == writer.ifaces.values_num || FAIL == elastic_bulk_filter_retries(data,
+						&curl_page->page))
+				{
+					zbx_vector_ptr_append(&retries, msg->easy_handle);
+				}
+				else if (NULL != data->buf)
+				{
+					if (CURLE_OK != (err = curl_easy_setopt(data->handle, CURLOPT_POSTFIELDS,
+							data->buf)))
+					{
+						zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]",
+								(int)CURLOPT_POSTFIELDS, curl_easy_strerror(err));
+						ret = FAIL;
+						goto clean;
+					}
+
+					zbx_vector_ptr_append(&retries, msg->easy_handle);
+				}
 			}
 		}
 
@@ -588,7 +690,22 @@ try_again:
 	if (0 < retries.values_num)
 	{
 		for (i = 0; i < retries.values_num; i++)
+		{
+			zbx_curlpage_t	*curl_page;
+
+			/* reset response buffer, otherwise the new response would be appended to the old one */
+			if (CURLE_OK == curl_easy_getinfo(retries.values[i], CURLINFO_PRIVATE, (char **)&curl_page))
+			{
+				curl_page->page.offset = 0;
+
+				if (0 < curl_page->page.alloc)
+					*curl_page->page.data = '\0';
+
+				*curl_page->errbuf = '\0';
+			}
+
 			curl_multi_add_handle(writer.handle, retries.values[i]);
+		}
 
 		zbx_vector_ptr_clear(&retries);
 
@@ -627,6 +744,12 @@ static void	elastic_destroy(zbx_history_iface_t *hist)
 
 	elastic_close(hist);
 
+	if (0 == writer.initialized && NULL != writer.handle)
+	{
+		curl_multi_cleanup(writer.handle);
+		writer.handle = NULL;
+	}
+
 	zbx_free(data->base_url);
 	zbx_free(data);
 }
@@ -11,10 +11,24 @@
 #include "zbxalgo.h"
 #include "zbxstr.h"
 
+#include <sys/uio.h>
+
 #define ZBX_IPC_PATH_MAX	sizeof(((struct sockaddr_un *)0)->sun_path)
 
 #define ZBX_IPC_DATA_DUMP_SIZE		128
 
+/* the number of queued messages returned by IPC service before checking sockets again */
+#define ZBX_IPC_RECV_POLL_INTERVAL	32
+
+/* the maximum number of buffers and bytes written to IPC client with one call */
+#define ZBX_IPC_TX_IOV_MAX		64
+#define ZBX_IPC_TX_BATCH_SIZE		(256 * ZBX_KIBIBYTE)
+
+/* message data buffers of 2^ZBX_IPC_POOL_SHIFT_MIN - 2^ZBX_IPC_POOL_SHIFT_MAX bytes are recycled */
+#define ZBX_IPC_POOL_SHIFT_MIN		6
+#define ZBX_IPC_POOL_SHIFT_MAX		(ZBX_IPC_POOL_SHIFT_MIN + ZBX_IPC_POOL_CLASSES_NUM - 1)
+#define ZBX_IPC_POOL_LIMIT		64
+
 static char	ipc_path[ZBX_IPC_PATH_MAX] = {0};
 static size_t	ipc_path_root_len = 0;
 
@@ -188,6 +202,74 @@ static int	ipc_write_data(int fd, const unsigned char *data, zbx_uint32_t size,
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes message header and data to a socket with a single system   *
+ *          call when possible                                                *
+ *                                                                            *
+ * Parameters: fd          - [IN] the socket file descriptor                  *
+ *             header      - [IN] the unsent part of message header           *
+ *             header_size - [IN] the unsent header size                      *
+ *             data        - [IN] the message data                            *
+ *             size        - [IN] the message data size                       *
+ *             size_sent   - [OUT] the actual size written to socket          *
+ *                                                                            *
+ * Return value: SUCCEED - no socket errors were detected. Either the data or *
+ *                         a part of it was written to socket or a write to   *
+ *                         non-blocking socket would block                    *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The header and data are gathered by kernel, so large messages    *
+ *           are neither copied into an intermediate buffer nor split into    *
+ *           separate header and data writes.                                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_write_message_data(int fd, const unsigned char *header, zbx_uint32_t header_size,
+		const unsigned char *data, zbx_uint32_t size, zbx_uint32_t *size_sent)
+{
+	zbx_uint32_t	offset = 0, total = header_size + size;
+	int		ret = SUCCEED, iovcnt;
+	ssize_t		n;
+	struct iovec	iov[2];
+
+	while (offset != total)
+	{
+		if (offset < header_size)
+		{
+			iov[0].iov_base = (void *)(header + offset);
+			iov[0].iov_len = header_size - offset;
+			iov[1].iov_base = (void *)data;
+			iov[1].iov_len = size;
+			iovcnt = (0 != size ? 2 : 1);
+		}
+		else
+		{
+			iov[0].iov_base = (void *)(data + offset - header_size);
+			iov[0].iov_len = total - offset;
+			iovcnt = 1;
+		}
+
+		if (-1 == (n = writev(fd, iov, iovcnt)))
+		{
+			if (EINTR == errno)
+				continue;
+
+			if (EWOULDBLOCK == errno || EAGAIN == errno)
+				break;
+
+			zabbix_log(LOG_LEVEL_WARNING, "cannot write to IPC socket: %s", strerror(errno));
+			ret = FAIL;
+			break;
+		}
+
+		offset += n;
+	}
+
+	*size_sent = offset;
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: reads data from a socket                                          *
@@ -294,8 +376,7 @@ out:
 static int	ipc_socket_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const unsigned char *data,
 		zbx_uint32_t size, zbx_uint32_t *tx_size)
 {
-	int		ret;
-	zbx_uint32_t	size_data, buffer[ZBX_IPC_SOCKET_BUFFER_SIZE / sizeof(zbx_uint32_t)];
+	zbx_uint32_t	buffer[ZBX_IPC_SOCKET_BUFFER_SIZE / sizeof(zbx_uint32_t)];
 
 	buffer[0] = code;
 	buffer[1] = size;
@@ -308,24 +389,79 @@ static int	ipc_socket_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code
 		return ipc_write_data(csocket->fd, (unsigned char *)buffer, size + ZBX_IPC_HEADER_SIZE, tx_size);
 	}
 
-	if (FAIL == ipc_write_data(csocket->fd, (unsigned char *)buffer, ZBX_IPC_HEADER_SIZE, tx_size))
-		return FAIL;
+	return ipc_write_message_data(csocket->fd, (unsigned char *)buffer, ZBX_IPC_HEADER_SIZE, data, size,
+			tx_size);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates message data buffer, reusing released buffers of        *
+ *          service if possible                                               *
+ *                                                                            *
+ * Parameters: service - [IN] the IPC service, can be NULL                    *
+ *             size    - [IN] the required buffer size                        *
+ *                                                                            *
+ * Return value: The allocated buffer.                                        *
+ *                                                                            *
+ * Comments: Buffers in size class N have at least 2^N bytes, so the buffer   *
+ *           is taken from the class of the required size rounded up to the   *
+ *           power of two.                                                    *
+ *                                                                            *
+ ******************************************************************************/
+static unsigned char	*ipc_service_alloc_data(zbx_ipc_service_t *service, zbx_uint32_t size)
+{
+	int	shift = ZBX_IPC_POOL_SHIFT_MIN;
 
-	/* in the case of non-blocking sockets only a part of the header might be sent */
-	if (ZBX_IPC_HEADER_SIZE != *tx_size)
-		return SUCCEED;
+	if (NULL == service || (1 << ZBX_IPC_POOL_SHIFT_MAX) < size)
+		return (unsigned char *)zbx_malloc(NULL, size);
 
-	ret = ipc_write_data(csocket->fd, data, size, &size_data);
-	*tx_size += size_data;
+	while ((zbx_uint32_t)(1 << shift) < size)
+		shift++;
 
-	return ret;
+	if (0 != service->buffers_pool[shift - ZBX_IPC_POOL_SHIFT_MIN].values_num)
+	{
+		zbx_vector_ptr_t	*pool = &service->buffers_pool[shift - ZBX_IPC_POOL_SHIFT_MIN];
+		unsigned char		*data;
+
+		data = (unsigned char *)pool->values[pool->values_num - 1];
+		zbx_vector_ptr_remove_noorder(pool, pool->values_num - 1);
+
+		return data;
+	}
+
+	return (unsigned char *)zbx_malloc(NULL, size);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates message, reusing released messages of service if        *
+ *          possible                                                          *
+ *                                                                            *
+ * Parameters: service - [IN] the IPC service, can be NULL                    *
+ *                                                                            *
+ * Return value: The allocated message.                                       *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_ipc_message_t	*ipc_service_alloc_message(zbx_ipc_service_t *service)
+{
+	zbx_ipc_message_t	*message;
+
+	if (NULL == service || 0 == service->messages_pool.values_num)
+		return (zbx_ipc_message_t *)zbx_malloc(NULL, sizeof(zbx_ipc_message_t));
+
+	message = (zbx_ipc_message_t *)service->messages_pool.values[service->messages_pool.values_num - 1];
+	zbx_vector_ptr_remove_noorder(&service->messages_pool, service->messages_pool.values_num - 1);
+
+	return message;
 }
 
 /******************************************************************************
  *                                                                            *
  * Purpose: reads message header and data from buffer                         *
  *                                                                            *
- * Parameters: header      - [IN/OUT] the message header                      *
+ * Parameters: service     - [IN] the IPC service receiving message, can be   *
+ *                                NULL                                        *
+ *             header      - [IN/OUT] the message header                      *
  *             data        - [OUT] the message data                           *
  *             rx_bytes    - [IN] the number of bytes stored in message       *
  *                                (including header)                          *
@@ -337,8 +473,8 @@ static int	ipc_socket_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code
  *               FAIL - not enough data                                       *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_read_buffer(zbx_uint32_t *header, unsigned char **data, zbx_uint32_t rx_bytes,
-		const unsigned char *buffer, zbx_uint32_t size, zbx_uint32_t *read_size)
+static int	ipc_read_buffer(zbx_ipc_service_t *service, zbx_uint32_t *header, unsigned char **data,
+		zbx_uint32_t rx_bytes, const unsigned char *buffer, zbx_uint32_t size, zbx_uint32_t *read_size)
 {
 	zbx_uint32_t	copy_size, data_size, data_offset;
 
@@ -361,7 +497,7 @@ static int	ipc_read_buffer(zbx_uint32_t *header, unsigned char **data, zbx_uint3
 			return SUCCEED;
 		}
 
-		*data = (unsigned char *)zbx_malloc(NULL, data_size);
+		*data = ipc_service_alloc_data(service, data_size);
 		data_offset = 0;
 	}
 	else
@@ -404,7 +540,8 @@ static int	ipc_message_is_completed(const zbx_uint32_t *header, zbx_uint32_t rx_
  *                                                                            *
  * Purpose: reads IPC message from buffered client socket                     *
  *                                                                            *
- * Parameters: csocket  - [IN] the source socket                              *
+ * Parameters: service  - [IN] the IPC service receiving message, can be NULL *
+ *             csocket  - [IN] the source socket                              *
  *             header   - [OUT] the header of the message                     *
  *             data     - [OUT] the data of the message                       *
  *             rx_bytes - [IN/OUT] the total message size read (including     *
@@ -416,8 +553,8 @@ static int	ipc_message_is_completed(const zbx_uint32_t *header, zbx_uint32_t rx_
  *                       was closed).                                         *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_socket_read_message(zbx_ipc_socket_t *csocket, zbx_uint32_t *header, unsigned char **data,
-		zbx_uint32_t *rx_bytes)
+static int	ipc_socket_read_message(zbx_ipc_service_t *service, zbx_ipc_socket_t *csocket, zbx_uint32_t *header,
+		unsigned char **data, zbx_uint32_t *rx_bytes)
 {
 	zbx_uint32_t	data_size, offset, read_size = 0;
 	int		ret = FAIL;
@@ -425,7 +562,8 @@ static int	ipc_socket_read_message(zbx_ipc_socket_t *csocket, zbx_uint32_t *head
 	/* try to read message from socket buffer */
 	if (csocket->rx_buffer_bytes > csocket->rx_buffer_offset)
 	{
-		ret = ipc_read_buffer(header, data, *rx_bytes, csocket->rx_buffer + csocket->rx_buffer_offset,
+		ret = ipc_read_buffer(service, header, data, *rx_bytes,
+				csocket->rx_buffer + csocket->rx_buffer_offset,
 				csocket->rx_buffer_bytes - csocket->rx_buffer_offset, &read_size);
 
 		csocket->rx_buffer_offset += read_size;
@@ -467,8 +605,8 @@ static int	ipc_socket_read_message(zbx_ipc_socket_t *csocket, zbx_uint32_t *head
 
 		csocket->rx_buffer_bytes = read_size;
 
-		ret = ipc_read_buffer(header, data, *rx_bytes, csocket->rx_buffer, csocket->rx_buffer_bytes,
-				&read_size);
+		ret = ipc_read_buffer(service, header, data, *rx_bytes, csocket->rx_buffer,
+				csocket->rx_buffer_bytes, &read_size);
 
 		csocket->rx_buffer_offset += read_size;
 		*rx_bytes += read_size;
@@ -541,7 +679,7 @@ static void	ipc_client_push_rx_message(zbx_ipc_client_t *client)
 {
 	zbx_ipc_message_t	*message;
 
-	message = (zbx_ipc_message_t *)zbx_malloc(NULL, sizeof(zbx_ipc_message_t));
+	message = ipc_service_alloc_message(client->service);
 	message->code = client->rx_header[ZBX_IPC_MESSAGE_CODE];
 	message->size = client->rx_header[ZBX_IPC_MESSAGE_SIZE];
 	message->data = client->rx_data;
@@ -593,8 +731,8 @@ static int	ipc_client_read(zbx_ipc_client_t *client)
 
 	do
 	{
-		if (FAIL == ipc_socket_read_message(&client->csocket, client->rx_header, &client->rx_data,
-				&client->rx_bytes))
+		if (FAIL == ipc_socket_read_message(client->service, &client->csocket, client->rx_header,
+				&client->rx_data, &client->rx_bytes))
 		{
 			zbx_free(client->rx_data);
 			client->rx_bytes = 0;
@@ -619,49 +757,82 @@ static int	ipc_client_read(zbx_ipc_client_t *client)
  * Return value: SUCCEED - the data was sent successfully                     *
  *               FAIL    - otherwise                                          *
  *                                                                            *
+ * Comments: The unsent part of current message and the following queued      *
+ *           messages are written with a single writev() call until all data  *
+ *           is sent or the write would block.                                *
+ *                                                                            *
  ******************************************************************************/
 static int	ipc_client_write(zbx_ipc_client_t *client)
 {
-	zbx_uint32_t	data_size, write_size;
-
-	data_size = client->tx_header[ZBX_IPC_MESSAGE_SIZE];
+	struct iovec		iov[ZBX_IPC_TX_IOV_MAX];
+	/* messages without data take a single iovec, so up to one header per iovec can be batched */
+	zbx_uint32_t		headers[ZBX_IPC_TX_IOV_MAX][2], data_size, size;
+	zbx_ipc_message_t	*message;
+	int			iovcnt, i;
+	size_t			batch_size;
+	ssize_t			n;
 
-	if (data_size < client->tx_bytes)
+	while (0 != client->tx_bytes)
 	{
-		zbx_uint32_t	size, offset;
+		iovcnt = 0;
+		data_size = client->tx_header[ZBX_IPC_MESSAGE_SIZE];
 
-		size = client->tx_bytes - data_size;
-		offset = ZBX_IPC_HEADER_SIZE - size;
+		if (data_size < client->tx_bytes)
+		{
+			size = client->tx_bytes - data_size;
+			iov[iovcnt].iov_base = (unsigned char *)client->tx_header + ZBX_IPC_HEADER_SIZE - size;
+			iov[iovcnt++].iov_len = size;
+		}
 
-		if (SUCCEED != ipc_write_data(client->csocket.fd, (unsigned char *)client->tx_header + offset, size,
-				&write_size))
+		if (0 != (size = MIN(data_size, client->tx_bytes)))
 		{
-			return FAIL;
+			iov[iovcnt].iov_base = client->tx_data + data_size - size;
+			iov[iovcnt++].iov_len = size;
 		}
 
-		client->tx_bytes -= write_size;
+		batch_size = client->tx_bytes;
 
-		if (data_size < client->tx_bytes)
-			return SUCCEED;
-	}
+		for (i = 0; ZBX_IPC_TX_IOV_MAX - 2 >= iovcnt && ZBX_IPC_TX_BATCH_SIZE > batch_size; i++)
+		{
+			if (NULL == (message = (zbx_ipc_message_t *)zbx_queue_ptr_peek(&client->tx_queue, i)))
+				break;
 
-	while (0 < client->tx_bytes)
-	{
-		if (SUCCEED != ipc_write_data(client->csocket.fd, client->tx_data + data_size - client->tx_bytes,
-				client->tx_bytes, &write_size))
+			headers[i][ZBX_IPC_MESSAGE_CODE] = message->code;
+			headers[i][ZBX_IPC_MESSAGE_SIZE] = message->size;
+			iov[iovcnt].iov_base = headers[i];
+			iov[iovcnt++].iov_len = ZBX_IPC_HEADER_SIZE;
+
+			if (0 != message->size)
+			{
+				iov[iovcnt].iov_base = message->data;
+				iov[iovcnt++].iov_len = message->size;
+			}
+
+			batch_size += ZBX_IPC_HEADER_SIZE + message->size;
+		}
+
+		if (-1 == (n = writev(client->csocket.fd, iov, iovcnt)))
 		{
+			if (EINTR == errno)
+				continue;
+
+			if (EWOULDBLOCK == errno || EAGAIN == errno)
+				return SUCCEED;
+
+			zabbix_log(LOG_LEVEL_WARNING, "cannot write to IPC socket: %s", strerror(errno));
 			return FAIL;
 		}
 
-		if (0 == write_size)
-			return SUCCEED;
+		/* advance through the fully sent messages */
+		while (0 != n && (size_t)n >= client->tx_bytes)
+		{
+			n -= client->tx_bytes;
+			ipc_client_pop_tx_message(client);
+		}
 
-		client->tx_bytes -= write_size;
+		client->tx_bytes -= n;
 	}
 
-	if (0 == client->tx_bytes)
-		ipc_client_pop_tx_message(client);
-
 	return SUCCEED;
 }
 
@@ -1204,7 +1375,7 @@ int	zbx_ipc_socket_read(zbx_ipc_socket_t *csocket, zbx_ipc_message_t *message)
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED != ipc_socket_read_message(csocket, header, &data, &rx_bytes))
+	if (SUCCEED != ipc_socket_read_message(NULL, csocket, header, &data, &rx_bytes))
 		goto out;
 
 	if (SUCCEED != ipc_message_is_completed(header, rx_bytes))
@@ -1451,7 +1622,7 @@ int	zbx_ipc_service_start(zbx_ipc_service_t *service, const char *service_name,
 {
 	struct sockaddr_un	addr;
 	const char		*socket_path;
-	int			ret = FAIL;
+	int			ret = FAIL, i;
 	mode_t			mode;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() service:%s", __func__, service_name);
@@ -1504,6 +1675,12 @@ int	zbx_ipc_service_start(zbx_ipc_service_t *service, const char *service_name,
 	zbx_vector_ptr_create(&service->clients);
 	zbx_queue_ptr_create(&service->clients_recv);
 
+	service->recv_nopoll_num = 0;
+
+	zbx_vector_ptr_create(&service->messages_pool);
+	for (i = 0; i < ZBX_IPC_POOL_CLASSES_NUM; i++)
+		zbx_vector_ptr_create(&service->buffers_pool[i]);
+
 	service->ev = event_base_new();
 	service->ev_listener = event_new(service->ev, service->fd, EV_READ | EV_PERSIST,
 			ipc_service_client_connected_cb, service);
@@ -1544,6 +1721,15 @@ void	zbx_ipc_service_close(zbx_ipc_service_t *service)
 	zbx_vector_ptr_destroy(&service->clients);
 	zbx_queue_ptr_destroy(&service->clients_recv);
 
+	zbx_vector_ptr_clear_ext(&service->messages_pool, zbx_ptr_free);
+	zbx_vector_ptr_destroy(&service->messages_pool);
+
+	for (i = 0; i < ZBX_IPC_POOL_CLASSES_NUM; i++)
+	{
+		zbx_vector_ptr_clear_ext(&service->buffers_pool[i], zbx_ptr_free);
+		zbx_vector_ptr_destroy(&service->buffers_pool[i]);
+	}
+
 	event_free(service->ev_alert);
 	event_free(service->ev_timer);
 	event_free(service->ev_listener);
@@ -1568,7 +1754,8 @@ void	zbx_ipc_service_close(zbx_ipc_service_t *service)
  *             message - [OUT] the received message or NULL if the client     *
  *                             connection was closed.                         *
  *                             The message must be freed by caller with       *
- *                             ipc_message_free() function.                   *
+ *                             ipc_message_free() or                          *
+ *                             zbx_ipc_service_release_message() function.    *
  *                                                                            *
  * Return value: ZBX_IPC_RECV_IMMEDIATE - returned immediately without        *
  *                                        waiting for socket events           *
@@ -1597,7 +1784,13 @@ int	zbx_ipc_service_recv(zbx_ipc_service_t *service, const zbx_timespec_t *timeo
 	else
 		flags = EVLOOP_NONBLOCK;
 
-	event_base_loop(service->ev, flags);
+	/* while already received messages are being processed poll sockets only periodically */
+	if (EVLOOP_NONBLOCK != flags || SUCCEED == zbx_queue_ptr_empty(&service->clients_recv) ||
+			ZBX_IPC_RECV_POLL_INTERVAL <= ++service->recv_nopoll_num)
+	{
+		service->recv_nopoll_num = 0;
+		event_base_loop(service->ev, flags);
+	}
 
 	if (NULL != (*client = ipc_service_pop_client(service)))
 	{
@@ -1632,6 +1825,55 @@ int	zbx_ipc_service_recv(zbx_ipc_service_t *service, const zbx_timespec_t *timeo
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees message received by IPC service, keeping the message and    *
+ *          its data buffer for reuse by next received messages               *
+ *                                                                            *
+ * Parameters: service - [IN] the IPC service                                 *
+ *             message - [IN] the message received by zbx_ipc_service_recv()  *
+ *                            function                                        *
+ *                                                                            *
+ * Comments: Use instead of zbx_ipc_message_free() on high volume channels to *
+ *           avoid allocating memory for every received message.              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_ipc_service_release_message(zbx_ipc_service_t *service, zbx_ipc_message_t *message)
+{
+	if (NULL == message)
+		return;
+
+	if (NULL != message->data)
+	{
+		int	shift = ZBX_IPC_POOL_SHIFT_MIN;
+
+		/* message size is the lower bound of buffer size, it is used to select the class */
+		if ((1 << ZBX_IPC_POOL_SHIFT_MIN) <= message->size &&
+				(zbx_uint32_t)(1 << ZBX_IPC_POOL_SHIFT_MAX) >= message->size)
+		{
+			zbx_vector_ptr_t	*pool;
+
+			while (shift < ZBX_IPC_POOL_SHIFT_MAX && (zbx_uint32_t)(1 << (shift + 1)) <= message->size)
+				shift++;
+
+			pool = &service->buffers_pool[shift - ZBX_IPC_POOL_SHIFT_MIN];
+
+			if (ZBX_IPC_POOL_LIMIT > pool->values_num)
+			{
+				zbx_vector_ptr_append(pool, message->data);
+				message->data = NULL;
+			}
+		}
+
+		zbx_free(message->data);
+	}
+
+	if (ZBX_IPC_POOL_LIMIT > service->messages_pool.values_num)
+		zbx_vector_ptr_append(&service->messages_pool, message);
+	else
+		zbx_free(message);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: interrupt IPC service recv loop from another thread               *
@@ -158,14 +158,28 @@ void	zbx_json_free(struct zbx_json *j)
 		zbx_free(j->buffer);
 }
 
+/* characters that must be escaped in JSON strings: quotation mark, reverse solidus and */
+/* control characters U+0001 - U+001F (U+0000 terminates the string)                   */
+static const char	json_escape_chars[] = "\"\\"
+		"\001\002\003\004\005\006\007\010\011\012\013\014\015\016\017"
+		"\020\021\022\023\024\025\026\027\030\031\032\033\034\035\036\037";
+
 static size_t	__zbx_json_stringsize(const char *string, zbx_json_type_t type)
 {
-	size_t		len = 0;
+	size_t		len = 0, run;
 	const char	*sptr;
 	char		buffer[] = {"null"};
 
-	for (sptr = (NULL != string ? string : buffer); '\0' != *sptr; sptr++)
+	for (sptr = (NULL != string ? string : buffer);; sptr++)
 	{
+		/* count characters that do not need escaping in one pass */
+		run = strcspn(sptr, json_escape_chars);
+		len += run;
+		sptr += run;
+
+		if ('\0' == *sptr)
+			break;
+
 		switch (*sptr)
 		{
 			case '"':  /* quotation mark */
@@ -181,10 +195,7 @@ static size_t	__zbx_json_stringsize(const char *string, zbx_json_type_t type)
 				break;
 			default:
 				/* RFC 8259 requires escaping control characters U+0000 - U+001F */
-				if (0x1f >= (unsigned char)*sptr)
-					len += 6;
-				else
-					len++;
+				len += 6;
 		}
 	}
 
@@ -215,14 +226,24 @@ static char	zbx_num2hex(unsigned char c)
 
 static char	*__zbx_json_insstring(char *p, const char *string, zbx_json_type_t type)
 {
+	size_t		run;
 	const char	*sptr;
 	char		buffer[] = {"null"};
 
 	if (NULL != string && ZBX_JSON_TYPE_STRING == type)
 		*p++ = '"';
 
-	for (sptr = (NULL != string ? string : buffer); '\0' != *sptr; sptr++)
+	for (sptr = (NULL != string ? string : buffer);; sptr++)
 	{
+		/* copy characters that do not need escaping in one go */
+		run = strcspn(sptr, json_escape_chars);
+		memcpy(p, sptr, run);
+		p += run;
+		sptr += run;
+
+		if ('\0' == *sptr)
+			break;
+
 		switch (*sptr)
 		{
 			case '"':		/* quotation mark */
@@ -257,17 +278,12 @@ static char	*__zbx_json_insstring(char *p, const char *string, zbx_json_type_t t
 				break;
 			default:
 				/* RFC 8259 requires escaping control characters U+0000 - U+001F */
-				if (0x1f >= (unsigned char)*sptr)
-				{
-					*p++ = '\\';
-					*p++ = 'u';
-					*p++ = '0';
-					*p++ = '0';
-					*p++ = zbx_num2hex((((unsigned char)*sptr) >> 4) & 0xf);
-					*p++ = zbx_num2hex(((unsigned char)*sptr) & 0xf);
-				}
-				else
-					*p++ = *sptr;
+				*p++ = '\\';
+				*p++ = 'u';
+				*p++ = '0';
+				*p++ = '0';
+				*p++ = zbx_num2hex((((unsigned char)*sptr) >> 4) & 0xf);
+				*p++ = zbx_num2hex(((unsigned char)*sptr) & 0xf);
 		}
 	}
 
@@ -504,6 +520,34 @@ static zbx_json_type_t	__zbx_json_type(const char *p)
 	return ZBX_JSON_TYPE_UNKNOWN;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locate closing quote of JSON string                               *
+ *                                                                            *
+ * Parameters: p - [IN] pointer to the opening quote                          *
+ *                                                                            *
+ * Return value: pointer to the closing quote                                 *
+ *               NULL - string is not terminated                              *
+ *                                                                            *
+ * Comments: string contents are skipped with strcspn() which is vectorized   *
+ *           by the C library, instead of a byte at a time                    *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*json_string_end(const char *p)
+{
+	for (p++;; p++)
+	{
+		p += strcspn(p, "\"\\");
+
+		if ('"' == *p)
+			return p;
+
+		/* skip the escaped character */
+		if ('\0' == *p || '\0' == *++p)
+			return NULL;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Return value: position of the right bracket                                *
@@ -513,7 +557,6 @@ static zbx_json_type_t	__zbx_json_type(const char *p)
 static const char	*__zbx_json_rbracket(const char *p)
 {
 	int	level = 0;
-	int	state = 0; /* 0 - outside string; 1 - inside string */
 	char	lbracket, rbracket;
 
 	assert(p);
@@ -530,26 +573,18 @@ static const char	*__zbx_json_rbracket(const char *p)
 		switch (*p)
 		{
 			case '"':
-				state = (0 == state ? 1 : 0);
-				break;
-			case '\\':
-				if (1 == state)
-					if ('\0' == *++p)
-						return NULL;
+				if (NULL == (p = json_string_end(p)))
+					return NULL;
 				break;
 			case '[':
 			case '{':
-				if (0 == state)
-					level++;
+				level++;
 				break;
 			case ']':
 			case '}':
-				if (0 == state)
-				{
-					level--;
-					if (0 == level)
-						return (rbracket == *p ? p : NULL);
-				}
+				level--;
+				if (0 == level)
+					return (rbracket == *p ? p : NULL);
 				break;
 		}
 		p++;
@@ -613,7 +648,6 @@ int	zbx_json_open(const char *buffer, struct zbx_json_parse *jp)
 const char	*zbx_json_next(const struct zbx_json_parse *jp, const char *p)
 {
 	int	level = 0;
-	int	state = 0;	/* 0 - outside string; 1 - inside string */
 
 	if (1 == jp->end - jp->start)	/* empty object or array */
 		return NULL;
@@ -630,28 +664,21 @@ const char	*zbx_json_next(const struct zbx_json_parse *jp, const char *p)
 		switch (*p)
 		{
 			case '"':
-				state = (0 == state) ? 1 : 0;
-				break;
-			case '\\':
-				if (1 == state)
-					p++;
+				if (NULL == (p = json_string_end(p)))
+					return NULL;
 				break;
 			case '[':
 			case '{':
-				if (0 == state)
-					level++;
+				level++;
 				break;
 			case ']':
 			case '}':
-				if (0 == state)
-				{
-					if (0 == level)
-						return NULL;
-					level--;
-				}
+				if (0 == level)
+					return NULL;
+				level--;
 				break;
 			case ',':
-				if (0 == state && 0 == level)
+				if (0 == level)
 				{
 					p++;
 					SKIP_WHITESPACE(p);
@@ -1014,11 +1041,37 @@ const char	*zbx_json_pair_next(const struct zbx_json_parse *jp, const char *p, c
 const char	*zbx_json_pair_by_name(const struct zbx_json_parse *jp, const char *name)
 {
 	char		buffer[MAX_STRING_LEN];
-	const char	*p = NULL;
+	const char	*p = NULL, *q, *n;
 
-	while (NULL != (p = zbx_json_pair_next(jp, p, buffer, sizeof(buffer))))
-		if (0 == strcmp(name, buffer))
-			return p;
+	while (NULL != (p = zbx_json_next(jp, p)))
+	{
+		if ('"' != *p)
+			break;
+
+		/* compare names without escape sequences in place, without copying them out */
+		for (q = p + 1, n = name; '\0' != *n && '"' != *q && '\\' != *q && *q == *n; q++, n++)
+			;
+
+		if ('\\' == *q)
+		{
+			if (NULL == (q = json_copy_string(p, buffer, sizeof(buffer))))
+				break;
+
+			if (0 != strcmp(name, buffer))
+				continue;
+		}
+		else if ('\0' != *n || '"' != *q++)
+			continue;
+
+		SKIP_WHITESPACE(q);
+
+		if (':' != *q++)
+			break;
+
+		SKIP_WHITESPACE(q);
+
+		return q;
+	}
 
 	zbx_set_json_strerror("cannot find pair with name \"%s\"", name);
 
@@ -1905,17 +1905,16 @@ static void	jsonpath_variant_to_boolean(zbx_variant_t *value)
  ******************************************************************************/
 static int	jsonpath_regexp_match(const char *text, const char *pattern, double *result)
 {
-	zbx_regexp_t	*rxp;
-	char		*error = NULL;
+	const zbx_regexp_t	*rxp;
+	char			*error = NULL;
 
-	if (FAIL == zbx_regexp_compile(pattern, &rxp, &error))
+	if (FAIL == zbx_regexp_compile_cached(pattern, &rxp, &error))
 	{
 		zbx_set_json_strerror("invalid regular expression in JSON path: %s", error);
 		zbx_free(error);
 		return FAIL;
 	}
 	*result = (0 == zbx_regexp_match_precompiled(text, rxp) ? 1.0 : 0.0);
-	zbx_regexp_free(rxp);
 
 	return SUCCEED;
 }
@@ -2827,6 +2826,162 @@ int	zbx_jsonpath_compile(const char *path, zbx_jsonpath_t *jsonpath)
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locate object member value in json text                           *
+ *                                                                            *
+ * Parameters: p    - [IN] the object start                                   *
+ *             name - [IN] the member name                                    *
+ *                                                                            *
+ * Return value: The member value or NULL if not found.                       *
+ *                                                                            *
+ * Comments: With duplicate names the last member is returned, the same as    *
+ *           zbx_jsonobj_open() keeps.                                        *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*jsonpath_text_match_name(const char *p, const char *name)
+{
+	struct zbx_json_parse	jp;
+	const char		*pnext = NULL, *value = NULL, *ptr;
+	char			*buf = NULL;
+	size_t			buf_alloc = 0;
+	zbx_json_type_t		type;
+
+	if ('{' != *p || SUCCEED != zbx_json_brackets_open(p, &jp))
+		return NULL;
+
+	while (NULL != (pnext = zbx_json_next(&jp, pnext)))
+	{
+		if (NULL == (ptr = zbx_json_decodevalue_dyn(pnext, &buf, &buf_alloc, &type)))
+			break;
+
+		SKIP_WHITESPACE(ptr);
+
+		if (':' != *ptr++)
+			break;
+
+		SKIP_WHITESPACE(ptr);
+
+		if (0 == strcmp(buf, name))
+			value = ptr;
+	}
+
+	zbx_free(buf);
+
+	return value;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locate array element in json text                                 *
+ *                                                                            *
+ * Parameters: p     - [IN] the array start                                   *
+ *             index - [IN] the element index, negative index is counted from *
+ *                          the array end                                     *
+ *                                                                            *
+ * Return value: The element or NULL if not found.                            *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*jsonpath_text_match_index(const char *p, int index)
+{
+	struct zbx_json_parse	jp;
+	const char		*pnext = NULL;
+
+	if ('[' != *p || SUCCEED != zbx_json_brackets_open(p, &jp))
+		return NULL;
+
+	if (0 > index && 0 > (index += zbx_json_count(&jp)))
+		return NULL;
+
+	while (NULL != (pnext = zbx_json_next(&jp, pnext)))
+	{
+		if (0 == index--)
+			return pnext;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: perform definite jsonpath query directly on json text             *
+ *                                                                            *
+ * Parameters: data     - [IN] the json data                                  *
+ *             jsonpath - [IN] the compiled jsonpath                          *
+ *             output   - [OUT] the output value                              *
+ *                                                                            *
+ * Return value: SUCCEED - the query was performed successfully (empty result *
+ *                         being counted as successful query)                 *
+ *               FAIL    - the query cannot be performed on text, the data    *
+ *                         must be queried with zbx_jsonobj_query_path()      *
+ *                                                                            *
+ * Comments: Paths made of single names and indexes, for example              *
+ *           $.data[2].value, are resolved by walking the text. Only the      *
+ *           matched value is parsed into json object, instead of building    *
+ *           the whole document tree.                                         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_jsonpath_query_text(const char *data, const zbx_jsonpath_t *jsonpath, char **output)
+{
+	struct zbx_json_parse	jp;
+	const char		*p;
+	zbx_jsonobj_t		obj;
+	char			*error = NULL;
+	size_t			output_alloc = 0, output_offset = 0;
+	int			i, ret;
+
+	if (1 != jsonpath->definite)
+		return FAIL;
+
+	for (i = 0; i < jsonpath->segments_num; i++)
+	{
+		const zbx_jsonpath_segment_t	*segment = &jsonpath->segments[i];
+
+		if (ZBX_JSONPATH_SEGMENT_MATCH_LIST != segment->type || 0 != segment->detached ||
+				NULL != segment->data.list.values->next)
+		{
+			return FAIL;
+		}
+	}
+
+	if (SUCCEED != zbx_json_open(data, &jp))
+		return FAIL;
+
+	for (i = 0, p = jp.start; i < jsonpath->segments_num; i++)
+	{
+		const zbx_jsonpath_list_t	*list = &jsonpath->segments[i].data.list;
+
+		if (ZBX_JSONPATH_LIST_NAME == list->type)
+		{
+			p = jsonpath_text_match_name(p, list->values->data);
+		}
+		else
+		{
+			int	index;
+
+			memcpy(&index, list->values->data, sizeof(index));
+			p = jsonpath_text_match_index(p, index);
+		}
+
+		if (NULL == p)
+			return SUCCEED;
+	}
+
+	jsonobj_init(&obj, ZBX_JSON_TYPE_UNKNOWN);
+
+	if (0 == json_parse_value(p, &obj, 0, &error))
+	{
+		zbx_free(error);
+		ret = FAIL;
+	}
+	else
+		ret = jsonpath_str_copy_value(output, &output_alloc, &output_offset, &obj);
+
+	zbx_jsonobj_clear(&obj);
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: perform jsonpath query on the specified json data                 *
@@ -2866,30 +3021,30 @@ static void	jsonpath_ctx_clear(zbx_jsonpath_context_t *ctx)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: perform jsonpath query on the specified json object               *
+ * Purpose: perform compiled jsonpath query on the specified json object      *
  *                                                                            *
- * Parameters: obj    - [IN] json object                                  *
- *             index  - [IN] jsonpath index (optional)                        *
- *             path   - [IN] jsonpath                                         *
- *             output - [OUT] output value                                    *
+ * Parameters: obj      - [IN] json object                                    *
+ *             index    - [IN] jsonpath index (optional)                      *
+ *             jsonpath - [IN] compiled jsonpath                              *
+ *             output   - [OUT] output value                                  *
  *                                                                            *
  * Return value: SUCCEED - the query was performed successfully (empty result *
  *                         being counted as successful query)                 *
  *               FAIL    - otherwise                                          *
  *                                                                            *
+ * Comments: The compiled jsonpath is not modified during query, so it can be *
+ *           reused for multiple queries.                                     *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_jsonobj_query_ext(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const char *path, char **output)
+int	zbx_jsonobj_query_path(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, zbx_jsonpath_t *jsonpath,
+		char **output)
 {
 	zbx_jsonpath_context_t	ctx;
-	zbx_jsonpath_t		jsonpath;
 	int			ret = SUCCEED;
 
-	if (FAIL == zbx_jsonpath_compile(path, &jsonpath))
-		return FAIL;
-
 	ctx.found = 0;
 	ctx.root = obj;
-	ctx.path = &jsonpath;
+	ctx.path = jsonpath;
 	zbx_vector_jsonobj_ref_create(&ctx.objects);
 	ctx.index = index;
 
@@ -2908,15 +3063,15 @@ int	zbx_jsonobj_query_ext(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const
 	if (SUCCEED == ret)
 	{
 		zbx_vector_jsonobj_ref_t	out;
-		int				definite_path = jsonpath.definite, path_depth;
+		int				definite_path = jsonpath->definite, path_depth;
 
 		zbx_vector_jsonobj_ref_create(&out);
 
-		path_depth = jsonpath.segments_num;
-		while (0 < path_depth && ZBX_JSONPATH_SEGMENT_FUNCTION == jsonpath.segments[path_depth - 1].type)
+		path_depth = jsonpath->segments_num;
+		while (0 < path_depth && ZBX_JSONPATH_SEGMENT_FUNCTION == jsonpath->segments[path_depth - 1].type)
 			path_depth--;
 
-		if (path_depth < jsonpath.segments_num)
+		if (path_depth < jsonpath->segments_num)
 		{
 			if (SUCCEED == (ret = jsonpath_apply_functions(&ctx, path_depth, &definite_path, &out)))
 				ret = jsonpath_format_query_result(&out, definite_path, output);
@@ -2929,6 +3084,34 @@ int	zbx_jsonobj_query_ext(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const
 	}
 
 	jsonpath_ctx_clear(&ctx);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: perform jsonpath query on the specified json object               *
+ *                                                                            *
+ * Parameters: obj    - [IN] json object                                      *
+ *             index  - [IN] jsonpath index (optional)                        *
+ *             path   - [IN] jsonpath                                         *
+ *             output - [OUT] output value                                    *
+ *                                                                            *
+ * Return value: SUCCEED - the query was performed successfully (empty result *
+ *                         being counted as successful query)                 *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_jsonobj_query_ext(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, const char *path, char **output)
+{
+	zbx_jsonpath_t	jsonpath;
+	int		ret;
+
+	if (FAIL == zbx_jsonpath_compile(path, &jsonpath))
+		return FAIL;
+
+	ret = zbx_jsonobj_query_path(obj, index, &jsonpath, output);
+
 	zbx_jsonpath_clear(&jsonpath);
 
 	return ret;
@@ -274,6 +274,12 @@ void	__zbx_rwlock_wrlock(const char *filename, int line, zbx_rwlock_t rwlock)
 	if (0 != locks_disabled)
 		return;
 
+	/* try the lock first to let profiler count contended acquisitions */
+	if (0 == pthread_rwlock_trywrlock(rwlock))
+		return;
+
+	zbx_prof_contended();
+
 	if (0 != pthread_rwlock_wrlock(rwlock))
 	{
 		zbx_error("[file:'%s',line:%d] write lock failed: %s", filename, line, zbx_strerror(errno));
@@ -298,6 +304,11 @@ void	__zbx_rwlock_rdlock(const char *filename, int line, zbx_rwlock_t rwlock)
 	if (0 != locks_disabled)
 		return;
 
+	if (0 == pthread_rwlock_tryrdlock(rwlock))
+		return;
+
+	zbx_prof_contended();
+
 	if (0 != pthread_rwlock_rdlock(rwlock))
 	{
 		zbx_error("[file:'%s',line:%d] read lock failed: %s", filename, line, zbx_strerror(errno));
@@ -451,6 +462,11 @@ void	__zbx_mutex_lock(const char *filename, int line, zbx_mutex_t mutex)
 	if (0 != locks_disabled)
 		return;
 
+	if (0 == pthread_mutex_trylock(mutex))
+		return;
+
+	zbx_prof_contended();
+
 	if (0 != pthread_mutex_lock(mutex))
 	{
 		zbx_error("[file:'%s',line:%d] lock failed: %s", filename, line, zbx_strerror(errno));
@@ -40,7 +40,7 @@
 int	zbx_is_uint_n_range(const char *str, size_t n, void *value, size_t size, zbx_uint64_t min, zbx_uint64_t max)
 {
 	zbx_uint64_t		value_uint64 = 0, c;
-	const zbx_uint64_t	max_uint64 = ~__UINT64_C(0);
+	const zbx_uint64_t	max_uint64 = ~__UINT64_C(0), max_div10 = max_uint64 / 10, max_mod10 = max_uint64 % 10;
 
 	if ('\0' == *str || 0 == n || sizeof(zbx_uint64_t) < size || (0 == size && NULL != value))
 		return FAIL;
@@ -52,7 +52,7 @@ int	zbx_is_uint_n_range(const char *str, size_t n, void *value, size_t size, zbx
 
 		c = (zbx_uint64_t)(unsigned char)(*str - '0');
 
-		if ((max_uint64 - c) / 10 < value_uint64)
+		if (max_div10 < value_uint64 || (max_div10 == value_uint64 && max_mod10 < c))
 			return FAIL;	/* maximum value exceeded */
 
 		value_uint64 = value_uint64 * 10 + c;
@@ -251,6 +251,108 @@ static int	is_double_valid_syntax(const char *str)
 	return '\0' == *(str + len) ? SUCCEED : FAIL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: converts simple decimal numbers to double without strtod()        *
+ *                                                                            *
+ * Parameters: str   - [IN] string to convert                                 *
+ *             value - [OUT] converted value                                  *
+ *                                                                            *
+ * Return value: SUCCEED - string was converted                               *
+ *               FAIL    - string is not a simple decimal number, must be     *
+ *                         validated and converted with strtod()              *
+ *                                                                            *
+ * Comments: When the significand fits into 53 bits and the decimal exponent  *
+ *           is within [-22, 22] both the significand and the power of ten    *
+ *           are exact doubles, so a single multiplication or division gives  *
+ *           the same correctly rounded result as strtod().                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	double_parse_fast(const char *str, double *value)
+{
+#if defined(FLT_EVAL_METHOD) && 0 != FLT_EVAL_METHOD
+	/* extended precision intermediates could round twice */
+	ZBX_UNUSED(str);
+	ZBX_UNUSED(value);
+
+	return FAIL;
+#else
+	static const double	pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+					1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	zbx_uint64_t		mantissa = 0;
+	int			digits = 0, exponent = 0, exp_value = 0, negative = 0;
+	double			result;
+
+	if ('-' == *str)
+	{
+		negative = 1;
+		str++;
+	}
+	else if ('+' == *str)
+		str++;
+
+	for (; 0 != isdigit((unsigned char)*str); str++, digits++)
+	{
+		if (19 == digits)
+			return FAIL;
+
+		mantissa = mantissa * 10 + (zbx_uint64_t)(*str - '0');
+	}
+
+	if ('.' == *str)
+	{
+		for (str++; 0 != isdigit((unsigned char)*str); str++, digits++, exponent--)
+		{
+			if (19 == digits)
+				return FAIL;
+
+			mantissa = mantissa * 10 + (zbx_uint64_t)(*str - '0');
+		}
+	}
+
+	if (0 == digits)
+		return FAIL;
+
+	if ('e' == *str || 'E' == *str)
+	{
+		int	exp_negative = 0;
+
+		if ('-' == *(++str))
+		{
+			exp_negative = 1;
+			str++;
+		}
+		else if ('+' == *str)
+			str++;
+
+		if (0 == isdigit((unsigned char)*str))
+			return FAIL;
+
+		for (; 0 != isdigit((unsigned char)*str); str++)
+		{
+			if (100 < (exp_value = exp_value * 10 + (*str - '0')))
+				return FAIL;
+		}
+
+		exponent += (0 == exp_negative ? exp_value : -exp_value);
+	}
+
+	if ('\0' != *str || (__UINT64_C(1) << 53) < mantissa || -22 > exponent || 22 < exponent)
+		return FAIL;
+
+	result = (double)mantissa;
+
+	if (0 > exponent)
+		result /= pow10[-exponent];
+	else
+		result *= pow10[exponent];
+
+	*value = (0 == negative ? result : -result);
+
+	return SUCCEED;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: validates and optionally converts string to number of type        *
@@ -271,6 +373,9 @@ int	zbx_is_double(const char *str, double *value)
 	double	tmp;
 	char	*endptr;
 
+	if (SUCCEED == double_parse_fast(str, &tmp))
+		goto out;
+
 	/* Not all strings accepted by strtod() can be accepted in Zabbix. */
 	/* Therefore additional, more strict syntax check is used before strtod(). */
 
@@ -282,7 +387,7 @@ int	zbx_is_double(const char *str, double *value)
 
 	if ('\0' != *endptr || HUGE_VAL == tmp || -HUGE_VAL == tmp || EDOM == errno)
 		return FAIL;
-
+out:
 	if (NULL != value)
 		*value = tmp;
 
@@ -583,10 +583,10 @@ int	item_preproc_2dec(zbx_variant_t *value, int op_type, char **errmsg)
  ******************************************************************************/
 int	item_preproc_regsub_op(zbx_variant_t *value, const char *params, char **errmsg)
 {
-	char		*pattern, *output, *new_value = NULL;
-	char		*regex_error = NULL;
-	zbx_regexp_t	*regex = NULL;
-	int		ret = FAIL;
+	char			*pattern, *output, *new_value = NULL;
+	char			*regex_error = NULL;
+	const zbx_regexp_t	*regex;
+	int			ret = FAIL;
 
 	if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 		return FAIL;
@@ -601,7 +601,7 @@ int	item_preproc_regsub_op(zbx_variant_t *value, const char *params, char **errm
 
 	*output++ = '\0';
 
-	if (FAIL == zbx_regexp_compile_ext(pattern, &regex, 0, &regex_error))	/* PCRE_MULTILINE is not used here */
+	if (FAIL == zbx_regexp_compile_cached_ext(pattern, &regex, 0, &regex_error))	/* PCRE_MULTILINE is not used here */
 	{
 		*errmsg = zbx_dsprintf(*errmsg, "invalid regular expression: %s", regex_error);
 		zbx_free(regex_error);
@@ -619,9 +619,6 @@ int	item_preproc_regsub_op(zbx_variant_t *value, const char *params, char **errm
 
 	ret = SUCCEED;
 out:
-	if (NULL != regex)
-		zbx_regexp_free(regex);
-
 	zbx_free(pattern);
 
 	return ret;
@@ -721,11 +718,11 @@ out:
  ******************************************************************************/
 int	item_preproc_validate_regex(const zbx_variant_t *value, const char *params, char **error)
 {
-	zbx_variant_t	value_str;
-	int		ret = FAIL;
-	zbx_regexp_t	*regex;
-	char		*errptr = NULL;
-	char		*errmsg;
+	zbx_variant_t		value_str;
+	int			ret = FAIL;
+	const zbx_regexp_t	*regex;
+	char			*errptr = NULL;
+	char			*errmsg;
 
 	zbx_variant_copy(&value_str, value);
 
@@ -735,7 +732,7 @@ int	item_preproc_validate_regex(const zbx_variant_t *value, const char *params,
 		goto out;
 	}
 
-	if (FAIL == zbx_regexp_compile(params, &regex, &errptr))
+	if (FAIL == zbx_regexp_compile_cached(params, &regex, &errptr))
 	{
 		errmsg = zbx_dsprintf(NULL, "invalid regular expression pattern: %s", errptr);
 		zbx_free(errptr);
@@ -746,8 +743,6 @@ int	item_preproc_validate_regex(const zbx_variant_t *value, const char *params,
 		errmsg = zbx_strdup(NULL, "value does not match regular expression");
 	else
 		ret = SUCCEED;
-
-	zbx_regexp_free(regex);
 out:
 	zbx_variant_clear(&value_str);
 
@@ -776,11 +771,11 @@ out:
  ******************************************************************************/
 int	item_preproc_validate_not_regex(const zbx_variant_t *value, const char *params, char **error)
 {
-	zbx_variant_t	value_str;
-	int		ret = FAIL;
-	zbx_regexp_t	*regex;
-	char		*errptr = NULL;
-	char		*errmsg;
+	zbx_variant_t		value_str;
+	int			ret = FAIL;
+	const zbx_regexp_t	*regex;
+	char			*errptr = NULL;
+	char			*errmsg;
 
 	zbx_variant_copy(&value_str, value);
 
@@ -790,7 +785,7 @@ int	item_preproc_validate_not_regex(const zbx_variant_t *value, const char *para
 		goto out;
 	}
 
-	if (FAIL == zbx_regexp_compile(params, &regex, &errptr))
+	if (FAIL == zbx_regexp_compile_cached(params, &regex, &errptr))
 	{
 		errmsg = zbx_dsprintf(NULL, "invalid regular expression pattern: %s", errptr);
 		zbx_free(errptr);
@@ -803,8 +798,6 @@ int	item_preproc_validate_not_regex(const zbx_variant_t *value, const char *para
 	}
 	else
 		ret = SUCCEED;
-
-	zbx_regexp_free(regex);
 out:
 	zbx_variant_clear(&value_str);
 
@@ -1255,6 +1248,38 @@ static int	item_preproc_csv_to_json_add_field(struct zbx_json *json, char ***nam
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initializes lookup table of bytes where CSV field scanning must   *
+ *          stop                                                              *
+ *                                                                            *
+ * Parameters: table  - [OUT] 256 byte lookup table                           *
+ *             sym    - [IN] delimiter or quote character                     *
+ *             sym_sz - [IN] character size in bytes                          *
+ *             eol    - [IN] 1 - line breaks are stop bytes                   *
+ *                                                                            *
+ * Comments: Terminating zero and all non-ASCII bytes are always marked as    *
+ *           stop bytes, so UTF-8 validation and multi-byte delimiter         *
+ *           matching are still done by the main parser loop.                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	item_preproc_csv_init_stop_table(unsigned char *table, const char *sym, size_t sym_sz, int eol)
+{
+	memset(table, 0, 0x80);
+	memset(table + 0x80, 1, 0x80);
+
+	table['\0'] = 1;
+
+	if (0 != eol)
+	{
+		table['\r'] = 1;
+		table['\n'] = 1;
+	}
+
+	if (1 == sym_sz)
+		table[(unsigned char)*sym] = 1;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: convert CSV format metrics to JSON format                         *
@@ -1279,6 +1304,7 @@ int	item_preproc_csv_to_json(zbx_variant_t *value, const char *params, char **er
 	struct zbx_json	json;
 	size_t		data_len, delim_sz = 1, quote_sz = 0, step;
 	int		ret = SUCCEED;
+	unsigned char	field_stop[256], quoted_stop[256];
 
 	if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 		return FAIL;
@@ -1355,8 +1381,20 @@ int	item_preproc_csv_to_json(zbx_variant_t *value, const char *params, char **er
 	if ('\0' == *data)
 		goto out;
 
+	item_preproc_csv_init_stop_table(field_stop, delim, delim_sz, 1);
+	item_preproc_csv_init_stop_table(quoted_stop, quote, quote_sz, 0);
+
 	for (field = NULL; value->data.str + data_len >= data; data += step)
 	{
+		/* skip plain ASCII field contents that cannot change parser state */
+		if (NULL != field && CSV_STATE_DELIM != state)
+		{
+			const unsigned char	*stop = (CSV_STATE_FIELD == state ? field_stop : quoted_stop);
+
+			while (0 == stop[(unsigned char)*data])
+				data++;
+		}
+
 		if (0 == (step = zbx_utf8_char_len(data)))
 		{
 			*errmsg = zbx_strdup(*errmsg, "cannot convert CSV to JSON: invalid UTF-8 character in value");
@@ -1579,9 +1617,13 @@ int	item_preproc_str_replace(zbx_variant_t *value, const char *params, char **er
 
 	if (SUCCEED == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 	{
-		new_string = zbx_string_replace(value->data.str, search_str, replace_str);
-		zbx_variant_clear(value);
-		zbx_variant_set_str(value, new_string);
+		/* avoid copying the whole value when there is nothing to replace */
+		if (NULL != strstr(value->data.str, search_str))
+		{
+			new_string = zbx_string_replace(value->data.str, search_str, replace_str);
+			zbx_variant_clear(value);
+			zbx_variant_set_str(value, new_string);
+		}
 
 		ret = SUCCEED;
 	}
@@ -23,6 +23,8 @@
 #include "zbxjson.h"
 #include "zbxprometheus.h"
 #include "preproc_snmp.h"
+#include "zbxstr.h"
+#include "zbxxml.h"
 
 /******************************************************************************
  *                                                                            *
@@ -58,6 +60,9 @@ zbx_pp_cache_t	*pp_cache_create(const zbx_pp_item_preproc_t *preproc, const zbx_
 	cache->data = NULL;
 	cache->refcount = 1;
 	cache->error = NULL;
+	cache->preproc = NULL;
+	cache->steps_values = NULL;
+	cache->steps_values_num = 0;
 
 	return cache;
 }
@@ -85,11 +90,25 @@ static void	pp_cache_free(zbx_pp_cache_t *cache)
 			case ZBX_PREPROC_SNMP_WALK_TO_VALUE:
 				zbx_snmp_value_cache_clear((zbx_snmp_value_cache_t *)cache->data);
 				break;
+#ifdef HAVE_LIBXML2
+			case ZBX_PREPROC_XPATH:
+				xmlFreeDoc((xmlDoc *)cache->data);
+				cache->data = NULL;
+				break;
+#endif
 		}
 
 		zbx_free(cache->data);
 	}
 
+	for (int i = 0; i < cache->steps_values_num; i++)
+		zbx_variant_clear(&cache->steps_values[i]);
+
+	zbx_free(cache->steps_values);
+
+	if (NULL != cache->preproc)
+		zbx_pp_item_preproc_release(cache->preproc);
+
 	zbx_free(cache->error);
 	zbx_free(cache);
 }
@@ -164,9 +183,123 @@ int	pp_cache_is_supported(zbx_pp_item_preproc_t *preproc)
 			case ZBX_PREPROC_PROMETHEUS_PATTERN:
 			case ZBX_PREPROC_PROMETHEUS_TO_JSON:
 			case ZBX_PREPROC_SNMP_WALK_TO_VALUE:
+#ifdef HAVE_LIBXML2
+			case ZBX_PREPROC_XPATH:
+#endif
 				return SUCCEED;
 		}
 	}
 
 	return FAIL;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enable caching of leading step results                            *
+ *                                                                            *
+ * Parameters: cache   - [IN] preprocessing cache                             *
+ *             preproc - [IN] preprocessing data of the primary dependent     *
+ *                            item                                            *
+ *                                                                            *
+ * Comments: The primary dependent item is processed before other dependent   *
+ *           items are queued, so the step results are written by a single    *
+ *           worker and afterwards only read.                                 *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_cache_record_steps(zbx_pp_cache_t *cache, zbx_pp_item_preproc_t *preproc)
+{
+	cache->preproc = zbx_pp_item_preproc_copy(preproc);
+	cache->steps_values = (zbx_variant_t *)zbx_malloc(NULL, sizeof(zbx_variant_t) *
+			(size_t)MIN(preproc->steps_num, PP_CACHE_STEPS_MAX));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if step result can be reused by other dependent items       *
+ *                                                                            *
+ * Comments: Steps with history and JavaScript steps, which can have side     *
+ *           effects, must be executed for each item.                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_cache_is_step_supported(const zbx_pp_step_t *step)
+{
+	if (SUCCEED == zbx_pp_preproc_has_history(step->type) || ZBX_PREPROC_SCRIPT == step->type)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: cache result of the primary dependent item step                   *
+ *                                                                            *
+ * Parameters: cache   - [IN] preprocessing cache                             *
+ *             preproc - [IN] preprocessing data of the processed item        *
+ *             step    - [IN] index of the executed step                      *
+ *             value   - [IN] step result                                     *
+ *                                                                            *
+ * Comments: Only results of successfully executed leading steps without      *
+ *           history are cached.                                              *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_cache_add_step_value(zbx_pp_cache_t *cache, const zbx_pp_item_preproc_t *preproc, int step,
+		const zbx_variant_t *value)
+{
+	if (preproc != cache->preproc || step != cache->steps_values_num || PP_CACHE_STEPS_MAX <= step)
+		return;
+
+	if (SUCCEED != pp_cache_is_step_supported(&preproc->steps[step]))
+		return;
+
+	if (ZBX_VARIANT_ERR == value->type || ZBX_VARIANT_NONE == value->type)
+		return;
+
+	zbx_variant_copy(&cache->steps_values[cache->steps_values_num++], value);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get cached result of the leading steps matching the specified     *
+ *          preprocessing data                                                *
+ *                                                                            *
+ * Parameters: cache   - [IN] preprocessing cache                             *
+ *             preproc - [IN] preprocessing data                              *
+ *             value   - [OUT] result of the last matching step               *
+ *                                                                            *
+ * Return value: The number of leading steps with cached results.             *
+ *                                                                            *
+ ******************************************************************************/
+int	pp_cache_get_steps(const zbx_pp_cache_t *cache, const zbx_pp_item_preproc_t *preproc, zbx_variant_t *value)
+{
+	int	steps_num = 0;
+
+	if (NULL == cache->preproc || preproc == cache->preproc || preproc->hostid != cache->preproc->hostid ||
+			preproc->value_type != cache->preproc->value_type)
+	{
+		return 0;
+	}
+
+	for (; steps_num < cache->steps_values_num && steps_num < preproc->steps_num; steps_num++)
+	{
+		const zbx_pp_step_t	*step = &preproc->steps[steps_num], *step_cached;
+
+		step_cached = &cache->preproc->steps[steps_num];
+
+		if (step->type != step_cached->type || step->error_handler != step_cached->error_handler)
+			break;
+
+		if (0 != strcmp(ZBX_NULL2EMPTY_STR(step->params), ZBX_NULL2EMPTY_STR(step_cached->params)))
+			break;
+
+		if (0 != strcmp(ZBX_NULL2EMPTY_STR(step->error_handler_params),
+				ZBX_NULL2EMPTY_STR(step_cached->error_handler_params)))
+		{
+			break;
+		}
+	}
+
+	if (0 != steps_num)
+		zbx_variant_copy(value, &cache->steps_values[steps_num - 1]);
+
+	return steps_num;
+}
@@ -30,13 +30,22 @@ typedef struct
 }
 zbx_pp_cache_jsonpath_t;
 
+/* maximum number of leading step results cached for dependent items */
+#define PP_CACHE_STEPS_MAX	8
+
 typedef struct
 {
-	zbx_uint32_t	refcount;
-	zbx_variant_t	value;
-	int		type;
-	void		*data;
-	char		*error;
+	zbx_uint32_t		refcount;
+	zbx_variant_t		value;
+	int			type;
+	void			*data;
+	char			*error;
+
+	/* results of the leading steps of the first (primary) dependent item, */
+	/* reused by other dependent items having the same leading steps       */
+	zbx_pp_item_preproc_t	*preproc;
+	zbx_variant_t		*steps_values;
+	int			steps_values_num;
 }
 zbx_pp_cache_t;
 
@@ -47,4 +56,9 @@ zbx_pp_cache_t	*pp_cache_copy(zbx_pp_cache_t *cache);
 void	pp_cache_prepare_output_value(zbx_pp_cache_t *cache, int step_type, zbx_variant_t *value);
 int	pp_cache_is_supported(zbx_pp_item_preproc_t *preproc);
 
+void	pp_cache_record_steps(zbx_pp_cache_t *cache, zbx_pp_item_preproc_t *preproc);
+void	pp_cache_add_step_value(zbx_pp_cache_t *cache, const zbx_pp_item_preproc_t *preproc, int step,
+		const zbx_variant_t *value);
+int	pp_cache_get_steps(const zbx_pp_cache_t *cache, const zbx_pp_item_preproc_t *preproc, zbx_variant_t *value);
+
 #endif
@@ -32,6 +32,25 @@
 #include "zbxnum.h"
 #include "zbxstr.h"
 
+#define PP_JSONPATH_CACHE_MAX	10000
+#define PP_XPATH_CACHE_MAX	10000
+
+typedef struct
+{
+	char		*path;
+	zbx_jsonpath_t	jsonpath;
+}
+zbx_pp_jsonpath_t;
+
+#ifdef HAVE_LIBXML2
+typedef struct
+{
+	char			*path;
+	xmlXPathCompExpr	*xpath;
+}
+zbx_pp_xpath_t;
+#endif
+
 #ifdef HAVE_LIBXML2
 #	ifndef LIBXML_THREAD_ENABLED
 #		error Zabbix requires libxml2 library built with thread support.
@@ -225,11 +244,77 @@ static int	pp_execute_regsub(zbx_variant_t *value, const char *params)
 	return FAIL;
 }
 
+static zbx_hash_t	pp_jsonpath_hash(const void *d)
+{
+	const zbx_pp_jsonpath_t	*jp = (const zbx_pp_jsonpath_t *)d;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(jp->path);
+}
+
+static int	pp_jsonpath_compare(const void *d1, const void *d2)
+{
+	const zbx_pp_jsonpath_t	*jp1 = (const zbx_pp_jsonpath_t *)d1;
+	const zbx_pp_jsonpath_t	*jp2 = (const zbx_pp_jsonpath_t *)d2;
+
+	return strcmp(jp1->path, jp2->path);
+}
+
+static void	pp_jsonpath_clear(void *d)
+{
+	zbx_pp_jsonpath_t	*jp = (zbx_pp_jsonpath_t *)d;
+
+	zbx_free(jp->path);
+	zbx_jsonpath_clear(&jp->jsonpath);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compiled jsonpath from worker context cache                   *
+ *                                                                            *
+ * Parameters: ctx  - [IN] worker specific execution context                  *
+ *             path - [IN] jsonpath                                           *
+ *                                                                            *
+ * Return value: The compiled jsonpath or NULL if compilation failed.         *
+ *                                                                            *
+ * Comments: Compiled jsonpaths are cached per worker, as the same paths are  *
+ *           used repeatedly for every value of the item. The cache is reset  *
+ *           when its size limit is reached.                                  *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_jsonpath_t	*pp_context_jsonpath(zbx_pp_context_t *ctx, const char *path)
+{
+	zbx_pp_jsonpath_t	jp_local, *jp;
+
+	if (0 == ctx->jsonpaths_initialized)
+	{
+		zbx_hashset_create_ext(&ctx->jsonpaths, 0, pp_jsonpath_hash, pp_jsonpath_compare, pp_jsonpath_clear,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		ctx->jsonpaths_initialized = 1;
+	}
+
+	jp_local.path = (char *)path;
+
+	if (NULL != (jp = (zbx_pp_jsonpath_t *)zbx_hashset_search(&ctx->jsonpaths, &jp_local)))
+		return &jp->jsonpath;
+
+	if (FAIL == zbx_jsonpath_compile(path, &jp_local.jsonpath))
+		return NULL;
+
+	if (PP_JSONPATH_CACHE_MAX <= ctx->jsonpaths.num_data)
+		zbx_hashset_clear(&ctx->jsonpaths);
+
+	jp_local.path = zbx_strdup(NULL, path);
+	jp = (zbx_pp_jsonpath_t *)zbx_hashset_insert(&ctx->jsonpaths, &jp_local, sizeof(jp_local));
+
+	return &jp->jsonpath;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute jsonpath query                                            *
  *                                                                            *
- * Parameters: cache  - [IN] preprocessing cache                              *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
  *             value  - [IN/OUT] value to process                             *
  *             params - [IN] step parameters                                  *
  *             errmsg - [OUT]                                                 *
@@ -238,10 +323,11 @@ static int	pp_execute_regsub(zbx_variant_t *value, const char *params)
  *               FAIL    - otherwise.                                         *
  *                                                                            *
  ******************************************************************************/
-static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value, const char *params,
-		char **errmsg)
+static int	pp_excute_jsonpath_query(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params, char **errmsg)
 {
-	char	*data = NULL;
+	char		*data = NULL;
+	zbx_jsonpath_t	*jsonpath;
 
 	if (NULL == cache || ZBX_PREPROC_JSONPATH != cache->type)
 	{
@@ -250,20 +336,25 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
 		if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 			return FAIL;
 
-		if (FAIL == zbx_jsonobj_open(value->data.str, &obj))
+		/* definite paths are resolved on the text without building the whole object tree */
+		if (NULL == (jsonpath = pp_context_jsonpath(ctx, params)) ||
+				SUCCEED != zbx_jsonpath_query_text(value->data.str, jsonpath, &data))
 		{
-			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
-			return FAIL;
-		}
+			if (FAIL == zbx_jsonobj_open(value->data.str, &obj))
+			{
+				*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
+				return FAIL;
+			}
+
+			if (NULL == jsonpath || FAIL == zbx_jsonobj_query_path(&obj, NULL, jsonpath, &data))
+			{
+				zbx_jsonobj_clear(&obj);
+				*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
+				return FAIL;
+			}
 
-		if (FAIL == zbx_jsonobj_query(&obj, params, &data))
-		{
 			zbx_jsonobj_clear(&obj);
-			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
-			return FAIL;
 		}
-
-		zbx_jsonobj_clear(&obj);
 	}
 	else
 	{
@@ -301,7 +392,8 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
 			cache->data = (void *)index;
 		}
 
-		if (FAIL == zbx_jsonobj_query_ext(&index->obj, index->index, params, &data))
+		if (NULL == (jsonpath = pp_context_jsonpath(ctx, params)) ||
+				FAIL == zbx_jsonobj_query_path(&index->obj, index->index, jsonpath, &data))
 		{
 			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
 			return FAIL;
@@ -324,7 +416,8 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
  *                                                                            *
  * Purpose: execute 'jsonpath' step                                           *
  *                                                                            *
- * Parameters: cache  - [IN] preprocessing cache                              *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
  *             value  - [IN/OUT] value to process                             *
  *             params - [IN] step parameters                                  *
  *                                                                            *
@@ -332,11 +425,12 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
  *               FAIL    - otherwise. The error message is stored in value.   *
  *                                                                            *
  ******************************************************************************/
-static int	pp_execute_jsonpath(zbx_pp_cache_t *cache, zbx_variant_t *value, const char *params)
+static int	pp_execute_jsonpath(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params)
 {
 	char	*errmsg = NULL;
 
-	if (SUCCEED == pp_excute_jsonpath_query(cache, value, params, &errmsg))
+	if (SUCCEED == pp_excute_jsonpath_query(ctx, cache, value, params, &errmsg))
 		return SUCCEED;
 
 	zbx_variant_clear(value);
@@ -398,11 +492,142 @@ static int	pp_execute_2dec(int type, zbx_variant_t *value)
 	return FAIL;
 }
 
+#ifdef HAVE_LIBXML2
+static zbx_hash_t	pp_xpath_hash(const void *d)
+{
+	const zbx_pp_xpath_t	*xp = (const zbx_pp_xpath_t *)d;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(xp->path);
+}
+
+static int	pp_xpath_compare(const void *d1, const void *d2)
+{
+	const zbx_pp_xpath_t	*xp1 = (const zbx_pp_xpath_t *)d1;
+	const zbx_pp_xpath_t	*xp2 = (const zbx_pp_xpath_t *)d2;
+
+	return strcmp(xp1->path, xp2->path);
+}
+
+static void	pp_xpath_clear(void *d)
+{
+	zbx_pp_xpath_t	*xp = (zbx_pp_xpath_t *)d;
+
+	zbx_free(xp->path);
+	xmlXPathFreeCompExpr(xp->xpath);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compiled xpath from worker context cache                      *
+ *                                                                            *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             path   - [IN] xpath                                            *
+ *             errmsg - [OUT]                                                 *
+ *                                                                            *
+ * Return value: The compiled xpath or NULL if compilation failed.            *
+ *                                                                            *
+ * Comments: Compiled expressions are evaluated with a new context each time, *
+ *           so they can be reused by the worker for all items.               *
+ *                                                                            *
+ ******************************************************************************/
+static xmlXPathCompExpr	*pp_context_xpath(zbx_pp_context_t *ctx, const char *path, char **errmsg)
+{
+	zbx_pp_xpath_t	xp_local, *xp;
+
+	if (0 == ctx->xpaths_initialized)
+	{
+		zbx_hashset_create_ext(&ctx->xpaths, 0, pp_xpath_hash, pp_xpath_compare, pp_xpath_clear,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		ctx->xpaths_initialized = 1;
+	}
+
+	xp_local.path = (char *)path;
+
+	if (NULL != (xp = (zbx_pp_xpath_t *)zbx_hashset_search(&ctx->xpaths, &xp_local)))
+		return xp->xpath;
+
+	if (NULL == (xp_local.xpath = zbx_xml_xpath_compile(path, errmsg)))
+		return NULL;
+
+	if (PP_XPATH_CACHE_MAX <= ctx->xpaths.num_data)
+		zbx_hashset_clear(&ctx->xpaths);
+
+	xp_local.path = zbx_strdup(NULL, path);
+	xp = (zbx_pp_xpath_t *)zbx_hashset_insert(&ctx->xpaths, &xp_local, sizeof(xp_local));
+
+	return xp->xpath;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute xpath query with cached document and compiled xpath       *
+ *                                                                            *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
+ *             value  - [IN/OUT] value to process                             *
+ *             params - [IN] step parameters                                  *
+ *             errmsg - [OUT]                                                 *
+ *                                                                            *
+ * Result value: SUCCEED - the query was executed successfully.               *
+ *               FAIL    - otherwise.                                         *
+ *                                                                            *
+ * Comments: The parsed document is stored in preprocessing cache and shared  *
+ *           by dependent items having xpath as the first step.               *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_query_xpath(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params, char **errmsg)
+{
+	xmlDoc			*doc;
+	xmlXPathCompExpr	*xpath;
+	int			ret;
+
+	if (NULL == cache || ZBX_PREPROC_XPATH != cache->type)
+	{
+		if (NULL == (doc = zbx_xml_doc_parse(value->data.str, errmsg)))
+			return FAIL;
+
+		if (NULL == (xpath = pp_context_xpath(ctx, params, errmsg)))
+			ret = FAIL;
+		else
+			ret = zbx_query_xpath_doc(doc, xpath, value, errmsg);
+
+		xmlFreeDoc(doc);
+
+		return ret;
+	}
+
+	if (NULL != cache->error)
+	{
+		*errmsg = zbx_strdup(NULL, cache->error);
+		return FAIL;
+	}
+
+	if (NULL == (doc = (xmlDoc *)cache->data))
+	{
+		if (NULL == (doc = zbx_xml_doc_parse(value->data.str, &cache->error)))
+		{
+			*errmsg = zbx_strdup(NULL, cache->error);
+			return FAIL;
+		}
+
+		cache->data = (void *)doc;
+	}
+
+	if (NULL == (xpath = pp_context_xpath(ctx, params, errmsg)))
+		return FAIL;
+
+	return zbx_query_xpath_doc(doc, xpath, value, errmsg);
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute xpath query                                               *
  *                                                                            *
- * Parameters: value  - [IN/OUT] value to process                             *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
+ *             value  - [IN/OUT] value to process                             *
  *             params - [IN] step parameters                                  *
  *             error  - [OUT]                                                 *
  *                                                                            *
@@ -410,15 +635,26 @@ static int	pp_execute_2dec(int type, zbx_variant_t *value)
  *               FAIL    - otherwise.                                         *
  *                                                                            *
  ******************************************************************************/
-static int	pp_execute_xpath_query(zbx_variant_t *value, const char *params, char **error)
+static int	pp_execute_xpath_query(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params, char **error)
 {
 	char	*errmsg = NULL;
 
-	if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, error))
+	if ((NULL == cache || ZBX_PREPROC_XPATH != cache->type || NULL == cache->data) &&
+			FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, error))
+	{
 		return FAIL;
+	}
+#ifdef HAVE_LIBXML2
+	if (SUCCEED == pp_query_xpath(ctx, cache, value, params, &errmsg))
+		return SUCCEED;
+#else
+	ZBX_UNUSED(ctx);
+	ZBX_UNUSED(cache);
 
 	if (SUCCEED == zbx_query_xpath(value, params, &errmsg))
 		return SUCCEED;
+#endif
 
 	*error = zbx_dsprintf(NULL, "cannot extract XML value with xpath \"%s\": %s", params, errmsg);
 	zbx_free(errmsg);
@@ -430,18 +666,21 @@ static int	pp_execute_xpath_query(zbx_variant_t *value, const char *params, char
  *                                                                            *
  * Purpose: execute 'xpath' step                                              *
  *                                                                            *
- * Parameters: value  - [IN/OUT] value to process                             *
+ * Parameters: ctx    - [IN] worker specific execution context                *
+ *             cache  - [IN] preprocessing cache                              *
+ *             value  - [IN/OUT] value to process                             *
  *             params - [IN] step parameters                                  *
  *                                                                            *
  * Result value: SUCCEED - the preprocessing step was executed successfully.  *
  *               FAIL    - otherwise. The error message is stored in value.   *
  *                                                                            *
  ******************************************************************************/
-static int	pp_execute_xpath(zbx_variant_t *value, const char *params)
+static int	pp_execute_xpath(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_variant_t *value,
+		const char *params)
 {
 	char	*errmsg = NULL;
 
-	if (SUCCEED == pp_execute_xpath_query(value, params, &errmsg))
+	if (SUCCEED == pp_execute_xpath_query(ctx, cache, value, params, &errmsg))
 		return SUCCEED;
 
 	zbx_variant_clear(value);
@@ -1064,10 +1303,10 @@ int	pp_execute_step(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_dc_um_shar
 			ret = pp_execute_delta(step->type, value_type, value, ts, history_value, history_ts);
 			goto out;
 		case ZBX_PREPROC_XPATH:
-			ret = pp_execute_xpath(value, params);
+			ret = pp_execute_xpath(ctx, cache, value, params);
 			goto out;
 		case ZBX_PREPROC_JSONPATH:
-			ret = pp_execute_jsonpath(cache, value, params);
+			ret = pp_execute_jsonpath(ctx, cache, value, params);
 			goto out;
 		case ZBX_PREPROC_VALIDATE_RANGE:
 			ret = pp_validate_range(value_type, value, params);
@@ -1134,6 +1373,83 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add execution time to time statistics                             *
+ *                                                                            *
+ * Parameters: stats - [IN/OUT] time statistics                               *
+ *             time  - [IN] execution time in seconds                         *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_time_stats_add(zbx_pp_time_stats_t *stats, double time)
+{
+	int	i;
+	double	limit = 0.001;
+
+	for (i = 0; i < ZBX_PP_TIME_BUCKETS_NUM - 1 && time >= limit; i++)
+		limit *= 10;
+
+	stats->buckets[i]++;
+	stats->num++;
+	stats->time += time;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merge time statistics                                             *
+ *                                                                            *
+ * Parameters: dst - [IN/OUT] destination time statistics                     *
+ *             src - [IN] source time statistics                              *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_time_stats_merge(zbx_pp_time_stats_t *dst, const zbx_pp_time_stats_t *src)
+{
+	for (int i = 0; i < ZBX_PP_TIME_BUCKETS_NUM; i++)
+		dst->buckets[i] += src->buckets[i];
+
+	dst->num += src->num;
+	dst->time += src->time;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add step execution time to worker context statistics              *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_context_add_step_time(zbx_pp_context_t *ctx, int type, double time)
+{
+	if (0 > type || PP_STEP_TYPES_NUM <= type)
+		return;
+
+	pp_time_stats_add(&ctx->steps_stats[type], time);
+	ctx->steps_stats_mask |= (zbx_uint32_t)1 << type;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: flush step execution time statistics from worker context          *
+ *                                                                            *
+ * Parameters: ctx         - [IN] worker specific execution context           *
+ *             steps_stats - [IN/OUT] statistics to update, indexed by step   *
+ *                                    type                                    *
+ *                                                                            *
+ * Comments: Only the statistics of steps executed since the last flush are   *
+ *           merged.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_context_flush_steps_stats(zbx_pp_context_t *ctx, zbx_pp_time_stats_t *steps_stats)
+{
+	for (int i = 0; 0 != ctx->steps_stats_mask; i++)
+	{
+		if (0 == (ctx->steps_stats_mask & ((zbx_uint32_t)1 << i)))
+			continue;
+
+		pp_time_stats_merge(&steps_stats[i], &ctx->steps_stats[i]);
+		memset(&ctx->steps_stats[i], 0, sizeof(zbx_pp_time_stats_t));
+		ctx->steps_stats_mask &= ~((zbx_uint32_t)1 << i);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute preprocessing steps                                       *
@@ -1157,8 +1473,9 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 {
 	zbx_pp_result_t		*results;
 	zbx_pp_history_t	*history;
-	int			quote_error, results_num, action;
+	int			quote_error = 0, results_num, action = ZBX_PREPROC_FAIL_DEFAULT, steps_cached = 0;
 	zbx_variant_t		value_raw;
+	zbx_pp_cache_t		*cache_steps = cache;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s(): value:%s type:%s", __func__,
 			zbx_variant_value_desc(NULL == cache ? value_in : &cache->value),
@@ -1177,12 +1494,16 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 	}
 	else
 	{
-		/* preprocessing cache is enabled only for the first step, */
-		/* so prepare output value based on first step type        */
-		pp_cache_prepare_output_value(cache, preproc->steps[0].type, value_out);
+		/* skip leading steps already executed by the primary dependent item, */
+		/* otherwise the cache is used for the first step and output value is */
+		/* prepared based on first step type                                  */
+		if (0 != (steps_cached = pp_cache_get_steps(cache, preproc, value_out)))
+			cache = NULL;
+		else
+			pp_cache_prepare_output_value(cache, preproc->steps[0].type, value_out);
 
-		/* set input value for error reporting */
-		value_in = &cache->value;
+		/* set input value for error reporting, cache is reset when cached steps are reused */
+		value_in = &cache_steps->value;
 	}
 
 	results = (zbx_pp_result_t *)zbx_malloc(NULL, sizeof(zbx_pp_result_t) * (size_t)preproc->steps_num);
@@ -1195,6 +1516,15 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 	{
 		zbx_variant_t	history_value;
 		zbx_timespec_t	history_ts;
+		double		time_start;
+		int		ret;
+
+		if (i < steps_cached)
+		{
+			pp_result_set(results + results_num++, &cache_steps->steps_values[i], ZBX_PREPROC_FAIL_DEFAULT,
+					&value_raw);
+			continue;
+		}
 
 		if (ZBX_VARIANT_ERR == value_out->type && ZBX_PREPROC_VALIDATE_NOT_SUPPORTED != preproc->steps[i].type)
 			break;
@@ -1204,8 +1534,12 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 
 		zbx_pp_history_pop(preproc->history, i, &history_value, &history_ts);
 
-		if (SUCCEED != pp_execute_step(ctx, cache, um_handle, preproc->hostid, preproc->value_type, value_out,
-				ts, preproc->steps + i, &history_value, &history_ts, config_source_ip))
+		time_start = zbx_time();
+		ret = pp_execute_step(ctx, cache, um_handle, preproc->hostid, preproc->value_type, value_out, ts,
+				preproc->steps + i, &history_value, &history_ts, config_source_ip);
+		pp_context_add_step_time(ctx, preproc->steps[i].type, zbx_time() - time_start);
+
+		if (SUCCEED != ret)
 		{
 			zbx_variant_copy(&value_raw, value_out);
 			if (ZBX_PREPROC_FAIL_DEFAULT == (action = pp_error_on_fail(value_out, preproc->steps + i)))
@@ -1219,6 +1553,9 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 
 		pp_result_set(results + results_num++, value_out, action, &value_raw);
 
+		if (NULL != cache_steps && ZBX_PREPROC_FAIL_DEFAULT == action && 0 == quote_error)
+			pp_cache_add_step_value(cache_steps, preproc, i, value_out);
+
 		if (NULL != history && ZBX_VARIANT_NONE != history_value.type && ZBX_VARIANT_ERR != value_out->type)
 		{
 			if (SUCCEED == zbx_pp_preproc_has_history(preproc->steps[i].type))
@@ -1281,6 +1618,12 @@ void	pp_context_destroy(zbx_pp_context_t *ctx)
 {
 	if (0 != ctx->es_initialized)
 		zbx_es_destroy(&ctx->es_engine);
+
+	if (0 != ctx->jsonpaths_initialized)
+		zbx_hashset_destroy(&ctx->jsonpaths);
+
+	if (0 != ctx->xpaths_initialized)
+		zbx_hashset_destroy(&ctx->xpaths);
 }
 
 zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx)
@@ -26,17 +26,33 @@
 #include "zbxtime.h"
 #include "zbxvariant.h"
 #include "zbxcacheconfig.h"
+#include "zbxalgo.h"
+
+/* number of supported preprocessing step types */
+#define PP_STEP_TYPES_NUM	(ZBX_PREPROC_SNMP_WALK_TO_JSON + 1)
 
 typedef struct
 {
-	int		es_initialized;
-	zbx_es_t	es_engine;
+	int			es_initialized;
+	zbx_es_t		es_engine;
+	int			jsonpaths_initialized;
+	zbx_hashset_t		jsonpaths;	/* compiled jsonpath cache */
+	int			xpaths_initialized;
+	zbx_hashset_t		xpaths;		/* compiled xpath cache */
+
+	/* step execution time statistics not yet flushed to worker statistics */
+	zbx_pp_time_stats_t	steps_stats[PP_STEP_TYPES_NUM];
+	zbx_uint32_t		steps_stats_mask;
 }
 zbx_pp_context_t;
 
 void		pp_context_init(zbx_pp_context_t *ctx);
 void		pp_context_destroy(zbx_pp_context_t *ctx);
 zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx);
+void		pp_context_flush_steps_stats(zbx_pp_context_t *ctx, zbx_pp_time_stats_t *steps_stats);
+
+void	pp_time_stats_add(zbx_pp_time_stats_t *stats, double time);
+void	pp_time_stats_merge(zbx_pp_time_stats_t *dst, const zbx_pp_time_stats_t *src);
 
 void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_cache_t *cache,
 		zbx_dc_um_shared_handle_t *um_handle, zbx_variant_t *value_in, zbx_timespec_t ts,
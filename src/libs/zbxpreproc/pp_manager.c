@@ -36,6 +36,7 @@
 #include "zbxvariant.h"
 #include "zbxlog.h"
 #include "pp_cache.h"
+#include "pp_execute.h"
 #include "zbxcacheconfig.h"
 #include "zbxipcservice.h"
 #include "zbxthreads.h"
@@ -47,6 +48,8 @@
 #	include <libxml/xpath.h>
 #endif
 
+ZBX_PTR_VECTOR_IMPL(pp_time_stats_ptr, zbx_pp_time_stats_t *)
+
 static zbx_flush_value_func_t	flush_value_func_cb = NULL;
 
 /******************************************************************************
@@ -133,6 +136,7 @@ zbx_pp_manager_t	*zbx_pp_manager_create(int workers_num, zbx_pp_notify_cb_t fini
 #endif
 	manager = (zbx_pp_manager_t *)zbx_malloc(NULL, sizeof(zbx_pp_manager_t));
 	memset(manager, 0, sizeof(zbx_pp_manager_t));
+	pp_context_init(&manager->execute_ctx);
 
 	if (SUCCEED != pp_task_queue_init(&manager->queue, error))
 		goto out;
@@ -225,6 +229,7 @@ void	zbx_pp_manager_free(zbx_pp_manager_t *manager)
 	zbx_timekeeper_free(manager->timekeeper);
 
 	zbx_dc_um_shared_handle_release(manager->um_handle);
+	pp_context_destroy(&manager->execute_ctx);
 
 #ifdef HAVE_NETSNMP
 	preproc_shutdown_snmp();
@@ -278,6 +283,40 @@ void	zbx_pp_manager_queue_value_preproc(zbx_pp_manager_t *manager, zbx_vector_pp
 	zbx_prof_end();
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if item value can be throttled by manager without           *
+ *          queuing preprocessing task                                        *
+ *                                                                            *
+ * Parameters: item - [IN] item                                               *
+ *                                                                            *
+ * Return value: SUCCEED - the value can be throttled by manager              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Only items with single throttling step and without dependent     *
+ *           items are throttled by manager. Such items are never processed   *
+ *           by workers, so the item preprocessing history is accessed only   *
+ *           by manager. Dependent items are excluded because their values    *
+ *           are queued directly from master item results.                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_manager_can_throttle_value(const zbx_pp_item_t *item)
+{
+	const zbx_pp_item_preproc_t	*preproc = item->preproc;
+
+	if (1 != preproc->steps_num || 0 != preproc->dep_itemids_num || ITEM_TYPE_DEPENDENT == preproc->type)
+		return FAIL;
+
+	switch (preproc->steps[0].type)
+	{
+		case ZBX_PREPROC_THROTTLE_VALUE:
+		case ZBX_PREPROC_THROTTLE_TIMED_VALUE:
+			return SUCCEED;
+		default:
+			return FAIL;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: create preprocessing task from request                            *
@@ -306,6 +345,18 @@ zbx_pp_task_t	*zbx_pp_manager_create_task(zbx_pp_manager_t *manager, zbx_uint64_
 	if (0 == item->preproc->dep_itemids_num && 0 == item->preproc->steps_num)
 		return NULL;
 
+	/* discard unchanged values directly instead of passing them to workers */
+	if (SUCCEED == pp_manager_can_throttle_value(item))
+	{
+		zbx_variant_t	value_out;
+
+		pp_execute(&manager->execute_ctx, item->preproc, NULL, NULL, value, ts, NULL, &value_out, NULL, NULL);
+		zbx_variant_clear(value);
+		*value = value_out;
+
+		return NULL;
+	}
+
 	if (ZBX_PP_PROCESS_PARALLEL == item->preproc->mode)
 	{
 		return pp_task_value_create(item->itemid, item->preproc, manager->um_handle, value, ts, value_opt,
@@ -427,6 +478,9 @@ static void	pp_manager_queue_value_task_result(zbx_pp_manager_t *manager, zbx_pp
 	zbx_pp_task_value_t	*d = (zbx_pp_task_value_t *)PP_TASK_DATA(task);
 	zbx_pp_item_t		*item;
 
+	if (NULL != (item = (zbx_pp_item_t *)zbx_hashset_search(&manager->items, &task->itemid)))
+		pp_time_stats_add(&item->time_stats, d->time);
+
 	if (ZBX_VARIANT_NONE == d->result.type)
 		return;
 
@@ -440,6 +494,7 @@ static void	pp_manager_queue_value_task_result(zbx_pp_manager_t *manager, zbx_pp
 		zbx_pp_task_dependent_t	*d_dep = (zbx_pp_task_dependent_t *)PP_TASK_DATA(dep_task);
 
 		d_dep->cache = pp_cache_create(item->preproc, &d->result);
+		pp_cache_record_steps(d_dep->cache, item->preproc);
 		zbx_variant_set_none(&value);
 
 		d_dep->primary = pp_task_value_create(item->itemid, item->preproc, d->um_handle, &value, d->ts,
@@ -542,6 +597,7 @@ void	zbx_pp_manager_process_finished(zbx_pp_manager_t *manager, zbx_vector_pp_ta
 	zbx_pp_task_t	*task;
 	static time_t	timekeeper_clock = 0;
 	time_t		now;
+	int		i, tasks_num = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -549,34 +605,35 @@ void	zbx_pp_manager_process_finished(zbx_pp_manager_t *manager, zbx_vector_pp_ta
 	zbx_prof_start(__func__, ZBX_PROF_MUTEX);
 	pp_task_queue_lock(&manager->queue);
 	zbx_prof_end_wait();
-	while (PP_FINISHED_TASK_BATCH_SIZE > tasks->values_num)
+
+	*finished_num = pp_task_queue_pop_finished(&manager->queue, tasks, PP_FINISHED_TASK_BATCH_SIZE);
+
+	for (i = 0; i < tasks->values_num; i++)
 	{
-		if (NULL != (task = pp_task_queue_pop_finished(&manager->queue)))
+		task = tasks->values[i];
+
+		switch (task->type)
 		{
-			switch (task->type)
-			{
-				case ZBX_PP_TASK_VALUE:
-					pp_manager_queue_value_task_result(manager, task);
-					break;
-				case ZBX_PP_TASK_DEPENDENT:
-					task = pp_manager_queue_dependent_task_result(manager, task);
-					break;
-				case ZBX_PP_TASK_SEQUENCE:
-					task = pp_manager_requeue_next_sequence_task(manager, task);
-					break;
-				default:
-					break;
-			}
+			case ZBX_PP_TASK_VALUE:
+				pp_manager_queue_value_task_result(manager, task);
+				break;
+			case ZBX_PP_TASK_DEPENDENT:
+				task = pp_manager_queue_dependent_task_result(manager, task);
+				break;
+			case ZBX_PP_TASK_SEQUENCE:
+				task = pp_manager_requeue_next_sequence_task(manager, task);
+				break;
+			default:
+				break;
 		}
 
-		if (NULL == task)
-			break;
-
-		zbx_vector_pp_task_ptr_append(tasks, task);
+		if (NULL != task)
+			tasks->values[tasks_num++] = task;
 	}
 
+	tasks->values_num = tasks_num;
+
 	*pending_num = manager->queue.pending_num;
-	*finished_num = manager->queue.finished_num;
 	*processing_num = manager->queue.processing_num;
 
 	pp_task_queue_unlock(&manager->queue);
@@ -651,7 +708,12 @@ void	zbx_pp_manager_get_diag_stats(zbx_pp_manager_t *manager, zbx_uint64_t *prep
 {
 	*preproc_num = (zbx_uint64_t)manager->items.num_data;
 	*pending_num = manager->queue.pending_num;
+
+	/* finished tasks are pushed by workers */
+	pthread_mutex_lock(&manager->queue.finished_lock);
 	*finished_num = manager->queue.finished_num;
+	pthread_mutex_unlock(&manager->queue.finished_lock);
+
 	*sequences_num = (zbx_uint64_t)manager->queue.sequences.num_data;
 }
 
@@ -675,6 +737,73 @@ void	zbx_pp_manager_get_worker_usage(zbx_pp_manager_t *manager, zbx_vector_dbl_t
 	(void)zbx_timekeeper_get_usage(manager->timekeeper, worker_usage);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get item preprocessing time statistics                            *
+ *                                                                            *
+ * Parameters: manager - [IN]                                                 *
+ *             items   - [OUT] time statistics of preprocessed items          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_pp_manager_get_item_stats(zbx_pp_manager_t *manager, zbx_vector_pp_time_stats_ptr_t *items)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_pp_item_t		*item;
+
+	zbx_hashset_iter_reset(&manager->items, &iter);
+	while (NULL != (item = (zbx_pp_item_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_pp_time_stats_t	*stats;
+
+		if (0 == item->time_stats.num)
+			continue;
+
+		stats = (zbx_pp_time_stats_t *)zbx_malloc(NULL, sizeof(zbx_pp_time_stats_t));
+		*stats = item->time_stats;
+		stats->id = item->itemid;
+		zbx_vector_pp_time_stats_ptr_append(items, stats);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get preprocessing step time statistics                            *
+ *                                                                            *
+ * Parameters: manager - [IN]                                                 *
+ *             steps   - [OUT] time statistics of executed step types         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_pp_manager_get_step_stats(zbx_pp_manager_t *manager, zbx_vector_pp_time_stats_ptr_t *steps)
+{
+	zbx_pp_time_stats_t	steps_stats[PP_STEP_TYPES_NUM];
+
+	/* steps executed by manager are not flushed, so take them directly from manager context */
+	memcpy(steps_stats, manager->execute_ctx.steps_stats, sizeof(steps_stats));
+
+	pp_task_queue_lock(&manager->queue);
+
+	for (int i = 0; i < manager->workers_num; i++)
+	{
+		for (int j = 0; j < PP_STEP_TYPES_NUM; j++)
+			pp_time_stats_merge(&steps_stats[j], &manager->workers[i].steps_stats[j]);
+	}
+
+	pp_task_queue_unlock(&manager->queue);
+
+	for (int i = 0; i < PP_STEP_TYPES_NUM; i++)
+	{
+		zbx_pp_time_stats_t	*stats;
+
+		if (0 == steps_stats[i].num)
+			continue;
+
+		stats = (zbx_pp_time_stats_t *)zbx_malloc(NULL, sizeof(zbx_pp_time_stats_t));
+		*stats = steps_stats[i];
+		stats->id = (zbx_uint64_t)i;
+		zbx_vector_pp_time_stats_ptr_append(steps, stats);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: synchronize preprocessing manager with configuration cache data   *
@@ -709,13 +838,10 @@ static void	preprocessor_sync_configuration(zbx_pp_manager_t *manager)
 static void	preproc_item_value_clear(zbx_preproc_item_value_t *value)
 {
 	zbx_free(value->error);
-	zbx_free(value->ts);
 
+	/* timestamp and result are unpacked into caller provided storage */
 	if (NULL != value->result)
-	{
 		zbx_free_agent_result(value->result);
-		zbx_free(value->result);
-	}
 }
 
 /******************************************************************************
@@ -849,6 +975,8 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 	zbx_preproc_item_value_t	value;
 	zbx_uint64_t			queued_num = 0;
 	zbx_vector_pp_task_ptr_t	tasks;
+	zbx_timespec_t			value_ts;
+	AGENT_RESULT			value_result;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -864,7 +992,7 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 		zbx_timespec_t		ts;
 		zbx_pp_task_t		*task;
 
-		offset += zbx_preprocessor_unpack_value(&value, message->data + offset);
+		offset += zbx_preprocessor_unpack_value(&value, &value_ts, &value_result, message->data + offset);
 		preproc_item_value_extract_data(&value, &var, &ts, &var_opt);
 
 		if (NULL == (task = zbx_pp_manager_create_task(manager, value.itemid, &var, ts, &var_opt)))
@@ -1065,6 +1193,62 @@ static void	preprocessor_reply_top_sequences(zbx_pp_manager_t *manager, zbx_ipc_
 	zbx_vector_pp_sequence_stats_ptr_destroy(&sequences);
 }
 
+static int	preprocessor_compare_time_stats(const void *d1, const void *d2)
+{
+	const zbx_pp_time_stats_t *s1 = *(const zbx_pp_time_stats_t * const *)d1;
+	const zbx_pp_time_stats_t *s2 = *(const zbx_pp_time_stats_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s2->time, s1->time);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: respond to top items or steps by execution time request           *
+ *                                                                            *
+ * Parameters: manager - [IN] preprocessing manager                           *
+ *             client  - [IN] request source                                  *
+ *             message - [IN] request message                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	preprocessor_reply_top_time_stats(zbx_pp_manager_t *manager, zbx_ipc_client_t *client,
+		zbx_ipc_message_t *message)
+{
+	int				limit;
+	zbx_vector_pp_time_stats_ptr_t	stats;
+	unsigned char			*data;
+	zbx_uint32_t			data_len, code;
+
+	zbx_vector_pp_time_stats_ptr_create(&stats);
+
+	zbx_preprocessor_unpack_top_request(&limit, message->data);
+
+	if (ZBX_IPC_PREPROCESSOR_TOP_ITEMS == message->code)
+	{
+		zbx_pp_manager_get_item_stats(manager, &stats);
+		code = ZBX_IPC_PREPROCESSOR_TOP_ITEMS_RESULT;
+	}
+	else
+	{
+		zbx_pp_manager_get_step_stats(manager, &stats);
+		code = ZBX_IPC_PREPROCESSOR_TOP_STEPS_RESULT;
+	}
+
+	if (limit > stats.values_num)
+		limit = stats.values_num;
+
+	zbx_vector_pp_time_stats_ptr_sort(&stats, preprocessor_compare_time_stats);
+
+	data_len = zbx_preprocessor_pack_top_time_stats_result(&data, &stats, limit);
+
+	zbx_ipc_client_send(client, code, data, data_len);
+
+	zbx_free(data);
+	zbx_vector_pp_time_stats_ptr_clear_ext(&stats, (zbx_pp_time_stats_ptr_free_func_t)zbx_ptr_free);
+	zbx_vector_pp_time_stats_ptr_destroy(&stats);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: respond to worker usage statistics request                        *
@@ -1264,6 +1448,10 @@ ZBX_THREAD_ENTRY(zbx_pp_manager_thread, args)
 				case ZBX_IPC_PREPROCESSOR_USAGE_STATS:
 					preprocessor_reply_usage_stats(manager, pp_args->workers_num, client);
 					break;
+				case ZBX_IPC_PREPROCESSOR_TOP_ITEMS:
+				case ZBX_IPC_PREPROCESSOR_TOP_STEPS:
+					preprocessor_reply_top_time_stats(manager, client, message);
+					break;
 				case ZBX_RTC_LOG_LEVEL_INCREASE:
 					preprocessor_change_loglevel(manager, 1, (const char *)message->data);
 					break;
@@ -1275,7 +1463,7 @@ ZBX_THREAD_ENTRY(zbx_pp_manager_thread, args)
 					goto out;
 			}
 
-			zbx_ipc_message_free(message);
+			zbx_ipc_service_release_message(&service, message);
 		}
 
 		if (NULL != client)
@@ -41,6 +41,8 @@ struct zbx_pp_manager
 	zbx_timekeeper_t		*timekeeper;
 
 	zbx_dc_um_shared_handle_t	*um_handle;
+
+	zbx_pp_context_t		execute_ctx;	/* context for steps executed by manager */
 };
 
 #endif
@@ -32,7 +32,12 @@
 #define PACKED_FIELD(value, size)	\
 		(zbx_packed_field_t){(value), (size), (0 == (size) ? PACKED_FIELD_STRING : PACKED_FIELD_RAW)}
 
+/* the cached message buffer is reused between flushes unless it grows */
+/* larger than ZBX_PREPROCESSING_CACHE_ALLOC_MAX bytes                  */
+#define ZBX_PREPROCESSING_CACHE_ALLOC_MAX	ZBX_MEBIBYTE
+
 static zbx_ipc_message_t	cached_message;
+static zbx_uint32_t		cached_alloc;
 static int			cached_values;
 
 ZBX_PTR_VECTOR_IMPL(ipcmsg, zbx_ipc_message_t *)
@@ -85,14 +90,21 @@ static zbx_uint32_t	fields_pack(const zbx_packed_field_t *fields, int fields_num
 	return (zbx_uint32_t)(offset - data);
 }
 
-static int	message_pack_fields(zbx_ipc_message_t *message, const zbx_packed_field_t *fields,
-		int fields_num, zbx_uint32_t fields_size)
+static int	message_pack_fields(zbx_ipc_message_t *message, zbx_uint32_t *message_alloc,
+		const zbx_packed_field_t *fields, int fields_num, zbx_uint32_t fields_size)
 {
 	if (UINT32_MAX - message->size < fields_size)
 		return FAIL;
 
 	message->size += fields_size;
-	message->data = (unsigned char *)zbx_realloc(message->data, message->size);
+
+	if (NULL == message_alloc)
+	{
+		message->data = (unsigned char *)zbx_realloc(message->data, message->size);
+	}
+	else
+		zbx_serialize_reserve(&message->data, message_alloc, message->size);
+
 	fields_pack(fields, fields_num, message->data + (message->size - fields_size));
 
 	return SUCCEED;
@@ -102,16 +114,19 @@ static int	message_pack_fields(zbx_ipc_message_t *message, const zbx_packed_fiel
  *                                                                            *
  * Purpose: helper for data packing based on defined format                   *
  *                                                                            *
- * Parameters: message - [OUT] IPC message, can be NULL for buffer size       *
- *                             calculations                                   *
- *             fields  - [IN] definition of data to be packed                 *
- *             count   - [IN] field count                                     *
+ * Parameters: message       - [OUT] IPC message, can be NULL for buffer size *
+ *                                   calculations                             *
+ *             message_alloc - [IN/OUT] allocated message data size, can be   *
+ *                                   NULL to allocate the exact size          *
+ *             fields        - [IN] definition of data to be packed           *
+ *             count         - [IN] field count                               *
  *                                                                            *
  * Return value: size of packed data or 0 if the message size would exceed    *
  *               4GB limit                                                    *
  *                                                                            *
  ******************************************************************************/
-static zbx_uint32_t	message_pack_data(zbx_ipc_message_t *message, zbx_packed_field_t *fields, int count)
+static zbx_uint32_t	message_pack_data(zbx_ipc_message_t *message, zbx_uint32_t *message_alloc,
+		zbx_packed_field_t *fields, int count)
 {
 	zbx_uint32_t	data_size = 0;
 
@@ -120,7 +135,7 @@ static zbx_uint32_t	message_pack_data(zbx_ipc_message_t *message, zbx_packed_fie
 
 	if (NULL != message)
 	{
-		if (SUCCEED != message_pack_fields(message, fields, count, data_size))
+		if (SUCCEED != message_pack_fields(message, message_alloc, fields, count, data_size))
 			return 0;
 	}
 
@@ -131,13 +146,15 @@ static zbx_uint32_t	message_pack_data(zbx_ipc_message_t *message, zbx_packed_fie
  *                                                                            *
  * Purpose: pack item value data into a single buffer that can be used in IPC *
  *                                                                            *
- * Parameters: message - [OUT] IPC message                                    *
- *             value   - [IN] value to be packed                              *
+ * Parameters: message       - [OUT] IPC message                              *
+ *             message_alloc - [IN/OUT] allocated message data size           *
+ *             value         - [IN] value to be packed                        *
  *                                                                            *
  * Return value: size of packed data                                          *
  *                                                                            *
  ******************************************************************************/
-static zbx_uint32_t	preprocessor_pack_value(zbx_ipc_message_t *message, zbx_preproc_item_value_t *value)
+static zbx_uint32_t	preprocessor_pack_value(zbx_ipc_message_t *message, zbx_uint32_t *message_alloc,
+		zbx_preproc_item_value_t *value)
 {
 	zbx_packed_field_t	fields[24], *offset = fields;	/* 24 - max field count */
 	unsigned char		ts_marker, result_marker, log_marker;
@@ -185,7 +202,7 @@ static zbx_uint32_t	preprocessor_pack_value(zbx_ipc_message_t *message, zbx_prep
 		}
 	}
 
-	return message_pack_data(message, fields, (int)(offset - fields));
+	return message_pack_data(message, message_alloc, fields, (int)(offset - fields));
 }
 
 /******************************************************************************
@@ -462,7 +479,7 @@ zbx_uint32_t	zbx_preprocessor_pack_test_result(unsigned char **data, const zbx_p
 	offset += preprocessor_pack_history(offset, history, &history_num);
 
 	zbx_ipc_message_init(&message);
-	size = message_pack_data(&message, fields, (int)(offset - fields));
+	size = message_pack_data(&message, NULL, fields, (int)(offset - fields));
 	*data = message.data;
 
 	zbx_free(fields);
@@ -591,17 +608,67 @@ zbx_uint32_t	zbx_preprocessor_pack_top_sequences_result(unsigned char **data,
 	return data_len;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pack top time statistics result data into a single buffer that    *
+ *          can be used in IPC                                                *
+ *                                                                            *
+ * Parameters: data      - [OUT] memory buffer for packed data                *
+ *             stats     - [IN] list of time statistics                       *
+ *             stats_num - [IN] number of time statistics to pack             *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint32_t	zbx_preprocessor_pack_top_time_stats_result(unsigned char **data,
+		const zbx_vector_pp_time_stats_ptr_t *stats, int stats_num)
+{
+	unsigned char	*ptr;
+	zbx_uint32_t	data_len = 0, stat_len = 0;
+
+	if (0 != stats_num)
+	{
+		zbx_serialize_prepare_value(stat_len, stats->values[0]->id);
+		zbx_serialize_prepare_value(stat_len, stats->values[0]->num);
+		zbx_serialize_prepare_value(stat_len, stats->values[0]->time);
+		stat_len += (zbx_uint32_t)sizeof(stats->values[0]->buckets);
+	}
+
+	zbx_serialize_prepare_value(data_len, stats_num);
+	data_len += stat_len * (zbx_uint32_t)stats_num;
+	*data = (unsigned char *)zbx_malloc(NULL, data_len);
+
+	ptr = *data;
+	ptr += zbx_serialize_value(ptr, stats_num);
+
+	for (int i = 0; i < stats_num; i++)
+	{
+		ptr += zbx_serialize_value(ptr, stats->values[i]->id);
+		ptr += zbx_serialize_value(ptr, stats->values[i]->num);
+		ptr += zbx_serialize_value(ptr, stats->values[i]->time);
+
+		for (int j = 0; j < ZBX_PP_TIME_BUCKETS_NUM; j++)
+			ptr += zbx_serialize_value(ptr, stats->values[i]->buckets[j]);
+	}
+
+	return data_len;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: unpack item value data from IPC data buffer                       *
  *                                                                            *
- * Parameters: value - [OUT] unpacked item value                              *
- *             data  - [IN]  IPC data buffer                                  *
+ * Parameters: value  - [OUT] unpacked item value                             *
+ *             ts     - [OUT] storage for value timestamp                     *
+ *             result - [OUT] storage for value result                        *
+ *             data   - [IN]  IPC data buffer                                 *
  *                                                                            *
  * Return value: size of packed data                                          *
  *                                                                            *
+ * Comments: The value timestamp and result are unpacked into the storage     *
+ *           provided by caller to avoid allocations per value.               *
+ *                                                                            *
  ******************************************************************************/
-zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsigned char *data)
+zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, zbx_timespec_t *ts,
+		AGENT_RESULT *result, unsigned char *data)
 {
 	zbx_uint32_t	value_len;
 	zbx_timespec_t	*timespec = NULL;
@@ -619,7 +686,7 @@ zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsi
 
 	if (0 != ts_marker)
 	{
-		timespec = (zbx_timespec_t *)zbx_malloc(NULL, sizeof(zbx_timespec_t));
+		timespec = ts;
 
 		offset += zbx_deserialize_int(offset, &timespec->sec);
 		offset += zbx_deserialize_int(offset, &timespec->ns);
@@ -630,7 +697,7 @@ zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsi
 	offset += zbx_deserialize_char(offset, &result_marker);
 	if (0 != result_marker)
 	{
-		agent_result = (AGENT_RESULT *)zbx_malloc(NULL, sizeof(AGENT_RESULT));
+		agent_result = result;
 
 		offset += zbx_deserialize_uint64(offset, &agent_result->lastlogsize);
 		offset += zbx_deserialize_uint64(offset, &agent_result->ui64);
@@ -790,6 +857,42 @@ void	zbx_preprocessor_unpack_top_sequences_result(zbx_vector_pp_sequence_stats_p
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: unpack top time statistics result data from IPC data buffer       *
+ *                                                                            *
+ * Parameters: stats - [OUT] time statistics                                  *
+ *             data  - [IN] memory buffer for packed data                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_preprocessor_unpack_top_time_stats_result(zbx_vector_pp_time_stats_ptr_t *stats,
+		const unsigned char *data)
+{
+	int	stats_num;
+
+	data += zbx_deserialize_value(data, &stats_num);
+
+	if (0 != stats_num)
+	{
+		zbx_vector_pp_time_stats_ptr_reserve(stats, (size_t)stats_num);
+
+		for (int i = 0; i < stats_num; i++)
+		{
+			zbx_pp_time_stats_t	*stat;
+
+			stat = (zbx_pp_time_stats_t *)zbx_malloc(NULL, sizeof(zbx_pp_time_stats_t));
+			data += zbx_deserialize_value(data, &stat->id);
+			data += zbx_deserialize_value(data, &stat->num);
+			data += zbx_deserialize_value(data, &stat->time);
+
+			for (int j = 0; j < ZBX_PP_TIME_BUCKETS_NUM; j++)
+				data += zbx_deserialize_value(data, &stat->buckets[j]);
+
+			zbx_vector_pp_time_stats_ptr_append(stats, stat);
+		}
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sends command to preprocessor manager                             *
@@ -885,10 +988,10 @@ void	zbx_preprocess_item_value(zbx_uint64_t itemid, zbx_uint64_t hostid, unsigne
 		}
 	}
 
-	if (0 == preprocessor_pack_value(&cached_message, &value))
+	if (0 == preprocessor_pack_value(&cached_message, &cached_alloc, &value))
 	{
 		zbx_preprocessor_flush();
-		preprocessor_pack_value(&cached_message, &value);
+		preprocessor_pack_value(&cached_message, &cached_alloc, &value);
 	}
 
 	if (ZBX_PREPROCESSING_BATCH_SIZE < ++cached_values)
@@ -908,8 +1011,15 @@ void	zbx_preprocessor_flush(void)
 	{
 		preprocessor_send(ZBX_IPC_PREPROCESSOR_REQUEST, cached_message.data, cached_message.size, NULL);
 
-		zbx_ipc_message_clean(&cached_message);
-		zbx_ipc_message_init(&cached_message);
+		if (ZBX_PREPROCESSING_CACHE_ALLOC_MAX < cached_alloc)
+		{
+			zbx_ipc_message_clean(&cached_message);
+			zbx_ipc_message_init(&cached_message);
+			cached_alloc = 0;
+		}
+		else
+			cached_message.size = 0;
+
 		cached_values = 0;
 	}
 }
@@ -972,7 +1082,7 @@ static zbx_uint32_t	preprocessor_pack_test_request(unsigned char **data, unsigne
 		offset += preprocessor_pack_step(offset, steps->values[i]);
 
 	zbx_ipc_message_init(&message);
-	size = message_pack_data(&message, fields, (int)(offset - fields));
+	size = message_pack_data(&message, NULL, fields, (int)(offset - fields));
 	*data = message.data;
 	zbx_free(fields);
 
@@ -1115,6 +1225,54 @@ int	zbx_preprocessor_get_top_sequences(int limit, zbx_vector_pp_sequence_stats_p
 	return preprocessor_get_top_view(limit, sequences, error, ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the top N items or steps by execution time                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	preprocessor_get_top_time_stats(int limit, zbx_vector_pp_time_stats_ptr_t *stats, char **error,
+		zbx_uint32_t code)
+{
+	int		ret;
+	unsigned char	*data, *result;
+	zbx_uint32_t	data_len;
+
+	data_len = zbx_preprocessor_pack_top_sequences_request(&data, limit);
+
+	if (SUCCEED != (ret = zbx_ipc_async_exchange(ZBX_IPC_SERVICE_PREPROCESSING, code, SEC_PER_MIN, data, data_len,
+			&result, error)))
+	{
+		goto out;
+	}
+
+	zbx_preprocessor_unpack_top_time_stats_result(stats, result);
+	zbx_free(result);
+out:
+	zbx_free(data);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the top N items by preprocessing execution time               *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_preprocessor_get_top_items(int limit, zbx_vector_pp_time_stats_ptr_t *items, char **error)
+{
+	return preprocessor_get_top_time_stats(limit, items, error, ZBX_IPC_PREPROCESSOR_TOP_ITEMS);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the top N preprocessing step types by execution time          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_preprocessor_get_top_steps(int limit, zbx_vector_pp_time_stats_ptr_t *steps, char **error)
+{
+	return preprocessor_get_top_time_stats(limit, steps, error, ZBX_IPC_PREPROCESSOR_TOP_STEPS);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get preprocessing manager diagnostic statistics                   *
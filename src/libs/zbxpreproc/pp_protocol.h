@@ -37,6 +37,10 @@
 #define ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES		10007
 #define ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES_RESULT	10008
 #define ZBX_IPC_PREPROCESSOR_USAGE_STATS		10009
+#define ZBX_IPC_PREPROCESSOR_TOP_ITEMS			10010
+#define ZBX_IPC_PREPROCESSOR_TOP_ITEMS_RESULT		10011
+#define ZBX_IPC_PREPROCESSOR_TOP_STEPS			10012
+#define ZBX_IPC_PREPROCESSOR_TOP_STEPS_RESULT		10013
 
 /* item value data used in preprocessing manager */
 typedef struct
@@ -63,7 +67,8 @@ typedef struct
 }
 zbx_packed_field_t;
 
-zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsigned char *data);
+zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, zbx_timespec_t *ts,
+		AGENT_RESULT *result, unsigned char *data);
 
 void	zbx_preprocessor_unpack_test_request(zbx_pp_item_preproc_t *preproc, zbx_variant_t *value, zbx_timespec_t *ts,
 		const unsigned char *data);
@@ -90,6 +95,12 @@ zbx_uint32_t	zbx_preprocessor_pack_top_sequences_result(unsigned char **data,
 void	zbx_preprocessor_unpack_top_sequences_result(zbx_vector_pp_sequence_stats_ptr_t *sequences,
 		const unsigned char *data);
 
+zbx_uint32_t	zbx_preprocessor_pack_top_time_stats_result(unsigned char **data,
+		const zbx_vector_pp_time_stats_ptr_t *stats, int stats_num);
+
+void	zbx_preprocessor_unpack_top_time_stats_result(zbx_vector_pp_time_stats_ptr_t *stats,
+		const unsigned char *data);
+
 zbx_uint32_t	zbx_preprocessor_pack_usage_stats(unsigned char **data, const zbx_vector_dbl_t *usage, int count);
 
 #endif
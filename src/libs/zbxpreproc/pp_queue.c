@@ -25,6 +25,7 @@
 #define PP_TASK_QUEUE_INIT_NONE		0x00
 #define PP_TASK_QUEUE_INIT_LOCK		0x01
 #define PP_TASK_QUEUE_INIT_EVENT	0x02
+#define PP_TASK_QUEUE_INIT_FINISHED	0x04
 
 ZBX_PTR_VECTOR_IMPL(pp_sequence_stats_ptr, zbx_pp_sequence_stats_t *)
 
@@ -75,6 +76,13 @@ int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error)
 	}
 	queue->init_flags |= PP_TASK_QUEUE_INIT_EVENT;
 
+	if (0 != (err = pthread_mutex_init(&queue->finished_lock, NULL)))
+	{
+		*error = zbx_dsprintf(NULL, "cannot initialize finished task queue mutex: %s", zbx_strerror(err));
+		goto out;
+	}
+	queue->init_flags |= PP_TASK_QUEUE_INIT_FINISHED;
+
 	ret = SUCCEED;
 out:
 	if (FAIL == ret)
@@ -109,6 +117,9 @@ void	pp_task_queue_destroy(zbx_pp_queue_t *queue)
 	if (0 != (queue->init_flags & PP_TASK_QUEUE_INIT_EVENT))
 		pthread_cond_destroy(&queue->event);
 
+	if (0 != (queue->init_flags & PP_TASK_QUEUE_INIT_FINISHED))
+		pthread_mutex_destroy(&queue->finished_lock);
+
 	pp_task_queue_clear_tasks(&queue->pending);
 	zbx_list_destroy(&queue->pending);
 
@@ -346,34 +357,63 @@ zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue)
  * Parameters: queue - [IN] task queue                                        *
  *             task  - [IN] task                                              *
  *                                                                            *
+ * Return value: SUCCEED - the finished task queue was empty, manager must be *
+ *                         notified                                           *
+ *               FAIL    - manager has not yet processed the previously       *
+ *                         finished tasks and will process this one with them *
+ *                                                                            *
+ * Comments: This function is used by workers and must be called without      *
+ *           holding task queue lock.                                         *
+ *                                                                            *
  ******************************************************************************/
-void	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
+int	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
 {
+	int	ret;
+
+	pthread_mutex_lock(&queue->finished_lock);
+
+	ret = (0 == queue->finished_num ? SUCCEED : FAIL);
 	queue->finished_num++;
-	queue->processing_num--;
 	(void)zbx_list_append(&queue->finished, task, NULL);
+
+	pthread_mutex_unlock(&queue->finished_lock);
+
+	return ret;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: pop finished task from queue                                      *
+ * Purpose: pop finished tasks from queue                                     *
  *                                                                            *
- * Parameters: queue - [IN] task queue                                        *
+ * Parameters: queue   - [IN] task queue                                      *
+ *             tasks   - [OUT] popped tasks                                   *
+ *             max_num - [IN] maximum number of tasks to pop                  *
+ *                                                                            *
+ * Return value: The number of finished tasks left in queue.                  *
  *                                                                            *
- * Return value: The popped task or NULL if there are no finished tasks.      *
+ * Comments: This function is used by manager and must be called while        *
+ *           holding task queue lock.                                         *
  *                                                                            *
  ******************************************************************************/
-zbx_pp_task_t	*pp_task_queue_pop_finished(zbx_pp_queue_t *queue)
+zbx_uint64_t	pp_task_queue_pop_finished(zbx_pp_queue_t *queue, zbx_vector_pp_task_ptr_t *tasks, int max_num)
 {
 	zbx_pp_task_t	*task;
+	zbx_uint64_t	finished_num;
+	int		tasks_num = tasks->values_num;
 
-	if (SUCCEED == zbx_list_pop(&queue->finished, (void **)&task))
-	{
-		queue->finished_num--;
-		return task;
-	}
+	pthread_mutex_lock(&queue->finished_lock);
 
-	return NULL;
+	while (max_num > tasks->values_num - tasks_num && SUCCEED == zbx_list_pop(&queue->finished, (void **)&task))
+		zbx_vector_pp_task_ptr_append(tasks, task);
+
+	queue->finished_num -= (zbx_uint64_t)(tasks->values_num - tasks_num);
+	finished_num = queue->finished_num;
+
+	pthread_mutex_unlock(&queue->finished_lock);
+
+	queue->processing_num -= (zbx_uint64_t)(tasks->values_num - tasks_num);
+
+	return finished_num;
 }
 
 /******************************************************************************
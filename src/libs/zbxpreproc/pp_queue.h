@@ -39,6 +39,10 @@ typedef struct
 
 	pthread_mutex_t	lock;
 	pthread_cond_t	event;
+
+	/* finished tasks are pushed by workers and popped by manager under separate lock */
+	/* to avoid blocking workers while manager is processing results                 */
+	pthread_mutex_t	finished_lock;
 }
 zbx_pp_queue_t;
 
@@ -60,8 +64,8 @@ void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 
 zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue);
 void	pp_task_queue_push_immediate(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
-void	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
-zbx_pp_task_t	*pp_task_queue_pop_finished(zbx_pp_queue_t *queue);
+int	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
+zbx_uint64_t	pp_task_queue_pop_finished(zbx_pp_queue_t *queue, zbx_vector_pp_task_ptr_t *tasks, int max_num);
 
 void	pp_task_queue_get_sequence_stats(zbx_pp_queue_t *queue, zbx_vector_pp_sequence_stats_ptr_t *stats);
 
@@ -133,6 +133,7 @@ zbx_pp_task_t	*pp_task_value_create(zbx_uint64_t itemid, zbx_pp_item_preproc_t *
 	zbx_variant_set_none(&d->result);
 	d->cache = pp_cache_copy(cache);
 	d->ts = ts;
+	d->time = 0;
 	if (NULL != value_opt)
 		d->opt = *value_opt;
 	else
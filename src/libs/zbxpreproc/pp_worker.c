@@ -53,8 +53,11 @@ static void	pp_task_process_test(zbx_pp_context_t *ctx, zbx_pp_task_t *task, con
 static void	pp_task_process_value(zbx_pp_context_t *ctx, zbx_pp_task_t *task, const char *config_source_ip)
 {
 	zbx_pp_task_value_t	*d = (zbx_pp_task_value_t *)PP_TASK_DATA(task);
+	double			time_start;
 
+	time_start = zbx_time();
 	pp_execute(ctx, d->preproc, d->cache, d->um_handle, &d->value, d->ts, config_source_ip, &d->result, NULL, NULL);
+	d->time = zbx_time() - time_start;
 }
 
 /******************************************************************************
@@ -66,9 +69,12 @@ static void	pp_task_process_dependent(zbx_pp_context_t *ctx, zbx_pp_task_t *task
 {
 	zbx_pp_task_dependent_t	*d = (zbx_pp_task_dependent_t *)PP_TASK_DATA(task);
 	zbx_pp_task_value_t	*d_first = (zbx_pp_task_value_t *)PP_TASK_DATA(d->primary);
+	double			time_start;
 
+	time_start = zbx_time();
 	pp_execute(ctx, d_first->preproc, d->cache, d_first->um_handle, &d_first->value, d_first->ts, config_source_ip,
 			&d_first->result, NULL, NULL);
+	d_first->time = zbx_time() - time_start;
 }
 
 /******************************************************************************
@@ -168,12 +174,14 @@ static void	*pp_worker_entry(void *args)
 
 			zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_IDLE);
 
-			pp_task_queue_lock(queue);
-			pp_task_queue_push_finished(queue, in);
-
-			if (NULL != worker->finished_cb)
+			/* manager keeps processing finished tasks until the queue is empty, */
+			/* so it must be notified only about the first finished task          */
+			if (SUCCEED == pp_task_queue_push_finished(queue, in) && NULL != worker->finished_cb)
 				worker->finished_cb(worker->finished_data);
 
+			pp_task_queue_lock(queue);
+			pp_context_flush_steps_stats(&worker->execute_ctx, worker->steps_stats);
+
 			continue;
 		}
 
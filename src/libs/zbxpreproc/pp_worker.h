@@ -38,6 +38,9 @@ typedef struct
 
 	zbx_pp_context_t		execute_ctx;
 
+	/* step execution time statistics, protected by task queue lock */
+	zbx_pp_time_stats_t		steps_stats[PP_STEP_TYPES_NUM];
+
 	zbx_timekeeper_t		*timekeeper;
 
 	zbx_pp_notify_cb_t		finished_cb;
@@ -2,16 +2,32 @@
 #include "zbxalgo.h"
 #include "zbxtime.h"
 
+#include <math.h>
+
 #define PROF_LEVEL_MAX	10
 
+/* latency histogram with power of two microsecond buckets: <1us, <2us, <4us, ... >=2^(N-2)us */
+#define PROF_HIST_BUCKETS	26
+
+typedef struct
+{
+	unsigned int	bucket[PROF_HIST_BUCKETS];
+	double		max;
+}
+zbx_prof_hist_t;
+
 typedef struct
 {
 	const char		*func_name;
 	double			start;
 	double			sec;
 	double			sec_wait;
+	double			last_wait;
 	unsigned int		locked;
+	unsigned int		contended;
 	zbx_prof_scope_t	scope;
+	zbx_prof_hist_t		hist_busy;
+	zbx_prof_hist_t		hist_wait;
 }
 zbx_func_profile_t;
 
@@ -52,6 +68,58 @@ static void	func_profile_free(zbx_func_profile_t *func_profile)
 	zbx_free(func_profile);
 }
 
+static void	prof_hist_add(zbx_prof_hist_t *hist, double sec)
+{
+	int	exp = 0;
+
+	if (sec > hist->max)
+		hist->max = sec;
+
+	/* usec = m * 2^exp, where 0.5 <= m < 1, so values below 1us get exp <= 0 */
+	(void)frexp(sec * 1000000, &exp);
+
+	if (0 > exp)
+		exp = 0;
+	else if (PROF_HIST_BUCKETS <= exp)
+		exp = PROF_HIST_BUCKETS - 1;
+
+	hist->bucket[exp]++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: estimate percentile from latency histogram                        *
+ *                                                                            *
+ * Parameters: hist  - [IN] the histogram                                     *
+ *             count - [IN] the number of recorded values                     *
+ *             pct   - [IN] the percentile                                    *
+ *                                                                            *
+ * Return value: upper bound of the bucket containing the percentile, in      *
+ *               seconds, limited by the maximum recorded value               *
+ *                                                                            *
+ ******************************************************************************/
+static double	prof_hist_percentile(const zbx_prof_hist_t *hist, unsigned int count, double pct)
+{
+	unsigned int	total = 0;
+	double		threshold = ceil((double)count * pct / 100);
+
+	for (int i = 0; i < PROF_HIST_BUCKETS - 1; i++)
+	{
+		if ((double)(total += hist->bucket[i]) >= threshold)
+			return MIN(ldexp(1, i) / 1000000, hist->max);
+	}
+
+	return hist->max;
+}
+
+static void	prof_hist_print(char **str, size_t *str_alloc, size_t *str_offset, const char *name,
+		const zbx_prof_hist_t *hist, unsigned int count)
+{
+	zbx_snprintf_alloc(str, str_alloc, str_offset, " %s p50:" ZBX_FS_DBL " p99:" ZBX_FS_DBL " max:" ZBX_FS_DBL,
+			name, prof_hist_percentile(hist, count, 50), prof_hist_percentile(hist, count, 99),
+			hist->max);
+}
+
 void	zbx_prof_start(const char *func_name, zbx_prof_scope_t scope)
 {
 	if (0 != zbx_prof_scope)
@@ -63,10 +131,8 @@ void	zbx_prof_start(const char *func_name, zbx_prof_scope_t scope)
 				compare_func_profile)))
 		{
 			func_profile = zbx_malloc(NULL, sizeof(zbx_func_profile_t));
+			memset(func_profile, 0, sizeof(zbx_func_profile_t));
 			func_profile->func_name = func_name;
-			func_profile->sec = 0;
-			func_profile->locked = 0;
-			func_profile->sec_wait = 0;
 			func_profile->scope = scope;
 
 			zbx_vector_func_profiles_append(&zbx_func_profiles, func_profile);
@@ -76,6 +142,7 @@ void	zbx_prof_start(const char *func_name, zbx_prof_scope_t scope)
 			func_profile = zbx_func_profiles.values[i];
 
 		func_profile->locked++;
+		func_profile->last_wait = 0;
 		func_profile->start = zbx_time();
 
 		zbx_func_profile[zbx_func_profile_level] = func_profile;
@@ -91,18 +158,39 @@ void	zbx_prof_end_wait(void)
 
 		func_profile = zbx_func_profile[zbx_func_profile_level - 1];
 
-		func_profile->sec_wait += zbx_time() - func_profile->start;
+		func_profile->last_wait = zbx_time() - func_profile->start;
+		func_profile->sec_wait += func_profile->last_wait;
+		prof_hist_add(&func_profile->hist_wait, func_profile->last_wait);
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: count lock acquisition that had to wait for other owner           *
+ *                                                                            *
+ * Comments: Called by lock functions between zbx_prof_start() and            *
+ *           zbx_prof_end_wait() when the lock was not immediately available. *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_prof_contended(void)
+{
+	if (0 != zbx_prof_scope && 0 != zbx_func_profile_level)
+		zbx_func_profile[zbx_func_profile_level - 1]->contended++;
+}
+
 void	zbx_prof_end(void)
 {
 	if (0 != zbx_prof_scope)
 	{
 		zbx_func_profile_t	*func_profile;
+		double			sec;
 
 		func_profile = zbx_func_profile[zbx_func_profile_level - 1];
-		func_profile->sec += zbx_time() - func_profile->start;
+		sec = zbx_time() - func_profile->start;
+		func_profile->sec += sec;
+
+		/* for locks the busy histogram tracks holding time */
+		prof_hist_add(&func_profile->hist_busy, sec - func_profile->last_wait);
 		zbx_func_profile_level--;
 	}
 }
@@ -131,7 +219,8 @@ static void	zbx_print_prof(const char *info)
 		size_t			str_offset = 0;
 		double			total_wait_lock = 0, total_busy_lock = 0, total_mutex_wait_lock = 0,
 					total_mutex_busy_lock = 0;
-		unsigned int		total_locked_mutex = 0, total_locked_rwlock = 0;
+		unsigned int		total_locked_mutex = 0, total_locked_rwlock = 0, total_contended_mutex = 0,
+					total_contended_rwlock = 0;
 
 		for (i = 0; i < zbx_func_profiles.values_num; i++)
 		{
@@ -144,26 +233,34 @@ static void	zbx_print_prof(const char *info)
 			{
 				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\n%s() processing : busy:" ZBX_FS_DBL
 						" sec", func_profile->func_name, func_profile->sec);
+				prof_hist_print(&str, &str_alloc, &str_offset, "busy", &func_profile->hist_busy,
+						func_profile->locked);
 			}
 			else
 			{
-				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\n%s() %s : locked:%u holding:"
-						ZBX_FS_DBL " sec waiting:"ZBX_FS_DBL " sec",
+				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\n%s() %s : locked:%u contended:%u"
+						" holding:" ZBX_FS_DBL " sec waiting:"ZBX_FS_DBL " sec",
 						func_profile->func_name, get_scope_string(func_profile->scope),
-						func_profile->locked, func_profile->sec - func_profile->sec_wait,
-						func_profile->sec_wait);
+						func_profile->locked, func_profile->contended,
+						func_profile->sec - func_profile->sec_wait, func_profile->sec_wait);
+				prof_hist_print(&str, &str_alloc, &str_offset, "holding", &func_profile->hist_busy,
+						func_profile->locked);
+				prof_hist_print(&str, &str_alloc, &str_offset, "waiting", &func_profile->hist_wait,
+						func_profile->locked);
 
 				if (ZBX_PROF_RWLOCK == func_profile->scope)
 				{
 					total_wait_lock += func_profile->sec_wait;
 					total_busy_lock += func_profile->sec - func_profile->sec_wait;
 					total_locked_rwlock += func_profile->locked;
+					total_contended_rwlock += func_profile->contended;
 				}
 				else
 				{
 					total_mutex_wait_lock += func_profile->sec_wait;
 					total_mutex_busy_lock += func_profile->sec - func_profile->sec_wait;
 					total_locked_mutex += func_profile->locked;
+					total_contended_mutex += func_profile->contended;
 				}
 			}
 		}
@@ -172,22 +269,23 @@ static void	zbx_print_prof(const char *info)
 		{
 			if (0 != (ZBX_PROF_RWLOCK & zbx_prof_scope))
 			{
-				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\nrwlocks : locked:%u holding:"
-						ZBX_FS_DBL " sec waiting:" ZBX_FS_DBL " sec", total_locked_rwlock,
-						total_busy_lock, total_wait_lock);
+				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\nrwlocks : locked:%u contended:%u"
+						" holding:" ZBX_FS_DBL " sec waiting:" ZBX_FS_DBL " sec", total_locked_rwlock,
+						total_contended_rwlock, total_busy_lock, total_wait_lock);
 			}
 			if (0 != (ZBX_PROF_MUTEX & zbx_prof_scope))
 			{
-				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\nmutexes : locked:%u holding:"
-						ZBX_FS_DBL " sec waiting:" ZBX_FS_DBL " sec", total_locked_mutex,
-						total_mutex_busy_lock, total_mutex_wait_lock);
+				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\nmutexes : locked:%u contended:%u"
+						" holding:" ZBX_FS_DBL " sec waiting:" ZBX_FS_DBL " sec", total_locked_mutex,
+						total_contended_mutex, total_mutex_busy_lock, total_mutex_wait_lock);
 			}
 
 			if (ZBX_PROF_ALL == zbx_prof_scope)
 			{
-				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\nlocking total : locked:%u holding:"
-						ZBX_FS_DBL " sec waiting:" ZBX_FS_DBL " sec",
+				zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "\nlocking total : locked:%u contended:%u"
+						" holding:" ZBX_FS_DBL " sec waiting:" ZBX_FS_DBL " sec",
 						total_locked_rwlock + total_locked_mutex,
+						total_contended_rwlock + total_contended_mutex,
 						total_busy_lock + total_mutex_busy_lock,
 						total_wait_lock + total_mutex_wait_lock);
 			}
@@ -860,6 +860,41 @@ static int	condition_match_key_value(const zbx_prometheus_condition_t *condition
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: matches metric name in data against filter condition without      *
+ *          copying it                                                        *
+ *                                                                            *
+ * Parameters: condition - [IN] the metric condition                          *
+ *             data      - [IN] the prometheus data                           *
+ *             loc       - [IN] the metric name location in data              *
+ *                                                                            *
+ * Return value: SUCCEED - the metric name matches condition or the condition *
+ *                         must be checked on the copied name                 *
+ *               FAIL    - the metric name does not match condition           *
+ *                                                                            *
+ ******************************************************************************/
+static int	condition_prematch_metric(const zbx_prometheus_condition_t *condition, const char *data,
+		const zbx_strloc_t *loc)
+{
+	switch (condition->op)
+	{
+		case ZBX_PROMETHEUS_CONDITION_OP_EQUAL:
+		case ZBX_PROMETHEUS_CONDITION_OP_EQUAL_VALUE:
+			if (0 != str_loc_cmp(data, loc, condition->pattern, strlen(condition->pattern)))
+				return FAIL;
+			break;
+		case ZBX_PROMETHEUS_CONDITION_OP_NOT_EQUAL:
+			if (0 == str_loc_cmp(data, loc, condition->pattern, strlen(condition->pattern)))
+				return FAIL;
+			break;
+		default:
+			break;
+	}
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: matches metric value against filter condition                     *
@@ -984,15 +1019,11 @@ static int	prometheus_parse_row(zbx_prometheus_filter_t *filter, const char *dat
 		zbx_prometheus_row_t **prow, zbx_strloc_t *loc_row, char **error)
 {
 	zbx_strloc_t		loc;
-	zbx_prometheus_row_t	*row;
+	zbx_prometheus_row_t	*row = NULL;
 	int			ret = FAIL, match = SUCCEED, i, j;
 
 	loc_row->l = pos;
 
-	row = (zbx_prometheus_row_t *)zbx_malloc(NULL, sizeof(zbx_prometheus_row_t));
-	memset(row, 0, sizeof(zbx_prometheus_row_t));
-	zbx_vector_prometheus_label_create(&row->labels);
-
 	/* parse metric and check against the filter */
 
 	if (SUCCEED != parse_metric(data, pos, &loc))
@@ -1001,6 +1032,14 @@ static int	prometheus_parse_row(zbx_prometheus_filter_t *filter, const char *dat
 		goto out;
 	}
 
+	/* skip rows of other metrics before allocating anything for them */
+	if (NULL != filter->metric && FAIL == (match = condition_prematch_metric(filter->metric, data, &loc)))
+		goto out;
+
+	row = (zbx_prometheus_row_t *)zbx_malloc(NULL, sizeof(zbx_prometheus_row_t));
+	memset(row, 0, sizeof(zbx_prometheus_row_t));
+	zbx_vector_prometheus_label_create(&row->labels);
+
 	row->metric = str_loc_dup(data, &loc);
 
 	if (NULL != filter->metric)
@@ -1084,7 +1123,8 @@ static int	prometheus_parse_row(zbx_prometheus_filter_t *filter, const char *dat
 out:
 	if (FAIL == ret)
 	{
-		prometheus_row_free(row);
+		if (NULL != row)
+			prometheus_row_free(row);
 		*prow = NULL;
 
 		/* match failure, return success with NULL row */
@@ -1757,32 +1797,18 @@ static void	prometheus_unlock(zbx_prometheus_t *prom)
  *                                                                            *
  ******************************************************************************/
 
+/* must be called with prometheus cache locked */
 static	zbx_prometheus_label_index_t	*prometheus_get_index(zbx_prometheus_t *prom, const char *label)
 {
-	int				i;
-	zbx_prometheus_label_index_t	*label_index = NULL;
-
-	prometheus_lock(prom);
+	int	i;
 
 	for (i = 0; i < prom->indexes.values_num; i++)
 	{
 		if (0 == strcmp(prom->indexes.values[i]->label, label))
-		{
-			label_index = prom->indexes.values[i];
-			break;
-		}
+			return prom->indexes.values[i];
 	}
 
-	prometheus_unlock(prom);
-
-	return label_index;
-}
-
-static void	prometheus_add_index(zbx_prometheus_t *prom, zbx_prometheus_label_index_t *index)
-{
-	prometheus_lock(prom);
-	zbx_vector_prometheus_label_index_append(&prom->indexes, index);
-	prometheus_unlock(prom);
+	return NULL;
 }
 
 static zbx_hash_t	prometheus_index_hash_func(const void *d)
@@ -1841,7 +1867,8 @@ static zbx_prometheus_label_t	*prometheus_get_row_label(zbx_prometheus_row_t *ro
  *                                                                            *
  * Comments: The rows are indexed by first filter 'label equals' condition.   *
  *           The index is created automatically when rows for unindexed       *
- *           label are requested.                                             *
+ *           label are requested. Created indexes are not modified, so they   *
+ *           are searched without locking.                                    *
  *                                                                            *
  ******************************************************************************/
 static int	prometheus_get_indexed_rows_by_label(zbx_prometheus_t *prom, zbx_prometheus_filter_t *filter,
@@ -1863,6 +1890,10 @@ static int	prometheus_get_indexed_rows_by_label(zbx_prometheus_t *prom, zbx_prom
 	if (i == filter->labels.values_num)
 		return FAIL;
 
+	/* keep the cache locked while building index, so that workers querying the same */
+	/* data concurrently wait for the index instead of each building its own copy   */
+	prometheus_lock(prom);
+
 	if (NULL == (label_index = prometheus_get_index(prom, condition->key)))
 	{
 		label_index = (zbx_prometheus_label_index_t *)zbx_malloc(NULL, sizeof(zbx_prometheus_label_index_t));
@@ -1891,9 +1922,11 @@ static int	prometheus_get_indexed_rows_by_label(zbx_prometheus_t *prom, zbx_prom
 			zbx_vector_prometheus_row_append(&index->rows, row);
 		}
 
-		prometheus_add_index(prom, label_index);
+		zbx_vector_prometheus_label_index_append(&prom->indexes, label_index);
 	}
 
+	prometheus_unlock(prom);
+
 	index_local.value = condition->pattern;
 
 	if (NULL != (index = (zbx_prometheus_index_t *)zbx_hashset_search(&label_index->index, &index_local)))
@@ -25,6 +25,10 @@
 #include "zbxdbhigh.h"
 #include "zbx_item_constants.h"
 #include "zbx_host_constants.h"
+#include "zbxcompress.h"
+
+/* minimum length of history value to be compressed in proxy memory buffer */
+#define PB_HISTORY_COMPRESS_MIN	256
 
 static void	pb_history_add_rows_db(zbx_list_t *rows, zbx_list_item_t *next, zbx_uint64_t *lastid);
 
@@ -51,18 +55,91 @@ void	pb_list_free_history(zbx_list_t *list, zbx_pb_history_t *row)
  * Purpose: estimate approximate history row size in cache                    *
  *                                                                            *
  ******************************************************************************/
-size_t	pb_history_estimate_row_size(const char *value, const char *source)
+size_t	pb_history_estimate_row_size(const zbx_pb_history_t *row)
 {
 	size_t	size = 0;
 
 	size += zbx_shmem_required_chunk_size(sizeof(zbx_pb_history_t));
 	size += zbx_shmem_required_chunk_size(sizeof(zbx_list_item_t));
-	size += zbx_shmem_required_chunk_size(strlen(value) + 1);
-	size += zbx_shmem_required_chunk_size(strlen(source) + 1);
+	size += zbx_shmem_required_chunk_size(0 != row->value_size ? row->value_size : strlen(row->value) + 1);
+	size += zbx_shmem_required_chunk_size(strlen(row->source) + 1);
 
 	return size;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress history value to be stored in memory cache               *
+ *                                                                            *
+ * Parameters: row   - [IN/OUT] history row                                   *
+ *             value - [IN] history value                                     *
+ *                                                                            *
+ * Comments: Values that are too short or do not compress well are stored     *
+ *           as is.                                                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	pb_history_set_value(zbx_pb_history_t *row, const char *value)
+{
+	char	*buf;
+	size_t	len, size;
+
+	row->value_size = 0;
+
+	if (0 != pb_data->compress && PB_HISTORY_COMPRESS_MIN <= (len = strlen(value)) &&
+			SUCCEED == zbx_compress(value, len, &buf, &size))
+	{
+		if (size < len)
+		{
+			row->value = buf;
+			row->value_len = len;
+			row->value_size = size;
+			return;
+		}
+
+		zbx_free(buf);
+	}
+
+	row->value = zbx_strdup(NULL, value);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get history row value, uncompressing it if necessary              *
+ *                                                                            *
+ * Parameters: row       - [IN] history row                                   *
+ *             buf       - [IN/OUT] buffer for uncompressed value             *
+ *             buf_alloc - [IN/OUT] buffer size                               *
+ *                                                                            *
+ * Return value: The history value.                                           *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*pb_history_get_value(const zbx_pb_history_t *row, char **buf, size_t *buf_alloc)
+{
+	size_t	size;
+
+	if (0 == row->value_size)
+		return row->value;
+
+	if (*buf_alloc <= row->value_len)
+	{
+		*buf_alloc = row->value_len + 1;
+		*buf = (char *)zbx_realloc(*buf, *buf_alloc);
+	}
+
+	size = row->value_len;
+
+	if (SUCCEED != zbx_uncompress(row->value, row->value_size, *buf, &size))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot uncompress history value of item " ZBX_FS_UI64
+				" in proxy memory buffer: %s", row->itemid, zbx_compress_strerror());
+		size = 0;
+	}
+
+	(*buf)[size] = '\0';
+
+	return *buf;
+}
+
 static void	pb_history_free(zbx_pb_history_t *row)
 {
 	if (0 == (row->flags & ZBX_PROXY_HISTORY_FLAG_NOVALUE))
@@ -94,10 +171,11 @@ static void	pb_history_add_value(zbx_pb_history_data_t *data, zbx_uint64_t itemi
 		row->timestamp = timestamp;
 		row->logeventid = logeventid;
 		row->severity = severity;
-		row->value = zbx_strdup(NULL, value);
 		row->source = zbx_strdup(NULL, source);
 		row->write_clock = now;
 
+		pb_history_set_value(row, value);
+
 		zbx_list_append(&data->rows, row, NULL);
 		data->rows_num++;
 	}
@@ -173,6 +251,7 @@ try_again:
 
 		hist = (zbx_pb_history_t *)zbx_malloc(NULL, sizeof(zbx_pb_history_t));
 		hist->id = id;
+		hist->value_size = 0;
 		ZBX_STR2UINT64(hist->itemid, row[1]);
 		ZBX_STR2UCHAR(hist->flags, row[12]);
 		hist->ts.sec = atoi(row[2]);
@@ -226,12 +305,13 @@ try_again:
 static int	pb_history_export(struct zbx_json *j, int records_num, const zbx_vector_pb_history_ptr_t *rows,
 		zbx_uint64_t *lastid)
 {
-	int				i, *errcodes;
+	int				i, *errcodes, *queued;
+	char				*buf = NULL;
+	size_t				buf_alloc = 0;
 	zbx_pb_history_t		*row;
 	zbx_vector_pb_history_ptr_t	records;
 	zbx_vector_uint64_t		itemids;
 	zbx_hashset_t			nodata_itemids;
-	zbx_dc_item_t			*dc_items;
 
 	zbx_vector_pb_history_ptr_create(&records);
 	zbx_vector_pb_history_ptr_reserve(&records, (size_t)rows->values_num);
@@ -255,10 +335,10 @@ static int	pb_history_export(struct zbx_json *j, int records_num, const zbx_vect
 		zbx_vector_uint64_append(&itemids, rows->values[i]->itemid);
 	}
 
-	dc_items = (zbx_dc_item_t *)zbx_malloc(NULL, (size_t)records.values_num * sizeof(zbx_dc_item_t));
 	errcodes = (int *)zbx_malloc(NULL, (size_t)records.values_num * sizeof(int));
+	queued = (int *)zbx_malloc(NULL, (size_t)records.values_num * sizeof(int));
 
-	zbx_dc_config_get_items_by_itemids(dc_items, itemids.values, errcodes, (size_t)itemids.values_num);
+	zbx_dc_config_get_items_monitored_status(itemids.values, errcodes, queued, (size_t)itemids.values_num);
 
 	for (i = records.values_num - 1; i >= 0; i--)
 	{
@@ -268,16 +348,10 @@ static int	pb_history_export(struct zbx_json *j, int records_num, const zbx_vect
 		if (SUCCEED != errcodes[i])
 			continue;
 
-		if (ITEM_STATUS_ACTIVE != dc_items[i].status)
-			continue;
-
-		if (HOST_STATUS_MONITORED != dc_items[i].host.status)
-			continue;
-
-		if (ZBX_PROXY_HISTORY_FLAG_NOVALUE == (row->flags & ZBX_PROXY_HISTORY_MASK_NOVALUE))
+		if (ZBX_PROXY_HISTORY_FLAG_NOVALUE == (row->flags & ZBX_PROXY_HISTORY_MASK_NOVALUE) &&
+				SUCCEED != queued[i])
 		{
-			if (SUCCEED != zbx_is_counted_in_item_queue(dc_items[i].type, dc_items[i].key_orig))
-				continue;
+			continue;
 		}
 
 		if (0 == records_num)
@@ -311,7 +385,8 @@ static int	pb_history_export(struct zbx_json *j, int records_num, const zbx_vect
 				if (0 != row->logeventid)
 					zbx_json_addint64(j, ZBX_PROTO_TAG_LOGEVENTID, row->logeventid);
 
-				zbx_json_addstring(j, ZBX_PROTO_TAG_VALUE, row->value, ZBX_JSON_TYPE_STRING);
+				zbx_json_addstring(j, ZBX_PROTO_TAG_VALUE, pb_history_get_value(row, &buf, &buf_alloc),
+						ZBX_JSON_TYPE_STRING);
 			}
 
 			if (0 != (row->flags & ZBX_PROXY_HISTORY_FLAG_META))
@@ -329,9 +404,9 @@ static int	pb_history_export(struct zbx_json *j, int records_num, const zbx_vect
 			break;
 	}
 
-	zbx_dc_config_clean_items(dc_items, errcodes, (size_t)itemids.values_num);
+	zbx_free(buf);
+	zbx_free(queued);
 	zbx_free(errcodes);
-	zbx_free(dc_items);
 
 	zbx_hashset_destroy(&nodata_itemids);
 	zbx_vector_uint64_destroy(&itemids);
@@ -453,14 +528,22 @@ static int	pb_history_add_row_mem(zbx_pb_t *pb, zbx_pb_history_t *src)
 	int			ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_TRACE, "In %s() free:" ZBX_FS_SIZE_T " request:" ZBX_FS_SIZE_T, __func__,
-			pb_get_free_size(), pb_history_estimate_row_size(src->value, src->source));
+			pb_get_free_size(), pb_history_estimate_row_size(src));
 
 	if (NULL == (row = (zbx_pb_history_t *)pb_malloc(sizeof(zbx_pb_history_t))))
 		goto out;
 
 	memcpy(row, src, sizeof(zbx_pb_history_t));
 
-	if (NULL == (row->value = pb_strdup(src->value)))
+	if (0 != src->value_size)
+	{
+		if (NULL != (row->value = (char *)pb_malloc(src->value_size)))
+			memcpy(row->value, src->value, src->value_size);
+	}
+	else
+		row->value = pb_strdup(src->value);
+
+	if (NULL == row->value)
 	{
 		row->source = NULL;
 		goto out;
@@ -538,7 +621,7 @@ static zbx_list_item_t	*pb_history_add_rows_mem(zbx_pb_t *pb, zbx_list_t *rows)
 			/* one can be written in proxy memory buffer            */
 
 			if (0 == size)
-				size = pb_history_estimate_row_size(row->value, row->source);
+				size = pb_history_estimate_row_size(row);
 
 			if (FAIL == pb_free_space(pb_data, size))
 			{
@@ -570,6 +653,8 @@ static void	pb_history_add_rows_db(zbx_list_t *rows, zbx_list_item_t *next, zbx_
 	zbx_list_iterator_t	li;
 	zbx_pb_history_t	*row;
 	int			rows_num = 0;
+	char			*buf = NULL;
+	size_t			buf_alloc = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() next:%p", __func__, next);
 
@@ -584,7 +669,8 @@ static void	pb_history_add_rows_db(zbx_list_t *rows, zbx_list_item_t *next, zbx_
 		{
 			(void)zbx_list_iterator_peek(&li, (void **)&row);
 			zbx_db_insert_add_values(&db_insert, row->id, row->itemid, row->ts.sec, row->timestamp,
-					row->source, row->severity, row->value, row->logeventid, row->ts.ns, row->state,
+					row->source, row->severity, pb_history_get_value(row, &buf, &buf_alloc),
+					row->logeventid, row->ts.ns, row->state,
 					row->lastlogsize, row->mtime, row->flags, (int)row->write_clock);
 			rows_num++;
 			*lastid = row->id;
@@ -593,6 +679,7 @@ static void	pb_history_add_rows_db(zbx_list_t *rows, zbx_list_item_t *next, zbx_
 
 		(void)zbx_db_insert_execute(&db_insert);
 		zbx_db_insert_clean(&db_insert);
+		zbx_free(buf);
 	}
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() rows_num:%d", __func__, rows_num);
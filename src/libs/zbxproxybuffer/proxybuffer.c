@@ -156,7 +156,7 @@ int	pb_free_space(zbx_pb_t *pb, size_t size)
 					" id:" ZBX_FS_UI64 " clock:%d", __func__, hrow->id, hrow->ts.sec);
 
 			zbx_list_pop(&pb->history, NULL);
-			size_left -= (ssize_t)pb_history_estimate_row_size(hrow->value, hrow->source);
+			size_left -= (ssize_t)pb_history_estimate_row_size(hrow);
 			pb_list_free_history(&pb->history, hrow);
 			continue;
 		}
@@ -440,10 +440,13 @@ void	pb_set_lastid(const char *table_name, const char *lastidfield, const zbx_ui
 	{
 		zbx_db_execute("delete from ids where table_name='%s' and field_name='%s'", table_name, lastidfield);
 	}
-	else
+	else if (ZBX_DB_OK == zbx_db_execute("update ids set nextid=" ZBX_FS_UI64 " where table_name='%s'"
+			" and field_name='%s'", lastid, table_name, lastidfield))
 	{
 		zbx_db_result_t	result;
 
+		/* nothing was updated - either the record does not exist yet or */
+		/* (with MySQL) its value was not changed                         */
 		result = zbx_db_select("select 1 from ids where table_name='%s' and field_name='%s'",
 				table_name, lastidfield);
 
@@ -452,11 +455,6 @@ void	pb_set_lastid(const char *table_name, const char *lastidfield, const zbx_ui
 			zbx_db_execute("insert into ids (table_name,field_name,nextid) values ('%s','%s'," ZBX_FS_UI64
 					")", table_name, lastidfield, lastid);
 		}
-		else
-		{
-			zbx_db_execute("update ids set nextid=" ZBX_FS_UI64 " where table_name='%s' and field_name='%s'",
-					lastid, table_name, lastidfield);
-		}
 		zbx_db_free_result(result);
 	}
 
@@ -660,15 +658,17 @@ void	pb_wait_handles(const zbx_vector_uint64_t *handleids)
  *                                                                            *
  * Purpose: initialize proxy  buffer                                          *
  *                                                                            *
- * Return value: size  - [IN] the cache size in bytes                         *
- *               age   - [IN] the maximum allowed data age                    *
- *               error - [OUT] error message                                  *
+ * Return value: size     - [IN] the cache size in bytes                      *
+ *               age      - [IN] the maximum allowed data age                 *
+ *               compress - [IN] 1 - compress large history values in memory  *
+ *                               0 - store history values as is               *
+ *               error    - [OUT] error message                               *
  *                                                                            *
  * Return value: SUCCEED - cache was initialized successfully                 *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-int	zbx_pb_init(int mode, zbx_uint64_t size, int age, int offline_buffer, char **error)
+int	zbx_pb_init(int mode, zbx_uint64_t size, int age, int offline_buffer, int compress, char **error)
 {
 	int	ret = FAIL, allow_oom;
 
@@ -708,6 +708,7 @@ int	zbx_pb_init(int mode, zbx_uint64_t size, int age, int offline_buffer, char *
 	pb_data->mode = mode;
 	pb_data->max_age = age;
 	pb_data->offline_buffer = offline_buffer;
+	pb_data->compress = compress;
 
 	pb_init_state(pb_data);
 
@@ -71,6 +71,8 @@ typedef struct
 	zbx_uint64_t	lastlogsize;
 	zbx_timespec_t	ts;		/* clock + ns */
 	char		*value;
+	size_t		value_len;	/* uncompressed value length */
+	size_t		value_size;	/* compressed value size, 0 if value is not compressed */
 	char		*source;
 	int		timestamp;
 	int		severity;
@@ -109,6 +111,7 @@ typedef struct
 	int			db_handles_num;		/* number of pending database inserts */
 	int			max_age;
 	int			offline_buffer;
+	int			compress;		/* compress large history values */
 	zbx_uint64_t		changes_num;
 	zbx_mutex_t		mutex;
 
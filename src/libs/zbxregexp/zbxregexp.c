@@ -258,40 +258,136 @@ int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags
 	return regexp_compile(pattern, flags, regexp, err_msg);
 }
 
+#define REGEXP_CACHE_MAX	1000
+
+typedef struct
+{
+	char		*pattern;
+	int		flags;
+	zbx_regexp_t	*regexp;
+}
+zbx_regexp_cache_t;
+
+static zbx_hash_t	regexp_cache_hash(const void *d)
+{
+	const zbx_regexp_cache_t	*rc = (const zbx_regexp_cache_t *)d;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_STRING_HASH_FUNC(rc->pattern);
+
+	return ZBX_DEFAULT_HASH_ALGO(&rc->flags, sizeof(rc->flags), hash);
+}
+
+static int	regexp_cache_compare(const void *d1, const void *d2)
+{
+	const zbx_regexp_cache_t	*rc1 = (const zbx_regexp_cache_t *)d1;
+	const zbx_regexp_cache_t	*rc2 = (const zbx_regexp_cache_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(rc1->flags, rc2->flags);
+
+	return strcmp(rc1->pattern, rc2->pattern);
+}
+
+static void	regexp_cache_clear(void *d)
+{
+	zbx_regexp_cache_t	*rc = (zbx_regexp_cache_t *)d;
+
+	zbx_free(rc->pattern);
+	zbx_regexp_free(rc->regexp);
+}
+
 /****************************************************************************************************
  *                                                                                                  *
- * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the last used regexp.                 *
+ * Purpose: wrapper for zbx_regexp_compile. Caches and reuses compiled regexps.                     *
+ *                                                                                                  *
+ * Comments: Log and trap filters alternate between the expressions of a global regular expression  *
+ *           for every line, so more than the last used regexp is cached per thread. The cache is   *
+ *           reset when its size limit is reached, so the returned regexp is valid only until the   *
+ *           next call.                                                                             *
  *                                                                                                  *
  ****************************************************************************************************/
 static int	regexp_prepare(const char *pattern, int flags, zbx_regexp_t **regexp, char **err_msg)
 {
-	static ZBX_THREAD_LOCAL zbx_regexp_t	*curr_regexp = NULL;
-	static ZBX_THREAD_LOCAL char		*curr_pattern = NULL;
-	static ZBX_THREAD_LOCAL int		curr_flags = 0;
-	int					ret = SUCCEED;
+	static ZBX_THREAD_LOCAL zbx_hashset_t	*cache = NULL;
+	zbx_regexp_cache_t			rc_local, *rc;
 
-	if (NULL == curr_regexp || 0 != strcmp(curr_pattern, pattern) || curr_flags != flags)
+	if (NULL == cache)
 	{
-		if (NULL != curr_regexp)
-		{
-			zbx_regexp_free(curr_regexp);
-			zbx_free(curr_pattern);
-		}
+		cache = (zbx_hashset_t *)zbx_malloc(NULL, sizeof(zbx_hashset_t));
+		zbx_hashset_create_ext(cache, 0, regexp_cache_hash, regexp_cache_compare, regexp_cache_clear,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
 
-		curr_regexp = NULL;
-		curr_pattern = NULL;
-		curr_flags = 0;
+	rc_local.pattern = (char *)pattern;
+	rc_local.flags = flags;
 
-		if (SUCCEED == regexp_compile(pattern, flags, &curr_regexp, err_msg))
-		{
-			curr_pattern = zbx_strdup(curr_pattern, pattern);
-			curr_flags = flags;
-		}
-		else
-			ret = FAIL;
+	if (NULL != (rc = (zbx_regexp_cache_t *)zbx_hashset_search(cache, &rc_local)))
+	{
+		*regexp = rc->regexp;
+		return SUCCEED;
 	}
 
-	*regexp = curr_regexp;
+	if (SUCCEED != regexp_compile(pattern, flags, &rc_local.regexp, err_msg))
+	{
+		*regexp = NULL;
+		return FAIL;
+	}
+
+	if (REGEXP_CACHE_MAX <= cache->num_data)
+		zbx_hashset_clear(cache);
+
+	rc_local.pattern = zbx_strdup(NULL, pattern);
+	rc = (zbx_regexp_cache_t *)zbx_hashset_insert(cache, &rc_local, sizeof(rc_local));
+
+	*regexp = rc->regexp;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compiled regular expression from per-thread cache             *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     pattern   - [IN] regular expression as a text string                   *
+ *     regexp    - [OUT] compiled regular expression, owned by the cache      *
+ *     err_msg   - [OUT] error message if any                                 *
+ *                                                                            *
+ * Return value: SUCCEED or FAIL                                              *
+ *                                                                            *
+ * Comments: Compiles with the same flags as zbx_regexp_compile(). Use it     *
+ *           instead of compiling and freeing the same pattern for every      *
+ *           value. The returned regexp must not be freed and is valid only   *
+ *           until the next regular expression function call.                *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_regexp_compile_cached(const char *pattern, const zbx_regexp_t **regexp, char **err_msg)
+{
+#ifdef ZBX_REGEXP_NO_AUTO_CAPTURE
+	return zbx_regexp_compile_cached_ext(pattern, regexp, ZBX_REGEXP_MULTILINE | ZBX_REGEXP_NO_AUTO_CAPTURE,
+			err_msg);
+#else
+	return zbx_regexp_compile_cached_ext(pattern, regexp, ZBX_REGEXP_MULTILINE, err_msg);
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compiled regular expression with the specified flags from     *
+ *          per-thread cache                                                  *
+ *                                                                            *
+ * Comments: See zbx_regexp_compile_ext() for flags and                       *
+ *           zbx_regexp_compile_cached() for the returned regexp lifetime.    *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_regexp_compile_cached_ext(const char *pattern, const zbx_regexp_t **regexp, int flags, char **err_msg)
+{
+	zbx_regexp_t	*rxp;
+	int		ret;
+
+	ret = regexp_prepare(pattern, flags, &rxp, err_msg);
+	*regexp = rxp;
+
 	return ret;
 }
 
@@ -429,6 +429,31 @@ int	zbx_rtc_reload_config_cache(char **error)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: notify task manager about new tasks to be processed               *
+ *                                                                            *
+ * Comments: The notification is best effort - task manager still checks     *
+ *           for new tasks periodically.                                      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_rtc_notify_taskmanager(void)
+{
+#define RTC_NOTIFY_TIMEOUT	1
+	unsigned char	*result = NULL;
+	char		*error = NULL;
+
+	if (SUCCEED != zbx_ipc_async_exchange(ZBX_IPC_SERVICE_RTC, ZBX_RTC_TASKMANAGER_PROCESS, RTC_NOTIFY_TIMEOUT,
+			NULL, 0, &result, &error))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot notify task manager: %s", error);
+		zbx_free(error);
+	}
+
+	zbx_free(result);
+#undef RTC_NOTIFY_TIMEOUT
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: exchange RTC data                                                 *
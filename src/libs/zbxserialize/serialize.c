@@ -97,3 +97,27 @@ zbx_uint32_t	zbx_deserialize_uint31_compact(const unsigned char *ptr, zbx_uint32
 		return pos;
 	}
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: ensures that reusable serialization buffer can hold the           *
+ *          requested number of bytes                                         *
+ *                                                                            *
+ * Parameters: buffer       - [IN/OUT] the buffer                             *
+ *             buffer_alloc - [IN/OUT] the allocated buffer size              *
+ *             size         - [IN] the required buffer size                   *
+ *                                                                            *
+ * Comments: The buffer grows geometrically, so it can be kept between        *
+ *           serializations without reallocating it for every message.        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_serialize_reserve(unsigned char **buffer, zbx_uint32_t *buffer_alloc, zbx_uint32_t size)
+{
+	if (*buffer_alloc >= size)
+		return;
+
+	if (UINT32_MAX / 2 < *buffer_alloc || (*buffer_alloc *= 2) < size)
+		*buffer_alloc = size;
+
+	*buffer = (unsigned char *)zbx_realloc(*buffer, *buffer_alloc);
+}
@@ -114,6 +114,14 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr);
 #define FREE_CHUNK(ptr)		(((*(zbx_uint64_t *)(ptr)) & SHMEM_FLG_USED) == 0)
 #define CHUNK_SIZE(ptr)		((*(zbx_uint64_t *)(ptr)) & ~SHMEM_FLG_USED)
 
+#if ZBX_SHMEM_BUCKET_COUNT > 64
+#	error "shared memory bucket count does not fit bucket mask"
+#endif
+
+#define SHMEM_BUCKET_BIT(index)	(__UINT64_C(1) << (index))
+
+#define SHMEM_HUGE_PAGE_SIZE	(__UINT64_C(2) * ZBX_MEBIBYTE)
+
 #define SHMEM_MIN_SIZE		__UINT64_C(128)
 #define SHMEM_MAX_SIZE		__UINT64_C(0x1000000000)	/* 64 GB */
 
@@ -210,6 +218,7 @@ static void	mem_link_chunk(zbx_shmem_info_t *info, void *chunk)
 	mem_set_next_chunk(chunk, info->buckets[index]);
 
 	info->buckets[index] = chunk;
+	info->buckets_mask |= SHMEM_BUCKET_BIT(index);
 }
 
 static void	mem_unlink_chunk(zbx_shmem_info_t *info, void *chunk)
@@ -229,6 +238,53 @@ static void	mem_unlink_chunk(zbx_shmem_info_t *info, void *chunk)
 	*next_in_prev_chunk = next_chunk;
 	if (NULL != prev_in_next_chunk)
 		*prev_in_next_chunk = prev_chunk;
+
+	if (NULL == info->buckets[index])
+		info->buckets_mask &= ~SHMEM_BUCKET_BIT(index);
+}
+
+static int	shmem_huge_pages = 0;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets private shared memory segment, using huge pages if enabled   *
+ *                                                                            *
+ * Parameters: size  - [IN/OUT] the requested size, the allocated size on     *
+ *                              return                                        *
+ *             descr - [IN] the shared memory description                     *
+ *                                                                            *
+ * Return value: The shared memory identifier or -1 on error.                 *
+ *                                                                            *
+ * Comments: If huge pages cannot be allocated a warning is logged and        *
+ *           regular pages are used.                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	mem_get_shm(zbx_uint64_t *size, const char *descr)
+{
+#ifdef SHM_HUGETLB
+	if (0 != shmem_huge_pages)
+	{
+		int		shm_id;
+		zbx_uint64_t	huge_size;
+
+		huge_size = (*size + SHMEM_HUGE_PAGE_SIZE - 1) & ~(SHMEM_HUGE_PAGE_SIZE - 1);
+
+		if (-1 != (shm_id = shmget(IPC_PRIVATE, huge_size, 0600 | SHM_HUGETLB)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "allocated " ZBX_FS_UI64 " bytes of shared memory for %s using huge"
+					" pages", huge_size, descr);
+			*size = huge_size;
+
+			return shm_id;
+		}
+
+		zabbix_log(LOG_LEVEL_WARNING, "cannot allocate shared memory of size " ZBX_FS_UI64 " for %s using huge"
+				" pages: %s, falling back to regular pages", huge_size, descr, zbx_strerror(errno));
+	}
+#else
+	ZBX_UNUSED(descr);
+#endif
+	return shmget(IPC_PRIVATE, *size, 0600);
 }
 
 /* private memory functions */
@@ -245,8 +301,24 @@ static void	*__mem_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
 
 	index = mem_bucket_by_size(size);
 
-	while (index < ZBX_SHMEM_BUCKET_COUNT - 1 && NULL == info->buckets[index])
-		index++;
+	if (index < ZBX_SHMEM_BUCKET_COUNT - 1 && NULL == info->buckets[index])
+	{
+		zbx_uint64_t	mask;
+
+		/* use bucket mask to skip empty special buckets without accessing them */
+		mask = info->buckets_mask & ~(SHMEM_BUCKET_BIT(index) - 1) &
+				(SHMEM_BUCKET_BIT(ZBX_SHMEM_BUCKET_COUNT - 1) - 1);
+
+		if (0 == mask)
+		{
+			index = ZBX_SHMEM_BUCKET_COUNT - 1;
+		}
+		else
+		{
+			while (0 == (mask & SHMEM_BUCKET_BIT(index)))
+				index++;
+		}
+	}
 
 	chunk = info->buckets[index];
 
@@ -552,7 +624,7 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 		goto out;
 	}
 
-	if (-1 == (shm_id = shmget(IPC_PRIVATE, size, 0600)))
+	if (-1 == (shm_id = mem_get_shm(&size, descr)))
 	{
 		*error = zbx_dsprintf(*error, "cannot get private shared memory of size " ZBX_FS_SIZE_T " for %s: %s",
 				(zbx_fs_size_t)size, descr, zbx_strerror(errno));
@@ -606,6 +678,7 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 
 	index = mem_bucket_by_size((*info)->total_size);
 	(*info)->buckets[index] = (*info)->lo_bound;
+	(*info)->buckets_mask = SHMEM_BUCKET_BIT(index);
 	mem_set_chunk_size((*info)->buckets[index], (*info)->total_size);
 	mem_set_prev_chunk((*info)->buckets[index], NULL);
 	mem_set_next_chunk((*info)->buckets[index], NULL);
@@ -660,6 +733,19 @@ int	zbx_shmem_create_min(zbx_shmem_info_t **info, zbx_uint64_t size, const char
 	return zbx_shmem_create(info, size, descr, param, allow_oom, error);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initializes shared memory allocator settings                      *
+ *                                                                            *
+ * Parameters: huge_pages - [IN] 1 - use huge pages for shared memory, 0 -    *
+ *                               use regular pages                            *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_init_library_shmem(int huge_pages)
+{
+	shmem_huge_pages = huge_pages;
+}
+
 void	zbx_shmem_destroy(zbx_shmem_info_t *info)
 {
 	(void)shmdt(info->base);
@@ -757,6 +843,7 @@ void	zbx_shmem_clear(zbx_shmem_info_t *info)
 	memset(info->buckets, 0, ZBX_SHMEM_BUCKET_COUNT * ZBX_PTR_SIZE);
 	index = mem_bucket_by_size(info->total_size);
 	info->buckets[index] = info->lo_bound;
+	info->buckets_mask = SHMEM_BUCKET_BIT(index);
 	mem_set_chunk_size(info->buckets[index], info->total_size);
 	mem_set_prev_chunk(info->buckets[index], NULL);
 	mem_set_next_chunk(info->buckets[index], NULL);
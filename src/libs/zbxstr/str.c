@@ -27,8 +27,8 @@
 char	*zbx_string_replace(const char *str, const char *sub_str1, const char *sub_str2)
 {
 	char		*t, *new_str = NULL;
-	const char	*p, *q, *r;
-	long		len, diff, count = 0;
+	const char	*p, *q;
+	long		len, len2, diff, count = 0;
 
 	assert(str);
 	assert(sub_str1);
@@ -42,7 +42,8 @@ char	*zbx_string_replace(const char *str, const char *sub_str1, const char *sub_
 	if (0 == count)
 		return zbx_strdup(NULL, str);
 
-	diff = (long)strlen(sub_str2) - len;
+	len2 = (long)strlen(sub_str2);
+	diff = len2 - len;
 
 	/* allocate new memory */
 	new_str = (char *)zbx_malloc(new_str, (size_t)(strlen(str) + count*diff + 1)*sizeof(char));
@@ -50,16 +51,16 @@ char	*zbx_string_replace(const char *str, const char *sub_str1, const char *sub_
 	for (q=str,t=new_str,p=str; (p = strstr(p, sub_str1)); )
 	{
 		/* copy until next occurrence of sub_str1 */
-		for ( ; q < p; *t++ = *q++);
-		q += len;
+		memcpy(t, q, (size_t)(p - q));
+		t += p - q;
+		q = p + len;
 		p = q;
-		for ( r = sub_str2; (*t++ = *r++); );
-		--t;
+		memcpy(t, sub_str2, (size_t)len2);
+		t += len2;
 	}
 	/* copy the tail of str */
-	for( ; *q ; *t++ = *q++ );
-
-	*t = '\0';
+	len = (long)strlen(q);
+	memcpy(t, q, (size_t)len + 1);
 
 	return new_str;
 }
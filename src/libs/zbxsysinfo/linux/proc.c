@@ -51,6 +51,30 @@ typedef struct
 }
 zbx_sysinfo_proc_t;
 
+/* process properties used by proc.num and proc.mem filters */
+typedef struct
+{
+	char		pid[ZBX_MAX_UINT64_LEN];
+	char		*name;		/* Name from /proc/[pid]/status */
+	zbx_uint64_t	uid;		/* real user id from /proc/[pid]/status */
+	unsigned char	uid_found;
+	char		state;		/* the first letter of State from /proc/[pid]/status */
+
+	/* read on demand by the first filter that needs them */
+	unsigned char	cmdline_read;
+	char		*cmdline;	/* arguments separated by spaces */
+	char		*name_arg0;	/* process name taken from the 0th argument */
+}
+proc_snapshot_entry_t;
+
+ZBX_PTR_VECTOR_DECL(proc_snapshot_ptr, proc_snapshot_entry_t *)
+ZBX_PTR_VECTOR_IMPL(proc_snapshot_ptr, proc_snapshot_entry_t *)
+
+/* processes are listed once per second and the list is shared by all proc.num and proc.mem checks */
+static ZBX_THREAD_LOCAL zbx_vector_proc_snapshot_ptr_t	proc_snapshot;
+static ZBX_THREAD_LOCAL int				proc_snapshot_initialized;
+static ZBX_THREAD_LOCAL time_t				proc_snapshot_time;
+
 typedef struct
 {
 	unsigned int	pid;
@@ -270,129 +294,218 @@ static int	get_cmdline(FILE *f_cmd, char **line, size_t *line_offset)
 	return FAIL;
 }
 
-static int	cmp_status(FILE *f_stat, const char *procname)
+static void	proc_snapshot_entry_free(proc_snapshot_entry_t *entry)
 {
-	char	tmp[MAX_STRING_LEN];
+	zbx_free(entry->name);
+	zbx_free(entry->cmdline);
+	zbx_free(entry->name_arg0);
+
+	zbx_free(entry);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create snapshot entry from /proc/[pid]/status file                *
+ *                                                                            *
+ * Parameters: pid - [IN] the process identifier (/proc subdirectory name)    *
+ *                                                                            *
+ * Return value: The created entry or NULL if the status file cannot be read. *
+ *                                                                            *
+ ******************************************************************************/
+static proc_snapshot_entry_t	*proc_snapshot_entry_create(const char *pid)
+{
+	char			tmp[MAX_STRING_LEN], *p;
+	FILE			*f_stat;
+	proc_snapshot_entry_t	*entry;
+
+	zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", pid);
+
+	if (NULL == (f_stat = fopen(tmp, "r")))
+		return NULL;
 
-	rewind(f_stat);
+	entry = (proc_snapshot_entry_t *)zbx_malloc(NULL, sizeof(proc_snapshot_entry_t));
+	memset(entry, 0, sizeof(proc_snapshot_entry_t));
+	zbx_strlcpy(entry->pid, pid, sizeof(entry->pid));
 
+	/* Name and State precede Uid in the status file */
 	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
 	{
-		if (0 != strncmp(tmp, "Name:\t", 6))
-			continue;
+		if (NULL == entry->name && 0 == strncmp(tmp, "Name:\t", 6))
+		{
+			zbx_rtrim(tmp + 6, "\n");
+			entry->name = zbx_strdup(NULL, tmp + 6);
+		}
+		else if ('\0' == entry->state && 0 == strncmp(tmp, "State:\t", 7))
+		{
+			entry->state = tmp[7];
+		}
+		else if (0 == strncmp(tmp, "Uid:", 4))
+		{
+			for (p = tmp + 4; ' ' == *p || '\t' == *p; p++)
+				;
 
-		zbx_rtrim(tmp + 6, "\n");
-		if (0 == strcmp(tmp + 6, procname))
-			return SUCCEED;
-		break;
+			entry->uid = (zbx_uint64_t)atoi(p);
+			entry->uid_found = 1;
+			break;
+		}
 	}
 
-	return FAIL;
+	zbx_fclose(f_stat);
+
+	return entry;
 }
 
-static int	check_procname(FILE *f_cmd, FILE *f_stat, const char *procname)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read process command line of snapshot entry if not read yet       *
+ *                                                                            *
+ ******************************************************************************/
+static void	proc_snapshot_read_cmdline(proc_snapshot_entry_t *entry)
 {
-	char	*tmp = NULL, *p;
-	size_t	l;
-	int	ret = SUCCEED;
+	char	tmp[MAX_STRING_LEN], *p;
+	FILE	*f_cmd;
+	size_t	i, l;
 
-	if (NULL == procname || '\0' == *procname)
-		return SUCCEED;
+	if (0 != entry->cmdline_read)
+		return;
 
-	/* process name in /proc/[pid]/status contains limited number of characters */
-	if (SUCCEED == cmp_status(f_stat, procname))
-		return SUCCEED;
+	entry->cmdline_read = 1;
+
+	zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entry->pid);
 
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
+	if (NULL == (f_cmd = fopen(tmp, "r")))
+		return;
+
+	if (SUCCEED == get_cmdline(f_cmd, &entry->cmdline, &l))
 	{
-		if (NULL == (p = strrchr(tmp, '/')))
-			p = tmp;
+		if (NULL == (p = strrchr(entry->cmdline, '/')))
+			p = entry->cmdline;
 		else
 			p++;
 
-		if (0 == strcmp(p, procname))
-			goto clean;
-	}
+		entry->name_arg0 = zbx_strdup(NULL, p);
 
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
+		for (i = 0, l -= 2; i < l; i++)
+		{
+			if ('\0' == entry->cmdline[i])
+				entry->cmdline[i] = ' ';
+		}
+	}
 
-	return ret;
+	zbx_fclose(f_cmd);
 }
 
-static int	check_user(FILE *f_stat, struct passwd *usrinfo)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get list of processes, reusing the list made during the current   *
+ *          second                                                            *
+ *                                                                            *
+ * Return value: SUCCEED - the process list was returned                      *
+ *               FAIL    - failed to open /proc directory                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_get(zbx_vector_proc_snapshot_ptr_t **snapshot)
 {
-	zbx_uint64_t	uid;
+	DIR			*dir;
+	struct dirent		*entries;
+	proc_snapshot_entry_t	*entry;
+	time_t			now;
 
-	if (NULL == usrinfo || (SUCCEED == proc_read_id(f_stat, PROC_ID_TYPE_USER, &uid) && usrinfo->pw_uid == uid))
-		return SUCCEED;
+	now = time(NULL);
 
-	return FAIL;
-}
+	if (0 == proc_snapshot_initialized)
+	{
+		zbx_vector_proc_snapshot_ptr_create(&proc_snapshot);
+		proc_snapshot_initialized = 1;
+	}
+	else if (now == proc_snapshot_time)
+	{
+		*snapshot = &proc_snapshot;
+		return SUCCEED;
+	}
 
-static int	check_proccomm(FILE *f_cmd, const char *proccomm)
-{
-	char	*tmp = NULL;
-	size_t	i, l;
-	int	ret = SUCCEED;
+	zbx_vector_proc_snapshot_ptr_clear_ext(&proc_snapshot, proc_snapshot_entry_free);
+	proc_snapshot_time = 0;
 
-	if (NULL == proccomm || '\0' == *proccomm)
-		return SUCCEED;
+	if (NULL == (dir = opendir("/proc")))
+		return FAIL;
 
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
+	while (NULL != (entries = readdir(dir)))
 	{
-		for (i = 0, l -= 2; i < l; i++)
-			if ('\0' == tmp[i])
-				tmp[i] = ' ';
+		if (0 == atoi(entries->d_name))
+			continue;
 
-		if (NULL != zbx_regexp_match(tmp, proccomm, NULL))
-			goto clean;
+		if (NULL != (entry = proc_snapshot_entry_create(entries->d_name)))
+			zbx_vector_proc_snapshot_ptr_append(&proc_snapshot, entry);
 	}
 
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
+	closedir(dir);
 
-	return ret;
+	proc_snapshot_time = now;
+	*snapshot = &proc_snapshot;
+
+	return SUCCEED;
 }
 
-static int	check_procstate(FILE *f_stat, int zbx_proc_stat)
+static int	proc_snapshot_match_name(proc_snapshot_entry_t *entry, const char *procname)
 {
-	char	tmp[MAX_STRING_LEN], *p;
+	if (NULL == procname || '\0' == *procname)
+		return SUCCEED;
 
-	if (ZBX_PROC_STAT_ALL == zbx_proc_stat)
+	/* process name in /proc/[pid]/status contains limited number of characters */
+	if (NULL != entry->name && 0 == strcmp(entry->name, procname))
 		return SUCCEED;
 
-	rewind(f_stat);
+	proc_snapshot_read_cmdline(entry);
 
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
-	{
-		if (0 != strncmp(tmp, "State:\t", 7))
-			continue;
+	if (NULL != entry->name_arg0 && 0 == strcmp(entry->name_arg0, procname))
+		return SUCCEED;
 
-		p = tmp + 7;
+	return FAIL;
+}
 
-		switch (zbx_proc_stat)
-		{
-			case ZBX_PROC_STAT_RUN:
-				return ('R' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_SLEEP:
-				return ('S' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_ZOMB:
-				return ('Z' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_DISK:
-				return ('D' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_TRACE:
-				return ('T' == *p) ? SUCCEED : FAIL;
-			default:
-				return FAIL;
-		}
-	}
+static int	proc_snapshot_match_user(const proc_snapshot_entry_t *entry, const struct passwd *usrinfo)
+{
+	if (NULL == usrinfo || (0 != entry->uid_found && usrinfo->pw_uid == entry->uid))
+		return SUCCEED;
+
+	return FAIL;
+}
+
+static int	proc_snapshot_match_cmdline(proc_snapshot_entry_t *entry, const char *proccomm)
+{
+	if (NULL == proccomm || '\0' == *proccomm)
+		return SUCCEED;
+
+	proc_snapshot_read_cmdline(entry);
+
+	if (NULL != entry->cmdline && NULL != zbx_regexp_match(entry->cmdline, proccomm, NULL))
+		return SUCCEED;
 
 	return FAIL;
 }
 
+static int	proc_snapshot_match_state(const proc_snapshot_entry_t *entry, int zbx_proc_stat)
+{
+	switch (zbx_proc_stat)
+	{
+		case ZBX_PROC_STAT_ALL:
+			return SUCCEED;
+		case ZBX_PROC_STAT_RUN:
+			return ('R' == entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_SLEEP:
+			return ('S' == entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_ZOMB:
+			return ('Z' == entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_DISK:
+			return ('D' == entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_TRACE:
+			return ('T' == entry->state) ? SUCCEED : FAIL;
+		default:
+			return FAIL;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Read amount of memory in bytes from a string in /proc file.       *
@@ -516,17 +629,16 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 #define ZBX_VMEXE	12
 #define ZBX_VMPTE	13
 
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
-	DIR		*dir;
-	struct dirent	*entries;
-	struct passwd	*usrinfo;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
-	zbx_uint64_t	mem_size = 0, byte_value = 0, total_memory;
-	double		pct_size = 0.0, pct_value = 0.0;
-	int		do_task, res, proccount = 0, invalid_user = 0, invalid_read = 0;
-	int		mem_type_tried = 0, mem_type_code;
-	char		*mem_type = NULL;
-	const char	*mem_type_search = NULL;
+	char				tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
+	struct passwd			*usrinfo;
+	FILE				*f_stat = NULL;
+	zbx_uint64_t			mem_size = 0, byte_value = 0, total_memory;
+	double				pct_size = 0.0, pct_value = 0.0;
+	int				i, do_task, res, proccount = 0, invalid_user = 0, invalid_read = 0;
+	int				mem_type_tried = 0, mem_type_code;
+	char				*mem_type = NULL;
+	const char			*mem_type_search = NULL;
+	zbx_vector_proc_snapshot_ptr_t	*snapshot;
 
 	if (5 < request->nparam)
 	{
@@ -673,41 +785,33 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 
-	if (NULL == (dir = opendir("/proc")))
+	if (SUCCEED != proc_snapshot_get(&snapshot))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		return SYSINFO_RET_FAIL;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (i = 0; i < snapshot->values_num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
-			continue;
+		proc_snapshot_entry_t	*entry = snapshot->values[i];
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
+		zbx_fclose(f_stat);
 
-		if (NULL == (f_cmd = fopen(tmp, "r")))
+		if (FAIL == proc_snapshot_match_name(entry, procname))
 			continue;
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
+		if (FAIL == proc_snapshot_match_user(entry, usrinfo))
 			continue;
 
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
+		if (FAIL == proc_snapshot_match_cmdline(entry, proccomm))
 			continue;
 
-		if (FAIL == check_user(f_stat, usrinfo))
-			continue;
+		/* memory usage changes all the time, so it is read from the status file of matching processes */
+		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entry->pid);
 
-		if (FAIL == check_proccomm(f_cmd, proccomm))
+		if (NULL == (f_stat = fopen(tmp, "r")))
 			continue;
 
-		rewind(f_stat);
-
 		if (0 == mem_type_tried)
 			mem_type_tried = 1;
 
@@ -830,9 +934,7 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 clean:
-	zbx_fclose(f_cmd);
 	zbx_fclose(f_stat);
-	closedir(dir);
 
 	if ((0 == proccount && 0 != mem_type_tried) || 0 != invalid_read)
 	{
@@ -879,12 +981,10 @@ out:
 
 int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
-	DIR		*dir;
-	struct dirent	*entries;
-	struct passwd	*usrinfo;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
-	int		proccount = 0, invalid_user = 0, zbx_proc_stat;
+	char				*procname, *proccomm, *param;
+	struct passwd			*usrinfo;
+	int				i, proccount = 0, invalid_user = 0, zbx_proc_stat;
+	zbx_vector_proc_snapshot_ptr_t	*snapshot;
 
 	if (4 < request->nparam)
 	{
@@ -939,47 +1039,30 @@ int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 	if (1 == invalid_user)	/* handle 0 for non-existent user after all parameters have been parsed and validated */
 		goto out;
 
-	if (NULL == (dir = opendir("/proc")))
+	if (SUCCEED != proc_snapshot_get(&snapshot))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		return SYSINFO_RET_FAIL;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (i = 0; i < snapshot->values_num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
+		proc_snapshot_entry_t	*entry = snapshot->values[i];
 
-		if (0 == atoi(entries->d_name))
+		if (FAIL == proc_snapshot_match_name(entry, procname))
 			continue;
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
+		if (FAIL == proc_snapshot_match_user(entry, usrinfo))
 			continue;
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
+		if (FAIL == proc_snapshot_match_cmdline(entry, proccomm))
 			continue;
 
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
-			continue;
-
-		if (FAIL == check_user(f_stat, usrinfo))
-			continue;
-
-		if (FAIL == check_proccomm(f_cmd, proccomm))
-			continue;
-
-		if (FAIL == check_procstate(f_stat, zbx_proc_stat))
+		if (FAIL == proc_snapshot_match_state(entry, zbx_proc_stat))
 			continue;
 
 		proccount++;
 	}
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
 out:
 	SET_UI64_RESULT(result, proccount);
 
@@ -26,6 +26,16 @@
 
 #define ZBX_TIMEKEEPER_FLUSH_DELAY		(ZBX_TIMEKEEPER_DELAY * 0.5)
 
+/* number of attempts to read consistent unit flush data before skipping the unit till the next collection */
+#define TIMEKEEPER_SNAPSHOT_ATTEMPTS		100
+
+/* When atomic builtins are available units publish flushed counters under per unit sequence counter */
+/* instead of taking the timekeeper lock, so that busy/idle state changes of many processes do not    */
+/* contend with each other and with the collector.                                                    */
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+#	define TIMEKEEPER_SEQLOCK
+#endif
+
 /* unit state cache, updated only by the execution units themselves */
 typedef struct
 {
@@ -49,12 +59,21 @@ typedef struct
 	/* historical unit state data */
 	zbx_uint64_t		h_counter[ZBX_PROCESS_STATE_COUNT][MAX_HISTORY];
 
-	/* unit state data for the current data gathering cycle */
-	zbx_uint64_t		counter[ZBX_PROCESS_STATE_COUNT];
-
-	/* the unit state that was already applied to the historical state data */
+	/* the estimated unit state that was already applied to the historical state data */
 	zbx_uint64_t		counter_used[ZBX_PROCESS_STATE_COUNT];
 
+	/* the flushed unit state already processed by collector */
+	zbx_uint64_t		flushed_used[ZBX_PROCESS_STATE_COUNT];
+
+	/* ticks of the last cache flush processed by collector */
+	clock_t			ticks_flush_used;
+
+	/* the cumulative unit state flushed from cache, updated only by the unit itself */
+	zbx_uint64_t		flushed[ZBX_PROCESS_STATE_COUNT];
+
+	/* flushed state sequence number, odd while the unit is flushing its cache */
+	unsigned int		flush_seq;
+
 	/* the unit state cache */
 	zbx_timekeeper_unit_cache_t	cache;
 }
@@ -260,6 +279,88 @@ void	zbx_timekeeper_free(zbx_timekeeper_t *timekeeper)
 	timekeeper->mem_free_func(timekeeper);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start updating unit flushed state                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	timekeeper_flush_begin(zbx_timekeeper_t *timekeeper, zbx_timekeeper_unit_t *unit)
+{
+#ifdef TIMEKEEPER_SEQLOCK
+	ZBX_UNUSED(timekeeper);
+
+	__atomic_store_n(&unit->flush_seq, unit->flush_seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#else
+	ZBX_UNUSED(unit);
+
+	timekeeper->sync->lock(timekeeper->sync->data);
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finish updating unit flushed state                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	timekeeper_flush_end(zbx_timekeeper_t *timekeeper, zbx_timekeeper_unit_t *unit)
+{
+#ifdef TIMEKEEPER_SEQLOCK
+	ZBX_UNUSED(timekeeper);
+
+	__atomic_store_n(&unit->flush_seq, unit->flush_seq + 1, __ATOMIC_RELEASE);
+#else
+	ZBX_UNUSED(unit);
+
+	timekeeper->sync->unlock(timekeeper->sync->data);
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read consistent copy of unit flushed state                        *
+ *                                                                            *
+ * Parameters: unit        - [IN] the unit                                    *
+ *             flushed     - [OUT] the cumulative flushed state counters      *
+ *             ticks_flush - [OUT] ticks of the last unit cache flush         *
+ *                                                                            *
+ * Return value: SUCCEED - the state was copied                               *
+ *               FAIL    - the unit kept flushing its cache, the state must   *
+ *                         be read during the next collection                 *
+ *                                                                            *
+ * Comments: Without atomic builtins this function must be called with        *
+ *           timekeeper lock held.                                            *
+ *                                                                            *
+ ******************************************************************************/
+static int	timekeeper_unit_snapshot(const zbx_timekeeper_unit_t *unit, zbx_uint64_t *flushed,
+		clock_t *ticks_flush)
+{
+#ifdef TIMEKEEPER_SEQLOCK
+	for (int i = 0; i < TIMEKEEPER_SNAPSHOT_ATTEMPTS; i++)
+	{
+		unsigned int	seq;
+
+		if (0 != ((seq = __atomic_load_n(&unit->flush_seq, __ATOMIC_ACQUIRE)) & 1))
+			continue;
+
+		memcpy(flushed, unit->flushed, sizeof(unit->flushed));
+		*ticks_flush = unit->cache.ticks_flush;
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (seq == __atomic_load_n(&unit->flush_seq, __ATOMIC_RELAXED))
+			return SUCCEED;
+	}
+
+	return FAIL;
+#else
+	memcpy(flushed, unit->flushed, sizeof(unit->flushed));
+	*ticks_flush = unit->cache.ticks_flush;
+
+	return SUCCEED;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: update process/thread state                                       *
@@ -293,7 +394,10 @@ void	zbx_timekeeper_update(zbx_timekeeper_t *timekeeper, int index, unsigned cha
 
 	if (0 == unit->cache.ticks_flush)
 	{
+		timekeeper_flush_begin(timekeeper, unit);
 		unit->cache.ticks_flush = ticks;
+		timekeeper_flush_end(timekeeper, unit);
+
 		unit->cache.state = state;
 		unit->cache.ticks = ticks;
 		return;
@@ -304,29 +408,19 @@ void	zbx_timekeeper_update(zbx_timekeeper_t *timekeeper, int index, unsigned cha
 
 	if (ZBX_TIMEKEEPER_FLUSH_DELAY < (double)(ticks - unit->cache.ticks_flush) / (double)timekeeper->ticks_per_sec)
 	{
-		timekeeper->sync->lock(timekeeper->sync->data);
+		timekeeper_flush_begin(timekeeper, unit);
 
 		for (int s = 0; s < ZBX_PROCESS_STATE_COUNT; s++)
 		{
-			/* If process did not update statistic counter during one timekeeper data         */
-			/* collection interval, then self timekeeper will collect statistics based on the */
-			/* current process state and the ticks passed since last timekeeper data          */
-			/* collection. This value is stored in counter_used and the local statistics      */
-			/* must be adjusted by this (already collected) value.                            */
-			if (unit->cache.counter[s] > unit->counter_used[s])
-			{
-				unit->cache.counter[s] -= unit->counter_used[s];
-				unit->counter[s] += unit->cache.counter[s];
-			}
+			unit->flushed[s] += unit->cache.counter[s];
 
 			/* reset current cache statistics */
-			unit->counter_used[s] = 0;
 			unit->cache.counter[s] = 0;
 		}
 
 		unit->cache.ticks_flush = ticks;
 
-		timekeeper->sync->unlock(timekeeper->sync->data);
+		timekeeper_flush_end(timekeeper, unit);
 	}
 
 	/* update local timekeeper cache */
@@ -381,16 +475,41 @@ void	zbx_timekeeper_collect(zbx_timekeeper_t *timekeeper)
 
 	for (i = 0; i < timekeeper->units_num; i++)
 	{
+		zbx_uint64_t	counter[ZBX_PROCESS_STATE_COUNT] = {0}, flushed[ZBX_PROCESS_STATE_COUNT];
+		clock_t		ticks_flush;
+
 		unit = timekeeper->units + i;
 
-		if (unit->cache.ticks_flush < timekeeper->ticks_sync)
+		if (SUCCEED == timekeeper_unit_snapshot(unit, flushed, &ticks_flush) &&
+				ticks_flush != unit->ticks_flush_used)
+		{
+			for (int s = 0; s < ZBX_PROCESS_STATE_COUNT; s++)
+			{
+				zbx_uint64_t	delta = flushed[s] - unit->flushed_used[s];
+
+				/* If process did not update statistic counter during one timekeeper data     */
+				/* collection interval, then timekeeper has collected statistics based on the */
+				/* process state and the ticks passed since last data collection. This value  */
+				/* is stored in counter_used and the flushed statistics must be adjusted by   */
+				/* this (already collected) value.                                            */
+				if (delta > unit->counter_used[s])
+					counter[s] = delta - unit->counter_used[s];
+
+				unit->counter_used[s] = 0;
+				unit->flushed_used[s] = flushed[s];
+			}
+
+			unit->ticks_flush_used = ticks_flush;
+		}
+
+		if (unit->ticks_flush_used < timekeeper->ticks_sync)
 		{
 			/* If the process local cache was not flushed during the last timekeeper       */
 			/* data collection interval update the process statistics based on the current */
 			/* process state and ticks passed during the collection interval.              */
 			/* This will serve as good estimate until the timekeeper cache is flushed and  */
 			/* its counters adjusted by those values.                                      */
-			unit->counter[unit->cache.state] += (zbx_uint64_t)ticks_done;
+			counter[unit->cache.state] += (zbx_uint64_t)ticks_done;
 
 			/* store the estimated ticks to adjust the counters when flushing local cache */
 			unit->counter_used[unit->cache.state] += (zbx_uint64_t)ticks_done;
@@ -402,8 +521,7 @@ void	zbx_timekeeper_collect(zbx_timekeeper_t *timekeeper)
 			/* timekeeper data collection interval. But in history the data are       */
 			/* stored as relative values. To achieve it we add the collected data to  */
 			/* the last values.                                                       */
-			unit->h_counter[s][index] = unit->h_counter[s][last] + unit->counter[s];
-			unit->counter[s] = 0;
+			unit->h_counter[s][index] = unit->h_counter[s][last] + counter[s];
 		}
 	}
 
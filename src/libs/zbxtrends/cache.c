@@ -627,6 +627,51 @@ void	zbx_tfc_put_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get items not having cached function value over the range         *
+ *                                                                            *
+ * Parameters: itemids  - [IN] the item identifiers                           *
+ *             start    - [IN] the period start time (including)              *
+ *             end      - [IN] the period end time (including)                *
+ *             function - [IN] the trend function                             *
+ *             missing  - [OUT] the items without cached value                *
+ *                                                                            *
+ * Return value: SUCCEED - the cache was checked successfully                 *
+ *               FAIL - trend function cache is disabled                      *
+ *                                                                            *
+ * Comments: Cache statistics and LRU order are not updated as the values     *
+ *           will be requested again during function evaluation.              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tfc_get_missing(const zbx_vector_uint64_t *itemids, time_t start, time_t end,
+		zbx_trend_function_t function, zbx_vector_uint64_t *missing)
+{
+	zbx_tfc_data_t	data_local;
+	int		i;
+
+	if (NULL == cache)
+		return FAIL;
+
+	data_local.start = start;
+	data_local.end = end;
+	data_local.function = function;
+
+	LOCK_CACHE;
+
+	for (i = 0; i < itemids->values_num; i++)
+	{
+		data_local.itemid = itemids->values[i];
+
+		if (NULL == zbx_hashset_search(&cache->index, &data_local))
+			zbx_vector_uint64_append(missing, itemids->values[i]);
+	}
+
+	UNLOCK_CACHE;
+
+	return SUCCEED;
+}
+
 void	zbx_tfc_invalidate_trends(ZBX_DC_TREND *trends, int trends_num)
 {
 	zbx_tfc_data_t	*root, *data, data_local;
@@ -24,6 +24,41 @@
 #include "zbxdb.h"
 #include "zbxcacheconfig.h"
 
+#define ZBX_TRENDS_BUCKET_CACHEABLE	0x01
+#define ZBX_TRENDS_BUCKET_CACHED	0x02
+
+/* daily bucket period, must be the first member of function specific buckets */
+typedef struct
+{
+	time_t		start;
+	time_t		end;
+	unsigned char	flags;
+}
+zbx_trends_period_t;
+
+typedef struct
+{
+	zbx_trends_period_t	period;
+	double			avg;
+	double			num;
+	double			sum;
+	zbx_trend_state_t	avg_state;
+	zbx_trend_state_t	num_state;
+	zbx_trend_state_t	sum_state;
+}
+zbx_trends_bucket_t;
+
+typedef struct
+{
+	zbx_trends_period_t	period;
+	double			value;
+	zbx_trend_state_t	state;
+}
+zbx_trends_value_bucket_t;
+
+typedef int	(*zbx_trends_bucket_get_func_t)(zbx_uint64_t itemid, void *bucket, void *data);
+typedef void	(*zbx_trends_bucket_add_func_t)(void *bucket, zbx_db_row_t row, void *data);
+
 static char	*trends_errors[ZBX_TREND_STATE_COUNT] = {
 		"unknown error",
 		NULL,
@@ -405,138 +440,446 @@ int	zbx_trends_parse_nextcheck(time_t from, const char *period_shift, time_t *ne
 
 /******************************************************************************
  *                                                                            *
- * Purpose: evaluate expression with trends data                              *
+ * Purpose: get start of the day containing the specified time                *
+ *                                                                            *
+ * Parameters: clock - [IN] time in seconds since Epoch                       *
+ *             next  - [OUT] start of the next day                            *
+ *                                                                            *
+ * Return value: The day start time in seconds since Epoch.                   *
+ *                                                                            *
+ ******************************************************************************/
+static time_t	trends_get_day_start(time_t clock, time_t *next)
+{
+	struct tm	tm;
+	time_t		day_start;
+
+	localtime_r(&clock, &tm);
+	zbx_tm_round_down(&tm, ZBX_TIME_UNIT_DAY);
+	day_start = mktime(&tm);
+
+	zbx_tm_add(&tm, 1, ZBX_TIME_UNIT_DAY);
+	*next = mktime(&tm);
+
+	return day_start;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get end of daily bucket starting at the specified time            *
+ *                                                                            *
+ * Parameters: bucket_start - [IN] bucket start time in seconds since Epoch   *
+ *             end          - [IN] period end time in seconds since Epoch     *
+ *             now          - [IN] current time                               *
+ *             bucket_end   - [OUT] bucket end time (start of its last hour)  *
+ *             next         - [OUT] start of the next bucket                  *
+ *                                                                            *
+ * Return value: SUCCEED - the bucket covers complete day in the past and     *
+ *                         its aggregates can be cached                       *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	trends_get_bucket_end(time_t bucket_start, time_t end, time_t now, time_t *bucket_end, time_t *next)
+{
+	time_t	day_start;
+
+	day_start = trends_get_day_start(bucket_start, next);
+
+	if (*next - SEC_PER_HOUR > end)
+	{
+		*bucket_end = end;
+		return FAIL;
+	}
+
+	*bucket_end = *next - SEC_PER_HOUR;
+
+	/* only complete days in the past are cached as buckets */
+	if (day_start != bucket_start || *next > now)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find the last bucket starting before the specified time           *
+ *                                                                            *
+ * Parameters: buckets     - [IN] buckets sorted by start time                *
+ *             bucket_size - [IN] size of a single bucket                     *
+ *             buckets_num - [IN] number of buckets                           *
+ *             clock       - [IN] time in seconds since Epoch                 *
+ *                                                                            *
+ * Return value: The bucket containing the specified time.                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	*trends_find_bucket(void *buckets, size_t bucket_size, int buckets_num, time_t clock)
+{
+	int	lo = 0, hi = buckets_num - 1;
+
+	while (lo < hi)
+	{
+		int				mid = (lo + hi + 1) / 2;
+		const zbx_trends_period_t	*period;
+
+		period = (const zbx_trends_period_t *)((char *)buckets + (size_t)mid * bucket_size);
+
+		if (period->start <= clock)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	return (char *)buckets + (size_t)lo * bucket_size;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: split period into daily buckets and fill them with cached         *
+ *          aggregates or trends data                                         *
  *                                                                            *
  * Parameters: table       - [IN] trends table name                           *
  *             itemid      - [IN]                                             *
- *             start       - [OUT] period start time in seconds since Epoch   *
- *             end         - [OUT] period end time in seconds since Epoch     *
- *             eval_single - [IN] sql expression to evaluate for single       *
- *                                 record                                     *
- *             eval_multi  - [IN] sql expression to evaluate for multiple     *
- *                                 records                                    *
- *             value       - [OUT] evaluation result                          *
+ *             start       - [IN] period start time in seconds since Epoch    *
+ *             end         - [IN] period end time in seconds since Epoch      *
+ *             columns     - [IN] trends table columns to select              *
+ *             bucket_size - [IN] size of a single bucket                     *
+ *             get_cached  - [IN] callback to get bucket aggregates from      *
+ *                                trend function cache                        *
+ *             add_row     - [IN] callback to add trends record to bucket     *
+ *             data        - [IN] callback data                               *
+ *             buckets_num - [OUT] number of returned buckets                 *
  *                                                                            *
- * Return value: Trend value state of the specified period and function.      *
+ * Return value: Allocated buckets sorted by start time or NULL if the period *
+ *               is empty. Each bucket starts with zbx_trends_period_t        *
+ *               structure.                                                   *
+ *                                                                            *
+ * Comments: Cacheable buckets not found in cache are reset, so partially     *
+ *           retrieved aggregates are not mixed with trends data. Trends      *
+ *           records of all remaining buckets are fetched with single query.  *
  *                                                                            *
  ******************************************************************************/
-static zbx_trend_state_t	trends_eval(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
-		const char *eval_single, const char *eval_multi, double *value)
+static void	*trends_get_buckets(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
+		const char *columns, size_t bucket_size, zbx_trends_bucket_get_func_t get_cached,
+		zbx_trends_bucket_add_func_t add_row, void *data, int *buckets_num)
 {
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
-	char			*sql = NULL;
-	size_t			sql_alloc = 0, sql_offset = 0;
-	zbx_trend_state_t	state;
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+	char		*buckets = NULL;
+	int		buckets_alloc = 0;
+	time_t		now, next, query_start = 0, query_end = 0;
+
+	*buckets_num = 0;
 
 	zbx_recalc_time_period(&start, ZBX_RECALC_TIME_PERIOD_TRENDS);
 
 	if (start > end)
-		return ZBX_TREND_STATE_NODATA;
+		return NULL;
+
+	now = time(NULL);
 
-	if (start != end)
+	for (next = start; next <= end;)
 	{
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-				"select %s from %s"
+		zbx_trends_period_t	*period;
+
+		if (*buckets_num == buckets_alloc)
+		{
+			buckets_alloc = (0 == buckets_alloc ? 32 : buckets_alloc * 2);
+			buckets = (char *)zbx_realloc(buckets, bucket_size * (size_t)buckets_alloc);
+		}
+
+		period = (zbx_trends_period_t *)(buckets + bucket_size * (size_t)(*buckets_num)++);
+		memset(period, 0, bucket_size);
+		period->start = next;
+
+		if (SUCCEED == trends_get_bucket_end(period->start, end, now, &period->end, &next))
+		{
+			zbx_trends_period_t	local_period = *period;
+
+			if (SUCCEED == get_cached(itemid, period, data))
+			{
+				period->flags = ZBX_TRENDS_BUCKET_CACHEABLE | ZBX_TRENDS_BUCKET_CACHED;
+				continue;
+			}
+
+			memset(period, 0, bucket_size);
+			*period = local_period;
+			period->flags = ZBX_TRENDS_BUCKET_CACHEABLE;
+		}
+
+		if (0 == query_end)
+			query_start = period->start;
+
+		query_end = period->end;
+	}
+
+	if (0 != query_end)
+	{
+		result = zbx_db_select("select clock,%s from %s"
 				" where itemid=" ZBX_FS_UI64
 					" and clock>=" ZBX_FS_I64
 					" and clock<=" ZBX_FS_I64,
-				eval_multi, table, itemid, start, end);
+				columns, table, itemid, query_start, query_end);
+
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			zbx_trends_period_t	*period;
+
+			period = (zbx_trends_period_t *)trends_find_bucket(buckets, bucket_size, *buckets_num,
+					(time_t)atoi(row[0]));
+
+			if (0 == (period->flags & ZBX_TRENDS_BUCKET_CACHED))
+				add_row(period, row, data);
+		}
+
+		zbx_db_free_result(result);
 	}
-	else
+
+	return buckets;
+}
+
+static int	trends_avg_sum_get_cached(zbx_uint64_t itemid, void *data_bucket, void *data)
+{
+	zbx_trends_bucket_t	*bucket = (zbx_trends_bucket_t *)data_bucket;
+
+	ZBX_UNUSED(data);
+
+	if (SUCCEED != zbx_tfc_get_value(itemid, bucket->period.start, bucket->period.end, ZBX_TREND_FUNCTION_AVG,
+			&bucket->avg, &bucket->avg_state))
 	{
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-				"select %s from %s"
-				" where itemid=" ZBX_FS_UI64
-					" and clock=" ZBX_FS_I64,
-				eval_single, table, itemid, start);
+		return FAIL;
 	}
 
-	result = zbx_db_select("%s", sql);
-	zbx_free(sql);
+	if (SUCCEED != zbx_tfc_get_value(itemid, bucket->period.start, bucket->period.end,
+			ZBX_TREND_FUNCTION_COUNT, &bucket->num, &bucket->num_state))
+	{
+		return FAIL;
+	}
+
+	return zbx_tfc_get_value(itemid, bucket->period.start, bucket->period.end, ZBX_TREND_FUNCTION_SUM,
+			&bucket->sum, &bucket->sum_state);
+}
+
+static void	trends_avg_sum_add_row(void *data_bucket, zbx_db_row_t row, void *data)
+{
+	zbx_trends_bucket_t	*bucket = (zbx_trends_bucket_t *)data_bucket;
+	double			row_avg, row_num;
 
-	if (NULL != (row = zbx_db_fetch(result)) && SUCCEED != zbx_db_is_null(row[0]))
+	ZBX_UNUSED(data);
+
+	row_avg = atof(row[1]);
+	row_num = atof(row[2]);
+
+	if (0 == bucket->num)
 	{
-		*value = atof(row[0]);
-		state = ZBX_TREND_STATE_NORMAL;
+		bucket->avg = row_avg;
+		bucket->num = row_num;
 	}
 	else
-		state = ZBX_TREND_STATE_NODATA;
-
-	zbx_db_free_result(result);
+	{
+		bucket->avg = bucket->avg / (bucket->num + row_num) * bucket->num +
+				row_avg / (bucket->num + row_num) * row_num;
+		bucket->num += row_num;
+	}
 
-	return state;
+	bucket->sum += row_avg * row_num;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: evaluate avg function with trends data                            *
+ * Purpose: evaluate avg and sum functions with trends data                   *
  *                                                                            *
- * Parameters: table       - [IN] trends table name                           *
- *             itemid      - [IN]                                             *
- *             start       - [OUT] period start time in seconds since Epoch   *
- *             end         - [OUT] period end time in seconds since Epoch     *
- *             value       - [OUT] evaluation result                          *
+ * Parameters: table     - [IN] trends table name                             *
+ *             itemid    - [IN]                                               *
+ *             start     - [IN] period start time in seconds since Epoch      *
+ *             end       - [IN] period end time in seconds since Epoch        *
+ *             avg       - [OUT] average value                                *
+ *             avg_state - [OUT] average value state                          *
+ *             sum       - [OUT] sum value                                    *
+ *             sum_state - [OUT] sum value state                              *
  *                                                                            *
- * Return value: Trend value state of the specified period and function.      *
+ * Comments: The period is split into daily buckets. Aggregates of complete   *
+ *           past days are stored in trend function cache, so overlapping     *
+ *           periods (for example 1M:now/M and 1w:now/w or baseline seasons)  *
+ *           reuse the cached buckets and query database only for the         *
+ *           remaining hours.                                                 *
  *                                                                            *
  ******************************************************************************/
-static zbx_trend_state_t	trends_eval_avg(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
-		double *value)
+static void	trends_eval_avg_sum(const char *table, zbx_uint64_t itemid, time_t start, time_t end, double *avg,
+		zbx_trend_state_t *avg_state, double *sum, zbx_trend_state_t *sum_state)
 {
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
-	char			*sql = NULL;
-	size_t			sql_alloc = 0, sql_offset = 0;
-	zbx_trend_state_t	state;
-	double			avg, num, num2, avg2;
+	zbx_trends_bucket_t	*buckets;
+	int			buckets_num, i;
+	double			num = 0;
 
-	zbx_recalc_time_period(&start, ZBX_RECALC_TIME_PERIOD_TRENDS);
+	*avg_state = ZBX_TREND_STATE_NODATA;
+	*sum = 0;
+	*sum_state = ZBX_TREND_STATE_NORMAL;
 
-	if (start > end)
-		return ZBX_TREND_STATE_NODATA;
+	buckets = (zbx_trends_bucket_t *)trends_get_buckets(table, itemid, start, end, "value_avg,num",
+			sizeof(zbx_trends_bucket_t), trends_avg_sum_get_cached, trends_avg_sum_add_row, NULL,
+			&buckets_num);
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select value_avg,num from %s where itemid=" ZBX_FS_UI64,
-			table, itemid);
+	for (i = 0; i < buckets_num; i++)
+	{
+		zbx_trends_bucket_t	*bucket = &buckets[i];
+
+		if (0 == (bucket->period.flags & ZBX_TRENDS_BUCKET_CACHED))
+		{
+			bucket->avg_state = (0 != bucket->num ? ZBX_TREND_STATE_NORMAL : ZBX_TREND_STATE_NODATA);
+			bucket->num_state = ZBX_TREND_STATE_NORMAL;
+			bucket->sum_state = (ZBX_INFINITY == bucket->sum ? ZBX_TREND_STATE_OVERFLOW :
+					ZBX_TREND_STATE_NORMAL);
+
+			if (0 != (bucket->period.flags & ZBX_TRENDS_BUCKET_CACHEABLE))
+			{
+				zbx_tfc_put_value(itemid, bucket->period.start, bucket->period.end,
+						ZBX_TREND_FUNCTION_AVG, bucket->avg, bucket->avg_state);
+				zbx_tfc_put_value(itemid, bucket->period.start, bucket->period.end,
+						ZBX_TREND_FUNCTION_COUNT, bucket->num, bucket->num_state);
+				zbx_tfc_put_value(itemid, bucket->period.start, bucket->period.end,
+						ZBX_TREND_FUNCTION_SUM, bucket->sum, bucket->sum_state);
+			}
+		}
+
+		if (ZBX_TREND_STATE_NORMAL == bucket->avg_state && 0 != bucket->num)
+		{
+			if (0 == num)
+				*avg = bucket->avg;
+			else
+				*avg = *avg / (num + bucket->num) * num + bucket->avg / (num + bucket->num) * bucket->num;
+
+			num += bucket->num;
+			*avg_state = ZBX_TREND_STATE_NORMAL;
+		}
+
+		if (ZBX_TREND_STATE_NORMAL != bucket->sum_state)
+			*sum_state = bucket->sum_state;
+		else
+			*sum += bucket->sum;
+	}
+
+	if (ZBX_INFINITY == *sum)
+		*sum_state = ZBX_TREND_STATE_OVERFLOW;
+
+	zbx_free(buckets);
+}
 
-	if (start != end)
+static int	trends_daily_get_cached(zbx_uint64_t itemid, void *data_bucket, void *data)
+{
+	zbx_trends_value_bucket_t	*bucket = (zbx_trends_value_bucket_t *)data_bucket;
+
+	return zbx_tfc_get_value(itemid, bucket->period.start, bucket->period.end, *(zbx_trend_function_t *)data,
+			&bucket->value, &bucket->state);
+}
+
+static void	trends_daily_add_row(void *data_bucket, zbx_db_row_t row, void *data)
+{
+	zbx_trends_value_bucket_t	*bucket = (zbx_trends_value_bucket_t *)data_bucket;
+	zbx_trend_function_t		function = *(zbx_trend_function_t *)data;
+	double				row_value;
+
+	row_value = atof(row[1]);
+
+	if (ZBX_TREND_STATE_NORMAL != bucket->state)
 	{
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and clock>=" ZBX_FS_I64 " and clock<=" ZBX_FS_I64,
-				start, end);
+		bucket->value = row_value;
+		bucket->state = ZBX_TREND_STATE_NORMAL;
 	}
-	else
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and clock=" ZBX_FS_I64, start);
+	else if (ZBX_TREND_FUNCTION_COUNT == function)
+		bucket->value += row_value;
+	else if (ZBX_TREND_FUNCTION_MAX == function ? row_value > bucket->value : row_value < bucket->value)
+		bucket->value = row_value;
+}
 
-	result = zbx_db_select("%s", sql);
-	zbx_free(sql);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate count, max or min function with trends data              *
+ *                                                                            *
+ * Parameters: table    - [IN] trends table name                              *
+ *             itemid   - [IN]                                                *
+ *             start    - [IN] period start time in seconds since Epoch       *
+ *             end      - [IN] period end time in seconds since Epoch         *
+ *             function - [IN] trend function to evaluate                     *
+ *             value    - [OUT] evaluation result                             *
+ *                                                                            *
+ * Return value: Trend value state of the specified period and function.      *
+ *                                                                            *
+ * Comments: The period is split into daily buckets in the same way as for    *
+ *           avg and sum functions, so long periods are combined from cached  *
+ *           daily aggregates instead of scanning all hourly records.         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_trend_state_t	trends_eval_daily(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
+		zbx_trend_function_t function, double *value)
+{
+	zbx_trends_value_bucket_t	*buckets;
+	int				buckets_num, i;
+	const char			*column;
+	zbx_trend_state_t		state;
 
-	if (NULL != (row = zbx_db_fetch(result)))
+	switch (function)
 	{
-		avg = atof(row[0]);
-		num = atof(row[1]);
+		case ZBX_TREND_FUNCTION_COUNT:
+			column = "num";
+			break;
+		case ZBX_TREND_FUNCTION_MAX:
+			column = "value_max";
+			break;
+		case ZBX_TREND_FUNCTION_MIN:
+			column = "value_min";
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			return ZBX_TREND_STATE_UNKNOWN;
+	}
 
-		while (NULL != (row = zbx_db_fetch(result)))
+	state = (ZBX_TREND_FUNCTION_COUNT == function ? ZBX_TREND_STATE_NORMAL : ZBX_TREND_STATE_NODATA);
+	*value = 0;
+
+	buckets = (zbx_trends_value_bucket_t *)trends_get_buckets(table, itemid, start, end, column,
+			sizeof(zbx_trends_value_bucket_t), trends_daily_get_cached, trends_daily_add_row, &function,
+			&buckets_num);
+
+	for (i = 0; i < buckets_num; i++)
+	{
+		zbx_trends_value_bucket_t	*bucket = &buckets[i];
+
+		if (0 == (bucket->period.flags & ZBX_TRENDS_BUCKET_CACHED))
 		{
-			avg2 = atof(row[0]);
-			num2 = atof(row[1]);
-			avg = avg / (num + num2) * num + avg2 / (num + num2) * num2;
-			num += num2;
+			/* count over a period without data is zero */
+			if (ZBX_TREND_FUNCTION_COUNT == function)
+				bucket->state = ZBX_TREND_STATE_NORMAL;
+			else if (ZBX_TREND_STATE_NORMAL != bucket->state)
+				bucket->state = ZBX_TREND_STATE_NODATA;
+
+			if (0 != (bucket->period.flags & ZBX_TRENDS_BUCKET_CACHEABLE))
+			{
+				zbx_tfc_put_value(itemid, bucket->period.start, bucket->period.end, function,
+						bucket->value, bucket->state);
+			}
 		}
 
-		*value = avg;
-		state = ZBX_TREND_STATE_NORMAL;
+		if (ZBX_TREND_STATE_NORMAL != bucket->state)
+			continue;
+
+		if (ZBX_TREND_STATE_NORMAL != state)
+		{
+			*value = bucket->value;
+			state = ZBX_TREND_STATE_NORMAL;
+		}
+		else if (ZBX_TREND_FUNCTION_COUNT == function)
+			*value += bucket->value;
+		else if (ZBX_TREND_FUNCTION_MAX == function ? bucket->value > *value : bucket->value < *value)
+			*value = bucket->value;
 	}
-	else
-		state = ZBX_TREND_STATE_NODATA;
 
-	zbx_db_free_result(result);
+	zbx_free(buckets);
 
 	return state;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: evaluate sum function with trends data                            *
+ * Purpose: evaluate avg function with trends data                            *
  *                                                                            *
  * Parameters: table       - [IN] trends table name                           *
  *             itemid      - [IN]                                             *
@@ -547,45 +890,39 @@ static zbx_trend_state_t	trends_eval_avg(const char *table, zbx_uint64_t itemid,
  * Return value: Trend value state of the specified period and function.      *
  *                                                                            *
  ******************************************************************************/
-static zbx_trend_state_t	trends_eval_sum(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
+static zbx_trend_state_t	trends_eval_avg(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
 		double *value)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	char		*sql = NULL;
-	size_t		sql_alloc = 0, sql_offset = 0;
-	double		sum = 0;
+	zbx_trend_state_t	avg_state, sum_state;
+	double			sum;
 
-	zbx_recalc_time_period(&start, ZBX_RECALC_TIME_PERIOD_TRENDS);
-
-	if (start > end)
-		return ZBX_TREND_STATE_NODATA;
+	trends_eval_avg_sum(table, itemid, start, end, value, &avg_state, &sum, &sum_state);
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select value_avg,num from %s where itemid=" ZBX_FS_UI64,
-			table, itemid);
-
-	if (start != end)
-	{
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and clock>=" ZBX_FS_I64 " and clock<=" ZBX_FS_I64,
-				start, end);
-	}
-	else
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and clock=" ZBX_FS_I64, start);
-
-	result = zbx_db_select("%s", sql);
-	zbx_free(sql);
-
-	while (NULL != (row = zbx_db_fetch(result)))
-		sum += atof(row[0]) * atof(row[1]);
-
-	zbx_db_free_result(result);
+	return avg_state;
+}
 
-	if (ZBX_INFINITY == sum)
-		return ZBX_TREND_STATE_OVERFLOW;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate sum function with trends data                            *
+ *                                                                            *
+ * Parameters: table       - [IN] trends table name                           *
+ *             itemid      - [IN]                                             *
+ *             start       - [OUT] period start time in seconds since Epoch   *
+ *             end         - [OUT] period end time in seconds since Epoch     *
+ *             value       - [OUT] evaluation result                          *
+ *                                                                            *
+ * Return value: Trend value state of the specified period and function.      *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_trend_state_t	trends_eval_sum(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
+		double *value)
+{
+	zbx_trend_state_t	avg_state, sum_state;
+	double			avg;
 
-	*value = sum;
+	trends_eval_avg_sum(table, itemid, start, end, &avg, &avg_state, value, &sum_state);
 
-	return ZBX_TREND_STATE_NORMAL;
+	return sum_state;
 }
 
 int	zbx_trends_eval_avg(const char *table, zbx_uint64_t itemid, time_t start, time_t end, double *value,
@@ -617,12 +954,7 @@ int	zbx_trends_eval_count(const char *table, zbx_uint64_t itemid, time_t start,
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_COUNT, value, &state))
 	{
-		if (ZBX_TREND_STATE_NORMAL != (state = trends_eval(table, itemid, start, end, "num", "sum(num)",
-				value)))
-		{
-			state = ZBX_TREND_STATE_NORMAL;
-			*value = 0;
-		}
+		state = trends_eval_daily(table, itemid, start, end, ZBX_TREND_FUNCTION_COUNT, value);
 
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_COUNT, *value, state);
 	}
@@ -637,7 +969,7 @@ int	zbx_trends_eval_max(const char *table, zbx_uint64_t itemid, time_t start, ti
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_MAX, value, &state))
 	{
-		state = trends_eval(table, itemid, start, end, "value_max", "max(value_max)", value);
+		state = trends_eval_daily(table, itemid, start, end, ZBX_TREND_FUNCTION_MAX, value);
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_MAX, *value, state);
 	}
 
@@ -657,7 +989,7 @@ int	zbx_trends_eval_min(const char *table, zbx_uint64_t itemid, time_t start, ti
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_MIN, value, &state))
 	{
-		state = trends_eval(table, itemid, start, end, "value_min", "min(value_min)", value);
+		state = trends_eval_daily(table, itemid, start, end, ZBX_TREND_FUNCTION_MIN, value);
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_MIN, *value, state);
 	}
 
@@ -704,6 +1036,186 @@ zbx_trend_state_t	zbx_trends_get_avg(const char *table, zbx_uint64_t itemid, tim
 	return state;
 }
 
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	double		value;
+	double		num;
+}
+zbx_trends_prefetch_value_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate trend function for multiple items with single query and  *
+ *          store the results in trend function cache                         *
+ *                                                                            *
+ * Parameters: table    - [IN] trends table name                              *
+ *             function - [IN] trend function name without 'trend' prefix     *
+ *             start    - [IN] period start time in seconds since Epoch       *
+ *             end      - [IN] period end time in seconds since Epoch         *
+ *             itemids  - [IN] items to evaluate the function for             *
+ *                                                                            *
+ * Comments: Items already having cached function value over the period are   *
+ *           skipped. The avg and sum values are calculated from the fetched  *
+ *           hourly records in the same way as for single item evaluation.    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_trends_prefetch(const char *table, const char *function, time_t start, time_t end,
+		const zbx_vector_uint64_t *itemids)
+{
+	zbx_trend_function_t		trend_function;
+	zbx_vector_uint64_t		missing;
+	zbx_hashset_t			values;
+	zbx_hashset_iter_t		iter;
+	zbx_trends_prefetch_value_t	*value, value_local;
+	zbx_db_result_t			result;
+	zbx_db_row_t			row;
+	char				*sql = NULL;
+	size_t				sql_alloc = 0, sql_offset = 0;
+	const char			*expression;
+	time_t				query_start = start;
+	int				i;
+
+	if (0 == strcmp(function, "avg"))
+	{
+		trend_function = ZBX_TREND_FUNCTION_AVG;
+		expression = "value_avg,num";
+	}
+	else if (0 == strcmp(function, "count"))
+	{
+		trend_function = ZBX_TREND_FUNCTION_COUNT;
+		expression = "sum(num)";
+	}
+	else if (0 == strcmp(function, "max"))
+	{
+		trend_function = ZBX_TREND_FUNCTION_MAX;
+		expression = "max(value_max)";
+	}
+	else if (0 == strcmp(function, "min"))
+	{
+		trend_function = ZBX_TREND_FUNCTION_MIN;
+		expression = "min(value_min)";
+	}
+	else if (0 == strcmp(function, "sum"))
+	{
+		trend_function = ZBX_TREND_FUNCTION_SUM;
+		expression = "value_avg,num";
+	}
+	else
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() %s:%s itemids_num:%d", __func__, table, function, itemids->values_num);
+
+	zbx_vector_uint64_create(&missing);
+
+	if (SUCCEED != zbx_tfc_get_missing(itemids, start, end, trend_function, &missing) ||
+			2 > missing.values_num)
+	{
+		/* nothing to gain from batching when cache is disabled or single item must be evaluated */
+		goto out;
+	}
+
+	zbx_recalc_time_period(&query_start, ZBX_RECALC_TIME_PERIOD_TRENDS);
+
+	if (query_start > end)
+		goto out;
+
+	zbx_vector_uint64_sort(&missing, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(&missing, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	zbx_hashset_create(&values, (size_t)missing.values_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select itemid,%s from %s"
+			" where clock>=" ZBX_FS_I64
+				" and clock<=" ZBX_FS_I64
+				" and",
+			expression, table, query_start, end);
+
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", missing.values, missing.values_num);
+
+	if (ZBX_TREND_FUNCTION_AVG != trend_function && ZBX_TREND_FUNCTION_SUM != trend_function)
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " group by itemid");
+
+	result = zbx_db_select("%s", sql);
+	zbx_free(sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		double	avg, num;
+
+		ZBX_STR2UINT64(value_local.itemid, row[0]);
+
+		if (ZBX_TREND_FUNCTION_AVG != trend_function && ZBX_TREND_FUNCTION_SUM != trend_function)
+		{
+			if (SUCCEED == zbx_db_is_null(row[1]))
+				continue;
+
+			value_local.value = atof(row[1]);
+			zbx_hashset_insert(&values, &value_local, sizeof(value_local));
+			continue;
+		}
+
+		avg = atof(row[1]);
+		num = atof(row[2]);
+
+		if (NULL == (value = (zbx_trends_prefetch_value_t *)zbx_hashset_search(&values, &value_local)))
+		{
+			value_local.value = (ZBX_TREND_FUNCTION_AVG == trend_function ? avg : avg * num);
+			value_local.num = num;
+			zbx_hashset_insert(&values, &value_local, sizeof(value_local));
+			continue;
+		}
+
+		if (ZBX_TREND_FUNCTION_AVG == trend_function)
+		{
+			value->value = value->value / (value->num + num) * value->num + avg / (value->num + num) * num;
+			value->num += num;
+		}
+		else
+			value->value += avg * num;
+	}
+
+	zbx_db_free_result(result);
+
+	zbx_hashset_iter_reset(&values, &iter);
+	while (NULL != (value = (zbx_trends_prefetch_value_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_trend_state_t	state = ZBX_TREND_STATE_NORMAL;
+
+		if (ZBX_TREND_FUNCTION_SUM == trend_function && ZBX_INFINITY == value->value)
+			state = ZBX_TREND_STATE_OVERFLOW;
+
+		zbx_tfc_put_value(value->itemid, start, end, trend_function, value->value, state);
+	}
+
+	/* store results for items without trends data in the period */
+	for (i = 0; i < missing.values_num; i++)
+	{
+		if (NULL != zbx_hashset_search(&values, &missing.values[i]))
+			continue;
+
+		switch (trend_function)
+		{
+			case ZBX_TREND_FUNCTION_COUNT:
+			case ZBX_TREND_FUNCTION_SUM:
+				zbx_tfc_put_value(missing.values[i], start, end, trend_function, 0,
+						ZBX_TREND_STATE_NORMAL);
+				break;
+			default:
+				zbx_tfc_put_value(missing.values[i], start, end, trend_function, 0,
+						ZBX_TREND_STATE_NODATA);
+		}
+	}
+
+	zbx_hashset_destroy(&values);
+out:
+	zbx_vector_uint64_destroy(&missing);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
 const char	*zbx_trends_error(zbx_trend_state_t state)
 {
 	if (0 > state || state >= ZBX_TREND_STATE_COUNT)
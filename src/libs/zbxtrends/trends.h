@@ -19,6 +19,7 @@
 
 #include "zbxtrends.h"
 #include "zbxtypes.h"
+#include "zbxalgo.h"
 
 #ifndef ZABBIX_TRENDS_H
 #define ZABBIX_TRENDS_H
@@ -49,6 +50,8 @@ int	zbx_tfc_get_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_f
 		zbx_trend_state_t *state);
 void	zbx_tfc_put_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function, double value,
 		zbx_trend_state_t state);
+int	zbx_tfc_get_missing(const zbx_vector_uint64_t *itemids, time_t start, time_t end,
+		zbx_trend_function_t function, zbx_vector_uint64_t *missing);
 const char	*zbx_trends_error(zbx_trend_state_t state);
 zbx_trend_state_t	zbx_trends_get_avg(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
 		double *value);
@@ -270,25 +270,27 @@ static int	variant_to_ui64(zbx_variant_t *value)
 
 static int	variant_to_str(zbx_variant_t *value)
 {
-	char	*value_str, buffer[ZBX_MAX_DOUBLE_LEN + 1];
+	char	buffer[MAX(ZBX_MAX_DOUBLE_LEN, ZBX_MAX_UINT64_LEN) + 1];
 
+	/* format into stack buffer and allocate only the resulting length, */
+	/* zbx_dsprintf() would allocate a large buffer for every number    */
 	switch (value->type)
 	{
 		case ZBX_VARIANT_STR:
 			return SUCCEED;
 		case ZBX_VARIANT_DBL:
-			value_str = zbx_strdup(NULL, zbx_print_double(buffer, sizeof(buffer), value->data.dbl));
-			zbx_del_zeros(value_str);
+			zbx_print_double(buffer, sizeof(buffer), value->data.dbl);
+			zbx_del_zeros(buffer);
 			break;
 		case ZBX_VARIANT_UI64:
-			value_str = zbx_dsprintf(NULL, ZBX_FS_UI64, value->data.ui64);
+			zbx_snprintf(buffer, sizeof(buffer), ZBX_FS_UI64, value->data.ui64);
 			break;
 		default:
 			return FAIL;
 	}
 
 	zbx_variant_clear(value);
-	zbx_variant_set_str(value, value_str);
+	zbx_variant_set_str(value, zbx_strdup(NULL, buffer));
 
 	return SUCCEED;
 }
@@ -255,47 +255,90 @@ void zbx_xml_escape_xpath(char **data)
 	*data = buffer;
 }
 
+#ifdef HAVE_LIBXML2
 /******************************************************************************
  *                                                                            *
- * Purpose: execute xpath query                                               *
+ * Purpose: parse xml document                                                *
  *                                                                            *
- * Parameters: value  - [IN/OUT] the value to process                         *
- *             params - [IN] the operation parameters                         *
+ * Parameters: data   - [IN] the xml data                                     *
  *             errmsg - [OUT] error message                                   *
  *                                                                            *
- * Return value: SUCCEED - the value was processed successfully               *
- *               FAIL - otherwise                                             *
+ * Return value: The parsed document or NULL on error. The document must be   *
+ *               freed with xmlFreeDoc().                                     *
  *                                                                            *
  ******************************************************************************/
-int	zbx_query_xpath(zbx_variant_t *value, const char *params, char **errmsg)
+xmlDoc	*zbx_xml_doc_parse(const char *data, char **errmsg)
 {
-#ifndef HAVE_LIBXML2
-	ZBX_UNUSED(value);
-	ZBX_UNUSED(params);
-	*errmsg = zbx_dsprintf(*errmsg, "Zabbix was compiled without libxml2 support");
-	return FAIL;
-#else
-	int		i, ret = FAIL;
-	char		buffer[32], *ptr;
-	xmlDoc		*doc = NULL;
-	xmlXPathContext	*xpathCtx;
-	xmlXPathObject	*xpathObj;
-	xmlNodeSetPtr	nodeset;
+	xmlDoc		*doc;
 	xmlErrorPtr	pErr;
-	xmlBufferPtr	xmlBufferLocal;
 
-	if (NULL == (doc = xmlReadMemory(value->data.str, strlen(value->data.str), "noname.xml", NULL, 0)))
+	if (NULL == (doc = xmlReadMemory(data, strlen(data), "noname.xml", NULL, 0)))
 	{
 		if (NULL != (pErr = xmlGetLastError()))
 			*errmsg = zbx_dsprintf(*errmsg, "cannot parse xml value: %s", pErr->message);
 		else
 			*errmsg = zbx_strdup(*errmsg, "cannot parse xml value");
-		return FAIL;
 	}
 
+	return doc;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compile xpath expression                                          *
+ *                                                                            *
+ * Parameters: xpath  - [IN] the xpath expression                             *
+ *             errmsg - [OUT] error message                                   *
+ *                                                                            *
+ * Return value: The compiled expression or NULL on error. The expression     *
+ *               must be freed with xmlXPathFreeCompExpr().                   *
+ *                                                                            *
+ ******************************************************************************/
+xmlXPathCompExpr	*zbx_xml_xpath_compile(const char *xpath, char **errmsg)
+{
+	xmlXPathCompExpr	*comp;
+	xmlErrorPtr		pErr;
+
+	if (NULL == (comp = xmlXPathCompile((const xmlChar *)xpath)))
+	{
+		if (NULL != (pErr = xmlGetLastError()))
+			*errmsg = zbx_dsprintf(*errmsg, "cannot parse xpath: %s", pErr->message);
+		else
+			*errmsg = zbx_strdup(*errmsg, "cannot parse xpath");
+	}
+
+	return comp;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute compiled xpath query on parsed xml document               *
+ *                                                                            *
+ * Parameters: doc    - [IN] the parsed xml document                          *
+ *             xpath  - [IN] the compiled xpath expression                    *
+ *             value  - [OUT] the query result                                *
+ *             errmsg - [OUT] error message                                   *
+ *                                                                            *
+ * Return value: SUCCEED - the query was executed successfully                *
+ *               FAIL - otherwise                                             *
+ *                                                                            *
+ * Comments: The document is not modified, so the same document can be       *
+ *           queried by several threads.                                      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_query_xpath_doc(xmlDoc *doc, xmlXPathCompExpr *xpath, zbx_variant_t *value, char **errmsg)
+{
+	int		i, ret = FAIL;
+	char		buffer[32], *ptr;
+	xmlXPathContext	*xpathCtx;
+	xmlXPathObject	*xpathObj;
+	xmlNodeSetPtr	nodeset;
+	xmlErrorPtr	pErr;
+	xmlBufferPtr	xmlBufferLocal;
+
 	xpathCtx = xmlXPathNewContext(doc);
 
-	if (NULL == (xpathObj = xmlXPathEvalExpression((const xmlChar *)params, xpathCtx)))
+	if (NULL == (xpathObj = xmlXPathCompiledEval(xpath, xpathCtx)))
 	{
 		if (NULL != (pErr = xmlGetLastError()))
 			*errmsg = zbx_dsprintf(*errmsg, "cannot parse xpath: %s", pErr->message);
@@ -357,6 +400,44 @@ int	zbx_query_xpath(zbx_variant_t *value, const char *params, char **errmsg)
 out:
 	xmlXPathFreeObject(xpathObj);
 	xmlXPathFreeContext(xpathCtx);
+
+	return ret;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute xpath query                                               *
+ *                                                                            *
+ * Parameters: value  - [IN/OUT] the value to process                         *
+ *             params - [IN] the operation parameters                         *
+ *             errmsg - [OUT] error message                                   *
+ *                                                                            *
+ * Return value: SUCCEED - the value was processed successfully               *
+ *               FAIL - otherwise                                             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_query_xpath(zbx_variant_t *value, const char *params, char **errmsg)
+{
+#ifndef HAVE_LIBXML2
+	ZBX_UNUSED(value);
+	ZBX_UNUSED(params);
+	*errmsg = zbx_dsprintf(*errmsg, "Zabbix was compiled without libxml2 support");
+	return FAIL;
+#else
+	int			ret = FAIL;
+	xmlDoc			*doc;
+	xmlXPathCompExpr	*xpath;
+
+	if (NULL == (doc = zbx_xml_doc_parse(value->data.str, errmsg)))
+		return FAIL;
+
+	if (NULL != (xpath = zbx_xml_xpath_compile(params, errmsg)))
+	{
+		ret = zbx_query_xpath_doc(doc, xpath, value, errmsg);
+		xmlXPathFreeCompExpr(xpath);
+	}
+
 	xmlFreeDoc(doc);
 
 	return ret;
@@ -27,6 +27,7 @@
 #include "zbxlog.h"
 #include "zbxsysinfo.h"
 #include "zbxcommshigh.h"
+#include "zbxcompress.h"
 #include "zbxthreads.h"
 #include "zbxcrypto.h"
 #include "zbxjson.h"
@@ -108,6 +109,12 @@ static ZBX_THREAD_LOCAL zbx_vector_pre_persistent_t	pre_persistent_vec;	/* used
 /* used for deleting inactive persistent files */
 static ZBX_THREAD_LOCAL zbx_vector_persistent_inactive_t	persistent_inactive_vec;
 
+/* compression method for agent data, zstd is used only if the server announced it in active checks response */
+static ZBX_THREAD_LOCAL int					compress_method = ZBX_COMPRESS_METHOD_ZLIB;
+
+/* smaller agent data messages are sent uncompressed */
+#define ZBX_AGENT_DATA_COMPRESS_MIN	1024
+
 typedef struct
 {
 	zbx_uint64_t	id;
@@ -481,6 +488,8 @@ static int	parse_list_of_checks(char *str, const char *host, unsigned short port
 		goto out;
 	}
 
+	compress_method = zbx_get_compression_method(&jp);
+
 	if (FAIL == zbx_json_value_by_name(&jp, ZBX_PROTO_TAG_CONFIG_REVISION, tmp, sizeof(tmp), NULL))
 	{
 		config_revision = 0;
@@ -898,6 +907,7 @@ static int	refresh_active_checks(zbx_vector_addr_ptr_t *addrs, const zbx_config_
 
 	zbx_json_adduint64(&json, ZBX_PROTO_TAG_CONFIG_REVISION, (zbx_uint64_t)*config_revision_local);
 	zbx_json_addstring(&json, ZBX_PROTO_TAG_SESSION, session_token, ZBX_JSON_TYPE_STRING);
+	zbx_json_add_compression(&json);
 
 	level = SUCCEED != last_ret ? LOG_LEVEL_DEBUG : LOG_LEVEL_WARNING;
 
@@ -1178,6 +1188,7 @@ static int	send_buffer(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_persistent_t
 		int config_buffer_send, int config_buffer_size)
 {
 	int			ret = SUCCEED, ret_metrics, ret_commands, now, level;
+	unsigned char		protocol;
 	zbx_timespec_t		ts;
 	zbx_socket_t		s;
 	struct zbx_json		json;
@@ -1209,7 +1220,15 @@ static int	send_buffer(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_persistent_t
 
 		zabbix_log(LOG_LEVEL_DEBUG, "JSON before sending [%s]", json.buffer);
 
-		if (SUCCEED == (ret = zbx_tcp_send(&s, json.buffer)))
+		if (ZBX_AGENT_DATA_COMPRESS_MIN <= json.buffer_size &&
+				SUCCEED == zbx_compress_method_supported(compress_method))
+		{
+			protocol = zbx_compress_method_protocol(compress_method);
+		}
+		else
+			protocol = ZBX_TCP_PROTOCOL;
+
+		if (SUCCEED == (ret = zbx_tcp_send_ext(&s, json.buffer, json.buffer_size, 0, protocol, 0)))
 		{
 			if (SUCCEED == (ret = zbx_tcp_recv(&s)))
 			{
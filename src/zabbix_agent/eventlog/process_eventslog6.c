@@ -665,25 +665,26 @@ cleanup:
  *                                                                            *
  * Parameters: wsource        - [IN] Event Log file name                      *
  *             render_context - [IN] handle to rendering context              *
- *             event_bookmark - [IN/OUT] handle of Event record for parsing   *
+ *             event_bookmark - [IN] handle of Event record for parsing       *
  *             which          - [IN/OUT] position of Event Log record         *
+ *             out_content    - [OUT] rendered values of Event record, must   *
+ *                                    be freed by caller                      *
  *             ...            - [OUT] ELR detail                              *
- *             prov_meta      - [IN/OUT] provider metadata cache              *
  *             error          - [OUT] error message in case of failure        *
  *                                                                            *
  * Return value: SUCCEED or FAIL                                              *
  *                                                                            *
+ * Comments: Event message is not formatted here, it is done by               *
+ *           zbx_get_eventlog_message6() only for records that pass other     *
+ *           filters.                                                         *
+ *                                                                            *
  ******************************************************************************/
 static int	zbx_parse_eventlog_message6(const wchar_t *wsource, EVT_HANDLE *render_context,
-		EVT_HANDLE *event_bookmark, zbx_uint64_t *which, unsigned short *out_severity,
-		unsigned long *out_timestamp, char **out_provider, char **out_source, char **out_message,
-		unsigned long *out_eventid, zbx_uint64_t *out_keywords, zbx_vector_prov_meta_t *prov_meta,
-		int gather_evt_msg, char **error)
+		EVT_HANDLE *event_bookmark, zbx_uint64_t *which, EVT_VARIANT **out_content,
+		unsigned short *out_severity, unsigned long *out_timestamp, char **out_provider, char **out_source,
+		unsigned long *out_eventid, zbx_uint64_t *out_keywords, char **error)
 {
-#define EVT_VARIANT_TYPE_ARRAY	128
-#define EVT_VARIANT_TYPE_MASK	0x7f
 	EVT_VARIANT*		renderedContent = NULL;
-	const wchar_t		*pprovider = NULL;
 	char			*tmp_str = NULL;
 	DWORD			size = 0, bookmarkedCount = 0, require = 0, error_code;
 	const zbx_uint64_t	sec_1970 = 116444736000000000, success_audit = 0x20000000000000,
@@ -710,12 +711,12 @@ static int	zbx_parse_eventlog_message6(const wchar_t *wsource, EVT_HANDLE *rende
 				&require, &bookmarkedCount))
 		{
 			*error = zbx_dsprintf(*error, "EvtRender failed: %s", zbx_strerror_from_system(GetLastError()));
+			zbx_free(renderedContent);
 			goto out;
 		}
 	}
 
-	pprovider = VAR_PROVIDER_NAME(renderedContent);
-	*out_provider = zbx_unicode_to_utf8(pprovider);
+	*out_provider = zbx_unicode_to_utf8(VAR_PROVIDER_NAME(renderedContent));
 	*out_source = NULL;
 
 	if (NULL != VAR_SOURCE_NAME(renderedContent))
@@ -728,78 +729,92 @@ static int	zbx_parse_eventlog_message6(const wchar_t *wsource, EVT_HANDLE *rende
 	*out_timestamp = (unsigned long)((VAR_TIME_CREATED(renderedContent) - sec_1970) / 10000000);
 	*out_eventid = VAR_EVENT_ID(renderedContent);
 
-	if (1 == gather_evt_msg)
-		*out_message = expand_message6(pprovider, *event_bookmark, prov_meta);
-	else
-		*out_message = zbx_strdup(NULL, "");
-
-	if (NULL != *out_message)
-		replace_sids_to_accounts(*event_bookmark, out_message);
-
-	tmp_str = zbx_unicode_to_utf8(wsource);
-
 	if (VAR_RECORD_NUMBER(renderedContent) != *which)
 	{
+		tmp_str = zbx_unicode_to_utf8(wsource);
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() Overwriting expected EventRecordID:" ZBX_FS_UI64 " with the real"
 				" EventRecordID:" ZBX_FS_UI64 " in eventlog '%s'", __func__, *which,
 				VAR_RECORD_NUMBER(renderedContent), tmp_str);
 		*which = VAR_RECORD_NUMBER(renderedContent);
 	}
 
+	*out_content = renderedContent;
+
+	ret = SUCCEED;
+out:
+	zbx_free(tmp_str);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: formats message of parsed Event Log record                        *
+ *                                                                            *
+ * Parameters: event_bookmark  - [IN] handle of Event record                  *
+ *             renderedContent - [IN] rendered values of Event record         *
+ *             eventid         - [IN] Event ID                                *
+ *             provider        - [IN] Event provider name                     *
+ *             prov_meta       - [IN/OUT] provider metadata cache             *
+ *                                                                            *
+ * Return value: formatted message, must be freed by caller                   *
+ *                                                                            *
+ ******************************************************************************/
+static char	*zbx_get_eventlog_message6(EVT_HANDLE event_bookmark, const EVT_VARIANT *renderedContent,
+		unsigned long eventid, const char *provider, zbx_vector_prov_meta_t *prov_meta)
+{
+#define EVT_VARIANT_TYPE_ARRAY	128
+#define EVT_VARIANT_TYPE_MASK	0x7f
+	char	*message;
+
+	if (NULL != (message = expand_message6(VAR_PROVIDER_NAME(renderedContent), event_bookmark, prov_meta)))
+	{
+		replace_sids_to_accounts(event_bookmark, &message);
+		return message;
+	}
+
 	/* some events don't have enough information for making event message */
-	if (NULL == *out_message)
+	message = zbx_dsprintf(NULL, "The description for Event ID:%lu in Source:'%s'"
+			" cannot be found. Either the component that raises this event is not installed"
+			" on your local computer or the installation is corrupted. You can install or repair"
+			" the component on the local computer. If the event originated on another computer,"
+			" the display information had to be saved with the event.", eventid,
+			NULL == provider ? "" : provider);
+
+	if (EvtVarTypeString == (VAR_EVENT_DATA_TYPE(renderedContent) & EVT_VARIANT_TYPE_MASK))
 	{
-		*out_message = zbx_strdcatf(*out_message, "The description for Event ID:%lu in Source:'%s'"
-				" cannot be found. Either the component that raises this event is not installed"
-				" on your local computer or the installation is corrupted. You can install or repair"
-				" the component on the local computer. If the event originated on another computer,"
-				" the display information had to be saved with the event.", *out_eventid,
-				NULL == *out_provider ? "" : *out_provider);
-		if (EvtVarTypeString == (VAR_EVENT_DATA_TYPE(renderedContent) & EVT_VARIANT_TYPE_MASK))
+		unsigned int	i;
+		char		*data = NULL;
+
+		if (0 != (VAR_EVENT_DATA_TYPE(renderedContent) & EVT_VARIANT_TYPE_ARRAY) &&
+			0 < VAR_EVENT_DATA_COUNT(renderedContent))
 		{
-			unsigned int	i;
-			char		*data = NULL;
+			message = zbx_strdcatf(message, " The following information was included with the event: ");
 
-			if (0 != (VAR_EVENT_DATA_TYPE(renderedContent) & EVT_VARIANT_TYPE_ARRAY) &&
-				0 < VAR_EVENT_DATA_COUNT(renderedContent))
+			for (i = 0; i < VAR_EVENT_DATA_COUNT(renderedContent); i++)
 			{
-				*out_message = zbx_strdcatf(*out_message, " The following information was included"
-						" with the event: ");
-
-				for (i = 0; i < VAR_EVENT_DATA_COUNT(renderedContent); i++)
+				if (NULL != VAR_EVENT_DATA_STRING_ARRAY(renderedContent, i))
 				{
-					if (NULL != VAR_EVENT_DATA_STRING_ARRAY(renderedContent, i))
-					{
-						if (0 < i)
-							*out_message = zbx_strdcat(*out_message, "; ");
+					if (0 < i)
+						message = zbx_strdcat(message, "; ");
 
-						data = zbx_unicode_to_utf8(VAR_EVENT_DATA_STRING_ARRAY(renderedContent,
-								i));
-						*out_message = zbx_strdcatf(*out_message, "%s", data);
-						zbx_free(data);
-					}
+					data = zbx_unicode_to_utf8(VAR_EVENT_DATA_STRING_ARRAY(renderedContent, i));
+					message = zbx_strdcatf(message, "%s", data);
+					zbx_free(data);
 				}
 			}
-			else if (NULL != VAR_EVENT_DATA_STRING(renderedContent))
-			{
-				data = zbx_unicode_to_utf8(VAR_EVENT_DATA_STRING(renderedContent));
-				*out_message = zbx_strdcatf(*out_message, "The following information was included"
-						" with the event: %s", data);
-				zbx_free(data);
-			}
+		}
+		else if (NULL != VAR_EVENT_DATA_STRING(renderedContent))
+		{
+			data = zbx_unicode_to_utf8(VAR_EVENT_DATA_STRING(renderedContent));
+			message = zbx_strdcatf(message, "The following information was included with the event: %s",
+					data);
+			zbx_free(data);
 		}
 	}
 
-	ret = SUCCEED;
-out:
-	EvtClose(*event_bookmark);
-	*event_bookmark = NULL;
-
-	zbx_free(tmp_str);
-	zbx_free(renderedContent);
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
-
-	return ret;
+	return message;
 #undef EVT_VARIANT_TYPE_ARRAY
 #undef EVT_VARIANT_TYPE_MASK
 }
@@ -867,6 +882,7 @@ int	process_eventslog6(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_re
 	char		*evt_provider, *evt_source, *evt_message, str_logeventid[8];
 	unsigned short	evt_severity;
 	EVT_HANDLE	event_bookmarks[EVT_ARRAY_SIZE];
+	EVT_VARIANT	*evt_content = NULL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() source: '%s' previous lastlogsize: " ZBX_FS_UI64 ", FirstID: "
 			ZBX_FS_UI64 ", LastID: " ZBX_FS_UI64, __func__, eventlog_name, lastlogsize, FirstID,
@@ -927,10 +943,11 @@ int	process_eventslog6(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_re
 				gather_evt_msg = 0;
 
 			lastlogsize += 1;
+			evt_message = NULL;
 
 			if (SUCCEED != zbx_parse_eventlog_message6(eventlog_name_w, render_context, &event_bookmarks[i],
-					&lastlogsize, &evt_severity, &evt_timestamp, &evt_provider, &evt_source,
-					&evt_message, &evt_eventid, &keywords, prov_meta, gather_evt_msg, error))
+					&lastlogsize, &evt_content, &evt_severity, &evt_timestamp, &evt_provider,
+					&evt_source, &evt_eventid, &keywords, error))
 			{
 				goto out;
 			}
@@ -984,6 +1001,15 @@ int	process_eventslog6(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_re
 				int	ret1 = ZBX_REGEXP_NO_MATCH, ret2 = ZBX_REGEXP_NO_MATCH,
 					ret3 = ZBX_REGEXP_NO_MATCH, ret4 = ZBX_REGEXP_NO_MATCH;
 
+				/* the first record also validates all regular expressions, so message is needed */
+				if (1 == gather_evt_msg)
+				{
+					evt_message = zbx_get_eventlog_message6(event_bookmarks[i], evt_content,
+							evt_eventid, evt_provider, prov_meta);
+				}
+				else
+					evt_message = zbx_strdup(NULL, "");
+
 				if (FAIL == (ret1 = zbx_regexp_match_ex(regexps, evt_message, pattern,
 						ZBX_CASE_SENSITIVE)))
 				{
@@ -1030,14 +1056,28 @@ int	process_eventslog6(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_re
 			}
 			else
 			{
-				match = ZBX_REGEXP_MATCH == zbx_regexp_match_ex(regexps, evt_message, pattern,
-							ZBX_CASE_SENSITIVE) &&
-						ZBX_REGEXP_MATCH == zbx_regexp_match_ex(regexps, str_severity,
-							key_severity, ZBX_IGNORE_CASE) &&
+				/* formatting message and resolving SIDs is the most expensive part of */
+				/* processing, so it is done only for records matching other filters   */
+				match = ZBX_REGEXP_MATCH == zbx_regexp_match_ex(regexps, str_severity, key_severity,
+							ZBX_IGNORE_CASE) &&
 						ZBX_REGEXP_MATCH == zbx_regexp_match_ex(regexps, evt_provider,
 							key_source, ZBX_IGNORE_CASE) &&
 						ZBX_REGEXP_MATCH == zbx_regexp_match_ex(regexps, str_logeventid,
 							key_logeventid, ZBX_CASE_SENSITIVE);
+
+				if (1 == match)
+				{
+					if (1 == gather_evt_msg)
+					{
+						evt_message = zbx_get_eventlog_message6(event_bookmarks[i],
+								evt_content, evt_eventid, evt_provider, prov_meta);
+					}
+					else
+						evt_message = zbx_strdup(NULL, "");
+
+					match = ZBX_REGEXP_MATCH == zbx_regexp_match_ex(regexps, evt_message,
+							pattern, ZBX_CASE_SENSITIVE);
+				}
 			}
 
 			if (1 == match)
@@ -1065,6 +1105,10 @@ int	process_eventslog6(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_re
 			zbx_free(evt_source);
 			zbx_free(evt_provider);
 			zbx_free(evt_message);
+			zbx_free(evt_content);
+
+			EvtClose(event_bookmarks[i]);
+			event_bookmarks[i] = NULL;
 
 			if (EVT_LOG_ITEM == evt_item_type)
 			{
@@ -1118,6 +1162,7 @@ out:
 			EvtClose(event_bookmarks[i]);
 	}
 
+	zbx_free(evt_content);
 	zbx_free(eventlog_name_w);
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s last eventid:%lu", __func__, zbx_result_string(ret), evt_eventid);
 
@@ -1775,6 +1775,90 @@ static int	compile_filename_regexp(const char *filename_regexp, zbx_regexp_t **r
 	return SUCCEED;
 }
 
+#if !defined(_WINDOWS) && !defined(__MINGW32__)
+static zbx_hash_t	logfile_ino_hash(const void *data)
+{
+	const struct st_logfile	*logfile = *(const struct st_logfile * const *)data;
+	zbx_hash_t		hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&logfile->dev);
+
+	return ZBX_DEFAULT_UINT64_HASH_ALGO(&logfile->ino_lo, sizeof(logfile->ino_lo), hash);
+}
+
+static int	logfile_ino_compare(const void *d1, const void *d2)
+{
+	const struct st_logfile	*logfile1 = *(const struct st_logfile * const *)d1;
+	const struct st_logfile	*logfile2 = *(const struct st_logfile * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(logfile1->dev, logfile2->dev);
+	ZBX_RETURN_IF_NOT_EQUAL(logfile1->ino_lo, logfile2->ino_lo);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copy MD5 sums from the old list for files that have not changed   *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     logfiles         - [IN/OUT] list of log files                          *
+ *     logfiles_num     - [IN] number of elements in 'logfiles'               *
+ *     logfiles_old     - [IN] list of log files from the previous check      *
+ *     logfiles_num_old - [IN] number of elements in 'logfiles_old'           *
+ *                                                                            *
+ * Comments: A file with the same device, inode, size and modification time   *
+ *           as in the previous check is assumed to have the same content, so *
+ *           it is not opened and hashed again. The old MD5 sums must also    *
+ *           cover exactly the current file size. MD5 sums of files which are *
+ *           not found are left uninitialized ('md5_block_size' is -1).       *
+ *                                                                            *
+ ******************************************************************************/
+static void	copy_unchanged_file_md5(struct st_logfile *logfiles, int logfiles_num,
+		const struct st_logfile *logfiles_old, int logfiles_num_old)
+{
+	zbx_hashset_t		index;
+	int			i;
+
+	if (0 == logfiles_num_old || 0 == logfiles_num)
+		return;
+
+	zbx_hashset_create(&index, (size_t)logfiles_num_old, logfile_ino_hash, logfile_ino_compare);
+
+	for (i = 0; i < logfiles_num_old; i++)
+	{
+		const struct st_logfile	*old = logfiles_old + i;
+
+		if (-1 != old->md5_block_size)
+			zbx_hashset_insert(&index, &old, sizeof(old));
+	}
+
+	for (i = 0; i < logfiles_num; i++)
+	{
+		struct st_logfile		*p = logfiles + i;
+		const struct st_logfile		**old;
+
+		if (NULL == (old = (const struct st_logfile **)zbx_hashset_search(&index, &p)))
+			continue;
+
+		if ((*old)->size != p->size || (*old)->mtime != p->mtime)
+			continue;
+
+		/* 'size' in the old list can be advanced to 'lastlogsize' after processing, reuse */
+		/* MD5 sums only if they were calculated for exactly the current file size */
+		if ((*old)->last_block_offset + (size_t)(*old)->md5_block_size != p->size)
+			continue;
+
+		p->md5_block_size = (*old)->md5_block_size;
+		p->last_block_offset = (*old)->last_block_offset;
+		memcpy(p->first_block_md5, (*old)->first_block_md5, sizeof(p->first_block_md5));
+		memcpy(p->last_block_md5, (*old)->last_block_md5, sizeof(p->last_block_md5));
+	}
+
+	zbx_hashset_destroy(&index);
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: fill-in MD5 sums, device and inode numbers for files in the list  *
@@ -1806,6 +1890,10 @@ static int	fill_file_details(struct st_logfile *logfiles, int logfiles_num, char
 		int			f;
 		struct st_logfile	*p = logfiles + i;
 
+#if !defined(_WINDOWS) && !defined(__MINGW32__)
+		if (-1 != p->md5_block_size)	/* copied from the previous check */
+			continue;
+#endif
 		if (-1 == (f = open_file_helper(p->filename, err_msg)))
 			return FAIL;
 
@@ -1851,6 +1939,9 @@ clean:
  *                      or logrt.count                                        *
  *     filename       - [IN] logfile name (regular expression with a path)    *
  *     mtime          - [IN] last modification time of the file               *
+ *     logfiles_old   - [IN] list of logfiles from the previous check, MD5    *
+ *                      sums of unchanged files are taken from it             *
+ *     logfiles_num_old - [IN] number of elements in 'logfiles_old'           *
  *     logfiles       - [IN/OUT] pointer to the list of logfiles              *
  *     logfiles_alloc - [IN/OUT] number of logfiles memory was allocated for  *
  *     logfiles_num   - [IN/OUT] number of already inserted logfiles          *
@@ -1866,7 +1957,8 @@ clean:
  *                                                                            *
  ******************************************************************************/
 static int	make_logfile_list(unsigned char flags, const char *filename, int mtime,
-		struct st_logfile **logfiles, int *logfiles_alloc, int *logfiles_num, int *use_ino, char **err_msg)
+		const struct st_logfile *logfiles_old, int logfiles_num_old, struct st_logfile **logfiles,
+		int *logfiles_alloc, int *logfiles_num, int *use_ino, char **err_msg)
 {
 	int	ret = SUCCEED;
 
@@ -1962,8 +2054,12 @@ clean1:
 	}
 
 #if defined(_WINDOWS) || defined(__MINGW32__)
+	ZBX_UNUSED(logfiles_old);
+	ZBX_UNUSED(logfiles_num_old);
+
 	ret = fill_file_details(*logfiles, *logfiles_num, *use_ino, err_msg);
 #else
+	copy_unchanged_file_md5(*logfiles, *logfiles_num, logfiles_old, logfiles_num_old);
 	ret = fill_file_details(*logfiles, *logfiles_num, err_msg);
 #endif
 clean:
@@ -1973,6 +2069,11 @@ clean:
 	return	ret;
 }
 
+/* bytes below 0x0e (NULL, LF, CR) need attention, everything else is skipped 8 bytes at a time */
+#define BUF_WORD_ONES		__UINT64_C(0x0101010101010101)
+#define BUF_WORD_HIGHS		__UINT64_C(0x8080808080808080)
+#define BUF_WORD_HAS_LESS(x, n)	((((x) - BUF_WORD_ONES * (n)) & ~(x) & BUF_WORD_HIGHS))
+
 static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const char *cr, const char *lf,
 		size_t szbyte)
 {
@@ -1980,6 +2081,21 @@ static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const c
 	{
 		for (; p < p_end; p++)
 		{
+			zbx_uint64_t	word;
+
+			while (p + sizeof(word) <= p_end)
+			{
+				memcpy(&word, p, sizeof(word));
+
+				if (0 != BUF_WORD_HAS_LESS(word, 0xe))
+					break;
+
+				p += sizeof(word);
+			}
+
+			if (p == p_end)
+				break;
+
 			/* detect NULL byte and replace it with '?' character */
 			if (0x0 == *p)
 			{
@@ -2023,6 +2139,14 @@ static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const c
 					*p = '?';
 			}
 
+			/* every byte of LF or CR is either 0x0 or the character code, so characters */
+			/* with no zero or CR/LF bytes can be skipped without comparing them         */
+			if (0xd < (unsigned char)*p && 0xd < (unsigned char)p[1])
+			{
+				p += szbyte;
+				continue;
+			}
+
 			if (0 == memcmp(p, lf, szbyte))		/* LF (Unix) */
 			{
 				*p_next = p + szbyte;
@@ -2048,6 +2172,10 @@ static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const c
 	}
 }
 
+#undef BUF_WORD_ONES
+#undef BUF_WORD_HIGHS
+#undef BUF_WORD_HAS_LESS
+
 static void	log_regexp_runtime_error(const char *key, const char *err_msg, zbx_uint64_t itemid,
 		int *runtime_error_logging_allowed)
 {
@@ -3395,8 +3523,8 @@ static int	process_logrt(unsigned char flags, const char *filename, zbx_uint64_t
 
 	adjust_mtime_to_clock(mtime);
 
-	if (SUCCEED != (res = make_logfile_list(flags, filename, *mtime, &logfiles, &logfiles_alloc, &logfiles_num,
-			use_ino, err_msg)))
+	if (SUCCEED != (res = make_logfile_list(flags, filename, *mtime, *logfiles_old, logfiles_num_old, &logfiles,
+			&logfiles_alloc, &logfiles_num, use_ino, err_msg)))
 	{
 		if (ZBX_NO_FILE_ERROR == res)
 		{
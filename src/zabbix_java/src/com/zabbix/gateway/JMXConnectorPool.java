@@ -0,0 +1,164 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+package com.zabbix.gateway;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.LinkedList;
+import java.util.List;
+import java.util.Map;
+
+import javax.management.remote.JMXConnector;
+import javax.management.remote.JMXServiceURL;
+
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+class JMXConnectorPool
+{
+	private static final Logger logger = LoggerFactory.getLogger(JMXConnectorPool.class);
+
+	// idle connectors older than this are closed instead of being reused
+	private static final long IDLE_TIMEOUT = 60 * 1000;
+
+	private static class IdleConnector
+	{
+		final JMXConnector jmxc;
+		final long lastUsed;
+
+		IdleConnector(JMXConnector jmxc)
+		{
+			this.jmxc = jmxc;
+			this.lastUsed = System.currentTimeMillis();
+		}
+	}
+
+	private static final Map<String, LinkedList<IdleConnector>> pool = new HashMap<String, LinkedList<IdleConnector>>();
+	private static long lastSweep = System.currentTimeMillis();
+
+	static String getKey(JMXServiceURL url, String username, String password)
+	{
+		return url.toString() + '\0' + (null == username ? "" : username) + '\0' +
+				(null == password ? "" : password);
+	}
+
+	// Returns an idle connector for the key that still answers, or null if a new one must be opened.
+	static JMXConnector acquire(String key)
+	{
+		long now = System.currentTimeMillis();
+
+		while (true)
+		{
+			IdleConnector idle;
+
+			synchronized (pool)
+			{
+				LinkedList<IdleConnector> connectors = pool.get(key);
+
+				if (null == connectors)
+					return null;
+
+				idle = connectors.removeFirst();
+
+				if (connectors.isEmpty())
+					pool.remove(key);
+			}
+
+			if (now - idle.lastUsed < IDLE_TIMEOUT)
+			{
+				try
+				{
+					idle.jmxc.getConnectionId();
+					logger.trace("reusing JMX connector for '{}'", idle.jmxc);
+
+					return idle.jmxc;
+				}
+				catch (Exception e)
+				{
+					logger.debug("discarding broken JMX connector: {}", ZabbixException.getRootCauseMessage(e));
+				}
+			}
+
+			close(idle.jmxc);
+		}
+	}
+
+	static void release(String key, JMXConnector jmxc)
+	{
+		List<JMXConnector> expired = null;
+		long now = System.currentTimeMillis();
+
+		synchronized (pool)
+		{
+			LinkedList<IdleConnector> connectors = pool.get(key);
+
+			if (null == connectors)
+			{
+				connectors = new LinkedList<IdleConnector>();
+				pool.put(key, connectors);
+			}
+
+			connectors.addFirst(new IdleConnector(jmxc));
+
+			if (now - lastSweep >= IDLE_TIMEOUT)
+			{
+				expired = removeExpired(now);
+				lastSweep = now;
+			}
+		}
+
+		if (null != expired)
+		{
+			for (JMXConnector c : expired)
+				close(c);
+		}
+	}
+
+	// Must be called with the pool locked. Connectors of endpoints that are no longer polled would
+	// otherwise stay open forever.
+	private static List<JMXConnector> removeExpired(long now)
+	{
+		List<JMXConnector> expired = new ArrayList<JMXConnector>();
+		Iterator<Map.Entry<String, LinkedList<IdleConnector>>> it = pool.entrySet().iterator();
+
+		while (it.hasNext())
+		{
+			LinkedList<IdleConnector> connectors = it.next().getValue();
+
+			// connectors are kept most recently used first
+			while (!connectors.isEmpty() && now - connectors.getLast().lastUsed >= IDLE_TIMEOUT)
+				expired.add(connectors.removeLast().jmxc);
+
+			if (connectors.isEmpty())
+				it.remove();
+		}
+
+		if (!expired.isEmpty())
+			logger.debug("closing {} idle JMX connectors", expired.size());
+
+		return expired;
+	}
+
+	static void close(JMXConnector jmxc)
+	{
+		try { jmxc.close(); } catch (Exception exception) { }
+	}
+}
@@ -94,6 +94,8 @@ class JMXItemChecker extends ItemChecker
 	JSONArray getValues() throws ZabbixException
 	{
 		JSONArray values = new JSONArray();
+		String poolKey = JMXConnectorPool.getKey(url, username, password);
+		boolean reusable = false;
 
 		try
 		{
@@ -104,7 +106,11 @@ class JMXItemChecker extends ItemChecker
 				env.put(JMXConnector.CREDENTIALS, new String[] {username, password});
 			}
 
-			if (!useRMISSLforURLHintCache.containsKey(url.getURLPath()) ||
+			if (null != (jmxc = JMXConnectorPool.acquire(poolKey)))
+			{
+				logger.debug("reusing JMX connection to {}", url);
+			}
+			else if (!useRMISSLforURLHintCache.containsKey(url.getURLPath()) ||
 					!useRMISSLforURLHintCache.get(url.getURLPath()))
 			{
 				try
@@ -140,6 +146,8 @@ class JMXItemChecker extends ItemChecker
 
 			for (String key : keys)
 				values.put(getJSONValue(key));
+
+			reusable = true;
 		}
 		catch (SecurityException e1)
 		{
@@ -170,7 +178,11 @@ class JMXItemChecker extends ItemChecker
 		}
 		finally
 		{
-			try { if (null != jmxc) jmxc.close(); } catch (java.io.IOException exception) { }
+			// keep the connection open for the next request with the same endpoint and credentials
+			if (reusable)
+				JMXConnectorPool.release(poolKey, jmxc);
+			else if (null != jmxc)
+				JMXConnectorPool.close(jmxc);
 
 			jmxc = null;
 			mbsc = null;
@@ -61,6 +61,7 @@
 #include "zbx_rtc_constants.h"
 #include "zbxicmpping.h"
 #include "zbxipcservice.h"
+#include "zbxshmem.h"
 #include "../zabbix_server/ipmi/ipmi_manager.h"
 #include "preproc/preproc_proxy.h"
 #include "zbxdiscovery.h"
@@ -262,6 +263,8 @@ static int	config_vmware_frequency		= 60;
 static int	config_vmware_perf_frequency	= 60;
 static int	config_vmware_timeout		= 10;
 
+static int	config_huge_pages		= 0;
+
 static zbx_uint64_t	config_conf_cache_size		= 8 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_history_cache_size	= 16 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_history_index_cache_size	= 4 * ZBX_MEBIBYTE;
@@ -332,6 +335,7 @@ static char		*config_proxy_buffer_mode_str = NULL;
 static int		config_proxy_buffer_mode	= 0;
 static zbx_uint64_t	config_proxy_memory_buffer_size	= 0;
 static int		config_proxy_memory_buffer_age	= 0;
+static int		config_proxy_memory_buffer_compression	= 0;
 
 /* proxy has no any events processing */
 static const zbx_events_funcs_t	events_cbs = {
@@ -783,6 +787,13 @@ static void	zbx_validate_config(ZBX_TASK_EX *task)
 					" when \"ProxyBufferMode\" is \"memory\" or \"hybrid\"");
 			err = 1;
 		}
+
+		if (0 != config_proxy_memory_buffer_compression)
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "\"ProxyMemoryBufferCompression\" configuration parameter can be set"
+					" only when \"ProxyBufferMode\" is \"memory\" or \"hybrid\"");
+			err = 1;
+		}
 	}
 
 	if (ZBX_PB_MODE_HYBRID != config_proxy_buffer_mode)
@@ -862,6 +873,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	0,			1},
 		{"CacheSize",			&config_conf_cache_size,		TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(64) * ZBX_GIBIBYTE},
+		{"HugePages",			&config_huge_pages,			TYPE_INT,
+			PARM_OPT,	0,			1},
 		{"HistoryCacheSize",		&config_history_cache_size,		TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"HistoryIndexCacheSize",	&config_history_index_cache_size,	TYPE_UINT64,
@@ -1032,6 +1045,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	0,	__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"ProxyMemoryBufferAge",	&config_proxy_memory_buffer_age,	TYPE_INT,
 			PARM_OPT,	0,	SEC_PER_DAY * 10},
+		{"ProxyMemoryBufferCompression",	&config_proxy_memory_buffer_compression,	TYPE_INT,
+			PARM_OPT,	0,	1},
 		{"ProxyBufferMode",		&config_proxy_buffer_mode_str,		TYPE_STRING,
 			PARM_OPT,	0,	0},
 		{"StartHTTPAgentPollers",	&CONFIG_FORKS[ZBX_PROCESS_TYPE_HTTPAGENT_POLLER],	TYPE_INT,
@@ -1245,6 +1260,7 @@ int	main(int argc, char **argv)
 	zbx_init_library_dbupgrade(get_program_type);
 	zbx_init_library_dbwrap(NULL);
 	zbx_init_library_icmpping(&config_icmpping);
+	zbx_init_library_shmem(config_huge_pages);
 	zbx_init_library_ipcservice(program_type);
 	zbx_init_library_sysinfo(get_zbx_config_timeout, get_zbx_config_enable_remote_commands,
 			get_zbx_config_log_remote_commands, get_zbx_config_unsafe_user_parameters,
@@ -1579,7 +1595,8 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 	proxy_db_init();
 
 	if (FAIL == zbx_pb_init(config_proxy_buffer_mode, config_proxy_memory_buffer_size,
-			config_proxy_memory_buffer_age, config_proxy_offline_buffer * SEC_PER_HOUR, &error))
+			config_proxy_memory_buffer_age, config_proxy_offline_buffer * SEC_PER_HOUR,
+			config_proxy_memory_buffer_compression, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize proxy buffer: %s", error);
 		zbx_free(error);
@@ -108,6 +108,9 @@ ZBX_PTR_VECTOR_DECL(table_row_ptr, struct zbx_table_row *)
 /* bit defines for proxyconfig row flags, lower bits are reserved for field update flags */
 #define PROXYCONFIG_ROW_EXISTS		127
 
+/* number of existing rows read from database at once when preparing table for sync */
+#define PROXYCONFIG_SELECT_BATCH	10000
+
 typedef struct zbx_table_row
 {
 	zbx_uint64_t			recid;
@@ -1073,6 +1076,9 @@ clean:
  *                                                                            *
  * Comments: The key_field and key_ids allow to specify scope within which the*
  *           table sync will be made.                                         *
+ *           Existing rows are read in batches ordered by record identifier   *
+ *           to limit the memory used by database result sets on large        *
+ *           tables.                                                          *
  *                                                                            *
  ******************************************************************************/
 static void	proxyconfig_prepare_table(zbx_table_data_t *td, const char *key_field, zbx_vector_uint64_t *key_ids,
@@ -1081,10 +1087,10 @@ static void	proxyconfig_prepare_table(zbx_table_data_t *td, const char *key_fiel
 	zbx_db_result_t	result;
 	zbx_db_row_t	dbrow;
 	char		*sql = NULL, *buf, *delim = " where";
-	size_t		sql_alloc = 0, sql_offset = 0, buf_alloc = ZBX_KIBIBYTE;
-	zbx_uint64_t	recid;
+	size_t		sql_alloc = 0, sql_offset = 0, sql_base, buf_alloc = ZBX_KIBIBYTE;
+	zbx_uint64_t	recid = 0;
 	zbx_table_row_t	*row;
-	int		i;
+	int		i, rows_num;
 
 	if (NULL != key_ids && 0 == key_ids->values_num)
 		return;
@@ -1105,29 +1111,40 @@ static void	proxyconfig_prepare_table(zbx_table_data_t *td, const char *key_fiel
 	}
 
 	if (NULL != td->sql_filter)
+	{
 		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%s %s", delim, td->sql_filter);
+		delim = " and";
+	}
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " order by %s", td->table->recid);
-
-	result = zbx_db_select("%s", sql);
+	sql_base = sql_offset;
 
-	while (NULL != (dbrow = zbx_db_fetch(result)))
+	do
 	{
-		ZBX_STR2UINT64(recid, dbrow[0]);
+		sql_offset = sql_base;
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%s %s>" ZBX_FS_UI64 " order by %s", delim,
+				td->table->recid, recid, td->table->recid);
 
-		if (NULL != recids)
-			zbx_vector_uint64_append(recids, recid);
+		result = zbx_db_select_n(sql, PROXYCONFIG_SELECT_BATCH);
 
-		if (NULL == (row = (zbx_table_row_t *)zbx_hashset_search(&td->rows, &recid)))
+		for (rows_num = 0; NULL != (dbrow = zbx_db_fetch(result)); rows_num++)
 		{
-			zbx_vector_uint64_append(&td->del_ids, recid);
-			continue;
-		}
+			ZBX_STR2UINT64(recid, dbrow[0]);
+
+			if (NULL != recids)
+				zbx_vector_uint64_append(recids, recid);
 
-		if (SUCCEED != proxyconfig_compare_row(row, dbrow, &buf, &buf_alloc))
-			zbx_vector_table_row_ptr_append(&td->updates, row);
+			if (NULL == (row = (zbx_table_row_t *)zbx_hashset_search(&td->rows, &recid)))
+			{
+				zbx_vector_uint64_append(&td->del_ids, recid);
+				continue;
+			}
+
+			if (SUCCEED != proxyconfig_compare_row(row, dbrow, &buf, &buf_alloc))
+				zbx_vector_table_row_ptr_append(&td->updates, row);
+		}
+		zbx_db_free_result(result);
 	}
-	zbx_db_free_result(result);
+	while (PROXYCONFIG_SELECT_BATCH == rows_num);
 
 	zbx_free(sql);
 	zbx_free(buf);
@@ -1815,6 +1832,12 @@ static int	proxyconfig_delete_hosts(const zbx_vector_uint64_t *hostids, char **e
 		if (ZBX_DB_OK > zbx_db_execute("%s", sql))
 			goto out;
 
+		sql_offset = 0;
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "delete from item_parameter where");
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids.values, itemids.values_num);
+		if (ZBX_DB_OK > zbx_db_execute("%s", sql))
+			goto out;
+
 		sql_offset = 0;
 		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "update items set master_itemid=null where");
 		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids.values, itemids.values_num);
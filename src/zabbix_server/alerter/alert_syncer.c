@@ -655,6 +655,67 @@ static void	am_service_add_event_tags(zbx_vector_events_tags_t *events_tags)
 	zbx_free(data);
 }
 
+static int	am_db_result_status_compare(const void *d1, const void *d2)
+{
+	const zbx_am_result_t	*r1 = *(const zbx_am_result_t * const *)d1;
+	const zbx_am_result_t	*r2 = *(const zbx_am_result_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->status, r2->status);
+	ZBX_RETURN_IF_NOT_EQUAL(r1->retries, r2->retries);
+	ZBX_RETURN_IF_NOT_EQUAL(r1->alertid, r2->alertid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates status of alerts without error message, grouping alerts  *
+ *          with the same status and retries into single update statement     *
+ *                                                                            *
+ * Parameters: results    - [IN] alert results without error message          *
+ *             sql        - [IN/OUT] sql buffer                               *
+ *             sql_alloc  - [IN/OUT]                                          *
+ *             sql_offset - [IN/OUT]                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	am_db_update_alerts_status(zbx_vector_ptr_t *results, char **sql, size_t *sql_alloc,
+		size_t *sql_offset)
+{
+	zbx_vector_uint64_t	alertids;
+	int			i, j;
+
+	zbx_vector_uint64_create(&alertids);
+
+	zbx_vector_ptr_sort(results, am_db_result_status_compare);
+
+	for (i = 0; i < results->values_num; i = j)
+	{
+		zbx_am_result_t	*result = (zbx_am_result_t *)results->values[i];
+
+		zbx_vector_uint64_clear(&alertids);
+
+		for (j = i; j < results->values_num; j++)
+		{
+			zbx_am_result_t	*next = (zbx_am_result_t *)results->values[j];
+
+			if (next->status != result->status || next->retries != result->retries)
+				break;
+
+			zbx_vector_uint64_append(&alertids, next->alertid);
+		}
+
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "update alerts set status=%d,retries=%d,error=''"
+				" where", result->status, result->retries);
+		zbx_db_add_condition_alloc(sql, sql_alloc, sql_offset, "alertid", alertids.values,
+				alertids.values_num);
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ";\n");
+
+		zbx_db_execute_overflowed_sql(sql, sql_alloc, sql_offset);
+	}
+
+	zbx_vector_uint64_destroy(&alertids);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieves alert updates from alert manager and flushes them into  *
@@ -687,16 +748,19 @@ static int	am_db_flush_results(zbx_am_db_t *amdb)
 
 	if (0 != results_num)
 	{
-		int 		i, ret;
-		char		*sql;
-		size_t		sql_alloc = results_num * 128, sql_offset;
-		zbx_db_insert_t	db_event, db_problem;
+		int			i, ret;
+		char			*sql;
+		size_t			sql_alloc = results_num * 128, sql_offset;
+		zbx_db_insert_t		db_event, db_problem;
+		zbx_vector_ptr_t	noerror_results;
 
 		sql = (char *)zbx_malloc(NULL, sql_alloc);
+		zbx_vector_ptr_create(&noerror_results);
 
 		do
 		{
 			zbx_vector_events_tags_clear_ext(&update_events_tags, event_tags_free);
+			zbx_vector_ptr_clear(&noerror_results);
 			sql_offset = 0;
 
 			zbx_db_begin();
@@ -710,22 +774,19 @@ static int	am_db_flush_results(zbx_am_db_t *amdb)
 				zbx_am_db_mediatype_t	*mediatype;
 				zbx_am_result_t		*result = results[i];
 
-				zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-						"update alerts set status=%d,retries=%d",
-						result->status, result->retries);
-
 				if (NULL != result->error)
 				{
 					char	*error_esc;
+
 					error_esc = zbx_db_dyn_escape_field("alerts", "error", result->error);
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ",error='%s'", error_esc);
+					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+							"update alerts set status=%d,retries=%d,error='%s'"
+							" where alertid=" ZBX_FS_UI64 ";\n",
+							result->status, result->retries, error_esc, result->alertid);
 					zbx_free(error_esc);
 				}
 				else
-					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ",error=''");
-
-				zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " where alertid=" ZBX_FS_UI64 ";\n",
-						result->alertid);
+					zbx_vector_ptr_append(&noerror_results, result);
 
 				if (EVENT_SOURCE_TRIGGERS == result->source && NULL != result->value)
 				{
@@ -739,6 +800,8 @@ static int	am_db_flush_results(zbx_am_db_t *amdb)
 				zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
 			}
 
+			am_db_update_alerts_status(&noerror_results, &sql, &sql_alloc, &sql_offset);
+
 			am_db_validate_tags_for_update(&update_events_tags, &db_event, &db_problem);
 
 			zbx_db_end_multiple_update(&sql, &sql_alloc, &sql_offset);
@@ -767,6 +830,7 @@ static int	am_db_flush_results(zbx_am_db_t *amdb)
 			zbx_free(result);
 		}
 
+		zbx_vector_ptr_destroy(&noerror_results);
 		zbx_free(sql);
 	}
 
@@ -31,6 +31,48 @@
 #include "zbxjson.h"
 #include "zbxstr.h"
 
+#ifdef HAVE_LIBCURL
+static CURLSH	*curl_share = NULL;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create cURL share object to keep connections to connector         *
+ *          endpoints open between requests                                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	worker_curl_share_init(void)
+{
+	CURLSHcode	shrerr;
+
+	if (NULL == (curl_share = curl_share_init()))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot initialize cURL share object");
+		return;
+	}
+
+	/* no locking is needed as worker sends one request at a time */
+#if LIBCURL_VERSION_NUM >= 0x073900
+	/* CURL_LOCK_DATA_CONNECT is supported starting with version 7.57.0 (0x073900) */
+	if (CURLSHE_OK != (shrerr = curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot share connections between cURL handles: %s",
+				curl_share_strerror(shrerr));
+	}
+#endif
+	if (CURLSHE_OK != (shrerr = curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot share DNS cache between cURL handles: %s",
+				curl_share_strerror(shrerr));
+	}
+
+	if (CURLSHE_OK != (shrerr = curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot share TLS sessions between cURL handles: %s",
+				curl_share_strerror(shrerr));
+	}
+}
+#endif
+
 static int	connector_object_compare_func(const void *d1, const void *d2)
 {
 	return zbx_timespec_compare(&((const zbx_connector_data_point_t *)d1)->ts,
@@ -74,7 +116,15 @@ static void	worker_process_request(zbx_ipc_socket_t *socket, const char *config_
 			HTTP_STORE_RAW, config_source_ip, &error)))
 	{
 		long		response_code;
-		CURLcode	err = zbx_http_request_sync_perform(context.easyhandle, &context);
+		CURLcode	err;
+
+		if (NULL != curl_share && CURLE_OK != (err = curl_easy_setopt(context.easyhandle, CURLOPT_SHARE,
+				curl_share)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "cannot set share handle: %s", curl_easy_strerror(err));
+		}
+
+		err = zbx_http_request_sync_perform(context.easyhandle, &context);
 
 		if (SUCCEED == (ret = zbx_http_handle_response(context.easyhandle, &context, err, &response_code,
 				&out, &error)))
@@ -191,7 +241,9 @@ ZBX_THREAD_ENTRY(connector_worker_thread, args)
 	zbx_setproctitle("%s #%d started", get_process_type_string(process_type), process_num);
 
 	zbx_vector_connector_data_point_create(&connector_data_points);
-
+#ifdef HAVE_LIBCURL
+	worker_curl_share_init();
+#endif
 	time_stat = zbx_time();
 
 	for (;;)
@@ -245,5 +297,9 @@ ZBX_THREAD_ENTRY(connector_worker_thread, args)
 	}
 
 	zbx_vector_connector_data_point_destroy(&connector_data_points);
+#ifdef HAVE_LIBCURL
+	if (NULL != curl_share)
+		curl_share_cleanup(curl_share);
+#endif
 	exit(EXIT_SUCCESS);
 }
@@ -61,13 +61,44 @@ static int	diag_valuecache_item_compare_hourly(const void *d1, const void *d2)
 	return i2->hourly_num - i1->hourly_num;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sort value cache items by used memory in descending order         *
+ *                                                                            *
+ ******************************************************************************/
+static int	diag_valuecache_item_compare_size(const void *d1, const void *d2)
+{
+	zbx_vc_item_stats_t	*i1 = *(zbx_vc_item_stats_t **)d1;
+	zbx_vc_item_stats_t	*i2 = *(zbx_vc_item_stats_t **)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(i2->size, i1->size);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sort value cache items by values read from database in descending *
+ *          order                                                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	diag_valuecache_item_compare_misses(const void *d1, const void *d2)
+{
+	zbx_vc_item_stats_t	*i1 = *(zbx_vc_item_stats_t **)d1;
+	zbx_vc_item_stats_t	*i2 = *(zbx_vc_item_stats_t **)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(i2->misses, i1->misses);
+
+	return 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add valuecache items diagnostic statistics to json                *
  *                                                                            *
  ******************************************************************************/
 static void	diag_valuecache_add_items(struct zbx_json *json, const char *field, zbx_vc_item_stats_t **items,
-		int items_num)
+		int items_num, int get_size)
 {
 	int	i;
 
@@ -79,6 +110,12 @@ static void	diag_valuecache_add_items(struct zbx_json *json, const char *field,
 		zbx_json_addint64(json, "itemid", items[i]->itemid);
 		zbx_json_addint64(json, "values", items[i]->values_num);
 		zbx_json_addint64(json, "request.values", items[i]->hourly_num);
+		zbx_json_adduint64(json, "hits", items[i]->hits);
+		zbx_json_adduint64(json, "misses", items[i]->misses);
+
+		if (0 != get_size)
+			zbx_json_adduint64(json, "size", items[i]->size);
+
 		zbx_json_close(json);
 	}
 	zbx_json_close(json);
@@ -159,12 +196,19 @@ static int	diag_add_valuecache_info(const struct zbx_json_parse *jp, struct zbx_
 		if (0 != tops.values_num)
 		{
 			zbx_vector_ptr_t	items;
-			int			i;
+			int			i, get_size = 0;
 
 			zbx_vector_ptr_create(&items);
 
+			/* item size is calculated by walking all cached values, do it only if requested */
+			for (i = 0; i < tops.values_num; i++)
+			{
+				if (0 == strcmp(((zbx_diag_map_t *)tops.values[i])->name, "size"))
+					get_size = 1;
+			}
+
 			time1 = zbx_time();
-			zbx_vc_get_item_stats(&items);
+			zbx_vc_get_item_stats(&items, get_size);
 			time2 = zbx_time();
 			time_total += time2 - time1;
 
@@ -183,6 +227,14 @@ static int	diag_add_valuecache_info(const struct zbx_json_parse *jp, struct zbx_
 				{
 					zbx_vector_ptr_sort(&items, diag_valuecache_item_compare_hourly);
 				}
+				else if (0 == strcmp(map->name, "size"))
+				{
+					zbx_vector_ptr_sort(&items, diag_valuecache_item_compare_size);
+				}
+				else if (0 == strcmp(map->name, "misses"))
+				{
+					zbx_vector_ptr_sort(&items, diag_valuecache_item_compare_misses);
+				}
 				else
 				{
 					*error = zbx_dsprintf(*error, "Unsupported top field: %s", map->name);
@@ -191,7 +243,8 @@ static int	diag_add_valuecache_info(const struct zbx_json_parse *jp, struct zbx_
 				}
 
 				limit = MIN((int)map->value, items.values_num);
-				diag_valuecache_add_items(json, map->name, (zbx_vc_item_stats_t **)items.values, limit);
+				diag_valuecache_add_items(json, map->name, (zbx_vc_item_stats_t **)items.values, limit,
+						get_size);
 			}
 			zbx_json_close(json);
 
@@ -850,7 +850,7 @@ static int	process_results(zbx_discoverer_manager_t *manager, zbx_vector_uint64_
 		zbx_hashset_t *incomplete_druleids, zbx_uint64_t *unsaved_checks, const zbx_events_funcs_t *events_cbs)
 {
 #define DISCOVERER_BATCH_RESULTS_NUM	1000
-	int					i;
+	int					i, j;
 	zbx_uint64_t				res_check_total = 0,res_check_count = 0;
 	zbx_vector_discoverer_results_ptr_t	results;
 	zbx_discoverer_results_t		*result, *result_tmp;
@@ -906,10 +906,31 @@ static int	process_results(zbx_discoverer_manager_t *manager, zbx_vector_uint64_
 
 	if (0 != results.values_num)
 	{
+		void			*handle;
+		zbx_vector_uint64_t	dcheckids;
+		zbx_vector_str_t	ips;
+
+		zbx_vector_uint64_create(&dcheckids);
+		zbx_vector_str_create(&ips);
+
+		for (i = 0; i < results.values_num; i++)
+		{
+			result = results.values[i];
+
+			for (j = 0; j < result->services.values_num; j++)
+				zbx_vector_uint64_append(&dcheckids, result->services.values[j]->dcheckid);
 
-		void	*handle;
+			zbx_vector_str_append(&ips, result->ip);
+		}
+
+		zbx_vector_uint64_sort(&dcheckids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_uniq(&dcheckids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 		handle = zbx_discovery_open();
+		zbx_discovery_prefetch(handle, &dcheckids, &ips);
+
+		zbx_vector_str_destroy(&ips);
+		zbx_vector_uint64_destroy(&dcheckids);
 
 		for (i = 0; i < results.values_num; i++)
 		{
@@ -112,6 +112,33 @@ typedef enum
 }
 zbx_vc_item_update_type_t;
 
+/* user data, cached for the duration of one escalator run */
+typedef struct
+{
+	zbx_uint64_t			userid;
+	zbx_uint64_t			roleid;
+	int				type;
+	char				*timezone;
+	int				tag_filters_loaded;
+	zbx_vector_ptr_t		tag_filters;
+	int				rights_loaded;
+	/* host group permissions of all user groups, host group id -> minimum permission, sorted */
+	zbx_vector_uint64_pair_t	rights;
+}
+zbx_escalation_user_t;
+
+/* trigger or item host groups, cached for the duration of one escalator run */
+typedef struct
+{
+	zbx_uint64_t		objectid;
+	zbx_vector_uint64_t	hostgroupids;
+}
+zbx_escalation_groups_t;
+
+static zbx_hashset_t	user_cache;
+static zbx_hashset_t	trigger_groups_cache;
+static zbx_hashset_t	item_groups_cache;
+
 static void	zbx_tag_filter_free(zbx_tag_filter_t *tag_filter)
 {
 	zbx_free(tag_filter->tag);
@@ -119,32 +146,112 @@ static void	zbx_tag_filter_free(zbx_tag_filter_t *tag_filter)
 	zbx_free(tag_filter);
 }
 
+static void	escalation_user_clean(void *data)
+{
+	zbx_escalation_user_t	*user = (zbx_escalation_user_t *)data;
+
+	zbx_free(user->timezone);
+	zbx_vector_ptr_clear_ext(&user->tag_filters, (zbx_clean_func_t)zbx_tag_filter_free);
+	zbx_vector_ptr_destroy(&user->tag_filters);
+	zbx_vector_uint64_pair_destroy(&user->rights);
+}
+
+static void	escalation_groups_clean(void *data)
+{
+	zbx_escalation_groups_t	*groups = (zbx_escalation_groups_t *)data;
+
+	zbx_vector_uint64_destroy(&groups->hostgroupids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create caches of user and host group data used in permission      *
+ *          checks                                                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalator_cache_init(void)
+{
+	zbx_hashset_create_ext(&user_cache, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			escalation_user_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&trigger_groups_cache, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, escalation_groups_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&item_groups_cache, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, escalation_groups_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: drop cached user and host group data, so configuration changes    *
+ *          are picked up by the next escalator run                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalator_cache_clear(void)
+{
+	zbx_hashset_clear(&user_cache);
+	zbx_hashset_clear(&trigger_groups_cache);
+	zbx_hashset_clear(&item_groups_cache);
+}
+
 static void	add_message_alert(const zbx_db_event *event, const zbx_db_event *r_event, zbx_uint64_t actionid,
 		int esc_step, zbx_uint64_t userid, zbx_uint64_t mediatypeid, const char *subject, const char *message,
 		const zbx_db_acknowledge *ack, const zbx_service_alarm_t *service_alarm, const zbx_db_service *service,
 		int err_type, const char *tz);
 
-static int	get_user_info(zbx_uint64_t userid, zbx_uint64_t *roleid, char **user_timezone)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get cached user data, reading it from database on first access    *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_escalation_user_t	*escalation_get_user(zbx_uint64_t userid)
 {
-	int		user_type = -1;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
+	zbx_escalation_user_t	*user, user_local;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
 
-	*user_timezone = NULL;
+	if (NULL != (user = (zbx_escalation_user_t *)zbx_hashset_search(&user_cache, &userid)))
+		return user;
+
+	user_local.userid = userid;
+	user_local.roleid = 0;
+	user_local.type = -1;
+	user_local.timezone = NULL;
+	user_local.tag_filters_loaded = FAIL;
+	user_local.rights_loaded = FAIL;
 
 	result = zbx_db_select("select r.type,u.roleid,u.timezone from users u,role r where u.roleid=r.roleid and"
 			" userid=" ZBX_FS_UI64, userid);
 
 	if (NULL != (row = zbx_db_fetch(result)) && FAIL == zbx_db_is_null(row[0]))
 	{
-		user_type = atoi(row[0]);
-		ZBX_STR2UINT64(*roleid, row[1]);
-		*user_timezone = zbx_strdup(NULL, row[2]);
+		user_local.type = atoi(row[0]);
+		ZBX_STR2UINT64(user_local.roleid, row[1]);
+		user_local.timezone = zbx_strdup(NULL, row[2]);
 	}
 
 	zbx_db_free_result(result);
 
-	return user_type;
+	user = (zbx_escalation_user_t *)zbx_hashset_insert(&user_cache, &user_local, sizeof(user_local));
+	zbx_vector_ptr_create(&user->tag_filters);
+	zbx_vector_uint64_pair_create(&user->rights);
+
+	return user;
+}
+
+static int	get_user_info(zbx_uint64_t userid, zbx_uint64_t *roleid, char **user_timezone)
+{
+	zbx_escalation_user_t	*user;
+
+	user = escalation_get_user(userid);
+
+	if (-1 != user->type)
+		*roleid = user->roleid;
+
+	*user_timezone = (NULL != user->timezone ? zbx_strdup(NULL, user->timezone) : NULL);
+
+	return user->type;
 }
 
 static const char	*permission_string(int perm)
@@ -174,31 +281,54 @@ static const char	*permission_string(int perm)
  ******************************************************************************/
 static int	get_hostgroups_permission(zbx_uint64_t userid, zbx_vector_uint64_t *hostgroupids)
 {
-	int		perm = PERM_DENY;
-	char		*sql = NULL;
-	size_t		sql_alloc = 0, sql_offset = 0;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
+	int			perm = PERM_DENY, found = FAIL, i, index;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_escalation_user_t	*user;
+	zbx_uint64_pair_t	right;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	if (0 == hostgroupids->values_num)
 		goto out;
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-			"select min(r.permission)"
-			" from rights r"
-			" join users_groups ug on ug.usrgrpid=r.groupid"
-				" where ug.userid=" ZBX_FS_UI64 " and", userid);
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "r.id",
-			hostgroupids->values, hostgroupids->values_num);
-	result = zbx_db_select("%s", sql);
+	user = escalation_get_user(userid);
 
-	if (NULL != (row = zbx_db_fetch(result)) && FAIL == zbx_db_is_null(row[0]))
-		perm = atoi(row[0]);
+	if (SUCCEED != user->rights_loaded)
+	{
+		result = zbx_db_select(
+				"select r.id,min(r.permission) from rights r"
+				" join users_groups ug on ug.usrgrpid=r.groupid"
+					" where ug.userid=" ZBX_FS_UI64
+				" group by r.id", userid);
 
-	zbx_db_free_result(result);
-	zbx_free(sql);
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			ZBX_STR2UINT64(right.first, row[0]);
+			right.second = (zbx_uint64_t)atoi(row[1]);
+			zbx_vector_uint64_pair_append(&user->rights, right);
+		}
+		zbx_db_free_result(result);
+
+		zbx_vector_uint64_pair_sort(&user->rights, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		user->rights_loaded = SUCCEED;
+	}
+
+	for (i = 0; i < hostgroupids->values_num; i++)
+	{
+		right.first = hostgroupids->values[i];
+
+		if (FAIL == (index = zbx_vector_uint64_pair_bsearch(&user->rights, right,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
+		{
+			continue;
+		}
+
+		if (FAIL == found || (int)user->rights.values[index].second < perm)
+			perm = (int)user->rights.values[index].second;
+
+		found = SUCCEED;
+	}
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, permission_string(perm));
 
@@ -221,44 +351,49 @@ out:
 static int	check_tag_based_permission(zbx_uint64_t userid, zbx_vector_uint64_t *hostgroupids,
 		zbx_db_event *event)
 {
-	char			*sql = NULL, hostgroupid[ZBX_MAX_UINT64_LEN + 1];
-	size_t			sql_alloc = 0, sql_offset = 0;
+	char			hostgroupid[ZBX_MAX_UINT64_LEN + 1];
 	zbx_db_result_t		result;
 	zbx_db_row_t		row;
 	int			ret = FAIL, i;
-	zbx_vector_ptr_t	tag_filters;
+	zbx_vector_ptr_t	*tag_filters;
 	zbx_tag_filter_t	*tag_filter;
 	zbx_condition_t		condition;
+	zbx_escalation_user_t	*user;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_vector_ptr_create(&tag_filters);
-
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-			"select tf.groupid,tf.tag,tf.value from tag_filter tf"
-			" join users_groups ug on ug.usrgrpid=tf.usrgrpid"
-				" where ug.userid=" ZBX_FS_UI64, userid);
-	result = zbx_db_select("%s order by tf.groupid", sql);
+	user = escalation_get_user(userid);
+	tag_filters = &user->tag_filters;
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	if (SUCCEED != user->tag_filters_loaded)
 	{
-		tag_filter = (zbx_tag_filter_t *)zbx_malloc(NULL, sizeof(zbx_tag_filter_t));
-		ZBX_STR2UINT64(tag_filter->hostgroupid, row[0]);
-		tag_filter->tag = zbx_strdup(NULL, row[1]);
-		tag_filter->value = zbx_strdup(NULL, row[2]);
-		zbx_vector_ptr_append(&tag_filters, tag_filter);
+		result = zbx_db_select(
+				"select tf.groupid,tf.tag,tf.value from tag_filter tf"
+				" join users_groups ug on ug.usrgrpid=tf.usrgrpid"
+					" where ug.userid=" ZBX_FS_UI64
+				" order by tf.groupid", userid);
+
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			tag_filter = (zbx_tag_filter_t *)zbx_malloc(NULL, sizeof(zbx_tag_filter_t));
+			ZBX_STR2UINT64(tag_filter->hostgroupid, row[0]);
+			tag_filter->tag = zbx_strdup(NULL, row[1]);
+			tag_filter->value = zbx_strdup(NULL, row[2]);
+			zbx_vector_ptr_append(tag_filters, tag_filter);
+		}
+		zbx_db_free_result(result);
+
+		user->tag_filters_loaded = SUCCEED;
 	}
-	zbx_free(sql);
-	zbx_db_free_result(result);
 
-	if (0 < tag_filters.values_num)
+	if (0 < tag_filters->values_num)
 		condition.op = ZBX_CONDITION_OPERATOR_EQUAL;
 	else
 		ret = SUCCEED;
 
-	for (i = 0; i < tag_filters.values_num && SUCCEED != ret; i++)
+	for (i = 0; i < tag_filters->values_num && SUCCEED != ret; i++)
 	{
-		tag_filter = (zbx_tag_filter_t *)tag_filters.values[i];
+		tag_filter = (zbx_tag_filter_t *)tag_filters->values[i];
 
 		if (FAIL == zbx_vector_uint64_search(hostgroupids, tag_filter->hostgroupid,
 				ZBX_DEFAULT_UINT64_COMPARE_FUNC))
@@ -289,8 +424,6 @@ static int	check_tag_based_permission(zbx_uint64_t userid, zbx_vector_uint64_t *
 		else
 			ret = SUCCEED;
 	}
-	zbx_vector_ptr_clear_ext(&tag_filters, (zbx_clean_func_t)zbx_tag_filter_free);
-	zbx_vector_ptr_destroy(&tag_filters);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
@@ -310,7 +443,7 @@ static int	get_trigger_permission(zbx_uint64_t userid, zbx_db_event *event, char
 	int			perm = PERM_DENY;
 	zbx_db_result_t		result;
 	zbx_db_row_t		row;
-	zbx_vector_uint64_t	hostgroupids;
+	zbx_escalation_groups_t	*groups, groups_local;
 	zbx_uint64_t		hostgroupid, roleid;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -321,31 +454,36 @@ static int	get_trigger_permission(zbx_uint64_t userid, zbx_db_event *event, char
 		goto out;
 	}
 
-	zbx_vector_uint64_create(&hostgroupids);
+	if (NULL == (groups = (zbx_escalation_groups_t *)zbx_hashset_search(&trigger_groups_cache,
+			&event->objectid)))
+	{
+		groups_local.objectid = event->objectid;
+		groups = (zbx_escalation_groups_t *)zbx_hashset_insert(&trigger_groups_cache, &groups_local,
+				sizeof(groups_local));
+		zbx_vector_uint64_create(&groups->hostgroupids);
 
-	result = zbx_db_select(
-			"select distinct hg.groupid from items i"
-			" join functions f on i.itemid=f.itemid"
-			" join hosts_groups hg on hg.hostid = i.hostid"
-				" and f.triggerid=" ZBX_FS_UI64,
-			event->objectid);
+		result = zbx_db_select(
+				"select distinct hg.groupid from items i"
+				" join functions f on i.itemid=f.itemid"
+				" join hosts_groups hg on hg.hostid = i.hostid"
+					" and f.triggerid=" ZBX_FS_UI64,
+				event->objectid);
 
-	while (NULL != (row = zbx_db_fetch(result)))
-	{
-		ZBX_STR2UINT64(hostgroupid, row[0]);
-		zbx_vector_uint64_append(&hostgroupids, hostgroupid);
-	}
-	zbx_db_free_result(result);
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			ZBX_STR2UINT64(hostgroupid, row[0]);
+			zbx_vector_uint64_append(&groups->hostgroupids, hostgroupid);
+		}
+		zbx_db_free_result(result);
 
-	zbx_vector_uint64_sort(&hostgroupids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_sort(&groups->hostgroupids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	}
 
-	if (PERM_DENY < (perm = get_hostgroups_permission(userid, &hostgroupids)) &&
-			FAIL == check_tag_based_permission(userid, &hostgroupids, event))
+	if (PERM_DENY < (perm = get_hostgroups_permission(userid, &groups->hostgroupids)) &&
+			FAIL == check_tag_based_permission(userid, &groups->hostgroupids, event))
 	{
 		perm = PERM_DENY;
 	}
-
-	zbx_vector_uint64_destroy(&hostgroupids);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, permission_string(perm));
 
@@ -365,36 +503,40 @@ static int	get_item_permission(zbx_uint64_t userid, zbx_uint64_t itemid, char **
 	zbx_db_result_t		result;
 	zbx_db_row_t		row;
 	int			perm = PERM_DENY;
-	zbx_vector_uint64_t	hostgroupids;
+	zbx_escalation_groups_t	*groups, groups_local;
 	zbx_uint64_t		hostgroupid, roleid;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_vector_uint64_create(&hostgroupids);
-	zbx_vector_uint64_sort(&hostgroupids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
-
 	if (USER_TYPE_SUPER_ADMIN == get_user_info(userid, &roleid, user_timezone))
 	{
 		perm = PERM_READ_WRITE;
 		goto out;
 	}
 
-	result = zbx_db_select(
-			"select hg.groupid from items i"
-			" join hosts_groups hg on hg.hostid=i.hostid"
-			" where i.itemid=" ZBX_FS_UI64,
-			itemid);
-
-	while (NULL != (row = zbx_db_fetch(result)))
+	if (NULL == (groups = (zbx_escalation_groups_t *)zbx_hashset_search(&item_groups_cache, &itemid)))
 	{
-		ZBX_STR2UINT64(hostgroupid, row[0]);
-		zbx_vector_uint64_append(&hostgroupids, hostgroupid);
+		groups_local.objectid = itemid;
+		groups = (zbx_escalation_groups_t *)zbx_hashset_insert(&item_groups_cache, &groups_local,
+				sizeof(groups_local));
+		zbx_vector_uint64_create(&groups->hostgroupids);
+
+		result = zbx_db_select(
+				"select hg.groupid from items i"
+				" join hosts_groups hg on hg.hostid=i.hostid"
+				" where i.itemid=" ZBX_FS_UI64,
+				itemid);
+
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			ZBX_STR2UINT64(hostgroupid, row[0]);
+			zbx_vector_uint64_append(&groups->hostgroupids, hostgroupid);
+		}
+		zbx_db_free_result(result);
 	}
-	zbx_db_free_result(result);
 
-	perm = get_hostgroups_permission(userid, &hostgroupids);
+	perm = get_hostgroups_permission(userid, &groups->hostgroupids);
 out:
-	zbx_vector_uint64_destroy(&hostgroupids);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, permission_string(perm));
 
@@ -3632,6 +3774,8 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+	escalator_cache_init();
+
 	while (ZBX_IS_RUNNING())
 	{
 		sec = zbx_time();
@@ -3660,6 +3804,7 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_source_ip);
 
+		escalator_cache_clear();
 		zbx_config_clean(&cfg);
 		total_sec += zbx_time() - sec;
 
@@ -1173,36 +1173,53 @@ typedef enum
 }
 zbx_problem_state_t;
 
+/* old problem matched by global correlation rule */
+typedef struct
+{
+	zbx_uint64_t	eventid;
+	zbx_uint64_t	objectid;
+	zbx_uint64_t	correlationid;
+}
+zbx_correlation_match_t;
+
+ZBX_VECTOR_DECL(correlation_match, zbx_correlation_match_t)
+ZBX_VECTOR_IMPL(correlation_match, zbx_correlation_match_t)
+
+/* new event with correlation rules it must be checked against */
+typedef struct
+{
+	zbx_db_event			*event;
+	zbx_vector_ptr_t		corr_new;
+	zbx_vector_ptr_t		corr_old;
+	zbx_vector_correlation_match_t	matches;
+}
+zbx_correlation_event_t;
+
+/* number of new events checked against old problems with single query */
+#define ZBX_CORRELATION_SELECT_BATCH	100
+
 /******************************************************************************
  *                                                                            *
- * Purpose: find problem events that must be recovered by global correlation  *
- *          rules and check if the new event must be closed                   *
+ * Purpose: find global correlation rules that must be checked for new event  *
  *                                                                            *
- * Parameters: event         - [IN] new event                                 *
+ * Parameters: cevent        - [IN/OUT] new event with correlation rules      *
  *             problem_state - [IN/OUT] problem state cache variable          *
  *                                                                            *
- * Comments: The correlation data (zbx_event_recovery_t) of events that       *
- *           must be closed are added to event_correlation hashset            *
- *                                                                            *
- *           The global event correlation matching is done in two parts:      *
+ * Comments: The global event correlation matching is done in two parts:      *
  *             1) exclude correlations that can't possibly match the event    *
  *                based on new event tag/value/group conditions               *
  *             2) assemble sql statement to select problems/correlations      *
  *                based on the rest correlation conditions                    *
  *                                                                            *
+ *           This function does the first part, splitting the rules into the  *
+ *           ones that can be executed directly (corr_new) and the ones that  *
+ *           must be checked against old events (corr_old).                   *
+ *                                                                            *
  ******************************************************************************/
-static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_state_t *problem_state)
+static void	correlation_prepare_event(zbx_correlation_event_t *cevent, zbx_problem_state_t *problem_state)
 {
 	int			i;
 	zbx_correlation_t	*correlation;
-	zbx_vector_ptr_t	corr_old, corr_new;
-	char			*sql = NULL;
-	const char		*delim = "";
-	size_t			sql_alloc = 0, sql_offset = 0;
-	zbx_uint64_t		eventid, correlationid, objectid;
-
-	zbx_vector_ptr_create(&corr_old);
-	zbx_vector_ptr_create(&corr_new);
 
 	for (i = 0; i < correlation_rules.correlations.values_num; i++)
 	{
@@ -1210,7 +1227,7 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 
 		correlation = (zbx_correlation_t *)correlation_rules.correlations.values[i];
 
-		switch (correlation_match_new_event(correlation, event, SUCCEED))
+		switch (correlation_match_new_event(correlation, cevent->event, SUCCEED))
 		{
 			case CORRELATION_MATCH:
 				if (SUCCEED == correlation_has_old_event_operation(correlation))
@@ -1250,77 +1267,133 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 				/* with no open problems all conditions involving old events will fail       */
 				/* so there is no need to check old events. Instead re-check if correlation  */
 				/* still matches the new event and must be processed in new event scope.     */
-				if (CORRELATION_MATCH == correlation_match_new_event(correlation, event, FAIL))
-					zbx_vector_ptr_append(&corr_new, correlation);
+				if (CORRELATION_MATCH == correlation_match_new_event(correlation, cevent->event, FAIL))
+					zbx_vector_ptr_append(&cevent->corr_new, correlation);
 			}
 			else
-				zbx_vector_ptr_append(&corr_old, correlation);
+				zbx_vector_ptr_append(&cevent->corr_old, correlation);
 		}
 		else
-			zbx_vector_ptr_append(&corr_new, correlation);
+			zbx_vector_ptr_append(&cevent->corr_new, correlation);
 	}
+}
 
-	if (0 != corr_new.values_num)
-	{
-		/* Process correlations that matches new event and does not use or affect old events. */
-		/* Those correlations can be executed directly, without checking database.            */
-		for (i = 0; i < corr_new.values_num; i++)
-			correlation_execute_operations((zbx_correlation_t *)corr_new.values[i], event, 0, 0);
-	}
+/******************************************************************************
+ *                                                                            *
+ * Purpose: select old problems matching global correlation rules of a batch  *
+ *          of new events                                                     *
+ *                                                                            *
+ * Parameters: cevents - [IN/OUT] new events with correlation rules           *
+ *             start   - [IN] first event index                               *
+ *             end     - [IN] last event index + 1                            *
+ *                                                                            *
+ * Comments: Problem selection for every new event with old event scope       *
+ *           rules is combined into single query, the matches are returned    *
+ *           with new event index. The operations are not executed here, so   *
+ *           the events can be processed afterwards in their original order.  *
+ *                                                                            *
+ ******************************************************************************/
+static void	correlation_select_old_events(zbx_correlation_event_t *cevents, int start, int end)
+{
+	int			i, j, index;
+	char			*sql = NULL;
+	const char		*union_delim = "";
+	size_t			sql_alloc = 0, sql_offset = 0;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_correlation_match_t	match;
 
-	if (0 != corr_old.values_num)
+	for (i = start; i < end; i++)
 	{
-		zbx_db_result_t	result;
-		zbx_db_row_t	row;
+		const char	*delim = "";
 
-		/* Process correlations that matches new event and either uses old events in conditions */
-		/* or has operations involving old events.                                              */
+		if (0 == cevents[i].corr_old.values_num)
+			continue;
 
-		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select p.eventid,p.objectid,c.correlationid"
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%sselect p.eventid,p.objectid,c.correlationid,%d"
 								" from correlation c,problem p"
 								" where p.r_eventid is null"
 								" and p.source=" ZBX_STR(EVENT_SOURCE_TRIGGERS)
-								" and (");
+								" and (", union_delim, i);
 
-		for (i = 0; i < corr_old.values_num; i++)
+		for (j = 0; j < cevents[i].corr_old.values_num; j++)
 		{
-			correlation = (zbx_correlation_t *)corr_old.values[i];
-
 			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, delim);
-			correlation_add_event_filter(&sql, &sql_alloc, &sql_offset, correlation, event);
+			correlation_add_event_filter(&sql, &sql_alloc, &sql_offset,
+					(zbx_correlation_t *)cevents[i].corr_old.values[j], cevents[i].event);
 			delim = " or ";
 		}
 
 		zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
-		result = zbx_db_select("%s", sql);
+		union_delim = " union all ";
+	}
 
-		while (NULL != (row = zbx_db_fetch(result)))
+	if (NULL == sql)
+		return;
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		index = atoi(row[3]);
+
+		if (index < start || index >= end)
 		{
-			ZBX_STR2UINT64(eventid, row[0]);
+			THIS_SHOULD_NEVER_HAPPEN;
+			continue;
+		}
 
-			/* check if this event is not already recovered by another correlation rule */
-			if (NULL != zbx_hashset_search(&correlation_cache, &eventid))
-				continue;
+		ZBX_STR2UINT64(match.eventid, row[0]);
+		ZBX_STR2UINT64(match.objectid, row[1]);
+		ZBX_STR2UINT64(match.correlationid, row[2]);
 
-			ZBX_STR2UINT64(correlationid, row[2]);
+		zbx_vector_correlation_match_append(&cevents[index].matches, match);
+	}
 
-			if (FAIL == (i = zbx_vector_ptr_bsearch(&corr_old, &correlationid,
-					ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
-			{
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
-			}
+	zbx_db_free_result(result);
+	zbx_free(sql);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute global correlation rules matched by new event             *
+ *                                                                            *
+ * Parameters: cevent - [IN/OUT] new event with correlation rules and matched *
+ *                               old problems                                 *
+ *                                                                            *
+ * Comments: The correlation data (zbx_event_recovery_t) of events that       *
+ *           must be closed are added to event_correlation hashset            *
+ *                                                                            *
+ ******************************************************************************/
+static void	correlation_execute_event(zbx_correlation_event_t *cevent)
+{
+	int	i, index;
+
+	/* Process correlations that matches new event and does not use or affect old events. */
+	/* Those correlations can be executed directly, without checking database.            */
+	for (i = 0; i < cevent->corr_new.values_num; i++)
+		correlation_execute_operations((zbx_correlation_t *)cevent->corr_new.values[i], cevent->event, 0, 0);
 
-			ZBX_STR2UINT64(objectid, row[1]);
-			correlation_execute_operations((zbx_correlation_t *)corr_old.values[i], event, eventid, objectid);
+	/* Process correlations that matches new event and either uses old events in conditions */
+	/* or has operations involving old events.                                              */
+	for (i = 0; i < cevent->matches.values_num; i++)
+	{
+		zbx_correlation_match_t	*match = &cevent->matches.values[i];
+
+		/* check if this event is not already recovered by another correlation rule */
+		if (NULL != zbx_hashset_search(&correlation_cache, &match->eventid))
+			continue;
+
+		if (FAIL == (index = zbx_vector_ptr_bsearch(&cevent->corr_old, &match->correlationid,
+				ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
+		{
+			THIS_SHOULD_NEVER_HAPPEN;
+			continue;
 		}
 
-		zbx_db_free_result(result);
-		zbx_free(sql);
+		correlation_execute_operations((zbx_correlation_t *)cevent->corr_old.values[index], cevent->event,
+				match->eventid, match->objectid);
 	}
-
-	zbx_vector_ptr_destroy(&corr_new);
-	zbx_vector_ptr_destroy(&corr_old);
 }
 
 /******************************************************************************
@@ -1331,9 +1404,10 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
  ******************************************************************************/
 static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events, zbx_vector_ptr_t *trigger_diff)
 {
-	int			i, index;
+	int			i, index, cevents_num = 0;
 	zbx_trigger_diff_t	*diff;
 	zbx_problem_state_t	problem_state = ZBX_PROBLEM_STATE_UNKNOWN;
+	zbx_correlation_event_t	*cevents;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() events:%d", __func__, correlation_cache.num_data);
 
@@ -1342,15 +1416,35 @@ static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events, z
 	if (0 == correlation_rules.correlations.values_num)
 		goto out;
 
-	/* process global correlation and queue the events that must be closed */
+	cevents = (zbx_correlation_event_t *)zbx_malloc(NULL, sizeof(zbx_correlation_event_t) *
+			(size_t)trigger_events->values_num);
+
 	for (i = 0; i < trigger_events->values_num; i++)
 	{
-		zbx_db_event	*event = (zbx_db_event *)trigger_events->values[i];
+		zbx_db_event		*event = (zbx_db_event *)trigger_events->values[i];
+		zbx_correlation_event_t	*cevent;
 
 		if (0 == (ZBX_FLAGS_DB_EVENT_CREATE & event->flags))
 			continue;
 
-		correlate_event_by_global_rules(event, &problem_state);
+		cevent = &cevents[cevents_num++];
+		cevent->event = event;
+		zbx_vector_ptr_create(&cevent->corr_new);
+		zbx_vector_ptr_create(&cevent->corr_old);
+		zbx_vector_correlation_match_create(&cevent->matches);
+
+		correlation_prepare_event(cevent, &problem_state);
+	}
+
+	for (i = 0; i < cevents_num; i += ZBX_CORRELATION_SELECT_BATCH)
+		correlation_select_old_events(cevents, i, MIN(cevents_num, i + ZBX_CORRELATION_SELECT_BATCH));
+
+	/* process global correlation and queue the events that must be closed */
+	for (i = 0; i < cevents_num; i++)
+	{
+		zbx_db_event	*event = cevents[i].event;
+
+		correlation_execute_event(&cevents[i]);
 
 		/* force value recalculation based on open problems for triggers with */
 		/* events closed by 'close new' correlation operation                */
@@ -1363,12 +1457,19 @@ static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events, z
 				diff->flags |= ZBX_FLAGS_TRIGGER_DIFF_RECALCULATE_PROBLEM_COUNT;
 			}
 		}
+
+		zbx_vector_correlation_match_destroy(&cevents[i].matches);
+		zbx_vector_ptr_destroy(&cevents[i].corr_old);
+		zbx_vector_ptr_destroy(&cevents[i].corr_new);
 	}
 
+	zbx_free(cevents);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+#undef ZBX_CORRELATION_SELECT_BATCH
+
 /******************************************************************************
  *                                                                            *
  * Purpose: try flushing correlation close events queue, generated by         *
@@ -1147,6 +1147,11 @@ finish:
  *                                                                            *
  * Purpose: update node lastaccess                                            *
  *                                                                            *
+ * Comments: Only the own node record is updated (and so row locked), the     *
+ *           whole node registry is not locked as lastaccess update does not  *
+ *           depend on other node states. This way the heartbeat does not     *
+ *           wait for and does not delay node checks of other nodes.          *
+ *                                                                            *
  ******************************************************************************/
 static void	ha_db_update_lastaccess(zbx_ha_info_t *info)
 {
@@ -1155,9 +1160,8 @@ static void	ha_db_update_lastaccess(zbx_ha_info_t *info)
 	if (ZBX_DB_OK > ha_db_begin(info))
 		goto out;
 
-	if (SUCCEED == ha_db_lock_nodes(info) &&
-			SUCCEED == ha_db_execute(info, "update ha_node set lastaccess=" ZBX_DB_TIMESTAMP()
-					" where ha_nodeid='%s'", info->ha_nodeid.str))
+	if (SUCCEED == ha_db_execute(info, "update ha_node set lastaccess=" ZBX_DB_TIMESTAMP()
+			" where ha_nodeid='%s'", info->ha_nodeid.str))
 	{
 		ha_db_commit(info);
 	}
@@ -20,6 +20,7 @@
 #include "housekeeper.h"
 
 #include "zbxlog.h"
+#include "zbxcachehistory.h"
 #include "zbxnix.h"
 #include "zbxself.h"
 #include "zbxexpression.h"
@@ -43,6 +44,13 @@ static int	hk_period;
 /* the maximum number of housekeeping periods to be removed per single housekeeping cycle */
 #define HK_MAX_DELETE_PERIODS		4
 
+/* history deletes are paused while history cache free space is below this percentage */
+#define HK_HISTORY_CACHE_PFREE_MIN	20
+/* the number of per item history deletes between history cache checks */
+#define HK_HISTORY_CACHE_CHECK_ITEMS	100
+/* the maximum time in seconds history deletes are paused per single check */
+#define HK_HISTORY_CACHE_WAIT_MAX	SEC_PER_MIN
+
 #define HK_MIN_CLOCK_UNDEFINED		0
 #define HK_MIN_CLOCK_ALWAYS_RECHECK	-1
 
@@ -629,6 +637,31 @@ static void 	hk_update_dbversion_status(void)
 }
 #endif
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pauses history housekeeping while history cache is filling up     *
+ *                                                                            *
+ * Comments: History syncers compete with housekeeper for the database. When  *
+ *           history cache free space drops below HK_HISTORY_CACHE_PFREE_MIN  *
+ *           percent the housekeeper waits up to HK_HISTORY_CACHE_WAIT_MAX    *
+ *           seconds, so syncers can catch up.                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	hk_history_cache_wait(void)
+{
+	int	waited = 0;
+
+	while (HK_HISTORY_CACHE_WAIT_MAX > waited && ZBX_IS_RUNNING() &&
+			HK_HISTORY_CACHE_PFREE_MIN > *(double *)zbx_dc_get_stats(ZBX_STATS_HISTORY_PFREE))
+	{
+		if (0 == waited)
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() history cache is filling up, pausing", __func__);
+
+		zbx_sleep(1);
+		waited++;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: performs housekeeping for history and trends tables               *
@@ -716,6 +749,9 @@ static int	housekeeping_history_and_trends(int now)
 		{
 			zbx_hk_delete_queue_t	*item_record = (zbx_hk_delete_queue_t *)rule->delete_queue.values[i];
 
+			if (0 == (i + 1) % HK_HISTORY_CACHE_CHECK_ITEMS)
+				hk_history_cache_wait();
+
 			rc = zbx_db_execute("delete from %s where itemid=" ZBX_FS_UI64 " and clock<%d",
 					rule->table, item_record->itemid, item_record->min_clock);
 			if (ZBX_DB_OK < rc)
@@ -786,6 +822,7 @@ static int	housekeeping_process_rule(int now, zbx_hk_rule_t *rule)
 		size_t			sql_alloc = 0, sql_offset;
 		zbx_vector_uint64_t	ids_uint64;
 		zbx_vector_str_t	ids_str;
+		zbx_uint64_t		lastid = 0;
 		int			ret;
 
 		if (0 == id_field_str_type)
@@ -795,16 +832,31 @@ static int	housekeeping_process_rule(int now, zbx_hk_rule_t *rule)
 
 		min_clock = MIN(keep_from, min_clock + HK_MAX_DELETE_PERIODS * hk_period);
 
-		zbx_snprintf(buffer, sizeof(buffer),
-			"select %s"
-			" from %s"
-			" where clock<%d%s%s"
-			" order by %s",
-			rule->field_name, rule->table, min_clock, '\0' != *rule->filter ? " and " : "", rule->filter,
-			rule->field_name);
-
 		while (1)
 		{
+			/* continue numeric id selection after the last deleted id, so that records matching */
+			/* clock but not the filter are not scanned again on every iteration                 */
+			if (0 == id_field_str_type)
+			{
+				zbx_snprintf(buffer, sizeof(buffer),
+					"select %s"
+					" from %s"
+					" where clock<%d and %s>" ZBX_FS_UI64 "%s%s"
+					" order by %s",
+					rule->field_name, rule->table, min_clock, rule->field_name, lastid,
+					'\0' != *rule->filter ? " and " : "", rule->filter, rule->field_name);
+			}
+			else
+			{
+				zbx_snprintf(buffer, sizeof(buffer),
+					"select %s"
+					" from %s"
+					" where clock<%d%s%s"
+					" order by %s",
+					rule->field_name, rule->table, min_clock,
+					'\0' != *rule->filter ? " and " : "", rule->filter, rule->field_name);
+			}
+
 			/* Select IDs of records that must be deleted, this allows to avoid locking for every   */
 			/* record the search encounters when using delete statement, thus eliminates deadlocks. */
 			if (0 == CONFIG_MAX_HOUSEKEEPER_DELETE)
@@ -831,6 +883,8 @@ static int	housekeeping_process_rule(int now, zbx_hk_rule_t *rule)
 			{
 				if (0 == ids_uint64.values_num)
 					break;
+
+				lastid = ids_uint64.values[ids_uint64.values_num - 1];
 			}
 			else
 			{
@@ -1217,21 +1271,25 @@ static int	housekeeping_problems(int now)
 	size_t			sql_alloc = 0, sql_offset;
 	char			*sql = NULL;
 	char			buffer[MAX_STRING_LEN];
+	zbx_uint64_t		lastid = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() now:%d", __func__, now);
 
 	zbx_vector_uint64_create(&ids_uint64);
 
-	zbx_snprintf(buffer, sizeof(buffer),
-		"select p1.eventid from problem p1"
-		" where p1.r_clock<>0 and p1.r_clock<%d and not exists ("
-			"select NULL"
-			" from problem p2"
-			" where p1.eventid=p2.cause_eventid"
-		")", now - SEC_PER_DAY);
-
 	while (1)
 	{
+		/* continue after the last deleted problem, so that resolved problems that are still */
+		/* referenced as cause are not scanned again on every iteration                      */
+		zbx_snprintf(buffer, sizeof(buffer),
+			"select p1.eventid from problem p1"
+			" where p1.eventid>" ZBX_FS_UI64 " and p1.r_clock<>0 and p1.r_clock<%d and not exists ("
+				"select NULL"
+				" from problem p2"
+				" where p1.eventid=p2.cause_eventid"
+			")"
+			" order by p1.eventid", lastid, now - SEC_PER_DAY);
+
 		if (0 == CONFIG_MAX_HOUSEKEEPER_DELETE)
 			result = zbx_db_select("%s", buffer);
 		else
@@ -1250,6 +1308,8 @@ static int	housekeeping_problems(int now)
 		if (0 == ids_uint64.values_num)
 			break;
 
+		lastid = ids_uint64.values[ids_uint64.values_num - 1];
+
 		sql_offset = 0;
 		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "delete from problem where");
 		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "eventid", ids_uint64.values,
@@ -55,6 +55,50 @@ typedef struct
 zbx_httppage_t;
 
 static zbx_httppage_t	page;
+static CURLSH		*curl_share = NULL;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get cURL share object for DNS cache and TLS sessions shared by    *
+ *          all web scenarios of the process                                  *
+ *                                                                            *
+ * Return value: the share object or NULL if it cannot be created             *
+ *                                                                            *
+ * Comments: Cookies and connections are not shared, each scenario keeps them *
+ *           within its own easy handle. No locking is needed as scenarios    *
+ *           are executed one at a time.                                      *
+ *                                                                            *
+ ******************************************************************************/
+static CURLSH	*httptest_get_curl_share(void)
+{
+	static int	initialized = 0;
+	CURLSHcode	shrerr;
+
+	if (0 != initialized)
+		return curl_share;
+
+	initialized = 1;
+
+	if (NULL == (curl_share = curl_share_init()))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot initialize cURL share object");
+		return NULL;
+	}
+
+	if (CURLSHE_OK != (shrerr = curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot share DNS cache between cURL handles: %s",
+				curl_share_strerror(shrerr));
+	}
+
+	if (CURLSHE_OK != (shrerr = curl_share_setopt(curl_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "Cannot share TLS sessions between cURL handles: %s",
+				curl_share_strerror(shrerr));
+	}
+
+	return curl_share;
+}
 
 static size_t	curl_write_cb(void *ptr, size_t size, size_t nmemb, void *userdata)
 {
@@ -677,6 +721,13 @@ static void	process_httptest(zbx_dc_host_t *host, zbx_httptest_t *httptest, int
 		goto clean;
 	}
 
+	if (NULL != httptest_get_curl_share() &&
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_SHARE, curl_share)))
+	{
+		err_str = zbx_strdup(err_str, curl_easy_strerror(err));
+		goto clean;
+	}
+
 #if LIBCURL_VERSION_NUM >= 0x071304
 	/* CURLOPT_PROTOCOLS is supported starting with version 7.19.4 (0x071304) */
 	/* CURLOPT_PROTOCOLS was deprecated in favor of CURLOPT_PROTOCOLS_STR starting with version 7.85.0 (0x075500) */
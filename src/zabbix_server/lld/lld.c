@@ -965,7 +965,7 @@ int	lld_validate_item_override_no_discover(const zbx_vector_lld_override_t *over
 
 static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_lld_row_t *lld_rows,
 		const zbx_vector_lld_macro_path_t *lld_macro_paths, const zbx_vector_lld_override_t *overrides,
-		char **info, char **error)
+		zbx_arena_t *arena, char **info, char **error)
 {
 	struct zbx_json_parse	jp, jp_array, jp_row;
 	const char		*p;
@@ -1000,7 +1000,7 @@ static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_
 		if (SUCCEED != filter_evaluate(filter, &jp_row, lld_macro_paths, info))
 			continue;
 
-		lld_row = (zbx_lld_row_t *)zbx_malloc(NULL, sizeof(zbx_lld_row_t));
+		lld_row = (zbx_lld_row_t *)zbx_arena_malloc(arena, sizeof(zbx_lld_row_t));
 		zbx_vector_lld_row_append(lld_rows, lld_row);
 
 		lld_row->jp_row = jp_row;
@@ -1052,17 +1052,11 @@ out:
 	return ret;
 }
 
-static void	lld_item_link_free(zbx_lld_item_link_t *item_link)
+/* rows and item links are allocated from the discovery rule arena and are released together with it */
+static void	lld_row_clean(zbx_lld_row_t *lld_row)
 {
-	zbx_free(item_link);
-}
-
-static void	lld_row_free(zbx_lld_row_t *lld_row)
-{
-	zbx_vector_lld_item_link_clear_ext(&lld_row->item_links, lld_item_link_free);
 	zbx_vector_lld_item_link_destroy(&lld_row->item_links);
 	zbx_vector_lld_override_destroy(&lld_row->overrides);
-	zbx_free(lld_row);
 }
 
 /******************************************************************************
@@ -1091,6 +1085,7 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	zbx_dc_um_handle_t		*um_handle;
 	zbx_vector_lld_override_t	overrides;
 	zbx_vector_lld_row_t		lld_rows;
+	zbx_arena_t			arena;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64, __func__, lld_ruleid);
 
@@ -1099,6 +1094,7 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	zbx_vector_lld_row_create(&lld_rows);
 	zbx_vector_lld_macro_path_create(&lld_macro_paths);
 	zbx_vector_lld_override_create(&overrides);
+	zbx_arena_create(&arena, 64 * ZBX_KIBIBYTE);
 
 	lld_filter_init(&filter);
 
@@ -1162,7 +1158,7 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	if (SUCCEED != (ret = lld_overrides_load(&overrides, lld_ruleid, &item, error)))
 		goto out;
 
-	if (SUCCEED != lld_rows_get(value, &filter, &lld_rows, &lld_macro_paths, &overrides, &info, error))
+	if (SUCCEED != lld_rows_get(value, &filter, &lld_rows, &lld_macro_paths, &overrides, &arena, &info, error))
 	{
 		ret = FAIL;
 		goto out;
@@ -1175,7 +1171,8 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_AUDITLOG_ENABLED);
 	zbx_audit_init(cfg.auditlog_enabled);
 
-	if (SUCCEED != lld_update_items(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, error, lifetime, now))
+	if (SUCCEED != lld_update_items(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, &arena, error, lifetime,
+			now))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add items because parent host was removed while"
 				" processing lld rule");
@@ -1213,8 +1210,9 @@ out:
 
 	zbx_vector_lld_override_clear_ext(&overrides, lld_override_free);
 	zbx_vector_lld_override_destroy(&overrides);
-	zbx_vector_lld_row_clear_ext(&lld_rows, lld_row_free);
+	zbx_vector_lld_row_clear_ext(&lld_rows, lld_row_clean);
 	zbx_vector_lld_row_destroy(&lld_rows);
+	zbx_arena_destroy(&arena);
 	zbx_vector_lld_macro_path_clear_ext(&lld_macro_paths, zbx_lld_macro_path_free);
 	zbx_vector_lld_macro_path_destroy(&lld_macro_paths);
 
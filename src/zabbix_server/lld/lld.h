@@ -304,7 +304,8 @@ int	lld_validate_item_override_no_discover(const zbx_vector_lld_override_t *over
 		unsigned char override_default);
 
 int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_lld_row_t *lld_rows,
-		const zbx_vector_lld_macro_path_t *lld_macro_paths, char **error, int lifetime, int lastcheck);
+		const zbx_vector_lld_macro_path_t *lld_macro_paths, zbx_arena_t *arena, char **error, int lifetime,
+		int lastcheck);
 
 void	lld_item_links_sort(zbx_vector_lld_row_t *lld_rows);
 
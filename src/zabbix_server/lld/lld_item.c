@@ -44,6 +44,14 @@ typedef struct
 }
 zbx_item_dependence_t;
 
+/* item dependence indexed by itemid and master_itemid pair */
+typedef struct
+{
+	zbx_uint64_pair_t	ids;
+	zbx_item_dependence_t	*dependence;
+}
+zbx_item_dependence_ref_t;
+
 ZBX_PTR_VECTOR_IMPL(lld_item_full, zbx_lld_item_full_t*)
 
 ZBX_PTR_VECTOR_IMPL(lld_item_preproc, zbx_lld_item_preproc_t*)
@@ -852,18 +860,21 @@ static void	lld_item_dependencies_get(const zbx_vector_ptr_t *item_prototypes, z
 #define NEXT_CHECK_BY_ITEM_IDS		0
 #define NEXT_CHECK_BY_MASTERITEM_IDS	1
 
-	int			i, check_type;
-	zbx_vector_uint64_t	processed_masterid, processed_itemid, next_check_itemids, next_check_masterids,
-				*check_ids;
-	char			*sql = NULL;
-	size_t			sql_alloc = 0, sql_offset;
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
+	int				i, j, check_type;
+	zbx_vector_uint64_t		next_check_itemids, next_check_masterids, *check_ids;
+	zbx_hashset_t			processed_masterid, processed_itemid, dependencies_index;
+	zbx_item_dependence_ref_t	ref_local, *ref;
+	char				*sql = NULL;
+	size_t				sql_alloc = 0, sql_offset;
+	zbx_db_result_t			result;
+	zbx_db_row_t			row;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_vector_uint64_create(&processed_masterid);
-	zbx_vector_uint64_create(&processed_itemid);
+	zbx_hashset_create(&processed_masterid, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_hashset_create(&processed_itemid, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_hashset_create(&dependencies_index, 100, ZBX_DEFAULT_UINT64_PAIR_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
 	zbx_vector_uint64_create(&next_check_itemids);
 	zbx_vector_uint64_create(&next_check_masterids);
 
@@ -876,8 +887,12 @@ static void	lld_item_dependencies_get(const zbx_vector_ptr_t *item_prototypes, z
 
 		if (0 != item_prototype->master_itemid)
 		{
-			lld_item_dependence_add(item_dependencies, item_prototype->itemid,
+			ref_local.dependence = lld_item_dependence_add(item_dependencies, item_prototype->itemid,
 					item_prototype->master_itemid, ZBX_FLAG_DISCOVERY_PROTOTYPE);
+			ref_local.ids.first = item_prototype->itemid;
+			ref_local.ids.second = item_prototype->master_itemid;
+			zbx_hashset_insert(&dependencies_index, &ref_local, sizeof(ref_local));
+
 			zbx_vector_uint64_append(&next_check_itemids, item_prototype->master_itemid);
 			zbx_vector_uint64_append(&next_check_masterids, item_prototype->master_itemid);
 		}
@@ -886,27 +901,32 @@ static void	lld_item_dependencies_get(const zbx_vector_ptr_t *item_prototypes, z
 	/* search dependency in two directions (masteritem_id->itemid and itemid->masteritem_id) */
 	while (0 < next_check_itemids.values_num || 0 < next_check_masterids.values_num)
 	{
+		zbx_hashset_t	*processed_ids;
+
 		if (0 < next_check_itemids.values_num)
 		{
 			check_type = NEXT_CHECK_BY_ITEM_IDS;
 			check_ids = &next_check_itemids;
+			processed_ids = &processed_itemid;
 		}
 		else
 		{
 			check_type = NEXT_CHECK_BY_MASTERITEM_IDS;
 			check_ids = &next_check_masterids;
+			processed_ids = &processed_masterid;
 		}
 
+		zbx_vector_uint64_sort(check_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_uniq(check_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
 		sql_offset = 0;
 		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select itemid,master_itemid,flags from items where");
 		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset,
 				NEXT_CHECK_BY_ITEM_IDS == check_type ? "itemid" : "master_itemid",
 				check_ids->values, check_ids->values_num);
 
-		if (NEXT_CHECK_BY_ITEM_IDS == check_type)
-			zbx_vector_uint64_append_array(&processed_itemid, check_ids->values, check_ids->values_num);
-		else
-			zbx_vector_uint64_append_array(&processed_masterid, check_ids->values, check_ids->values_num);
+		for (j = 0; j < check_ids->values_num; j++)
+			zbx_hashset_insert(processed_ids, &check_ids->values[j], sizeof(zbx_uint64_t));
 
 		zbx_vector_uint64_clear(check_ids);
 
@@ -914,53 +934,42 @@ static void	lld_item_dependencies_get(const zbx_vector_ptr_t *item_prototypes, z
 
 		while (NULL != (row = zbx_db_fetch(result)))
 		{
-			int			dependence_found = 0;
-			zbx_item_dependence_t	*dependence = NULL;
-			zbx_uint64_t		itemid, master_itemid;
+			zbx_item_dependence_t	*dependence;
 			unsigned int		item_flags;
 
-			ZBX_STR2UINT64(itemid, row[0]);
-			ZBX_DBROW2UINT64(master_itemid, row[1]);
+			ZBX_STR2UINT64(ref_local.ids.first, row[0]);
+			ZBX_DBROW2UINT64(ref_local.ids.second, row[1]);
 			ZBX_STR2UCHAR(item_flags, row[2]);
 
-			for (i = 0; i < item_dependencies->values_num; i++)
+			if (NULL != (ref = (zbx_item_dependence_ref_t *)zbx_hashset_search(&dependencies_index,
+					&ref_local)))
 			{
-				dependence = (zbx_item_dependence_t *)item_dependencies->values[i];
-
-				if (dependence->itemid == itemid && dependence->master_itemid == master_itemid)
-				{
-					dependence_found = 1;
-					break;
-				}
+				dependence = ref->dependence;
 			}
-
-			if (0 == dependence_found)
+			else
 			{
-				dependence = lld_item_dependence_add(item_dependencies, itemid, master_itemid,
-						item_flags);
+				dependence = lld_item_dependence_add(item_dependencies, ref_local.ids.first,
+						ref_local.ids.second, item_flags);
+				ref_local.dependence = dependence;
+				zbx_hashset_insert(&dependencies_index, &ref_local, sizeof(ref_local));
 			}
 
-			if (FAIL == zbx_vector_uint64_search(&processed_masterid, dependence->itemid,
-					ZBX_DEFAULT_UINT64_COMPARE_FUNC))
-			{
+			if (NULL == zbx_hashset_search(&processed_masterid, &dependence->itemid))
 				zbx_vector_uint64_append(&next_check_masterids, dependence->itemid);
-			}
 
 			if (NEXT_CHECK_BY_ITEM_IDS != check_type || 0 == dependence->master_itemid)
 				continue;
 
-			if (FAIL == zbx_vector_uint64_search(&processed_itemid, dependence->master_itemid,
-					ZBX_DEFAULT_UINT64_COMPARE_FUNC))
-			{
+			if (NULL == zbx_hashset_search(&processed_itemid, &dependence->master_itemid))
 				zbx_vector_uint64_append(&next_check_itemids, dependence->master_itemid);
-			}
 		}
 		zbx_db_free_result(result);
 	}
 	zbx_free(sql);
 
-	zbx_vector_uint64_destroy(&processed_masterid);
-	zbx_vector_uint64_destroy(&processed_itemid);
+	zbx_hashset_destroy(&dependencies_index);
+	zbx_hashset_destroy(&processed_masterid);
+	zbx_hashset_destroy(&processed_itemid);
 	zbx_vector_uint64_destroy(&next_check_itemids);
 	zbx_vector_uint64_destroy(&next_check_masterids);
 
@@ -3986,7 +3995,7 @@ static	void	get_item_info(const void *object, zbx_uint64_t *id, int *discovery_f
 }
 
 static void	lld_item_links_populate(const zbx_vector_ptr_t *item_prototypes, zbx_vector_lld_row_t *lld_rows,
-		zbx_hashset_t *items_index)
+		zbx_hashset_t *items_index, zbx_arena_t *arena)
 {
 	int				i, j;
 	zbx_lld_item_prototype_t	*item_prototype;
@@ -4011,7 +4020,7 @@ static void	lld_item_links_populate(const zbx_vector_ptr_t *item_prototypes, zbx
 			if (0 == (item_index->item->flags & ZBX_FLAG_LLD_ITEM_DISCOVERED))
 				continue;
 
-			item_link = (zbx_lld_item_link_t *)zbx_malloc(NULL, sizeof(zbx_lld_item_link_t));
+			item_link = (zbx_lld_item_link_t *)zbx_arena_malloc(arena, sizeof(zbx_lld_item_link_t));
 
 			item_link->parent_itemid = item_index->item->parent_itemid;
 			item_link->itemid = item_index->item->itemid;
@@ -4271,7 +4280,8 @@ static void	lld_link_dependent_items(zbx_vector_lld_item_full_t *items, zbx_hash
  *                                                                            *
  ******************************************************************************/
 int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_lld_row_t *lld_rows,
-		const zbx_vector_lld_macro_path_t *lld_macro_paths, char **error, int lifetime, int lastcheck)
+		const zbx_vector_lld_macro_path_t *lld_macro_paths, zbx_arena_t *arena, char **error, int lifetime,
+		int lastcheck)
 {
 	zbx_vector_ptr_t		item_prototypes, item_dependencies;
 	zbx_hashset_t			items_index;
@@ -4323,7 +4333,7 @@ int	lld_update_items(zbx_uint64_t hostid, zbx_uint64_t lld_ruleid, zbx_vector_ll
 		goto clean;
 	}
 
-	lld_item_links_populate(&item_prototypes, lld_rows, &items_index);
+	lld_item_links_populate(&item_prototypes, lld_rows, &items_index, arena);
 	lld_remove_lost_objects("item_discovery", "itemid", (const zbx_vector_ptr_t *)&items, lifetime, lastcheck,
 			zbx_db_delete_items, get_item_info);
 clean:
@@ -23,9 +23,11 @@
 #include "zbxipcservice.h"
 #include "zbxsysinfo.h"
 
-zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint64_t itemid, zbx_uint64_t hostid,
-		const char *value, const zbx_timespec_t *ts, unsigned char meta, zbx_uint64_t lastlogsize, int mtime,
-		const char *error)
+#define ZBX_LLD_VALUE_BUFFER_ALLOC_MAX	ZBX_MEBIBYTE
+
+zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint32_t *data_alloc, zbx_uint64_t itemid,
+		zbx_uint64_t hostid, const char *value, const zbx_timespec_t *ts, unsigned char meta,
+		zbx_uint64_t lastlogsize, int mtime, const char *error)
 {
 	unsigned char	*ptr;
 	zbx_uint32_t	data_len = 0, value_len, error_len;
@@ -43,7 +45,10 @@ zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint64_t ite
 		zbx_serialize_prepare_value(data_len, mtime);
 	}
 
-	*data = (unsigned char *)zbx_malloc(NULL, data_len);
+	if (NULL == data_alloc)
+		*data = (unsigned char *)zbx_malloc(NULL, data_len);
+	else
+		zbx_serialize_reserve(data, data_alloc, data_len);
 
 	ptr = *data;
 	ptr += zbx_serialize_value(ptr, itemid);
@@ -190,8 +195,9 @@ void	zbx_lld_queue_value(zbx_uint64_t itemid, zbx_uint64_t hostid, const char *v
 		unsigned char meta, zbx_uint64_t lastlogsize, int mtime, const char *error)
 {
 	static zbx_ipc_socket_t	socket;
+	static unsigned char	*data;
+	static zbx_uint32_t	data_alloc;
 	char			*errmsg = NULL;
-	unsigned char		*data;
 	zbx_uint32_t		data_len;
 
 	/* each process has a permanent connection to manager */
@@ -201,7 +207,8 @@ void	zbx_lld_queue_value(zbx_uint64_t itemid, zbx_uint64_t hostid, const char *v
 		exit(EXIT_FAILURE);
 	}
 
-	data_len = zbx_lld_serialize_item_value(&data, itemid, hostid, value, ts, meta, lastlogsize, mtime, error);
+	data_len = zbx_lld_serialize_item_value(&data, &data_alloc, itemid, hostid, value, ts, meta, lastlogsize,
+			mtime, error);
 
 	if (FAIL == zbx_ipc_socket_write(&socket, ZBX_IPC_LLD_REQUEST, data, data_len))
 	{
@@ -209,7 +216,12 @@ void	zbx_lld_queue_value(zbx_uint64_t itemid, zbx_uint64_t hostid, const char *v
 		exit(EXIT_FAILURE);
 	}
 
-	zbx_free(data);
+	/* keep the serialization buffer for next values unless it was grown by a large value */
+	if (ZBX_LLD_VALUE_BUFFER_ALLOC_MAX < data_alloc)
+	{
+		zbx_free(data);
+		data_alloc = 0;
+	}
 }
 
 /******************************************************************************
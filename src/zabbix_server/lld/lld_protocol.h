@@ -51,9 +51,9 @@
 /* manager -> process */
 #define ZBX_IPC_LLD_TOP_ITEMS_RESULT	1403
 
-zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint64_t itemid, zbx_uint64_t hostid,
-		const char *value, const zbx_timespec_t *ts, unsigned char meta, zbx_uint64_t lastlogsize, int mtime,
-		const char *error);
+zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint32_t *data_alloc, zbx_uint64_t itemid,
+		zbx_uint64_t hostid, const char *value, const zbx_timespec_t *ts, unsigned char meta,
+		zbx_uint64_t lastlogsize, int mtime, const char *error);
 
 void	zbx_lld_deserialize_item_value(const unsigned char *data, zbx_uint64_t *itemid, zbx_uint64_t *hostid,
 		char **value, zbx_timespec_t *ts, unsigned char *meta, zbx_uint64_t *lastlogsize, int *mtime,
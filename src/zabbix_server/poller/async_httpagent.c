@@ -33,7 +33,7 @@ void	zbx_async_check_httpagent_clean(zbx_httpagent_context *httpagent_context)
 }
 
 int	zbx_async_check_httpagent(zbx_dc_item_t *item, AGENT_RESULT *result, const char *config_source_ip,
-		CURLM *curl_handle)
+		CURLM *curl_handle, CURLSH *curl_share, zbx_httpagent_context **context)
 {
 	char			*error = NULL;
 	zbx_httpagent_context	*httpagent_context = zbx_malloc(NULL, sizeof(zbx_httpagent_context));
@@ -73,6 +73,25 @@ int	zbx_async_check_httpagent(zbx_dc_item_t *item, AGENT_RESULT *result, const c
 		goto fail;
 	}
 
+	if (CURLE_OK != (err = curl_easy_setopt(httpagent_context->http_context.easyhandle, CURLOPT_SHARE,
+			curl_share)))
+	{
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot set share handle: %s", curl_easy_strerror(err)));
+
+		goto fail;
+	}
+
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	/* CURLOPT_PIPEWAIT is supported starting with version 7.43.0 (0x072b00) */
+	/* wait for a connection to the same host to be multiplexed instead of opening a new one */
+	if (CURLE_OK != (err = curl_easy_setopt(httpagent_context->http_context.easyhandle, CURLOPT_PIPEWAIT,
+			1L)))
+	{
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot set pipewait: %s", curl_easy_strerror(err)));
+
+		goto fail;
+	}
+#endif
 	if (CURLM_OK != (merr = curl_multi_add_handle(curl_handle, httpagent_context->http_context.easyhandle)))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot add a standard curl handle to the multi stack: %s",
@@ -82,6 +101,8 @@ int	zbx_async_check_httpagent(zbx_dc_item_t *item, AGENT_RESULT *result, const c
 	}
 
 	/* httpagent_context is associated with this curl handle and will be freed when handle is freed */
+	*context = httpagent_context;
+
 	return SUCCEED;
 fail:
 	zbx_async_check_httpagent_clean(httpagent_context);
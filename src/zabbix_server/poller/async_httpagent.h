@@ -46,7 +46,7 @@ typedef struct
 zbx_httpagent_context;
 
 int	zbx_async_check_httpagent(zbx_dc_item_t *item, AGENT_RESULT *result, const char *config_source_ip,
-		CURLM *curl_handle);
+		CURLM *curl_handle, CURLSH *curl_share, zbx_httpagent_context **context);
 void	zbx_async_check_httpagent_clean(zbx_httpagent_context *httpagent_context);
 #endif
 #endif
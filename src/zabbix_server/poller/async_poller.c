@@ -210,6 +210,7 @@ static void	process_httpagent_result(CURL *easy_handle, CURLcode err, void *arg)
 	zabbix_log(LOG_LEVEL_DEBUG, "finished processing itemid:" ZBX_FS_UI64, httpagent_context->item_context.itemid);
 
 	curl_multi_remove_handle(poller_config->curl_handle, easy_handle);
+	zbx_hashset_remove(&poller_config->httpagent_contexts, &httpagent_context);
 	zbx_async_check_httpagent_clean(httpagent_context);
 	zbx_free(httpagent_context);
 fail:
@@ -334,8 +335,15 @@ static void	async_check_items(evutil_socket_t fd, short events, void *arg)
 		if (ITEM_TYPE_HTTPAGENT == items[i].type)
 		{
 #ifdef HAVE_LIBCURL
-			errcodes[i] = zbx_async_check_httpagent(&items[i], &results[i],
-					poller_config->config_source_ip, poller_config->curl_handle);
+			zbx_httpagent_context	*httpagent_context;
+
+			if (SUCCEED == (errcodes[i] = zbx_async_check_httpagent(&items[i], &results[i],
+					poller_config->config_source_ip, poller_config->curl_handle,
+					poller_config->curl_share, &httpagent_context)))
+			{
+				zbx_hashset_insert(&poller_config->httpagent_contexts, &httpagent_context,
+						sizeof(httpagent_context));
+			}
 #else
 			errcodes[i] = NOTSUPPORTED;
 			SET_MSG_RESULT(&results[i], zbx_strdup(NULL, "Support for HTTP agent was not compiled in:"
@@ -496,6 +504,7 @@ static void	async_poller_dns_init(zbx_poller_config_t *poller_config, zbx_thread
 static void	async_poller_dns_destroy(zbx_poller_config_t *poller_config)
 {
 	evdns_base_free(poller_config->dnsbase, 1);
+	zbx_async_poller_dns_cache_destroy();
 }
 
 static void	async_poller_stop(zbx_poller_config_t *poller_config)
@@ -532,6 +541,29 @@ static void	poller_update_selfmon_counter(void *arg)
 		poller_config->state = ZBX_PROCESS_STATE_BUSY;
 	}
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove and clean up HTTP agent requests still in progress, so     *
+ *          that the cURL multi and share handles can be released             *
+ *                                                                            *
+ ******************************************************************************/
+static void	async_poller_httpagent_clear(zbx_poller_config_t *poller_config)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_httpagent_context	**httpagent_context;
+
+	zbx_hashset_iter_reset(&poller_config->httpagent_contexts, &iter);
+
+	while (NULL != (httpagent_context = (zbx_httpagent_context **)zbx_hashset_iter_next(&iter)))
+	{
+		curl_multi_remove_handle(poller_config->curl_handle, (*httpagent_context)->http_context.easyhandle);
+		zbx_async_check_httpagent_clean(*httpagent_context);
+		zbx_free(*httpagent_context);
+	}
+
+	zbx_hashset_destroy(&poller_config->httpagent_contexts);
+}
 #endif
 
 static void	socket_read_event_cb(evutil_socket_t fd, short what, void *arg)
@@ -588,6 +620,9 @@ ZBX_THREAD_ENTRY(async_poller_thread, args)
 		asynchttppoller_config = zbx_async_httpagent_create(poller_config.base, process_httpagent_result,
 				poller_update_selfmon_counter, &poller_config);
 		poller_config.curl_handle = asynchttppoller_config->curl_handle;
+		poller_config.curl_share = asynchttppoller_config->curl_share;
+		zbx_hashset_create(&poller_config.httpagent_contexts, 100, ZBX_DEFAULT_PTR_HASH_FUNC,
+				ZBX_DEFAULT_PTR_COMPARE_FUNC);
 #endif
 	}
 	else if (ZBX_POLLER_TYPE_AGENT == poller_type)
@@ -651,6 +686,7 @@ ZBX_THREAD_ENTRY(async_poller_thread, args)
 	if (ZBX_POLLER_TYPE_HTTPAGENT == poller_type)
 	{
 #ifdef HAVE_LIBCURL
+		async_poller_httpagent_clear(&poller_config);
 		zbx_async_httpagent_clean(asynchttppoller_config);
 		zbx_free(asynchttppoller_config);
 #endif
@@ -49,6 +49,8 @@ typedef struct
 	zbx_hashset_t		interfaces;
 #ifdef HAVE_LIBCURL
 	CURLM			*curl_handle;
+	CURLSH			*curl_share;
+	zbx_hashset_t		httpagent_contexts;	/* contexts of the requests in progress */
 #endif
 }
 zbx_poller_config_t;
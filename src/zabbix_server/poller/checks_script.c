@@ -20,7 +20,43 @@
 #include "checks_script.h"
 #include "zbxembed.h"
 
-static zbx_es_t	es_engine;
+/* maximum number of cached compiled scripts */
+#define SCRIPTITEM_BYTECODE_CACHE_MAX	1000
+
+typedef struct
+{
+	char	*script;
+	char	*bin;
+	int	bin_sz;
+}
+zbx_script_bytecode_t;
+
+static zbx_es_t		es_engine;
+static zbx_hashset_t	es_bytecode;
+static int		es_bytecode_initialized;
+
+static zbx_hash_t	script_bytecode_hash(const void *d)
+{
+	const zbx_script_bytecode_t	*bc = (const zbx_script_bytecode_t *)d;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(bc->script);
+}
+
+static int	script_bytecode_compare(const void *d1, const void *d2)
+{
+	const zbx_script_bytecode_t	*bc1 = (const zbx_script_bytecode_t *)d1;
+	const zbx_script_bytecode_t	*bc2 = (const zbx_script_bytecode_t *)d2;
+
+	return strcmp(bc1->script, bc2->script);
+}
+
+static void	script_bytecode_clear(void *d)
+{
+	zbx_script_bytecode_t	*bc = (zbx_script_bytecode_t *)d;
+
+	zbx_free(bc->script);
+	zbx_free(bc->bin);
+}
 
 void	scriptitem_es_engine_init(void)
 {
@@ -31,12 +67,62 @@ void	scriptitem_es_engine_destroy(void)
 {
 	if (SUCCEED == zbx_es_is_env_initialized(&es_engine))
 		zbx_es_destroy(&es_engine);
+
+	if (0 != es_bytecode_initialized)
+	{
+		zbx_hashset_destroy(&es_bytecode);
+		es_bytecode_initialized = 0;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compiled script bytecode                                      *
+ *                                                                            *
+ * Parameters: script - [IN] script source                                    *
+ *             error  - [OUT] error message                                   *
+ *                                                                            *
+ * Return value: The cached script bytecode or NULL on compilation failure.   *
+ *                                                                            *
+ * Comments: The script items are executed repeatedly with the same script    *
+ *           source, so the compiled bytecode is cached to avoid compiling it *
+ *           on every check. The cache is reset when its size limit is        *
+ *           reached.                                                         *
+ *                                                                            *
+ ******************************************************************************/
+static const zbx_script_bytecode_t	*script_get_bytecode(const char *script, char **error)
+{
+	zbx_script_bytecode_t	bc_local, *bc;
+
+	if (0 == es_bytecode_initialized)
+	{
+		zbx_hashset_create_ext(&es_bytecode, 0, script_bytecode_hash, script_bytecode_compare,
+				script_bytecode_clear, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+				ZBX_DEFAULT_MEM_FREE_FUNC);
+		es_bytecode_initialized = 1;
+	}
+
+	bc_local.script = (char *)script;
+
+	if (NULL != (bc = (zbx_script_bytecode_t *)zbx_hashset_search(&es_bytecode, &bc_local)))
+		return bc;
+
+	if (SUCCEED != zbx_es_compile(&es_engine, script, &bc_local.bin, &bc_local.bin_sz, error))
+		return NULL;
+
+	if (SCRIPTITEM_BYTECODE_CACHE_MAX <= es_bytecode.num_data)
+		zbx_hashset_clear(&es_bytecode);
+
+	bc_local.script = zbx_strdup(NULL, script);
+
+	return (zbx_script_bytecode_t *)zbx_hashset_insert(&es_bytecode, &bc_local, sizeof(bc_local));
 }
 
 int	get_value_script(zbx_dc_item_t *item, const char *config_source_ip, AGENT_RESULT *result)
 {
-	char		*error = NULL, *script_bin = NULL, *output = NULL;
-	int		script_bin_sz, timeout_seconds, ret = NOTSUPPORTED;
+	char				*error = NULL, *output = NULL;
+	int				timeout_seconds, ret = NOTSUPPORTED;
+	const zbx_script_bytecode_t	*bc;
 
 	if (FAIL == zbx_is_time_suffix(item->timeout, &timeout_seconds, strlen(item->timeout)))
 	{
@@ -51,7 +137,7 @@ int	get_value_script(zbx_dc_item_t *item, const char *config_source_ip, AGENT_RE
 		return ret;
 	}
 
-	if (SUCCEED != zbx_es_compile(&es_engine, item->params, &script_bin, &script_bin_sz, &error))
+	if (NULL == (bc = script_get_bytecode(item->params, &error)))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot compile script: %s", error));
 		goto err;
@@ -59,7 +145,7 @@ int	get_value_script(zbx_dc_item_t *item, const char *config_source_ip, AGENT_RE
 
 	zbx_es_set_timeout(&es_engine, timeout_seconds);
 
-	if (SUCCEED != zbx_es_execute(&es_engine, NULL, script_bin, script_bin_sz, item->script_params, &output,
+	if (SUCCEED != zbx_es_execute(&es_engine, NULL, bc->bin, bc->bin_sz, item->script_params, &output,
 			&error))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot execute script: %s", error));
@@ -81,7 +167,6 @@ err:
 		}
 	}
 
-	zbx_free(script_bin);
 	zbx_free(error);
 
 	return ret;
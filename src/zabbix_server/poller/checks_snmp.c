@@ -171,8 +171,31 @@ struct zbx_snmp_context
 	unsigned char			snmpv3_privprotocol;
 	char				*snmpv3_privpassphrase;
 	const char			*config_source_ip;
+	char				*walk_oids;
 };
 
+/* walk[] results of the same subtrees on the same SNMP agent/user shared between items for a short time */
+typedef struct
+{
+	char		*addr;
+	unsigned short	port;
+	char		*oids;			/* walk[] OID parameters */
+	char		*community_context;	/* community (SNMPv1 or v2c) or contextName (SNMPv3) */
+	char		*security_name;		/* only SNMPv3, empty string in case of other versions */
+	char		*authpassphrase;	/* only SNMPv3, empty string in case of other versions */
+	char		*privpassphrase;	/* only SNMPv3, empty string in case of other versions */
+	unsigned char	snmp_version;
+	unsigned char	securitylevel;		/* only SNMPv3, 0 in case of other versions */
+	unsigned char	authprotocol;		/* only SNMPv3, 0 in case of other versions */
+	unsigned char	privprotocol;		/* only SNMPv3, 0 in case of other versions */
+	char		*value;
+	zbx_uint64_t	itemid;			/* the item which retrieved the value */
+	time_t		expires;
+}
+zbx_snmp_walk_entry_t;
+
+#define ZBX_SNMP_WALK_CACHE_TTL	5
+
 typedef struct
 {
 	AGENT_RESULT	*result;
@@ -182,6 +205,8 @@ typedef struct
 zbx_snmp_result_t;
 
 static ZBX_THREAD_LOCAL zbx_hashset_t	snmpidx;		/* Dynamic Index Cache */
+static ZBX_THREAD_LOCAL zbx_hashset_t	snmpwalk;		/* walk[] result cache */
+static ZBX_THREAD_LOCAL time_t		snmpwalk_cleanup;
 static char				zbx_snmp_init_done;
 static char				zbx_snmp_init_bulkwalk_done;
 static pthread_rwlock_t			snmp_exec_rwlock;
@@ -270,6 +295,71 @@ static void	__snmpidx_mapping_clean(void *data)
 	zbx_free(mapping->index);
 }
 
+static zbx_hash_t	__snmpwalk_entry_hash(const void *data)
+{
+	const zbx_snmp_walk_entry_t	*entry = (const zbx_snmp_walk_entry_t *)data;
+
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_STRING_HASH_FUNC(entry->addr);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(&entry->port, sizeof(entry->port), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(entry->oids, strlen(entry->oids), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(entry->community_context, strlen(entry->community_context), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(entry->security_name, strlen(entry->security_name), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(entry->authpassphrase, strlen(entry->authpassphrase), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(entry->privpassphrase, strlen(entry->privpassphrase), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(&entry->snmp_version, sizeof(entry->snmp_version), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(&entry->securitylevel, sizeof(entry->securitylevel), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(&entry->authprotocol, sizeof(entry->authprotocol), hash);
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(&entry->privprotocol, sizeof(entry->privprotocol), hash);
+
+	return hash;
+}
+
+static int	__snmpwalk_entry_compare(const void *d1, const void *d2)
+{
+	const zbx_snmp_walk_entry_t	*entry1 = (const zbx_snmp_walk_entry_t *)d1;
+	const zbx_snmp_walk_entry_t	*entry2 = (const zbx_snmp_walk_entry_t *)d2;
+
+	int				ret;
+
+	if (0 != (ret = strcmp(entry1->addr, entry2->addr)))
+		return ret;
+
+	ZBX_RETURN_IF_NOT_EQUAL(entry1->port, entry2->port);
+	ZBX_RETURN_IF_NOT_EQUAL(entry1->snmp_version, entry2->snmp_version);
+	ZBX_RETURN_IF_NOT_EQUAL(entry1->securitylevel, entry2->securitylevel);
+	ZBX_RETURN_IF_NOT_EQUAL(entry1->authprotocol, entry2->authprotocol);
+	ZBX_RETURN_IF_NOT_EQUAL(entry1->privprotocol, entry2->privprotocol);
+
+	if (0 != (ret = strcmp(entry1->community_context, entry2->community_context)))
+		return ret;
+
+	if (0 != (ret = strcmp(entry1->security_name, entry2->security_name)))
+		return ret;
+
+	if (0 != (ret = strcmp(entry1->authpassphrase, entry2->authpassphrase)))
+		return ret;
+
+	if (0 != (ret = strcmp(entry1->privpassphrase, entry2->privpassphrase)))
+		return ret;
+
+	return strcmp(entry1->oids, entry2->oids);
+}
+
+static void	__snmpwalk_entry_clean(void *data)
+{
+	zbx_snmp_walk_entry_t	*entry = (zbx_snmp_walk_entry_t *)data;
+
+	zbx_free(entry->addr);
+	zbx_free(entry->oids);
+	zbx_free(entry->community_context);
+	zbx_free(entry->security_name);
+	zbx_free(entry->authpassphrase);
+	zbx_free(entry->privpassphrase);
+	zbx_free(entry->value);
+}
+
 static int	zbx_snmp_oid_compare(const zbx_snmp_oid_t **s1, const zbx_snmp_oid_t **s2)
 {
 	return strcmp((*s1)->str_oid, (*s2)->str_oid);
@@ -357,22 +447,26 @@ end:
 
 /******************************************************************************
  *                                                                            *
- * Purpose: store the index-value pair in the relevant index cache            *
+ * Purpose: prepare the relevant index cache for rebuilding                   *
  *                                                                            *
  * Parameters: item      - [IN] configuration of Zabbix item, contains        *
  *                              IP address, port, community string, context,  *
  *                              security name                                 *
  *             snmp_oid  - [IN] OID of the table which contains the indexes   *
- *             index     - [IN] index part of the index-value pair            *
- *             value     - [IN] value part of the index-value pair            *
+ *                                                                            *
+ * Return value: the emptied index-value mappings of the specified index      *
+ *               cache                                                        *
+ *                                                                            *
+ * Comments: The index cache is created if it does not exist. The mappings    *
+ *           are returned so the whole OID table walk can store index-value   *
+ *           pairs without looking up the index cache for every row.          *
  *                                                                            *
  ******************************************************************************/
-static void	cache_put_snmp_index(const zbx_dc_item_t *item, const char *snmp_oid, const char *index, const char *value)
+static zbx_hashset_t	*cache_reset_snmp_index_subtree(const zbx_dc_item_t *item, const char *snmp_oid)
 {
 	zbx_snmpidx_main_key_t	*main_key, main_key_local;
-	zbx_snmpidx_mapping_t	*mapping, mapping_local;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() OID:'%s' index:'%s' value:'%s'", __func__, snmp_oid, index, value);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() OID:'%s'", __func__, snmp_oid);
 
 	if (NULL == snmpidx.slots)
 	{
@@ -404,57 +498,43 @@ static void	cache_put_snmp_index(const zbx_dc_item_t *item, const char *snmp_oid
 		main_key = (zbx_snmpidx_main_key_t *)zbx_hashset_insert(&snmpidx, &main_key_local,
 				sizeof(main_key_local));
 	}
-
-	if (NULL == (mapping = (zbx_snmpidx_mapping_t *)zbx_hashset_search(main_key->mappings, &value)))
-	{
-		mapping_local.value = zbx_strdup(NULL, value);
-		mapping_local.index = zbx_strdup(NULL, index);
-
-		zbx_hashset_insert(main_key->mappings, &mapping_local, sizeof(mapping_local));
-	}
-	else if (0 != strcmp(mapping->index, index))
-	{
-		zbx_free(mapping->index);
-		mapping->index = zbx_strdup(NULL, index);
-	}
+	else
+		zbx_hashset_clear(main_key->mappings);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+
+	return main_key->mappings;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: delete index-value mappings from the specified index cache        *
- *                                                                            *
- * Parameters: item      - [IN] configuration of Zabbix item, contains        *
- *                              IP address, port, community string, context,  *
- *                              security name                                 *
- *             snmp_oid  - [IN] OID of the table which contains the indexes   *
+ * Purpose: store the index-value pair in the index cache mappings            *
  *                                                                            *
- * Comments: does nothing if the index cache is empty or if it does not       *
- *           contain the cache for the specified OID                          *
+ * Parameters: mappings - [IN] the index cache mappings returned by           *
+ *                             cache_reset_snmp_index_subtree()               *
+ *             index    - [IN] index part of the index-value pair             *
+ *             value    - [IN] value part of the index-value pair             *
  *                                                                            *
  ******************************************************************************/
-static void	cache_del_snmp_index_subtree(const zbx_dc_item_t *item, const char *snmp_oid)
+static void	cache_put_snmp_index(zbx_hashset_t *mappings, const char *index, const char *value)
 {
-	zbx_snmpidx_main_key_t	*main_key, main_key_local;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() OID:'%s'", __func__, snmp_oid);
-
-	if (NULL == snmpidx.slots)
-		goto end;
+	zbx_snmpidx_mapping_t	*mapping, mapping_local;
 
-	main_key_local.addr = item->interface.addr;
-	main_key_local.port = item->interface.port;
-	main_key_local.oid = (char *)snmp_oid;
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() index:'%s' value:'%s'", __func__, index, value);
 
-	main_key_local.community_context = get_item_community_context(item);
-	main_key_local.security_name = get_item_security_name(item);
+	if (NULL == (mapping = (zbx_snmpidx_mapping_t *)zbx_hashset_search(mappings, &value)))
+	{
+		mapping_local.value = zbx_strdup(NULL, value);
+		mapping_local.index = zbx_strdup(NULL, index);
 
-	if (NULL == (main_key = (zbx_snmpidx_main_key_t *)zbx_hashset_search(&snmpidx, &main_key_local)))
-		goto end;
+		zbx_hashset_insert(mappings, &mapping_local, sizeof(mapping_local));
+	}
+	else if (0 != strcmp(mapping->index, index))
+	{
+		zbx_free(mapping->index);
+		mapping->index = zbx_strdup(NULL, index);
+	}
 
-	zbx_hashset_clear(main_key->mappings);
-end:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -1993,7 +2073,7 @@ out:
 
 static void	zbx_snmp_walk_cache_cb(void *arg, const char *snmp_oid, const char *index, const char *value)
 {
-	cache_put_snmp_index((const zbx_dc_item_t *)arg, snmp_oid, index, value);
+	cache_put_snmp_index((zbx_hashset_t *)arg, index, value);
 }
 
 typedef struct
@@ -2094,7 +2174,7 @@ static int	snmp_bulkwalk_handle_response(int status, struct snmp_pdu *response,
 		size_t max_error_len)
 {
 	struct variable_list	*var;
-	int			ret = SUCCEED;
+	int			ret = SUCCEED, printed;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -2124,8 +2204,6 @@ static int	snmp_bulkwalk_handle_response(int status, struct snmp_pdu *response,
 		if (SNMP_ENDOFMIBVIEW != var->type && SNMP_NOSUCHOBJECT != var->type &&
 				SNMP_NOSUCHINSTANCE != var->type)
 		{
-			char	buffer[MAX_STRING_LEN];
-
 			bulkwalk_context->vars_num++;
 
 			if (SNMP_MSG_GET != bulkwalk_context->pdu_type)
@@ -2140,12 +2218,30 @@ static int	snmp_bulkwalk_handle_response(int status, struct snmp_pdu *response,
 			else
 				bulkwalk_context->running = 0;
 
-			snprint_variable(buffer, sizeof(buffer), var->name, var->name_length, var);
-
 			if (NULL != *results)
 				zbx_chrcpy_alloc(results, results_alloc, results_offset, '\n');
 
-			zbx_strcpy_alloc(results, results_alloc, results_offset, buffer);
+			/* print variable directly into the results buffer instead of copying it from a */
+			/* temporary buffer, walks of large tables can return thousands of variables    */
+			if (NULL == *results || *results_alloc - *results_offset < MAX_STRING_LEN)
+			{
+				*results_alloc = MAX(*results_alloc * 3 / 2, *results_offset + MAX_STRING_LEN);
+				*results = (char *)zbx_realloc(*results, *results_alloc);
+			}
+
+			(*results)[*results_offset] = '\0';
+
+			if (0 <= (printed = snprint_variable(*results + *results_offset, MAX_STRING_LEN, var->name,
+					var->name_length, var)))
+			{
+				*results_offset += (size_t)printed;
+			}
+			else
+			{
+				/* output was truncated, keep what fits into the buffer */
+				(*results)[*results_offset + MAX_STRING_LEN - 1] = '\0';
+				*results_offset += strlen(*results + *results_offset);
+			}
 
 			if (NULL == var->next_variable)
 			{
@@ -2418,6 +2514,133 @@ void	zbx_unset_snmp_bulkwalk_options(void)
 	snmp_bulkwalk_set_options(&default_opts);
 }
 
+static void	snmp_walk_cache_key(const zbx_snmp_context_t *snmp_context, zbx_snmp_walk_entry_t *entry)
+{
+	entry->addr = snmp_context->item.interface.addr;
+	entry->port = snmp_context->item.interface.port;
+	entry->oids = snmp_context->walk_oids;
+	entry->snmp_version = snmp_context->snmp_version;
+
+	if (ZBX_IF_SNMP_VERSION_3 == snmp_context->snmp_version)
+	{
+		entry->community_context = ZBX_NULL2EMPTY_STR(snmp_context->snmpv3_contextname);
+		entry->security_name = ZBX_NULL2EMPTY_STR(snmp_context->snmpv3_securityname);
+		entry->authpassphrase = ZBX_NULL2EMPTY_STR(snmp_context->snmpv3_authpassphrase);
+		entry->privpassphrase = ZBX_NULL2EMPTY_STR(snmp_context->snmpv3_privpassphrase);
+		entry->securitylevel = snmp_context->snmpv3_securitylevel;
+		entry->authprotocol = snmp_context->snmpv3_authprotocol;
+		entry->privprotocol = snmp_context->snmpv3_privprotocol;
+	}
+	else
+	{
+		entry->community_context = ZBX_NULL2EMPTY_STR(snmp_context->snmp_community);
+		entry->security_name = "";
+		entry->authpassphrase = "";
+		entry->privpassphrase = "";
+		entry->securitylevel = 0;
+		entry->authprotocol = 0;
+		entry->privprotocol = 0;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get walk[] result of the same subtrees retrieved by another item  *
+ *          from the same SNMP agent/user not longer than cache TTL ago       *
+ *                                                                            *
+ * Parameters: snmp_context - [IN/OUT]                                        *
+ *                                                                            *
+ * Return value: SUCCEED - the item result was set from cache                 *
+ *               FAIL    - the subtrees must be walked                        *
+ *                                                                            *
+ * Comments: The result retrieved by the item itself is never reused, so an   *
+ *           item is never served its own stale value.                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_walk_cache_get(zbx_snmp_context_t *snmp_context)
+{
+	zbx_snmp_walk_entry_t	*entry, entry_local;
+
+	if (NULL == snmpwalk.slots || NULL == snmp_context->walk_oids)
+		return FAIL;
+
+	snmp_walk_cache_key(snmp_context, &entry_local);
+
+	if (NULL == (entry = (zbx_snmp_walk_entry_t *)zbx_hashset_search(&snmpwalk, &entry_local)))
+		return FAIL;
+
+	if (entry->expires <= time(NULL) || entry->itemid == snmp_context->item.itemid)
+		return FAIL;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() itemid:" ZBX_FS_UI64 " reusing walk result of itemid:" ZBX_FS_UI64,
+			__func__, snmp_context->item.itemid, entry->itemid);
+
+	SET_TEXT_RESULT(&snmp_context->item.result, zbx_strdup(NULL, entry->value));
+	snmp_context->item.ret = SUCCEED;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: store walk[] result for reuse by other items walking the same     *
+ *          subtrees on the same SNMP agent/user                              *
+ *                                                                            *
+ * Parameters: snmp_context - [IN]                                            *
+ *             value        - [IN] the walk result                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_walk_cache_put(const zbx_snmp_context_t *snmp_context, const char *value)
+{
+	zbx_snmp_walk_entry_t	*entry, entry_local;
+	time_t			now;
+
+	if (NULL == snmp_context->walk_oids)
+		return;
+
+	now = time(NULL);
+
+	if (NULL == snmpwalk.slots)
+	{
+		zbx_hashset_create_ext(&snmpwalk, 100, __snmpwalk_entry_hash, __snmpwalk_entry_compare,
+				__snmpwalk_entry_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+				ZBX_DEFAULT_MEM_FREE_FUNC);
+		snmpwalk_cleanup = now + ZBX_SNMP_WALK_CACHE_TTL;
+	}
+	else if (snmpwalk_cleanup <= now)
+	{
+		zbx_hashset_iter_t	iter;
+
+		zbx_hashset_iter_reset(&snmpwalk, &iter);
+		while (NULL != (entry = (zbx_snmp_walk_entry_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (entry->expires <= now)
+				zbx_hashset_iter_remove(&iter);
+		}
+
+		snmpwalk_cleanup = now + ZBX_SNMP_WALK_CACHE_TTL;
+	}
+
+	snmp_walk_cache_key(snmp_context, &entry_local);
+
+	if (NULL == (entry = (zbx_snmp_walk_entry_t *)zbx_hashset_search(&snmpwalk, &entry_local)))
+	{
+		entry_local.addr = zbx_strdup(NULL, entry_local.addr);
+		entry_local.oids = zbx_strdup(NULL, entry_local.oids);
+		entry_local.community_context = zbx_strdup(NULL, entry_local.community_context);
+		entry_local.security_name = zbx_strdup(NULL, entry_local.security_name);
+		entry_local.authpassphrase = zbx_strdup(NULL, entry_local.authpassphrase);
+		entry_local.privpassphrase = zbx_strdup(NULL, entry_local.privpassphrase);
+		entry_local.value = NULL;
+
+		entry = (zbx_snmp_walk_entry_t *)zbx_hashset_insert(&snmpwalk, &entry_local, sizeof(entry_local));
+	}
+
+	entry->value = zbx_strdup(entry->value, value);
+	entry->itemid = snmp_context->item.itemid;
+	entry->expires = now + ZBX_SNMP_WALK_CACHE_TTL;
+}
+
 static int	snmp_task_process(short event, void *data, int *fd, const char *addr, char *dnserr)
 {
 	zbx_bulkwalk_context_t	*bulkwalk_context;
@@ -2531,6 +2754,8 @@ static int	snmp_task_process(short event, void *data, int *fd, const char *addr,
 					else
 						SET_TEXT_RESULT(&snmp_context->item.result, snmp_context->results);
 
+					snmp_walk_cache_put(snmp_context, snmp_context->item.result.text);
+
 					snmp_context->results = NULL;
 					snmp_context->item.ret = SUCCEED;
 					goto stop;
@@ -2540,6 +2765,9 @@ static int	snmp_task_process(short event, void *data, int *fd, const char *addr,
 	}
 	else
 	{
+		if (SUCCEED == snmp_walk_cache_get(snmp_context))
+			goto stop;
+
 		if (NULL == (snmp_context->ssp = zbx_snmp_open_session(snmp_context->snmp_version, addr,
 				snmp_context->item.interface.port, snmp_context->snmp_community,
 				snmp_context->snmpv3_securityname, snmp_context->snmpv3_contextname,
@@ -2587,6 +2815,7 @@ void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context)
 	zbx_free(snmp_context->snmpv3_contextname);
 	zbx_free(snmp_context->snmpv3_authpassphrase);
 	zbx_free(snmp_context->snmpv3_privpassphrase);
+	zbx_free(snmp_context->walk_oids);
 
 	zbx_free(snmp_context->item.key);
 	zbx_free(snmp_context->item.key_orig);
@@ -2651,6 +2880,7 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 	snmp_context->snmpv3_privpassphrase = item->snmpv3_privpassphrase;
 	item->snmpv3_privpassphrase = NULL;
 	snmp_context->config_source_ip = config_source_ip;
+	snmp_context->walk_oids = NULL;
 
 	zbx_vector_bulkwalk_context_create(&snmp_context->bulkwalk_contexts);
 
@@ -2690,6 +2920,8 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 		goto out;
 	}
 
+	snmp_context->walk_oids = zbx_strdup(NULL, item->snmp_oid);
+
 	for (i = 0; i < snmp_context->param_oids.values_num; i++)
 	{
 		zbx_bulkwalk_context_t	*bulkwalk_context;
@@ -2729,6 +2961,7 @@ static int	zbx_snmp_process_dynamic(zbx_snmp_sess_t ssp, const zbx_dc_item_t *it
 	char		oids_translated[ZBX_MAX_SNMP_ITEMS][ZBX_ITEM_SNMP_OID_LEN_MAX];
 	char		*idx = NULL, *pl;
 	size_t		idx_alloc = 32;
+	zbx_hashset_t	*mappings;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -2844,10 +3077,10 @@ static int	zbx_snmp_process_dynamic(zbx_snmp_sess_t ssp, const zbx_dc_item_t *it
 
 			/* walk */
 
-			cache_del_snmp_index_subtree(&items[j], oids_translated[j]);
+			mappings = cache_reset_snmp_index_subtree(&items[j], oids_translated[j]);
 
 			errcode = zbx_snmp_walk(ssp, &items[j], oids_translated[j], error, max_error_len, max_succeed,
-					min_fail, num, bulk, zbx_snmp_walk_cache_cb, (void *)&items[j]);
+					min_fail, num, bulk, zbx_snmp_walk_cache_cb, (void *)mappings);
 
 			if (NETWORK_ERROR == errcode)
 			{
@@ -3224,6 +3457,9 @@ void	zbx_clear_cache_snmp(unsigned char process_type, int process_num)
 	zabbix_log(LOG_LEVEL_WARNING, "forced reloading of the snmp cache on [%s #%d]",
 			get_process_type_string(process_type), process_num);
 
+	if (NULL != snmpwalk.slots)
+		zbx_hashset_destroy(&snmpwalk);
+
 	if (0 == zbx_snmp_init_done)
 		return;
 
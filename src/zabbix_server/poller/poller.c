@@ -825,7 +825,8 @@ static int	get_values(unsigned char poller_type, int *nextcheck, const zbx_confi
 {
 	zbx_dc_item_t		item, *items;
 	AGENT_RESULT		results[ZBX_MAX_POLLER_ITEMS];
-	int			errcodes[ZBX_MAX_POLLER_ITEMS];
+	int			errcodes[ZBX_MAX_POLLER_ITEMS], lastclocks[ZBX_MAX_POLLER_ITEMS];
+	zbx_uint64_t		itemids[ZBX_MAX_POLLER_ITEMS];
 	zbx_timespec_t		timespec;
 	int			i, num, last_available = ZBX_INTERFACE_AVAILABLE_UNKNOWN;
 	zbx_vector_ptr_t	add_results;
@@ -940,10 +941,13 @@ static int	get_values(unsigned char poller_type, int *nextcheck, const zbx_confi
 					items[i].flags, NULL, &timespec, items[i].state, results[i].msg);
 		}
 
-		zbx_dc_poller_requeue_items(&items[i].itemid, &timespec.sec, &errcodes[i], 1, poller_type,
-				nextcheck);
+		itemids[i] = items[i].itemid;
+		lastclocks[i] = timespec.sec;
 	}
 
+	/* requeue the whole batch at once to lock configuration cache only once */
+	zbx_dc_poller_requeue_items(itemids, lastclocks, errcodes, (size_t)num, poller_type, nextcheck);
+
 	zbx_preprocessor_flush();
 	zbx_clean_items(items, num, results);
 	zbx_dc_config_clean_items(items, NULL, (size_t)num);
@@ -1177,7 +1177,7 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 	char				*error = NULL, *buffer = NULL, *version_str = NULL;
 	struct zbx_json			j;
 	zbx_dc_proxy_t			proxy;
-	int				ret, flags = ZBX_TCP_PROTOCOL, loglevel, version_int;
+	int				ret, flags = ZBX_TCP_PROTOCOL, loglevel, version_int, method;
 	size_t				buffer_size, reserved = 0;
 	zbx_proxyconfig_status_t	status;
 
@@ -1225,7 +1225,9 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	method = zbx_get_compression_method(jp);
+
+	if (SUCCEED != zbx_compress_ext(j.buffer, j.buffer_size, &buffer, &buffer_size, method))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
@@ -1240,7 +1242,7 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 			sock->peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
 			(double)reserved / (double)buffer_size);
 
-	ret = zbx_tcp_send_ext(sock, buffer, buffer_size, reserved, (unsigned char)flags,
+	ret = zbx_tcp_send_ext(sock, buffer, buffer_size, reserved, zbx_compress_method_protocol(method),
 			CONFIG_TRAPPER_TIMEOUT);
 
 	if (SUCCEED != ret)
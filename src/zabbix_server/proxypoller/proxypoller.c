@@ -169,6 +169,7 @@ static int	get_data_from_proxy(zbx_dc_proxy_t *proxy, const char *request, int c
 	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
 
 	zbx_json_addstring(&j, "request", request, ZBX_JSON_TYPE_STRING);
+	zbx_json_add_compression(&j);
 
 	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
@@ -596,11 +597,11 @@ static int	process_proxy(const zbx_config_vault_t *config_vault, int config_time
 			if (proxy.proxy_data_nextcheck <= now && (proxy.compatibility == ZBX_PROXY_VERSION_CURRENT ||
 					proxy.compatibility == ZBX_PROXY_VERSION_OUTDATED))
 			{
-				int	more;
+				int	more = ZBX_PROXY_DATA_DONE;
 
 				do
 				{
-					if (FAIL == zbx_hc_check_proxy(proxy.proxyid))
+					if (FAIL == zbx_hc_check_proxy(proxy.proxyid, ZBX_PROXY_DATA_MORE == more))
 						break;
 
 					if (SUCCEED != (ret = proxy_get_data(&proxy, config_timeout, events_cbs,
@@ -39,6 +39,9 @@ zbx_buffer_t;
 
 #if defined(HAVE_LIBCURL)
 
+/* cURL handle is kept between reports to reuse web service connections */
+static CURL	*rw_curl = NULL;
+
 static size_t	curl_write_cb(void *ptr, size_t size, size_t nmemb, void *userdata)
 {
 	size_t		r_size = size * nmemb, buf_alloc;
@@ -139,15 +142,24 @@ static int	rw_get_report(const char *url, const char *cookie, int width, int hei
 	zbx_json_addstring(&j, "height", buffer, ZBX_JSON_TYPE_STRING);
 	zbx_json_close(&j);
 
-	if (NULL == (curl = curl_easy_init()))
+	if (NULL == rw_curl)
 	{
-		*error = zbx_strdup(NULL, "Cannot initialize cURL library");
-		goto out;
+		if (NULL == (rw_curl = curl_easy_init()))
+		{
+			*error = zbx_strdup(NULL, "Cannot initialize cURL library");
+			goto out;
+		}
 	}
+	else
+		curl_easy_reset(rw_curl);
+
+	curl = rw_curl;
 
 	headers = curl_slist_append(headers, "Content-Type:application/json");
 
+	/* reset keeps the cookies of previous reports, they must not be sent with other user session */
 	if (CURLE_OK != (err = curl_easy_setopt(curl, opt = CURLOPT_COOKIEFILE, "")) ||
+			CURLE_OK != (err = curl_easy_setopt(curl, opt = CURLOPT_COOKIELIST, "ALL")) ||
 			CURLE_OK != (err = curl_easy_setopt(curl, opt = CURLOPT_FOLLOWLOCATION, 1L)) ||
 			CURLE_OK != (err = curl_easy_setopt(curl, opt = CURLOPT_WRITEFUNCTION, curl_write_cb)) ||
 			CURLE_OK != (err = curl_easy_setopt(curl, opt = CURLOPT_WRITEDATA, &response)) ||
@@ -247,9 +259,6 @@ out:
 
 	curl_slist_free_all(headers);
 
-	if (NULL != curl)
-		curl_easy_cleanup(curl);
-
 	zbx_json_clean(&j);
 	zbx_free(cookie_value);
 
@@ -494,6 +494,9 @@ int	rtc_process_request_ex_server(zbx_rtc_t *rtc, zbx_uint32_t code, const unsig
 		case ZBX_RTC_PROXYPOLLER_PROCESS:
 			zbx_rtc_notify(rtc, ZBX_PROCESS_TYPE_PROXYPOLLER, 0, ZBX_RTC_PROXYPOLLER_PROCESS, NULL, 0);
 			return SUCCEED;
+		case ZBX_RTC_TASKMANAGER_PROCESS:
+			zbx_rtc_notify(rtc, ZBX_PROCESS_TYPE_TASKMANAGER, 0, ZBX_RTC_TASKMANAGER_PROCESS, NULL, 0);
+			return SUCCEED;
 	}
 
 	return FAIL;
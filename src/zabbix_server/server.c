@@ -79,6 +79,7 @@
 #include "zbxthreads.h"
 #include "zbxicmpping.h"
 #include "zbxipcservice.h"
+#include "zbxshmem.h"
 #include "preproc/preproc_server.h"
 #include "zbxavailability.h"
 #include "zbxdbwrap.h"
@@ -296,6 +297,8 @@ static int	config_vmware_frequency		= 60;
 static int	config_vmware_perf_frequency	= 60;
 static int	config_vmware_timeout		= 10;
 
+static int	config_huge_pages		= 0;
+
 static zbx_uint64_t	config_conf_cache_size		= 32 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_history_cache_size	= 16 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_history_index_cache_size	= 4 * ZBX_MEBIBYTE;
@@ -837,6 +840,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	0,			1},
 		{"CacheSize",			&config_conf_cache_size,		TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(64) * ZBX_GIBIBYTE},
+		{"HugePages",			&config_huge_pages,			TYPE_INT,
+			PARM_OPT,	0,			1},
 		{"HistoryCacheSize",		&config_history_cache_size,		TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"HistoryIndexCacheSize",	&config_history_index_cache_size,	TYPE_UINT64,
@@ -1251,6 +1256,7 @@ int	main(int argc, char **argv)
 	zbx_init_library_dbupgrade(get_program_type);
 	zbx_init_library_dbwrap(zbx_lld_process_agent_result);
 	zbx_init_library_icmpping(&config_icmpping);
+	zbx_init_library_shmem(config_huge_pages);
 	zbx_init_library_ipcservice(program_type);
 	zbx_init_library_stats(get_program_type);
 	zbx_init_library_sysinfo(get_zbx_config_timeout, get_zbx_config_enable_remote_commands,
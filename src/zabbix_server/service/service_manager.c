@@ -1919,57 +1919,202 @@ void	service_get_rootcause_eventids(const zbx_service_t *parent, zbx_vector_uint
 	zbx_vector_uint64_uniq(eventids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+/* service status recalculation queue item */
+typedef struct
+{
+	zbx_service_t	*service;
+	zbx_timespec_t	ts;
+	int		depth;
+	int		flags;
+}
+zbx_service_recalc_t;
+
+static zbx_hash_t	service_recalc_hash_func(const void *d)
+{
+	const zbx_service_recalc_t	*recalc = (const zbx_service_recalc_t *)d;
+
+	return ZBX_DEFAULT_UINT64_HASH_FUNC(&recalc->service->serviceid);
+}
+
+static int	service_recalc_compare_func(const void *d1, const void *d2)
+{
+	const zbx_service_recalc_t	*recalc1 = (const zbx_service_recalc_t *)d1;
+	const zbx_service_recalc_t	*recalc2 = (const zbx_service_recalc_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(recalc1->service->serviceid, recalc2->service->serviceid);
+	return 0;
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: updates service and its parents statuses                          *
+ * Purpose: orders recalculation queue so that deeper services are processed  *
+ *          first                                                             *
  *                                                                            *
- * Parameters: service    - [IN] the service to update                        *
- *             ts         - [IN] the update timestamp                         *
- *             alarms     - [OUT] the alarms update queue                     *
+ ******************************************************************************/
+static int	service_recalc_queue_compare(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+	const zbx_service_recalc_t	*recalc1 = (const zbx_service_recalc_t *)e1->data;
+	const zbx_service_recalc_t	*recalc2 = (const zbx_service_recalc_t *)e2->data;
+
+	ZBX_RETURN_IF_NOT_EQUAL(recalc2->depth, recalc1->depth);
+	ZBX_RETURN_IF_NOT_EQUAL(recalc1->service->serviceid, recalc2->service->serviceid);
+	return 0;
+}
+
+/******************************************************************************
  *                                                                            *
- * Comments: This function recalculates service status according to the       *
- *           algorithm and status of the children services. If the status     *
- *           has been changed, an alarm is generated and parent services      *
- *           (up until the root service) are updated too.                     *
+ * Purpose: gets service depth - the longest path from a root service         *
+ *                                                                            *
+ * Parameters: service - [IN] the service                                     *
+ *             depths  - [IN/OUT] the calculated depths (serviceid, depth)    *
+ *                                                                            *
+ * Return value: The service depth.                                           *
+ *                                                                            *
+ * Comments: Only the service ancestors are visited. Each service is deeper   *
+ *           than any of its parents.                                         *
  *                                                                            *
  ******************************************************************************/
-static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_timespec_t *ts,
-		zbx_vector_ptr_t *alarms, zbx_hashset_t *service_updates, int flags)
+static int	service_get_depth(const zbx_service_t *service, zbx_hashset_t *depths)
 {
-	int	status, rule_status, i;
+	zbx_uint64_pair_t	*pair, pair_local;
+	int			i, depth = 0, parent_depth;
 
-	status = service_get_main_status(itservice);
+	if (NULL != (pair = (zbx_uint64_pair_t *)zbx_hashset_search(depths, &service->serviceid)))
+		return (int)pair->second;
 
-	for (i = 0; i < itservice->status_rules.values_num; i++)
+	for (i = 0; i < service->parents.values_num; i++)
 	{
-		zbx_service_rule_t	*rule = (zbx_service_rule_t *)itservice->status_rules.values[i];
-
-		if (status < (rule_status = service_get_rule_status(itservice, rule)))
-			status = rule_status;
+		if (depth <= (parent_depth = service_get_depth((zbx_service_t *)service->parents.values[i], depths)))
+			depth = parent_depth + 1;
 	}
 
-	if (itservice->status != status)
-	{
-		zbx_service_update_t	*update;
+	pair_local.first = service->serviceid;
+	pair_local.second = (zbx_uint64_t)depth;
+	zbx_hashset_insert(depths, &pair_local, sizeof(pair_local));
+
+	return depth;
+}
+
+typedef struct
+{
+	zbx_hashset_t		recalcs;
+	zbx_hashset_t		depths;
+	zbx_binary_heap_t	queue;
+}
+zbx_service_recalc_queue_t;
+
+static void	its_recalc_queue_init(zbx_service_recalc_queue_t *queue)
+{
+	zbx_hashset_create(&queue->recalcs, 100, service_recalc_hash_func, service_recalc_compare_func);
+	zbx_hashset_create(&queue->depths, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_binary_heap_create(&queue->queue, service_recalc_queue_compare, ZBX_BINARY_HEAP_OPTION_EMPTY);
+}
+
+static void	its_recalc_queue_destroy(zbx_service_recalc_queue_t *queue)
+{
+	zbx_binary_heap_destroy(&queue->queue);
+	zbx_hashset_destroy(&queue->depths);
+	zbx_hashset_destroy(&queue->recalcs);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: queues parents of the service for status recalculation            *
+ *                                                                            *
+ * Parameters: queue   - [IN/OUT] the recalculation queue                     *
+ *             service - [IN] the service                                     *
+ *             ts      - [IN] the update timestamp                            *
+ *             flags   - [IN] the update flags                                *
+ *                                                                            *
+ * Comments: Parents already in the queue are not queued again, their         *
+ *           timestamp and flags are merged instead.                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	its_recalc_queue_parents(zbx_service_recalc_queue_t *queue, const zbx_service_t *service,
+		const zbx_timespec_t *ts, int flags)
+{
+	int	i;
 
-		update = update_service(service_updates, itservice, status, ts);
-		update->alarm = its_updates_append(alarms, itservice->serviceid, status, ts->sec);
+	for (i = 0; i < service->parents.values_num; i++)
+	{
+		zbx_service_recalc_t	recalc_local = {.service = (zbx_service_t *)service->parents.values[i]},
+					*recalc;
 
-		/* update parent services */
-		for (i = 0; i < itservice->parents.values_num; i++)
+		if (NULL == (recalc = (zbx_service_recalc_t *)zbx_hashset_search(&queue->recalcs, &recalc_local)))
 		{
-			its_itservice_update_status((zbx_service_t *)itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
+			zbx_binary_heap_elem_t	elem;
+
+			recalc_local.ts = *ts;
+			recalc_local.flags = flags;
+			recalc_local.depth = service_get_depth(recalc_local.service, &queue->depths);
+			recalc = (zbx_service_recalc_t *)zbx_hashset_insert(&queue->recalcs, &recalc_local,
+					sizeof(recalc_local));
+
+			elem.key = 0;
+			elem.data = (void *)recalc;
+			zbx_binary_heap_insert(&queue->queue, &elem);
+			continue;
 		}
+
+		recalc->flags |= flags;
+
+		if (0 > zbx_timespec_compare(&recalc->ts, ts))
+			recalc->ts = *ts;
 	}
-	else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & flags))
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates statuses of the queued services and their parents         *
+ *                                                                            *
+ * Parameters: queue           - [IN/OUT] the recalculation queue             *
+ *             alarms          - [OUT] the alarms update queue                *
+ *             service_updates - [OUT] the service updates                    *
+ *                                                                            *
+ * Comments: This function recalculates service status according to the       *
+ *           algorithm and status of the children services. If the status     *
+ *           has been changed, an alarm is generated and parent services      *
+ *           (up until the root service) are queued too.                      *
+ *           Services are processed starting with the deepest ones, so each   *
+ *           affected service is recalculated only once, after all its        *
+ *           affected children.                                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	its_itservices_update_status(zbx_service_recalc_queue_t *queue, zbx_vector_ptr_t *alarms,
+		zbx_hashset_t *service_updates)
+{
+	while (FAIL == zbx_binary_heap_empty(&queue->queue))
 	{
-		/* update parent services */
-		for (i = 0; i < itservice->parents.values_num; i++)
+		zbx_service_recalc_t	*recalc;
+		zbx_service_t		*itservice;
+		int			status, rule_status, i;
+
+		recalc = (zbx_service_recalc_t *)zbx_binary_heap_find_min(&queue->queue)->data;
+		zbx_binary_heap_remove_min(&queue->queue);
+
+		itservice = recalc->service;
+		status = service_get_main_status(itservice);
+
+		for (i = 0; i < itservice->status_rules.values_num; i++)
+		{
+			zbx_service_rule_t	*rule = (zbx_service_rule_t *)itservice->status_rules.values[i];
+
+			if (status < (rule_status = service_get_rule_status(itservice, rule)))
+				status = rule_status;
+		}
+
+		if (itservice->status != status)
 		{
-			its_itservice_update_status((zbx_service_t *)itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
+			zbx_service_update_t	*update;
+
+			update = update_service(service_updates, itservice, status, &recalc->ts);
+			update->alarm = its_updates_append(alarms, itservice->serviceid, status, recalc->ts.sec);
+			its_recalc_queue_parents(queue, itservice, &recalc->ts, recalc->flags);
 		}
+		else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & recalc->flags))
+			its_recalc_queue_parents(queue, itservice, &recalc->ts, recalc->flags);
 	}
 }
 
@@ -2481,14 +2626,16 @@ static int	service_update_compare_func(const void *d1, const void *d2)
 
 static void	db_update_services(zbx_service_manager_t *manager)
 {
-	zbx_hashset_iter_t	iter;
-	zbx_services_diff_t	*service_diff;
-	zbx_vector_ptr_t	alarms, service_problems_new;
-	zbx_vector_uint64_t	service_problemids;
-	zbx_hashset_t		service_updates;
+	zbx_hashset_iter_t		iter;
+	zbx_services_diff_t		*service_diff;
+	zbx_vector_ptr_t		alarms, service_problems_new;
+	zbx_vector_uint64_t		service_problemids;
+	zbx_hashset_t			service_updates;
+	zbx_service_recalc_queue_t	queue;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
+	its_recalc_queue_init(&queue);
 	zbx_vector_ptr_create(&alarms);
 	zbx_vector_ptr_create(&service_problems_new);
 	zbx_vector_uint64_create(&service_problemids);
@@ -2590,24 +2737,15 @@ static void	db_update_services(zbx_service_manager_t *manager)
 			update = update_service(&service_updates, service, status, &ts);
 			update->alarm = its_updates_append(&alarms, service->serviceid, service->status, ts.sec);
 
-			/* update parent services */
-			for (i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
+			its_recalc_queue_parents(&queue, service, &ts, service_diff->flags);
 		}
 		else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & service_diff->flags))
-		{
-			/* update parent services */
-			for (i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
-		}
+			its_recalc_queue_parents(&queue, service, &ts, service_diff->flags);
 	}
 
+	its_itservices_update_status(&queue, &alarms, &service_updates);
+	its_recalc_queue_destroy(&queue);
+
 	do
 	{
 		zbx_db_begin();
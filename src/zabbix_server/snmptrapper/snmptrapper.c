@@ -223,8 +223,6 @@ next:
 	zbx_regexp_clean_expressions(&regexps);
 	zbx_vector_expression_destroy(&regexps);
 
-	zbx_preprocessor_flush();
-
 	return ret;
 }
 
@@ -375,6 +373,9 @@ static void	parse_traps(int flag)
 			*buffer = '\0';
 		}
 	}
+
+	/* send values of all traps in the buffer to preprocessing at once */
+	zbx_preprocessor_flush();
 }
 
 /******************************************************************************
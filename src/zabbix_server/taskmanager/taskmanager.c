@@ -1616,7 +1616,7 @@ ZBX_THREAD_ENTRY(taskmanager_thread, args)
 	int			server_num = ((zbx_thread_args_t *)args)->info.server_num;
 	int			process_num = ((zbx_thread_args_t *)args)->info.process_num;
 	unsigned char		process_type = ((zbx_thread_args_t *)args)->info.process_type;
-	zbx_uint32_t		rtc_msgs[] = {ZBX_RTC_PROXY_CONFIG_CACHE_RELOAD};
+	zbx_uint32_t		rtc_msgs[] = {ZBX_RTC_PROXY_CONFIG_CACHE_RELOAD, ZBX_RTC_TASKMANAGER_PROCESS};
 
 	zbx_thread_taskmanager_args	*taskmanager_args_in = (zbx_thread_taskmanager_args *)
 			((((zbx_thread_args_t *)args))->args);
@@ -1646,7 +1646,8 @@ ZBX_THREAD_ENTRY(taskmanager_thread, args)
 		zbx_uint32_t	rtc_cmd;
 		unsigned char	*rtc_data = NULL;
 
-		if (SUCCEED == zbx_rtc_wait(&rtc, info, &rtc_cmd, &rtc_data, sleeptime) && 0 != rtc_cmd)
+		/* new task notifications wake up task manager, the pending ones are processed with a single pass */
+		while (SUCCEED == zbx_rtc_wait(&rtc, info, &rtc_cmd, &rtc_data, sleeptime) && 0 != rtc_cmd)
 		{
 			if (ZBX_RTC_PROXY_CONFIG_CACHE_RELOAD == rtc_cmd)
 				tm_reload_proxy_cache_by_names(&rtc, rtc_data);
@@ -1654,7 +1655,9 @@ ZBX_THREAD_ENTRY(taskmanager_thread, args)
 			zbx_free(rtc_data);
 
 			if (ZBX_RTC_SHUTDOWN == rtc_cmd)
-				break;
+				goto stop;
+
+			sleeptime = 0;
 		}
 
 		sec1 = zbx_time();
@@ -1679,7 +1682,7 @@ ZBX_THREAD_ENTRY(taskmanager_thread, args)
 		zbx_setproctitle("%s [processed %d task(s) in " ZBX_FS_DBL " sec, idle %d sec]",
 				get_process_type_string(process_type), tasks_num, sec2 - sec1, sleeptime);
 	}
-
+stop:
 	if (SUCCEED == zbx_is_export_enabled(ZBX_FLAG_EXPTYPE_EVENTS))
 		zbx_export_deinit(problems_export);
 
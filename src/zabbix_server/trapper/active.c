@@ -25,6 +25,7 @@
 #include "zbxcrypto.h"
 #include "zbxnum.h"
 #include "zbxcomms.h"
+#include "zbxcommshigh.h"
 #include "zbxip.h"
 #include "zbxsysinfo.h"
 #include "zbxversion.h"
@@ -543,6 +544,13 @@ int	send_list_of_active_checks_json(zbx_socket_t *sock, struct zbx_json_parse *j
 	zbx_json_init(&json, ZBX_JSON_STAT_BUF_LEN);
 	zbx_json_addstring(&json, ZBX_PROTO_TAG_RESPONSE, ZBX_PROTO_VALUE_SUCCESS, ZBX_JSON_TYPE_STRING);
 
+	/* let agent know it can send its data compressed with zstd */
+	if (ZBX_COMPRESS_METHOD_ZSTD == zbx_get_compression_method(jp))
+	{
+		zbx_json_addstring(&json, ZBX_PROTO_TAG_COMPRESSION, ZBX_PROTO_VALUE_COMPRESSION_ZSTD,
+				ZBX_JSON_TYPE_STRING);
+	}
+
 	if (NULL == session || 0 == session->last_id || agent_config_revision != revision)
 	{
 		zbx_json_adduint64(&json, ZBX_PROTO_TAG_CONFIG_REVISION, (zbx_uint64_t)revision);
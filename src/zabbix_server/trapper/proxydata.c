@@ -121,8 +121,9 @@ static int	proxy_data_no_history(const struct zbx_json_parse *jp)
 void	recv_proxy_data(zbx_socket_t *sock, const struct zbx_json_parse *jp, const zbx_timespec_t *ts,
 		const zbx_events_funcs_t *events_cbs, int config_timeout, int proxydata_frequency)
 {
-	int			ret = FAIL, upload_status = 0, status, version_int, responded = 0;
-	char			*error = NULL, *version_str = NULL;
+	int			ret = FAIL, upload_status = 0, status, version_int, responded = 0,
+				more = ZBX_PROXY_DATA_DONE;
+	char			*error = NULL, *version_str = NULL, value[MAX_ID_LEN + 1];
 	zbx_dc_proxy_t		proxy;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -151,7 +152,10 @@ void	recv_proxy_data(zbx_socket_t *sock, const struct zbx_json_parse *jp, const
 		goto reply;
 	}
 
-	if (FAIL == (ret = zbx_hc_check_proxy(proxy.proxyid)))
+	if (SUCCEED == zbx_json_value_by_name(jp, ZBX_PROTO_TAG_MORE, value, sizeof(value), NULL))
+		more = atoi(value);
+
+	if (FAIL == (ret = zbx_hc_check_proxy(proxy.proxyid, ZBX_PROXY_DATA_MORE == more)))
 	{
 		upload_status = ZBX_PROXY_UPLOAD_DISABLED;
 		ret = proxy_data_no_history(jp);
@@ -8874,6 +8874,50 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if xml node is an element with the specified local name     *
+ *                                                                            *
+ ******************************************************************************/
+static int	vmware_xml_node_is(const xmlNode *node, const char *name)
+{
+	if (XML_ELEMENT_NODE != node->type || 0 != xmlStrcmp(node->name, (const xmlChar *)name))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if performance counter sample holds a value                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	vmware_perf_sample_is_set(const char *sample)
+{
+	return '\0' != *sample && 0 != strcmp(sample, "-1") ? SUCCEED : FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read text content of xml element                                  *
+ *                                                                            *
+ * Return value: The allocated text, empty string if the element has no text. *
+ *                                                                            *
+ ******************************************************************************/
+static char	*vmware_xml_node_text(xmlDoc *xdoc, const xmlNode *node)
+{
+	xmlChar	*val;
+	char	*value;
+
+	if (NULL == (val = xmlNodeListGetString(xdoc, node->xmlChildrenNode, 1)))
+		return zbx_strdup(NULL, "");
+
+	value = zbx_strdup(NULL, (const char *)val);
+	xmlFree(val);
+
+	return value;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: updates vmware performance statistics data                        *
@@ -8891,42 +8935,54 @@ out:
  ******************************************************************************/
 static int	vmware_service_process_perf_entity_data(zbx_vmware_perf_data_t *perfdata, xmlDoc *xdoc, xmlNode *node)
 {
-	xmlXPathContext		*xpathCtx;
-	xmlXPathObject		*xpathObj;
-	xmlNodeSetPtr		nodeset;
-	char			*instance, *counter, *value;
-	int			i, values = 0, ret = FAIL;
+	xmlNode			*value_node, *child, *id_child;
+	char			*instance, *counter, *value, *sample;
+	int			values = 0, ret = FAIL;
 	zbx_vector_ptr_t	*pervalues = &perfdata->values;
 	zbx_vmware_perf_value_t	*perfvalue;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	xpathCtx = xmlXPathNewContext(xdoc);
-	xpathCtx->node = node;
-
-	if (NULL == (xpathObj = xmlXPathEvalExpression((const xmlChar *)"*[local-name()='value']", xpathCtx)))
-		goto out;
-
-	if (0 != xmlXPathNodeSetIsEmpty(xpathObj->nodesetval))
-		goto out;
+	/* walk the metric series directly instead of evaluating several XPath expressions for each */
+	/* counter value, as the response can contain hundreds of thousands of them                  */
+	for (value_node = node->children; NULL != value_node; value_node = value_node->next)
+	{
+		if (SUCCEED != vmware_xml_node_is(value_node, "value"))
+			continue;
 
-	nodeset = xpathObj->nodesetval;
-	zbx_vector_ptr_reserve(pervalues, (size_t)(nodeset->nodeNr + pervalues->values_alloc));
+		value = NULL;
+		instance = NULL;
+		counter = NULL;
 
-	for (i = 0; i < nodeset->nodeNr; i++)
-	{
-		if (NULL == (value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i],
-				"*[local-name()='value'][text() != '-1'][last()]")))
+		for (child = value_node->children; NULL != child; child = child->next)
 		{
-			value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='value'][last()]");
-		}
+			if (SUCCEED == vmware_xml_node_is(child, "value"))
+			{
+				/* use the last sample that is not -1, otherwise the last sample */
+				sample = vmware_xml_node_text(xdoc, child);
 
-		instance = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='id']"
-				"/*[local-name()='instance']");
-		counter = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='id']"
-				"/*[local-name()='counterId']");
+				if (NULL == value || SUCCEED == vmware_perf_sample_is_set(sample) ||
+						SUCCEED != vmware_perf_sample_is_set(value))
+				{
+					zbx_free(value);
+					value = sample;
+				}
+				else
+					zbx_free(sample);
+			}
+			else if (SUCCEED == vmware_xml_node_is(child, "id"))
+			{
+				for (id_child = child->children; NULL != id_child; id_child = id_child->next)
+				{
+					if (NULL == instance && SUCCEED == vmware_xml_node_is(id_child, "instance"))
+						instance = vmware_xml_node_text(xdoc, id_child);
+					else if (NULL == counter && SUCCEED == vmware_xml_node_is(id_child, "counterId"))
+						counter = vmware_xml_node_text(xdoc, id_child);
+				}
+			}
+		}
 
-		if (NULL != value && NULL != counter)
+		if (NULL != value && NULL != counter && '\0' != *counter)
 		{
 			perfvalue = (zbx_vmware_perf_value_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_value_t));
 
@@ -8954,10 +9010,6 @@ static int	vmware_service_process_perf_entity_data(zbx_vmware_perf_data_t *perfd
 		zbx_free(value);
 	}
 
-out:
-	xmlXPathFreeObject(xpathObj);
-	xmlXPathFreeContext(xpathCtx);
-
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() values:%d", __func__, values);
 
 	return ret;
@@ -9393,7 +9445,7 @@ static void	vmware_perf_counters_availability_check(zbx_vmware_service_t *servic
 			int				k;
 			char				*err = NULL;
 			zbx_vmware_perf_counter_t	*counter;
-			zbx_vmware_perf_available_t	*perf, perf_cmp = {.type = entity->type, .id = entity->id};
+			zbx_vmware_perf_available_t	*perf = NULL, perf_cmp = {.type = entity->type, .id = entity->id};
 
 			counter = (zbx_vmware_perf_counter_t *)entity->counters.values[j];
 
@@ -0,0 +1,98 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcompress.h"
+
+static int	str_to_compress_method(const char *str)
+{
+	if (0 == strcmp(str, "zlib"))
+		return ZBX_COMPRESS_METHOD_ZLIB;
+
+	if (0 == strcmp(str, "zstd"))
+		return ZBX_COMPRESS_METHOD_ZSTD;
+
+	fail_msg("Unknown compression method \"%s\"", str);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char	*pattern;
+	char		*data, *compressed = NULL, *uncompressed;
+	size_t		pattern_len, data_len, compressed_len, uncompressed_len;
+	int		method;
+	zbx_uint64_t	i, repeat;
+
+	ZBX_UNUSED(state);
+
+	method = str_to_compress_method(zbx_mock_get_parameter_string("in.method"));
+
+	if (SUCCEED != zbx_compress_method_supported(method))
+	{
+		zbx_mock_assert_result_eq("zbx_compress_ext() return code", FAIL,
+				zbx_compress_ext("", 0, &compressed, &compressed_len, method));
+		return;
+	}
+
+	/* data is built by repeating pattern to get compressible input of the required size */
+	pattern = zbx_mock_get_parameter_string("in.data");
+	pattern_len = strlen(pattern);
+	repeat = zbx_mock_get_parameter_uint64("in.repeat");
+	data_len = pattern_len * repeat;
+	data = (char *)zbx_malloc(NULL, data_len + 1);
+
+	for (i = 0; i < repeat; i++)
+		memcpy(data + i * pattern_len, pattern, pattern_len);
+
+	zbx_mock_assert_result_eq("zbx_compress_ext() return code", SUCCEED,
+			zbx_compress_ext(data, data_len, &compressed, &compressed_len, method));
+
+	uncompressed = (char *)zbx_malloc(NULL, data_len + 1);
+	uncompressed_len = data_len;
+
+	zbx_mock_assert_result_eq("zbx_uncompress_ext() return code", SUCCEED,
+			zbx_uncompress_ext(compressed, compressed_len, uncompressed, &uncompressed_len, method));
+	zbx_mock_assert_uint64_eq("uncompressed size", data_len, uncompressed_len);
+
+	if (0 != memcmp(data, uncompressed, data_len))
+		fail_msg("Uncompressed data does not match the original data");
+
+	/* data compressed with one method must not be accepted by the other */
+	uncompressed_len = data_len;
+	zbx_mock_assert_result_eq("zbx_uncompress_ext() return code with other method", FAIL,
+			zbx_uncompress_ext(compressed, compressed_len, uncompressed, &uncompressed_len,
+			ZBX_COMPRESS_METHOD_ZLIB == method ? ZBX_COMPRESS_METHOD_ZSTD : ZBX_COMPRESS_METHOD_ZLIB));
+
+	/* data with corrupted header must be rejected */
+	compressed[0] ^= 0xff;
+	uncompressed_len = data_len;
+	zbx_mock_assert_result_eq("zbx_uncompress_ext() return code with corrupted data", FAIL,
+			zbx_uncompress_ext(compressed, compressed_len, uncompressed, &uncompressed_len, method));
+
+	zbx_free(uncompressed);
+	zbx_free(compressed);
+	zbx_free(data);
+}
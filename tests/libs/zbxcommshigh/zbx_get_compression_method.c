@@ -0,0 +1,78 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcommshigh.h"
+#include "zbxcompress.h"
+
+static int	str_to_compress_method(const char *str)
+{
+	if (0 == strcmp(str, "zlib"))
+		return ZBX_COMPRESS_METHOD_ZLIB;
+
+	if (0 == strcmp(str, "zstd"))
+		return ZBX_COMPRESS_METHOD_ZSTD;
+
+	fail_msg("Unknown compression method \"%s\"", str);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	struct zbx_json		j;
+	struct zbx_json_parse	jp;
+	int			expected_method, method;
+
+	ZBX_UNUSED(state);
+
+	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
+	zbx_json_addstring(&j, ZBX_PROTO_TAG_REQUEST, zbx_mock_get_parameter_string("in.request"),
+			ZBX_JSON_TYPE_STRING);
+
+	/* peers without zstd support do not add compression tag to the request */
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.compression"))
+	{
+		zbx_json_addstring(&j, ZBX_PROTO_TAG_COMPRESSION, zbx_mock_get_parameter_string("in.compression"),
+				ZBX_JSON_TYPE_STRING);
+	}
+
+	if (SUCCEED != zbx_json_open(j.buffer, &jp))
+		fail_msg("Cannot open request json: %s", zbx_json_strerror());
+
+	expected_method = str_to_compress_method(zbx_mock_get_parameter_string("out.method"));
+
+	/* responder without zstd support always falls back to zlib */
+	if (SUCCEED != zbx_compress_method_supported(expected_method))
+		expected_method = ZBX_COMPRESS_METHOD_ZLIB;
+
+	method = zbx_get_compression_method(&jp);
+	zbx_mock_assert_int_eq("compression method", expected_method, method);
+
+	zbx_mock_assert_int_eq("response protocol", (ZBX_COMPRESS_METHOD_ZSTD == method ?
+			ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS | ZBX_TCP_ZSTD : ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS),
+			zbx_compress_method_protocol(method));
+
+	zbx_json_free(&j);
+}
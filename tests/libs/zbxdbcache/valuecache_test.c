@@ -51,6 +51,8 @@ int	zbx_vc_precache_values(zbx_uint64_t itemid, int value_type, int seconds, int
 	zbx_vc_item_t			*item;
 	int				ret;
 	zbx_vector_history_record_t	values;
+	zbx_vc_fold_vector_t		fold_vector = {.values = &values, .value_type = value_type};
+	zbx_vc_fold_t			fold = {.fold_func = vc_fold_vector_append, .data = &fold_vector};
 
 	/* add item to cache if necessary */
 	if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
@@ -62,7 +64,7 @@ int	zbx_vc_precache_values(zbx_uint64_t itemid, int value_type, int seconds, int
 	/* perform request to cache values */
 	zbx_history_record_vector_create(&values);
 	RDLOCK_CACHE;
-	ret = vch_item_get_values(item, &values, seconds, count, ts);
+	ret = vch_item_get_values(item, &fold, seconds, count, ts);
 	UNLOCK_CACHE;
 	zbx_vc_flush_stats();
 	zbx_history_record_vector_destroy(&values, value_type);
@@ -0,0 +1,74 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxjson.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char		*data, *path;
+	char			*output = NULL, *text_output = NULL;
+	int			expected_ret, returned_ret;
+	zbx_jsonpath_t		jsonpath;
+	struct zbx_json_parse	jp;
+
+	ZBX_UNUSED(state);
+
+	data = zbx_mock_get_parameter_string("in.data");
+	path = zbx_mock_get_parameter_string("in.path");
+
+	if (FAIL == zbx_json_open(data, &jp))
+		fail_msg("Invalid json data: %s", zbx_json_strerror());
+
+	if (FAIL == zbx_jsonpath_compile(path, &jsonpath))
+		fail_msg("Invalid jsonpath: %s", zbx_json_strerror());
+
+	zbx_mock_assert_result_eq("zbx_jsonpath_query() return value", SUCCEED,
+			zbx_jsonpath_query(&jp, path, &output));
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("out.value"))
+	{
+		zbx_mock_assert_ptr_ne("zbx_jsonpath_query() result", NULL, output);
+		zbx_mock_assert_str_eq("zbx_jsonpath_query() result", zbx_mock_get_parameter_string("out.value"),
+				output);
+	}
+	else
+		zbx_mock_assert_ptr_eq("zbx_jsonpath_query() result", NULL, output);
+
+	/* FAIL means the path cannot be resolved on text and the caller falls back to the object tree query */
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.text_return"));
+	returned_ret = zbx_jsonpath_query_text(data, &jsonpath, &text_output);
+	zbx_mock_assert_result_eq("zbx_jsonpath_query_text() return value", expected_ret, returned_ret);
+
+	if (SUCCEED == returned_ret)
+	{
+		if (NULL == output)
+			zbx_mock_assert_ptr_eq("zbx_jsonpath_query_text() result", NULL, text_output);
+		else
+			zbx_mock_assert_str_eq("zbx_jsonpath_query_text() result", output, text_output);
+	}
+
+	zbx_free(text_output);
+	zbx_free(output);
+	zbx_jsonpath_clear(&jsonpath);
+}
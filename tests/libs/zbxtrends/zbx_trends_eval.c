@@ -0,0 +1,391 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxtrends.h"
+#include "zbxdb.h"
+#include "zbxdbhigh.h"
+#include "zbxnum.h"
+#include "../../../src/libs/zbxtrends/trends.h"
+
+#define TRENDS_MAX		64
+#define TRENDS_CACHE_MAX	256
+
+typedef struct
+{
+	time_t	clock;
+	double	num;
+	double	avg;
+	double	min;
+	double	max;
+}
+zbx_mock_trend_t;
+
+typedef struct
+{
+	time_t			start;
+	time_t			end;
+	zbx_trend_function_t	function;
+	double			value;
+	zbx_trend_state_t	state;
+}
+zbx_mock_tfc_value_t;
+
+struct zbx_db_result
+{
+	const char	*columns[2];
+	time_t		start;
+	time_t		end;
+	int		index;
+	char		values[3][ZBX_MAX_DOUBLE_LEN + 1];
+	char		*row[3];
+};
+
+static zbx_mock_trend_t		trends[TRENDS_MAX];
+static int			trends_num;
+
+static zbx_mock_tfc_value_t	tfc_values[TRENDS_CACHE_MAX];
+static int			tfc_values_num, tfc_enabled, tfc_hits;
+
+static struct zbx_db_result	db_result;
+
+int	__wrap_zbx_tfc_get_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function,
+		double *value, zbx_trend_state_t *state);
+void	__wrap_zbx_tfc_put_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function,
+		double value, zbx_trend_state_t state);
+int	__wrap_zbx_db_is_null(const char *field);
+zbx_db_result_t	__wrap_zbx_db_select(const char *fmt, ...);
+zbx_db_row_t	__wrap_zbx_db_fetch(zbx_db_result_t result);
+void	__wrap_zbx_db_free_result(zbx_db_result_t result);
+void	__wrap_zbx_recalc_time_period(time_t *tm_start, int table_group);
+
+int	__wrap_zbx_tfc_get_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function,
+		double *value, zbx_trend_state_t *state)
+{
+	int	i;
+
+	ZBX_UNUSED(itemid);
+
+	for (i = 0; i < tfc_values_num; i++)
+	{
+		if (tfc_values[i].start == start && tfc_values[i].end == end && tfc_values[i].function == function)
+		{
+			*value = tfc_values[i].value;
+			*state = tfc_values[i].state;
+			tfc_hits++;
+
+			return SUCCEED;
+		}
+	}
+
+	return FAIL;
+}
+
+void	__wrap_zbx_tfc_put_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function,
+		double value, zbx_trend_state_t state)
+{
+	zbx_mock_tfc_value_t	*tfc_value;
+
+	ZBX_UNUSED(itemid);
+
+	if (0 == tfc_enabled)
+		return;
+
+	if (TRENDS_CACHE_MAX == tfc_values_num)
+		fail_msg("too many cached trend function values");
+
+	tfc_value = &tfc_values[tfc_values_num++];
+	tfc_value->start = start;
+	tfc_value->end = end;
+	tfc_value->function = function;
+	tfc_value->value = value;
+	tfc_value->state = state;
+}
+
+int	__wrap_zbx_db_is_null(const char *field)
+{
+	return NULL == field ? SUCCEED : FAIL;
+}
+
+zbx_db_result_t	__wrap_zbx_db_select(const char *fmt, ...)
+{
+	va_list		args;
+	char		sql[MAX_STRING_LEN], columns[MAX_STRING_LEN];
+	const char	*ptr;
+	zbx_int64_t	start, end;
+
+	va_start(args, fmt);
+	zbx_vsnprintf(sql, sizeof(sql), fmt, args);
+	va_end(args);
+
+	if (1 != sscanf(sql, "select clock,%s from", columns))
+		fail_msg("unexpected query \"%s\"", sql);
+
+	if (NULL == (ptr = strstr(sql, " and clock>=")) ||
+			2 != sscanf(ptr, " and clock>=" ZBX_FS_I64 " and clock<=" ZBX_FS_I64, &start, &end))
+	{
+		fail_msg("unexpected query \"%s\"", sql);
+	}
+
+	memset(&db_result, 0, sizeof(db_result));
+	db_result.start = (time_t)start;
+	db_result.end = (time_t)end;
+
+	if (0 == strcmp(columns, "value_avg,num"))
+	{
+		db_result.columns[0] = "avg";
+		db_result.columns[1] = "num";
+	}
+	else if (0 == strcmp(columns, "num"))
+		db_result.columns[0] = "num";
+	else if (0 == strcmp(columns, "value_min"))
+		db_result.columns[0] = "min";
+	else if (0 == strcmp(columns, "value_max"))
+		db_result.columns[0] = "max";
+	else
+		fail_msg("unexpected columns \"%s\"", columns);
+
+	return &db_result;
+}
+
+static double	trend_column_value(const zbx_mock_trend_t *trend, const char *column)
+{
+	if (0 == strcmp(column, "avg"))
+		return trend->avg;
+
+	if (0 == strcmp(column, "num"))
+		return trend->num;
+
+	if (0 == strcmp(column, "min"))
+		return trend->min;
+
+	return trend->max;
+}
+
+zbx_db_row_t	__wrap_zbx_db_fetch(zbx_db_result_t result)
+{
+	const zbx_mock_trend_t	*trend;
+	int			i;
+
+	for (; result->index < trends_num; result->index++)
+	{
+		trend = &trends[result->index];
+
+		if (trend->clock >= result->start && trend->clock <= result->end)
+			break;
+	}
+
+	if (result->index == trends_num)
+		return NULL;
+
+	result->index++;
+
+	zbx_snprintf(result->values[0], sizeof(result->values[0]), ZBX_FS_I64, (zbx_int64_t)trend->clock);
+	result->row[0] = result->values[0];
+
+	for (i = 0; i < 2 && NULL != result->columns[i]; i++)
+	{
+		zbx_snprintf(result->values[i + 1], sizeof(result->values[i + 1]), ZBX_FS_DBL64,
+				trend_column_value(trend, result->columns[i]));
+		result->row[i + 1] = result->values[i + 1];
+	}
+
+	return result->row;
+}
+
+void	__wrap_zbx_db_free_result(zbx_db_result_t result)
+{
+	ZBX_UNUSED(result);
+}
+
+void	__wrap_zbx_recalc_time_period(time_t *tm_start, int table_group)
+{
+	ZBX_UNUSED(tm_start);
+	ZBX_UNUSED(table_group);
+}
+
+static time_t	read_time(zbx_mock_handle_t handle, const char *name)
+{
+	zbx_timespec_t	ts;
+
+	if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(zbx_mock_get_object_member_string(handle, name), &ts))
+		fail_msg("invalid %s time format", name);
+
+	return ts.sec;
+}
+
+static void	read_trends(void)
+{
+	zbx_mock_handle_t	htrends, htrend;
+	zbx_mock_error_t	err;
+
+	htrends = zbx_mock_get_parameter_handle("in.trends");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(htrends, &htrend))))
+	{
+		zbx_mock_trend_t	*trend;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read trend record: %s", zbx_mock_error_string(err));
+
+		if (TRENDS_MAX == trends_num)
+			fail_msg("too many trend records");
+
+		trend = &trends[trends_num++];
+		trend->clock = read_time(htrend, "clock");
+		trend->num = atof(zbx_mock_get_object_member_string(htrend, "num"));
+		trend->avg = atof(zbx_mock_get_object_member_string(htrend, "avg"));
+		trend->min = atof(zbx_mock_get_object_member_string(htrend, "min"));
+		trend->max = atof(zbx_mock_get_object_member_string(htrend, "max"));
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate trend function directly from hourly records              *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_hourly(time_t start, time_t end, zbx_trend_function_t function, double *value)
+{
+	double	num = 0;
+	int	i, ret = FAIL;
+
+	*value = 0;
+
+	for (i = 0; i < trends_num; i++)
+	{
+		const zbx_mock_trend_t	*trend = &trends[i];
+
+		if (trend->clock < start || trend->clock > end)
+			continue;
+
+		switch (function)
+		{
+			case ZBX_TREND_FUNCTION_AVG:
+				*value = (0 == num ? trend->avg : *value / (num + trend->num) * num +
+						trend->avg / (num + trend->num) * trend->num);
+				num += trend->num;
+				break;
+			case ZBX_TREND_FUNCTION_SUM:
+				*value += trend->avg * trend->num;
+				break;
+			case ZBX_TREND_FUNCTION_COUNT:
+				*value += trend->num;
+				break;
+			case ZBX_TREND_FUNCTION_MAX:
+				if (FAIL == ret || trend->max > *value)
+					*value = trend->max;
+				break;
+			case ZBX_TREND_FUNCTION_MIN:
+				if (FAIL == ret || trend->min < *value)
+					*value = trend->min;
+				break;
+			default:
+				fail_msg("unsupported trend function %d", function);
+		}
+
+		ret = SUCCEED;
+	}
+
+	/* sum and count over a period without data are zero */
+	if (ZBX_TREND_FUNCTION_SUM == function || ZBX_TREND_FUNCTION_COUNT == function)
+		ret = SUCCEED;
+
+	return ret;
+}
+
+static void	check_function(time_t start, time_t end, const char *name, zbx_trend_function_t function,
+		int (*eval_func)(const char *, zbx_uint64_t, time_t, time_t, double *, char **), const char *out)
+{
+	char	path[MAX_STRING_LEN], *error = NULL;
+	double	value, hourly_value;
+	int	ret, hourly_ret;
+
+	ret = eval_func("trends", 1, start, end, &value, &error);
+	hourly_ret = eval_hourly(start, end, function, &hourly_value);
+
+	zbx_snprintf(path, sizeof(path), "trend%s() return value", name);
+	zbx_mock_assert_result_eq(path, hourly_ret, ret);
+
+	if (NULL != out)
+	{
+		zbx_snprintf(path, sizeof(path), "%s.%s", out, name);
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists(path))
+		{
+			zbx_mock_assert_result_eq(path, SUCCEED, ret);
+			zbx_mock_assert_double_eq(path, atof(zbx_mock_get_parameter_string(path)), value);
+		}
+		else
+			zbx_mock_assert_result_eq(path, FAIL, ret);
+	}
+
+	if (SUCCEED == ret)
+	{
+		zbx_snprintf(path, sizeof(path), "trend%s() value", name);
+		zbx_mock_assert_double_eq(path, hourly_value, value);
+	}
+
+	zbx_free(error);
+}
+
+static void	check_period(time_t start, time_t end, const char *out)
+{
+	check_function(start, end, "avg", ZBX_TREND_FUNCTION_AVG, zbx_trends_eval_avg, out);
+	check_function(start, end, "sum", ZBX_TREND_FUNCTION_SUM, zbx_trends_eval_sum, out);
+	check_function(start, end, "count", ZBX_TREND_FUNCTION_COUNT, zbx_trends_eval_count, out);
+	check_function(start, end, "max", ZBX_TREND_FUNCTION_MAX, zbx_trends_eval_max, out);
+	check_function(start, end, "min", ZBX_TREND_FUNCTION_MIN, zbx_trends_eval_min, out);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_mock_handle_t	hperiod;
+
+	ZBX_UNUSED(state);
+
+	if (0 != setenv("TZ", zbx_mock_get_parameter_string("in.timezone"), 1))
+		fail_msg("Cannot set 'TZ' environment variable: %s", zbx_strerror(errno));
+
+	tzset();
+
+	/* daily buckets combine averages in different order than hourly records */
+	zbx_update_epsilon_to_float_precision();
+
+	read_trends();
+
+	/* daily buckets of the prime period are cached before evaluating the tested period */
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.prime"))
+	{
+		tfc_enabled = 1;
+		hperiod = zbx_mock_get_parameter_handle("in.prime");
+		check_period(read_time(hperiod, "start"), read_time(hperiod, "end"), NULL);
+	}
+
+	tfc_hits = 0;
+	hperiod = zbx_mock_get_parameter_handle("in.period");
+	check_period(read_time(hperiod, "start"), read_time(hperiod, "end"), "out");
+
+	zbx_mock_assert_int_eq("cached bucket values", atoi(zbx_mock_get_parameter_string("out.cached")), tfc_hits);
+}
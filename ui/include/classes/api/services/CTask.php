@@ -207,7 +207,9 @@ class CTask extends CApiService {
 											'stats' =>			['type' => API_OUTPUT, 'in' => implode(',', ['items', 'values', 'memory', 'mode']), 'default' => API_OUTPUT_EXTEND],
 											'top' =>			['type' => API_OBJECT, 'fields' => [
 												'values' =>			['type' => API_INT32],
-												'request.values' =>	['type' => API_INT32]
+												'request.values' =>	['type' => API_INT32],
+												'size' =>			['type' => API_INT32],
+												'misses' =>			['type' => API_INT32]
 											]]
 										]],
 										'preprocessing' =>	['type' => API_OBJECT, 'fields' => [